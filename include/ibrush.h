@@ -60,23 +60,19 @@ const std::size_t SPHERE_MAX_SIDES = 7;
 
 }
 
-// The structure defining a single corner point of an IWinding
+// The structure defining a single corner point of an IWinding.
+// Texture coordinates, normal, tangent and bitangent are not stored per
+// vertex, they are evaluated on demand (see IFace::getTexcoord).
 struct WindingVertex
 {
 	Vector3 vertex;			// The 3D coordinates of the point
-	Vector2 texcoord;		// The UV coordinates
-	Vector3 tangent;		// The tangent
-	Vector3 bitangent;		// The bitangent
-	Vector3 normal;			// The normals
 	std::size_t adjacent;	// The index of the adjacent WindingVertex
 
 	// greebo: This operator is needed to enable scripting support
 	// using boost::python's vector_indexing_suite.
 	bool operator==(const WindingVertex& other) const
 	{
-		return (vertex == other.vertex && texcoord == other.texcoord &&
-			    tangent == other.tangent && bitangent == other.bitangent &&
-				normal == other.normal && adjacent == other.adjacent);
+		return (vertex == other.vertex && adjacent == other.adjacent);
 	}
 };
 
@@ -153,8 +149,21 @@ public:
 	virtual IWinding& getWinding() = 0;
 	virtual const IWinding& getWinding() const = 0;
 
+	// Returns the texture coordinates of the winding vertex with the given index.
+	// These are evaluated on demand, the first time they are requested.
+	virtual Vector2 getTexcoord(std::size_t vertexIndex) const = 0;
+
+	// Retrieves the tangent and bitangent of this face's texture space,
+	// which are the same for all winding vertices. The face normal is
+	// the one of the face plane.
+	virtual void getTextureAxes(Vector3& tangent, Vector3& bitangent) const = 0;
+
 	virtual const Plane3& getPlane3() const = 0;
 
+	// Replaces the plane of this face, the brush winding is re-evaluated afterwards.
+	// Call undoSave() beforehand to make this undoable.
+	virtual void setPlane3(const Plane3& plane) = 0;
+
 	/**
 	 * Returns the 3x3 texture matrix for this face, containing shift, scale and rotation.
 	 *
@@ -163,6 +172,10 @@ public:
 	 */
 	virtual Matrix4 getTexDefMatrix() const = 0;
 
+	// Sets the texture matrix in the same form as returned by getTexDefMatrix().
+	// Call undoSave() beforehand to make this undoable.
+	virtual void setTexDefMatrix(const Matrix4& matrix) = 0;
+
 	/**
 	 * The matrix used to project world coordinates to U/V space.
 	 */
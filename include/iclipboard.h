@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <functional>
 #include "imodule.h"
 
 namespace radiant
@@ -25,6 +26,22 @@ public:
 
     /// Copy the given string to the system clipboard
     virtual void setString(const std::string& str) = 0;
+
+    /// Function generating the clipboard string on demand
+    typedef std::function<std::string()> StringProducer;
+
+    /**
+     * Places a string on the system clipboard which is not generated before
+     * it is actually requested, either by this or by another application.
+     * Returns a token identifying this clipboard content, see containsContent().
+     */
+    virtual std::size_t setDeferredString(const StringProducer& producer) = 0;
+
+    /**
+     * Returns true if the system clipboard is still holding the content
+     * set by the setDeferredString() call that returned the given token.
+     */
+    virtual bool containsContent(std::size_t token) = 0;
 };
 
 }
@@ -7,6 +7,7 @@
  */
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <list>
 #include <set>
@@ -186,6 +187,11 @@ public:
 	/// \brief Returns the absolute filename for a relative \p name, or "" if not found.
 	virtual std::string findFile(const std::string& name) = 0;
 
+	/// \brief Returns the last modification time of the file identified by \p filename,
+	/// or 0 if not found. Files inside archives report the modification time of the archive.
+	/// The value is only meant to be compared against earlier results for the same file.
+	virtual std::int64_t getFileModificationTime(const std::string& filename) = 0;
+
 	/// \brief Returns the filesystem root for an absolute \p name, or "" if not found.
 	/// This can be used to convert an absolute name to a relative name.
 	virtual std::string findRoot(const std::string& name) = 0;
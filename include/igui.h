@@ -372,6 +372,11 @@ public:
 	// Returns the GUI appearance type for the given GUI path
 	virtual GuiType getGuiType(const std::string& guiPath) = 0;
 
+	// Determines the appearance type of every known GUI, such that
+	// foreachGui() is reporting them. This is much faster than calling
+	// getGuiType() for each GUI path.
+	virtual void determineGuiTypes() = 0;
+
 	// Reload the gui
 	virtual void reloadGui(const std::string& guiPath) = 0;
 
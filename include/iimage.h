@@ -77,6 +77,14 @@ public:
      */
     virtual ImagePtr imageFromVFS(const std::string& vfsPath) const = 0;
 
+    /**
+     * \brief
+     * Returns the VFS path of the file imageFromVFS() would load for the
+     * given image name (including prefix and extension), or an empty string
+     * if no matching file exists.
+     */
+    virtual std::string findImageFile(const std::string& vfsPath) const = 0;
+
     /**
      * \brief
      * Load an image from a filesystem path.
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
 #include <set>
 #include <string>
+#include <vector>
 #include <functional>
 #include "imodule.h"
 #include <sigc++/signal.h>
@@ -12,8 +17,281 @@ namespace scene
 class INode;
 typedef std::shared_ptr<INode> INodePtr;
 
-// A list of named layers
-typedef std::set<int> LayerList;
+/**
+ * The set of layer IDs a node is a member of.
+ *
+ * Stored as a bitset: IDs below 64 are kept in a single inline word, such
+ * that the common case needs no heap allocation and checks like "is any of
+ * these layers visible" boil down to a few bitwise ANDs. Higher IDs spill
+ * into additional words. The interface mimics the parts of std::set<int>
+ * that client code is using.
+ */
+class LayerList
+{
+private:
+	static const int BITS_PER_WORD = 64;
+
+	// Bits for the layer IDs [0..63]
+	std::uint64_t _bits;
+
+	// Bits for the layer IDs 64 and higher, one word per 64 IDs
+	std::vector<std::uint64_t> _extraBits;
+
+public:
+	typedef int value_type;
+
+	// Iterates over the contained layer IDs in ascending order
+	class const_iterator
+	{
+	private:
+		const LayerList* _list;
+		int _id;
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef int value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const int* pointer;
+		typedef const int& reference;
+
+		const_iterator(const LayerList* list, int id) :
+			_list(list),
+			_id(id)
+		{}
+
+		const int& operator*() const
+		{
+			return _id;
+		}
+
+		const_iterator& operator++()
+		{
+			_id = _list->findNext(_id + 1);
+			return *this;
+		}
+
+		const_iterator operator++(int)
+		{
+			const_iterator previous(*this);
+			++(*this);
+			return previous;
+		}
+
+		bool operator==(const const_iterator& other) const
+		{
+			return _id == other._id;
+		}
+
+		bool operator!=(const const_iterator& other) const
+		{
+			return _id != other._id;
+		}
+	};
+
+	typedef const_iterator iterator;
+
+	LayerList() :
+		_bits(0)
+	{}
+
+	LayerList(std::initializer_list<int> layerIds) :
+		_bits(0)
+	{
+		for (int layerId : layerIds)
+		{
+			insert(layerId);
+		}
+	}
+
+	const_iterator begin() const
+	{
+		return const_iterator(this, findNext(0));
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator(this, -1);
+	}
+
+	bool empty() const
+	{
+		if (_bits != 0) return false;
+
+		for (std::uint64_t word : _extraBits)
+		{
+			if (word != 0) return false;
+		}
+
+		return true;
+	}
+
+	std::size_t size() const
+	{
+		std::size_t count = CountBits(_bits);
+
+		for (std::uint64_t word : _extraBits)
+		{
+			count += CountBits(word);
+		}
+
+		return count;
+	}
+
+	void clear()
+	{
+		_bits = 0;
+		_extraBits.clear();
+	}
+
+	bool contains(int layerId) const
+	{
+		const std::uint64_t* word = getWord(layerId);
+		return word != nullptr && (*word & GetMask(layerId)) != 0;
+	}
+
+	std::size_t count(int layerId) const
+	{
+		return contains(layerId) ? 1 : 0;
+	}
+
+	const_iterator find(int layerId) const
+	{
+		return contains(layerId) ? const_iterator(this, layerId) : end();
+	}
+
+	// Adds the given ID, returns true if it hasn't been part of this set before
+	bool insert(int layerId)
+	{
+		if (layerId < 0) return false;
+
+		std::uint64_t& word = getOrCreateWord(layerId);
+		std::uint64_t mask = GetMask(layerId);
+
+		if ((word & mask) != 0) return false;
+
+		word |= mask;
+		return true;
+	}
+
+	// Removes the given ID, returns the number of removed elements (0 or 1)
+	std::size_t erase(int layerId)
+	{
+		std::uint64_t* word = const_cast<std::uint64_t*>(getWord(layerId));
+
+		if (word == nullptr || (*word & GetMask(layerId)) == 0) return 0;
+
+		*word &= ~GetMask(layerId);
+		return 1;
+	}
+
+	void erase(const_iterator pos)
+	{
+		erase(*pos);
+	}
+
+	// Returns true if at least one layer ID is contained in both sets
+	bool intersects(const LayerList& other) const
+	{
+		if ((_bits & other._bits) != 0) return true;
+
+		std::size_t numWords = std::min(_extraBits.size(), other._extraBits.size());
+
+		for (std::size_t i = 0; i < numWords; ++i)
+		{
+			if ((_extraBits[i] & other._extraBits[i]) != 0) return true;
+		}
+
+		return false;
+	}
+
+	bool operator==(const LayerList& other) const
+	{
+		if (_bits != other._bits) return false;
+
+		std::size_t numWords = std::max(_extraBits.size(), other._extraBits.size());
+
+		for (std::size_t i = 0; i < numWords; ++i)
+		{
+			std::uint64_t a = i < _extraBits.size() ? _extraBits[i] : 0;
+			std::uint64_t b = i < other._extraBits.size() ? other._extraBits[i] : 0;
+
+			if (a != b) return false;
+		}
+
+		return true;
+	}
+
+	bool operator!=(const LayerList& other) const
+	{
+		return !operator==(other);
+	}
+
+private:
+	static std::uint64_t GetMask(int layerId)
+	{
+		return std::uint64_t(1) << (layerId % BITS_PER_WORD);
+	}
+
+	static std::size_t CountBits(std::uint64_t word)
+	{
+		std::size_t count = 0;
+
+		for (; word != 0; word &= word - 1)
+		{
+			++count;
+		}
+
+		return count;
+	}
+
+	const std::uint64_t* getWord(int layerId) const
+	{
+		if (layerId < 0) return nullptr;
+		if (layerId < BITS_PER_WORD) return &_bits;
+
+		std::size_t index = static_cast<std::size_t>(layerId / BITS_PER_WORD - 1);
+		return index < _extraBits.size() ? &_extraBits[index] : nullptr;
+	}
+
+	std::uint64_t& getOrCreateWord(int layerId)
+	{
+		if (layerId < BITS_PER_WORD) return _bits;
+
+		std::size_t index = static_cast<std::size_t>(layerId / BITS_PER_WORD - 1);
+
+		if (index >= _extraBits.size())
+		{
+			_extraBits.resize(index + 1, 0);
+		}
+
+		return _extraBits[index];
+	}
+
+	// Returns the lowest contained ID which is >= the given one, or -1 if there is none
+	int findNext(int layerId) const
+	{
+		int numWords = 1 + static_cast<int>(_extraBits.size());
+
+		for (int wordIndex = layerId / BITS_PER_WORD; wordIndex < numWords; ++wordIndex)
+		{
+			std::uint64_t word = wordIndex == 0 ? _bits : _extraBits[wordIndex - 1];
+
+			// Mask out the bits below the start ID in the first word
+			int firstBit = wordIndex == layerId / BITS_PER_WORD ? layerId % BITS_PER_WORD : 0;
+			word &= ~std::uint64_t(0) << firstBit;
+
+			// Skip empty words entirely
+			if (word == 0) continue;
+
+			int bit = 0;
+			for (; (word & (std::uint64_t(1) << bit)) == 0; ++bit) {}
+
+			return wordIndex * BITS_PER_WORD + bit;
+		}
+
+		return -1;
+	}
+};
 
 /**
  * greebo: Interface of a Layered object.
@@ -174,6 +452,28 @@ public:
 	 */
 	virtual bool updateNodeVisibility(const scene::INodePtr& node) = 0;
 
+	/**
+	 * Called by scene nodes when they are inserted into or removed from the
+	 * scene this manager belongs to. The manager keeps an index of each
+	 * layer's members, such that changing the visibility of a layer doesn't
+	 * need to traverse the entire scene.
+	 */
+	virtual void registerNode(INode& node) = 0;
+	virtual void unregisterNode(INode& node) = 0;
+
+	/**
+	 * Called by registered nodes whenever their set of layers changes,
+	 * to keep the member index up to date. This doesn't update the node
+	 * visibility, see signal_nodeMembershipChanged().
+	 */
+	virtual void updateNodeMembership(INode& node, const LayerList& previousLayers) = 0;
+
+	/**
+	 * Returns the number of entities and primitives in the scene which
+	 * are member of the given layer, regardless of their visibility.
+	 */
+	virtual std::size_t getLayerMemberCount(int layerID) const = 0;
+
 	/**
 	 * greebo: Sets the selection status of the entire layer.
 	 *
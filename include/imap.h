@@ -28,6 +28,12 @@ class ITargetManager;
 // see ilayer.h
 class ILayerManager;
 
+namespace scene
+{
+	class IMaterialUsageIndex;
+	class IMapStatistics;
+}
+
 namespace selection 
 { 
 	class ISelectionSetManager;
@@ -82,6 +88,18 @@ public:
 	 * Provides methods to create and assign layers in this map.
 	 */
 	virtual ILayerManager& getLayerManager() = 0;
+
+	/**
+	 * Gives access to the index of materials used by the brushes
+	 * and patches in this map.
+	 */
+	virtual IMaterialUsageIndex& getMaterialUsageIndex() = 0;
+
+	/**
+	 * Gives access to the node counts of this map, like the number
+	 * of entities per entity class or the models in use.
+	 */
+	virtual IMapStatistics& getStatistics() = 0;
 };
 typedef std::shared_ptr<IMapRootNode> IMapRootNodePtr;
 
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <memory>
+
+namespace scene
+{
+
+class INode;
+
+/**
+ * Node counts of a map, broken down by entity class and model. Every map
+ * root node owns one.
+ *
+ * Entity, brush, patch and model nodes register with the statistics when
+ * they are inserted into the scene and unregister when they are removed.
+ * While in the scene they report changes affecting the counts (like a new
+ * model skin), which are picked up the next time the statistics are
+ * queried. Queries therefore don't need to traverse the scene, their cost
+ * only depends on the number of nodes changed since the last query.
+ */
+class IMapStatistics
+{
+public:
+	typedef std::shared_ptr<IMapStatistics> Ptr;
+
+	struct ModelCount
+	{
+		// Number of model nodes showing this model
+		std::size_t count = 0;
+
+		// Polygon count of a single instance
+		std::size_t polyCount = 0;
+
+		// Number of model nodes per skin, the default skin is listed as ""
+		std::map<std::string, std::size_t> skinCount;
+	};
+
+	// Number of entities per entity class name
+	typedef std::map<std::string, std::size_t> EntityClassCounts;
+
+	// Model counts per model path
+	typedef std::map<std::string, ModelCount> ModelCounts;
+
+	virtual ~IMapStatistics() {}
+
+	/**
+	 * Called by the nodes when they are inserted into or removed from
+	 * the scene these statistics belong to.
+	 */
+	virtual void registerNode(INode& node) = 0;
+	virtual void unregisterNode(INode& node) = 0;
+
+	/**
+	 * Called by registered nodes whenever any of their counted properties
+	 * changed. The node is re-evaluated lazily on the next query.
+	 */
+	virtual void onNodeChanged(INode& node) = 0;
+
+	// The number of entities in the map (including worldspawn)
+	virtual std::size_t getEntityCount() = 0;
+
+	// The number of primitives (brushes and patches) in the map
+	virtual std::size_t getPrimitiveCount() = 0;
+
+	// The number of entities of each entity class in use
+	virtual const EntityClassCounts& getEntityClassCounts() = 0;
+
+	// The usage of each model in the map
+	virtual const ModelCounts& getModelCounts() = 0;
+};
+
+} // namespace scene
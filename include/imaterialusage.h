@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <functional>
+
+namespace scene
+{
+
+class INode;
+typedef std::shared_ptr<INode> INodePtr;
+
+/**
+ * Reverse index of the materials used in a map, mapping each material
+ * name to the brushes and patches using it. Every map root node owns one.
+ *
+ * Brush and patch nodes register with the index when they are inserted
+ * into the scene and unregister when they are removed. While in the scene
+ * they report changes to their materials, which are picked up the next
+ * time the index is queried. Lookups are therefore proportional to the
+ * number of hits instead of the size of the map.
+ *
+ * Material names are compared case-insensitively, like the shader system
+ * does. Materials only differing in case share the same entry.
+ */
+class IMaterialUsageIndex
+{
+public:
+	typedef std::shared_ptr<IMaterialUsageIndex> Ptr;
+
+	virtual ~IMaterialUsageIndex() {}
+
+	/**
+	 * Called by brush and patch nodes when they are inserted into
+	 * or removed from the scene this index belongs to.
+	 */
+	virtual void registerNode(INode& node) = 0;
+	virtual void unregisterNode(INode& node) = 0;
+
+	/**
+	 * Called by registered nodes whenever any of their materials changed,
+	 * or faces have been added or removed. The node is re-evaluated
+	 * lazily on the next query.
+	 */
+	virtual void onNodeMaterialsChanged(INode& node) = 0;
+
+	/**
+	 * Invokes the given functor for each brush or patch using the given
+	 * material (brushes with at least one face using it). The functor is
+	 * allowed to change the materials of the visited nodes.
+	 */
+	virtual void foreachNodeUsingMaterial(const std::string& material,
+		const std::function<void(const INodePtr&)>& functor) = 0;
+
+	/**
+	 * Invokes the given functor for each material in use, in alphabetical
+	 * order, along with the number of faces and patches using it.
+	 */
+	virtual void foreachMaterial(const std::function<void(const std::string& material,
+		std::size_t faceCount, std::size_t patchCount)>& functor) = 0;
+
+	// Returns true if at least one face or patch is using the given material
+	virtual bool isMaterialInUse(const std::string& material) = 0;
+};
+
+} // namespace scene
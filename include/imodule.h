@@ -31,7 +31,7 @@
  * As long as no external module/plugin files are removed this number is safe to stay 
  * as it is. Keep this number compatible to std::size_t, i.e. unsigned.
  */
-#define MODULE_COMPATIBILITY_LEVEL 20201026
+#define MODULE_COMPATIBILITY_LEVEL 20201109
 
 // A function taking an error title and an error message string, invoked in debug builds
 // for things like ASSERT_MESSAGE and ERROR_MESSAGE
@@ -191,6 +191,35 @@ public:
         // Empty default implementation
     }
 
+    /**
+     * Returns true if initialiseModule() may be invoked on a worker thread,
+     * concurrently to the initialisation of modules which are neither
+     * dependencies nor dependents of this one. Such a module must restrict
+     * itself to thread-safe calls during initialiseModule(), like starting
+     * its definition loader. Most other modules are not safe to be called
+     * from a worker thread.
+     *
+     * The default implementation returns false, the module is initialised
+     * on the main thread.
+     */
+    virtual bool allowsConcurrentInitialisation() const
+    {
+        return false;
+    }
+
+    /**
+     * Invoked on the main thread after initialiseModule() returned, before
+     * any of the modules depending on this one is initialised. Modules
+     * allowing concurrent initialisation do their non-thread-safe setup
+     * here, like registering commands or creating wx objects.
+     *
+     * The default implementation does nothing.
+     */
+    virtual void finishModuleInitialisation(const IApplicationContext& ctx)
+    {
+        // Empty default implementation
+    }
+
     // Internally queried by the ModuleRegistry. To protect against leftover
     // binaries containing outdated moudles from being loaded and registered
     // the compatibility level is compared with the one in the ModuleRegistry.
@@ -329,6 +358,10 @@ public:
 	// Returns the instance ID of this registry. This is a numeric type used by
 	// InstanceReference classes to check if their references are still valid.
 	virtual InstanceId getInstanceId() const = 0;
+
+	// Lock to be held while acquiring a module reference, as modules
+	// can be initialised concurrently (see InstanceReference)
+	virtual std::mutex& getReferenceLock() = 0;
 };
 
 namespace module
@@ -426,6 +459,7 @@ namespace module
 		void acquireReference()
 		{
             auto& registry = GlobalModuleRegistry();
+            std::lock_guard<std::mutex> lock(registry.getReferenceLock());
 
 			_instancePtr = std::dynamic_pointer_cast<ModuleType>(registry.getModule(_moduleName)).get();
 
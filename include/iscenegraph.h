@@ -25,6 +25,7 @@ namespace scene
 
 class ISpacePartitionSystem;
 typedef std::shared_ptr<ISpacePartitionSystem> ISpacePartitionSystemPtr;
+class ISPNode;
 
 /**
 * A scene-graph - a Directed Acyclic Graph (DAG).
@@ -94,12 +95,26 @@ public:
 		virtual bool visit(const INodePtr& node) = 0;
 	};
 
+	// A walker class which is additionally notified about the space partition
+	// nodes the visited scene nodes are linked to
+	class SpacePartitionWalker :
+		public Walker
+	{
+	public:
+		// Called for each space partition node intersecting the volume,
+		// before any of its members is passed to visit()
+		virtual void visitSPNode(const ISPNode& node) = 0;
+	};
+
 	// Visit each scene node in the given volume using the given walker class, even hidden ones
 	virtual void foreachNodeInVolume(const VolumeTest& volume, Walker& walker) = 0;
 
 	// Same as above, but culls any hidden nodes
 	virtual void foreachVisibleNodeInVolume(const VolumeTest& volume, Walker& walker) = 0;
 
+	// Same as above, reporting each traversed space partition node to the walker
+	virtual void foreachVisibleNodeInVolume(const VolumeTest& volume, SpacePartitionWalker& walker) = 0;
+
 	// Call the functor on each scene node in the entire scenegraph, including hidden ones
 	virtual void foreachNode(const INode::VisitorFunc& functor) = 0;
 
@@ -114,6 +129,22 @@ public:
 
 	// Returns the associated spacepartition
 	virtual ISpacePartitionSystemPtr getSpacePartition() = 0;
+
+	// Counters collected by the most recent foreach[Visible]NodeInVolume() call
+	struct VolumeTraversalStatistics
+	{
+		std::size_t visitedSPNodes;	// space partition nodes entered
+		std::size_t culledSPNodes;	// space partition nodes skipped as a whole
+		std::size_t visitedNodes;	// scene nodes passed to the walker
+		std::size_t culledNodes;	// scene nodes skipped because of their bounds
+	};
+
+	virtual const VolumeTraversalStatistics& getVolumeTraversalStatistics() const = 0;
+
+	// The number of foreach[Visible]NodeInVolume() calls so far. Render walkers
+	// re-evaluate the view-dependent state of the nodes they visit, so if this
+	// number changed, that state might belong to another view by now.
+	virtual std::size_t getVolumeTraversalCount() const = 0;
 };
 typedef std::shared_ptr<Graph> GraphPtr;
 typedef std::weak_ptr<Graph> GraphWeakPtr;
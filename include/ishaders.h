@@ -174,6 +174,15 @@ public:
      */
     virtual TexturePtr getEditorImage() = 0;
 
+    /**
+     * \brief
+     * Return a downscaled version of the editor image for use in the texture
+     * and media browsers. The texture reports the dimensions of the full
+     * editor image. Thumbnails are generated in the background, an empty
+     * pointer is returned until this one is available.
+     */
+    virtual TexturePtr getEditorImageThumbnail() = 0;
+
     /**
      * \brief
      * Return true if the editor image is no tex for this shader.
@@ -355,6 +364,24 @@ typedef std::function<void(const std::string&)> ShaderNameCallback;
 
 const char* const MODULE_SHADERSYSTEM = "MaterialManager";
 
+/// GL texture memory used by the material images
+struct TextureMemoryUsage
+{
+    // Size of the mipmap chains currently uploaded to OpenGL
+    std::size_t residentBytes = 0;
+
+    // The configured budget, 0 if unlimited
+    std::size_t budgetBytes = 0;
+
+    std::size_t numResident = 0;
+
+    // Number of textures whose storage has been released to meet the budget
+    std::size_t numEvicted = 0;
+
+    // Number of resident textures stored S3TC compressed
+    std::size_t numCompressed = 0;
+};
+
 /**
  * \brief
  * Interface for the material manager.
@@ -451,6 +478,19 @@ public:
 	 */
 	virtual TexturePtr loadTextureFromFile(const std::string& filename) = 0;
 
+	/**
+	 * To be called by the renderer before binding a texture it obtained
+	 * from a material earlier. If the texture has been evicted to meet the
+	 * texture memory budget it is uploaded again. Texture numbers not
+	 * belonging to a material image are ignored.
+	 */
+	virtual void ensureTextureResident(GLuint textureNumber) = 0;
+
+	/**
+	 * Returns the amount of texture memory used by the material images.
+	 */
+	virtual TextureMemoryUsage getTextureMemoryUsage() = 0;
+
 	/**
 	 * Creates a new shader expression for the given string. This can be used to create standalone
 	 * expression objects for unit testing purposes.
@@ -125,6 +125,11 @@ public:
     // Will throw a std::out_of_range exception if the path cannot be resolved
     virtual float getSoundFileDuration(const std::string& vfsPath) = 0;
 
+    // Determines the durations of all the given sound files in parallel and keeps
+    // them in memory, such that subsequent getSoundFileDuration() calls return
+    // right away. Paths which cannot be resolved are ignored.
+    virtual void cacheSoundFileDurations(const std::vector<std::string>& vfsPaths) = 0;
+
     // Reloads all sound shader definitions from the VFS
     virtual void reloadSounds() = 0;
 
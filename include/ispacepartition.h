@@ -3,10 +3,12 @@
 
 #include <list>
 #include <vector>
+#include <cstdint>
 #include "imodule.h"
 
 // Forward declaration
 class AABB;
+class Frustum;
 
 namespace scene
 {
@@ -60,6 +62,13 @@ public:
 
 	// Get a list of members
 	virtual const MemberList& getMembers() const = 0;
+
+	// Tests the world bounds of each member against the given frustum. The result is
+	// stored in the order of getMembers(), members entirely outside get a 0 entry.
+	// Returns the number of members outside the frustum. The bounds are the ones
+	// recorded when the member was last linked, members with pending bounds changes
+	// are tested against their old bounds.
+	virtual std::size_t testMemberBounds(const Frustum& frustum, std::vector<std::uint8_t>& visibility) const = 0;
 };
 typedef std::shared_ptr<ISPNode> ISPNodePtr;
 
@@ -90,6 +99,10 @@ public:
 
 	// Returns the root node of this SP tree (the largest one, encompassing everything)
 	virtual ISPNodePtr getRoot() const = 0;
+
+	// Returns a number which changes each time a node is linked or unlinked.
+	// Data derived from the tree structure can compare it to detect changes.
+	virtual std::size_t getRevision() const = 0;
 };
 typedef std::shared_ptr<ISpacePartitionSystem> ISpacePartitionSystemPtr;
 
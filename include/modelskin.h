@@ -7,6 +7,9 @@
 class ModelSkin
 {
 public:
+	// Returned by getRemapId() if the skin doesn't remap the given material
+	static constexpr std::size_t NO_REMAP = static_cast<std::size_t>(-1);
+
     /**
 	 * Destructor
 	 */
@@ -23,6 +26,13 @@ public:
 	 * empty string.
 	 */
 	virtual std::string getRemap(const std::string& name) const = 0;
+
+	/**
+	 * Get the id of the mapped material for the given material id, both as
+	 * assigned by ModelSkinCache::getMaterialId(). This is a plain table lookup,
+	 * returns NO_REMAP if there is no mapping for the given material.
+	 */
+	virtual std::size_t getRemapId(std::size_t materialId) const = 0;
 };
 typedef std::shared_ptr<ModelSkin> ModelSkinPtr;
 
@@ -77,6 +87,18 @@ public:
 	 */
 	virtual const StringList& getAllSkins() = 0;
 
+	/**
+	 * Return the id of the given material name, as used by ModelSkin::getRemapId().
+	 * Ids are assigned on first request and stay valid for the whole session,
+	 * they are not invalidated by refresh().
+	 */
+	virtual std::size_t getMaterialId(const std::string& materialName) = 0;
+
+	/**
+	 * Return the material name belonging to the given id.
+	 */
+	virtual const std::string& getMaterialName(std::size_t materialId) = 0;
+
 	/**
 	 * greebo: Reloads all skins from the definition files.
 	 */
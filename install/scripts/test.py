@@ -313,3 +313,36 @@ group.foreachNode(gropWalker)
 camview = GlobalCameraManager.getActiveView()
 print(camview.getCameraOrigin())
 camview.setCameraOrigin(dr.Vector3(50,0,50))
+
+# Test the bulk accessors, which exchange whole arrays instead of single values
+brushes = []
+
+class BrushCollector(dr.SceneNodeVisitor) :
+	def pre(self, node):
+		if not node.getBrush().isNull():
+			brushes.append(node)
+		return 1
+
+GlobalSceneGraph.root().traverse(BrushCollector())
+
+# One row (normal x, y, z, dist) per face of all collected brushes
+planes = memoryview(GlobalBrushCreator.getFacePlanes(brushes)).tolist()
+print('Got ' + str(len(planes)) + ' face planes from ' + str(len(brushes)) + ' brushes')
+
+# Write the unchanged values back through a reversed view of a flat
+# buffer (negative stride), this is recorded as a single undo step
+import array
+reversedValues = array.array('d', [value for plane in planes for value in plane][::-1])
+GlobalBrushCreator.setFacePlanes(brushes, memoryview(reversedValues)[::-1])
+
+# Reading the planes again must yield the same values
+planesAfter = memoryview(GlobalBrushCreator.getFacePlanes(brushes)).tolist()
+mismatches = [i for i in range(len(planes)) if any(abs(a - b) > 0.0001 for a, b in zip(planes[i], planesAfter[i]))]
+
+if len(planesAfter) != len(planes) or len(mismatches) > 0:
+	print('Error: face planes changed in the round trip, ' + str(len(mismatches)) + ' mismatches')
+else:
+	print('Face planes survived the round trip')
+
+if not worldspawn.isNull():
+	print(worldspawn.getEntity().getKeyValueTable())
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace util
+{
+
+/**
+ * Invokes the given function for each index in [0..count), distributing the
+ * indices over a pool of worker threads (one per hardware thread).
+ *
+ * Indices are handed out dynamically, so uneven workloads balance themselves.
+ * The function must be safe to call concurrently for different indices.
+ * This call blocks until all indices have been processed; an exception thrown
+ * by the function is re-thrown to the caller after all workers finished.
+ */
+inline void parallelForEach(std::size_t count, const std::function<void(std::size_t)>& func)
+{
+    if (count == 0) return;
+
+    std::size_t numThreads = std::min<std::size_t>(
+        std::max(1u, std::thread::hardware_concurrency()), count);
+
+    // Run small workloads on the calling thread only
+    if (numThreads == 1)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            func(i);
+        }
+
+        return;
+    }
+
+    std::atomic<std::size_t> nextIndex(0);
+
+    auto worker = [&]()
+    {
+        for (std::size_t i = nextIndex++; i < count; i = nextIndex++)
+        {
+            func(i);
+        }
+    };
+
+    std::vector<std::future<void>> workers;
+    workers.reserve(numThreads - 1);
+
+    for (std::size_t i = 1; i < numThreads; ++i)
+    {
+        workers.emplace_back(std::async(std::launch::async, worker));
+    }
+
+    // The calling thread is taking part as well
+    std::exception_ptr exception;
+
+    try
+    {
+        worker();
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+
+    for (auto& future : workers)
+    {
+        try
+        {
+            future.get();
+        }
+        catch (...)
+        {
+            if (!exception) exception = std::current_exception();
+        }
+    }
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+}
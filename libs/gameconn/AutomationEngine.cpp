@@ -0,0 +1,143 @@
+#include "AutomationEngine.h"
+#include "MessageTcp.h"
+
+#include "itextstream.h"
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace gameconn
+{
+
+namespace
+{
+    //how long to sleep between polls when blocking on a response
+    const std::chrono::milliseconds WAIT_POLL_INTERVAL(1);
+
+    inline std::string seqnoPreamble(std::size_t seq) {
+        return "seqno " + std::to_string(seq) + "\n";
+    }
+}
+
+AutomationEngine::AutomationEngine() {}
+AutomationEngine::~AutomationEngine() {}
+
+void AutomationEngine::attach(std::unique_ptr<MessageTcp>&& connection) {
+    _inProgress.clear();
+    _connection = std::move(connection);
+}
+
+void AutomationEngine::detach() {
+    _inProgress.clear();
+    _connection.reset();
+}
+
+bool AutomationEngine::isAlive() const {
+    return _connection && _connection->isAlive();
+}
+
+std::size_t AutomationEngine::generateNewSequenceNumber() {
+    return ++_seqno;
+}
+
+std::size_t AutomationEngine::sendRequest(int tag, const std::string& request, const ResponseCallback& callback) {
+    if (!isAlive())
+        return 0;   //connection is down, drop all requests
+    auto seqno = generateNewSequenceNumber();
+    std::string fullMessage = seqnoPreamble(seqno) + request;
+    _connection->writeMessage(fullMessage.data(), static_cast<int>(fullMessage.size()));
+    _inProgress[seqno] = Request{ tag, callback };
+    return seqno;
+}
+
+bool AutomationEngine::isRequestFinished(std::size_t seqno) const {
+    return _inProgress.count(seqno) == 0;
+}
+
+bool AutomationEngine::isTagInProgress(int tag) const {
+    for (const auto& pair : _inProgress) {
+        if (pair.second.tag == tag)
+            return true;
+    }
+    return false;
+}
+
+std::size_t AutomationEngine::getNumRequestsInProgress() const {
+    return _inProgress.size();
+}
+
+void AutomationEngine::handleResponse(const std::vector<char>& message) {
+    //validate and remove preamble
+    int responseSeqno = 0, lineLen = 0;
+    int ret = sscanf(message.data(), "response %d\n%n", &responseSeqno, &lineLen);
+    if (ret != 1 || lineLen <= 0) {
+        rError() << "AutomationEngine: response without seqno preamble" << std::endl;
+        return;
+    }
+
+    auto iter = _inProgress.find(static_cast<std::size_t>(responseSeqno));
+    if (iter == _inProgress.end()) {
+        rWarning() << "AutomationEngine: unexpected response with seqno " << responseSeqno << std::endl;
+        return;
+    }
+
+    //mark request as finished before calling callback: it may send new requests
+    ResponseCallback callback = std::move(iter->second.callback);
+    _inProgress.erase(iter);
+
+    if (callback)
+        callback(std::string(message.begin() + lineLen, message.end()));
+}
+
+void AutomationEngine::think() {
+    if (!_connection)
+        return;
+
+    _connection->think();
+    //note: several responses can arrive at once when requests are pipelined
+    while (_connection->readMessage(_message))
+        handleResponse(_message);
+    _connection->think();
+
+    if (!_connection->isAlive()) {
+        //lost connection: nobody will answer requests in progress
+        _inProgress.clear();
+    }
+}
+
+void AutomationEngine::wait(std::size_t seqno) {
+    while (!isRequestFinished(seqno) && isAlive()) {
+        think();
+        if (!isRequestFinished(seqno))
+            std::this_thread::sleep_for(WAIT_POLL_INTERVAL);
+    }
+}
+
+void AutomationEngine::waitTag(int tag) {
+    while (isTagInProgress(tag) && isAlive()) {
+        think();
+        if (isTagInProgress(tag))
+            std::this_thread::sleep_for(WAIT_POLL_INTERVAL);
+    }
+}
+
+void AutomationEngine::waitAll() {
+    while (!_inProgress.empty() && isAlive()) {
+        think();
+        if (!_inProgress.empty())
+            std::this_thread::sleep_for(WAIT_POLL_INTERVAL);
+    }
+}
+
+std::string AutomationEngine::executeRequest(int tag, const std::string& request) {
+    std::string response;
+    auto seqno = sendRequest(tag, request, [&response](const std::string& text) {
+        response = text;
+    });
+    wait(seqno);
+    return response;
+}
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gameconn
+{
+
+class MessageTcp;
+
+/**
+ * Private for GameConnection class: do not use directly!
+ * Pipelined request channel on top of MessageTcp framing.
+ *
+ * Any number of requests can be in flight at the same time.
+ * Every request gets a unique seqno, and responses are matched against it when they arrive.
+ * Each request is also marked with a "tag" (small integer), which allows to check/wait
+ * whether any request of a certain kind (e.g. camera update) is still in progress.
+ *
+ * The engine does not know anything about sockets or wxWidgets:
+ * it is fed with connected MessageTcp, and must be pumped regularly by calling think().
+ * This makes it possible to run it against a loopback stand-in instead of the real game.
+ */
+class AutomationEngine
+{
+public:
+    //called from think() when response for a request arrives (response excludes seqno line)
+    typedef std::function<void(const std::string& response)> ResponseCallback;
+
+    AutomationEngine();
+    ~AutomationEngine();
+
+    //start working on top of the given (connected) framed channel
+    //all requests in progress from previous connection are dropped
+    void attach(std::unique_ptr<MessageTcp>&& connection);
+    //close connection and drop all requests in progress (callbacks are not called)
+    void detach();
+    //returns false if no connection is attached or if it has been closed for whatever reason
+    bool isAlive() const;
+
+    //prepend seqno to specified request and send it to game (non-blocking)
+    //callback (if set) is called from think() as soon as response arrives
+    //returns seqno of the request, or 0 if connection is dead
+    std::size_t sendRequest(int tag, const std::string& request, const ResponseCallback& callback = ResponseCallback());
+
+    //returns true if response for request with given seqno has already arrived
+    //note: unknown seqno (e.g. dropped) counts as finished
+    bool isRequestFinished(std::size_t seqno) const;
+    //returns true if there is at least one request with given tag in progress
+    bool isTagInProgress(int tag) const;
+    //returns number of requests sent and not yet responded
+    std::size_t getNumRequestsInProgress() const;
+
+    //check how socket is doing, accept all available responses and dispatch their callbacks
+    //this should be done regularly
+    void think();
+    //block until request with specified seqno is finished (or connection is lost)
+    void wait(std::size_t seqno);
+    //block until all requests with specified tag are finished (or connection is lost)
+    void waitTag(int tag);
+    //block until all requests in progress are finished (or connection is lost)
+    void waitAll();
+
+    //send given request and wait until its completion (blocking)
+    //returns response content
+    std::string executeRequest(int tag, const std::string& request);
+
+private:
+    struct Request
+    {
+        int tag;
+        ResponseCallback callback;
+    };
+
+    //every request should get unique seqno, otherwise we won't be able to distinguish their responses
+    std::size_t generateNewSequenceNumber();
+    //handle one raw message received from the game
+    void handleResponse(const std::vector<char>& message);
+
+    //framed connection to the game (null if detached)
+    std::unique_ptr<MessageTcp> _connection;
+    //sequence number of the last sent request (incremented sequentally)
+    std::size_t _seqno = 0;
+    //all requests sent and not yet responded, by seqno
+    std::map<std::size_t, Request> _inProgress;
+    //temporary buffer for incoming messages
+    std::vector<char> _message;
+};
+
+}
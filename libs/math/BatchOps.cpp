@@ -0,0 +1,586 @@
+#include "BatchOps.h"
+
+#include <cmath>
+#include <cfloat>
+#include <initializer_list>
+
+#include "Matrix4.h"
+#include "Plane3.h"
+#include "AABB.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BATCHOPS_SSE2
+#endif
+
+// The AVX kernels are compiled for AVX regardless of the compiler settings,
+// they're only called if the CPU supports it
+#if defined(BATCHOPS_SSE2) && (defined(_MSC_VER) || defined(__GNUC__))
+#include <immintrin.h>
+#define BATCHOPS_AVX
+#ifdef _MSC_VER
+#include <intrin.h>
+#define BATCHOPS_TARGET_AVX
+#else
+#define BATCHOPS_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+namespace math
+{
+
+namespace
+{
+
+// Returns the address of the element with the given index in a strided array
+inline double* elementAt(char* base, std::size_t stride, std::size_t index)
+{
+	return reinterpret_cast<double*>(base + stride * index);
+}
+
+inline const double* elementAt(const char* base, std::size_t stride, std::size_t index)
+{
+	return reinterpret_cast<const double*>(base + stride * index);
+}
+
+// Scalar implementations, used for the remainder of the SIMD loops too
+
+void transformPointsScalar(const Matrix4& m, char* base, std::size_t count, std::size_t stride)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		Vector3& point = *reinterpret_cast<Vector3*>(elementAt(base, stride, i));
+		point = m.transformPoint(point);
+	}
+}
+
+void transformPlanesScalar(const Matrix4& m, Plane3* planes, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		planes[i].transform(m);
+	}
+}
+
+void transformAABBsScalar(const Matrix4& m, AABB* boxes, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		boxes[i] = AABB::createFromOrientedAABBSafe(boxes[i], m);
+	}
+}
+
+void getPlaneDistancesScalar(const Plane3& plane, const char* base, std::size_t count,
+	double* distances, std::size_t stride)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		distances[i] = plane.distanceToPoint(*reinterpret_cast<const Vector3*>(elementAt(base, stride, i)));
+	}
+}
+
+#ifdef BATCHOPS_SSE2
+
+// The SIMD kernels evaluate the expressions in the same order as the
+// scalar methods, to produce exactly the same results
+
+inline __m128d load2(const double* a, const double* b)
+{
+	return _mm_loadh_pd(_mm_load_sd(a), b);
+}
+
+inline void store2(__m128d v, double* a, double* b)
+{
+	_mm_storel_pd(a, v);
+	_mm_storeh_pd(b, v);
+}
+
+// a*x + b*y + c*z
+inline __m128d dot2(__m128d a, __m128d x, __m128d b, __m128d y, __m128d c, __m128d z)
+{
+	return _mm_add_pd(_mm_add_pd(_mm_mul_pd(a, x), _mm_mul_pd(b, y)), _mm_mul_pd(c, z));
+}
+
+inline __m128d abs2(__m128d v)
+{
+	return _mm_andnot_pd(_mm_set1_pd(-0.0), v);
+}
+
+void transformPointsSSE2(const Matrix4& m, char* base, std::size_t count, std::size_t stride)
+{
+	const __m128d xx = _mm_set1_pd(m.xx()), xy = _mm_set1_pd(m.xy()), xz = _mm_set1_pd(m.xz());
+	const __m128d yx = _mm_set1_pd(m.yx()), yy = _mm_set1_pd(m.yy()), yz = _mm_set1_pd(m.yz());
+	const __m128d zx = _mm_set1_pd(m.zx()), zy = _mm_set1_pd(m.zy()), zz = _mm_set1_pd(m.zz());
+	const __m128d tx = _mm_set1_pd(m.tx()), ty = _mm_set1_pd(m.ty()), tz = _mm_set1_pd(m.tz());
+
+	std::size_t i = 0;
+
+	for (; i + 2 <= count; i += 2)
+	{
+		double* p0 = elementAt(base, stride, i);
+		double* p1 = elementAt(base, stride, i + 1);
+
+		__m128d x = load2(p0, p1);
+		__m128d y = load2(p0 + 1, p1 + 1);
+		__m128d z = load2(p0 + 2, p1 + 2);
+
+		store2(_mm_add_pd(dot2(xx, x, yx, y, zx, z), tx), p0, p1);
+		store2(_mm_add_pd(dot2(xy, x, yy, y, zy, z), ty), p0 + 1, p1 + 1);
+		store2(_mm_add_pd(dot2(xz, x, yz, y, zz, z), tz), p0 + 2, p1 + 2);
+	}
+
+	transformPointsScalar(m, base + stride * i, count - i, stride);
+}
+
+void transformPlanesSSE2(const Matrix4& m, Plane3* planes, std::size_t count)
+{
+	const __m128d xx = _mm_set1_pd(m.xx()), xy = _mm_set1_pd(m.xy()), xz = _mm_set1_pd(m.xz());
+	const __m128d yx = _mm_set1_pd(m.yx()), yy = _mm_set1_pd(m.yy()), yz = _mm_set1_pd(m.yz());
+	const __m128d zx = _mm_set1_pd(m.zx()), zy = _mm_set1_pd(m.zy()), zz = _mm_set1_pd(m.zz());
+	const __m128d tx = _mm_set1_pd(m.tx()), ty = _mm_set1_pd(m.ty()), tz = _mm_set1_pd(m.tz());
+
+	std::size_t i = 0;
+
+	for (; i + 2 <= count; i += 2)
+	{
+		double* n0 = &planes[i].normal().x();
+		double* n1 = &planes[i + 1].normal().x();
+
+		__m128d x = load2(n0, n1);
+		__m128d y = load2(n0 + 1, n1 + 1);
+		__m128d z = load2(n0 + 2, n1 + 2);
+		__m128d dist = load2(&planes[i].dist(), &planes[i + 1].dist());
+
+		__m128d nx = dot2(xx, x, yx, y, zx, z);
+		__m128d ny = dot2(xy, x, yy, y, zy, z);
+		__m128d nz = dot2(xz, x, yz, y, zz, z);
+
+		__m128d newDist = _mm_add_pd(_mm_add_pd(
+			_mm_mul_pd(nx, _mm_sub_pd(_mm_mul_pd(dist, nx), tx)),
+			_mm_mul_pd(ny, _mm_sub_pd(_mm_mul_pd(dist, ny), ty))),
+			_mm_mul_pd(nz, _mm_sub_pd(_mm_mul_pd(dist, nz), tz)));
+
+		store2(nx, n0, n1);
+		store2(ny, n0 + 1, n1 + 1);
+		store2(nz, n0 + 2, n1 + 2);
+		store2(newDist, &planes[i].dist(), &planes[i + 1].dist());
+	}
+
+	transformPlanesScalar(m, planes + i, count - i);
+}
+
+void transformAABBsSSE2(const Matrix4& m, AABB* boxes, std::size_t count)
+{
+	const __m128d xx = _mm_set1_pd(m.xx()), xy = _mm_set1_pd(m.xy()), xz = _mm_set1_pd(m.xz());
+	const __m128d yx = _mm_set1_pd(m.yx()), yy = _mm_set1_pd(m.yy()), yz = _mm_set1_pd(m.yz());
+	const __m128d zx = _mm_set1_pd(m.zx()), zy = _mm_set1_pd(m.zy()), zz = _mm_set1_pd(m.zz());
+	const __m128d tx = _mm_set1_pd(m.tx()), ty = _mm_set1_pd(m.ty()), tz = _mm_set1_pd(m.tz());
+
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d max = _mm_set1_pd(FLT_MAX);
+	const __m128d min = _mm_set1_pd(-FLT_MAX);
+
+	std::size_t i = 0;
+
+	for (; i + 2 <= count; i += 2)
+	{
+		double* o0 = &boxes[i].origin.x();
+		double* o1 = &boxes[i + 1].origin.x();
+		double* e0 = &boxes[i].extents.x();
+		double* e1 = &boxes[i + 1].extents.x();
+
+		__m128d ox = load2(o0, o1), oy = load2(o0 + 1, o1 + 1), oz = load2(o0 + 2, o1 + 2);
+		__m128d ex = load2(e0, e1), ey = load2(e0 + 1, e1 + 1), ez = load2(e0 + 2, e1 + 2);
+
+		// Same conditions as AABB::isValid(), invalid boxes keep their values
+		__m128d invalid = _mm_setzero_pd();
+
+		for (__m128d o : { ox, oy, oz })
+		{
+			invalid = _mm_or_pd(invalid, _mm_or_pd(_mm_cmplt_pd(o, min), _mm_cmpgt_pd(o, max)));
+		}
+
+		for (__m128d e : { ex, ey, ez })
+		{
+			invalid = _mm_or_pd(invalid, _mm_or_pd(_mm_cmplt_pd(e, zero), _mm_cmpgt_pd(e, max)));
+		}
+
+		auto select = [&](__m128d value, __m128d original)
+		{
+			return _mm_or_pd(_mm_and_pd(invalid, original), _mm_andnot_pd(invalid, value));
+		};
+
+		__m128d newOx = _mm_add_pd(dot2(xx, ox, yx, oy, zx, oz), tx);
+		__m128d newOy = _mm_add_pd(dot2(xy, ox, yy, oy, zy, oz), ty);
+		__m128d newOz = _mm_add_pd(dot2(xz, ox, yz, oy, zz, oz), tz);
+
+		__m128d newEx = _mm_add_pd(_mm_add_pd(abs2(_mm_mul_pd(xx, ex)), abs2(_mm_mul_pd(yx, ey))), abs2(_mm_mul_pd(zx, ez)));
+		__m128d newEy = _mm_add_pd(_mm_add_pd(abs2(_mm_mul_pd(xy, ex)), abs2(_mm_mul_pd(yy, ey))), abs2(_mm_mul_pd(zy, ez)));
+		__m128d newEz = _mm_add_pd(_mm_add_pd(abs2(_mm_mul_pd(xz, ex)), abs2(_mm_mul_pd(yz, ey))), abs2(_mm_mul_pd(zz, ez)));
+
+		store2(select(newOx, ox), o0, o1);
+		store2(select(newOy, oy), o0 + 1, o1 + 1);
+		store2(select(newOz, oz), o0 + 2, o1 + 2);
+		store2(select(newEx, ex), e0, e1);
+		store2(select(newEy, ey), e0 + 1, e1 + 1);
+		store2(select(newEz, ez), e0 + 2, e1 + 2);
+	}
+
+	transformAABBsScalar(m, boxes + i, count - i);
+}
+
+void getPlaneDistancesSSE2(const Plane3& plane, const char* base, std::size_t count,
+	double* distances, std::size_t stride)
+{
+	const __m128d nx = _mm_set1_pd(plane.normal().x());
+	const __m128d ny = _mm_set1_pd(plane.normal().y());
+	const __m128d nz = _mm_set1_pd(plane.normal().z());
+	const __m128d dist = _mm_set1_pd(plane.dist());
+
+	std::size_t i = 0;
+
+	for (; i + 2 <= count; i += 2)
+	{
+		const double* p0 = elementAt(base, stride, i);
+		const double* p1 = elementAt(base, stride, i + 1);
+
+		__m128d x = load2(p0, p1);
+		__m128d y = load2(p0 + 1, p1 + 1);
+		__m128d z = load2(p0 + 2, p1 + 2);
+
+		_mm_storeu_pd(distances + i, _mm_sub_pd(dot2(x, nx, y, ny, z, nz), dist));
+	}
+
+	getPlaneDistancesScalar(plane, base + stride * i, count - i, distances + i, stride);
+}
+
+#endif
+
+#ifdef BATCHOPS_AVX
+
+BATCHOPS_TARGET_AVX inline __m256d load4(const double* a, const double* b, const double* c, const double* d)
+{
+	return _mm256_insertf128_pd(_mm256_castpd128_pd256(load2(a, b)), load2(c, d), 1);
+}
+
+BATCHOPS_TARGET_AVX inline void store4(__m256d v, double* a, double* b, double* c, double* d)
+{
+	store2(_mm256_castpd256_pd128(v), a, b);
+	store2(_mm256_extractf128_pd(v, 1), c, d);
+}
+
+// a*x + b*y + c*z
+BATCHOPS_TARGET_AVX inline __m256d dot4(__m256d a, __m256d x, __m256d b, __m256d y, __m256d c, __m256d z)
+{
+	return _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a, x), _mm256_mul_pd(b, y)), _mm256_mul_pd(c, z));
+}
+
+BATCHOPS_TARGET_AVX inline __m256d abs4(__m256d v)
+{
+	return _mm256_andnot_pd(_mm256_set1_pd(-0.0), v);
+}
+
+BATCHOPS_TARGET_AVX void transformPointsAVX(const Matrix4& m, char* base, std::size_t count, std::size_t stride)
+{
+	const __m256d xx = _mm256_set1_pd(m.xx()), xy = _mm256_set1_pd(m.xy()), xz = _mm256_set1_pd(m.xz());
+	const __m256d yx = _mm256_set1_pd(m.yx()), yy = _mm256_set1_pd(m.yy()), yz = _mm256_set1_pd(m.yz());
+	const __m256d zx = _mm256_set1_pd(m.zx()), zy = _mm256_set1_pd(m.zy()), zz = _mm256_set1_pd(m.zz());
+	const __m256d tx = _mm256_set1_pd(m.tx()), ty = _mm256_set1_pd(m.ty()), tz = _mm256_set1_pd(m.tz());
+
+	std::size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		double* p0 = elementAt(base, stride, i);
+		double* p1 = elementAt(base, stride, i + 1);
+		double* p2 = elementAt(base, stride, i + 2);
+		double* p3 = elementAt(base, stride, i + 3);
+
+		__m256d x = load4(p0, p1, p2, p3);
+		__m256d y = load4(p0 + 1, p1 + 1, p2 + 1, p3 + 1);
+		__m256d z = load4(p0 + 2, p1 + 2, p2 + 2, p3 + 2);
+
+		store4(_mm256_add_pd(dot4(xx, x, yx, y, zx, z), tx), p0, p1, p2, p3);
+		store4(_mm256_add_pd(dot4(xy, x, yy, y, zy, z), ty), p0 + 1, p1 + 1, p2 + 1, p3 + 1);
+		store4(_mm256_add_pd(dot4(xz, x, yz, y, zz, z), tz), p0 + 2, p1 + 2, p2 + 2, p3 + 2);
+	}
+
+	transformPointsScalar(m, base + stride * i, count - i, stride);
+}
+
+BATCHOPS_TARGET_AVX void transformPlanesAVX(const Matrix4& m, Plane3* planes, std::size_t count)
+{
+	const __m256d xx = _mm256_set1_pd(m.xx()), xy = _mm256_set1_pd(m.xy()), xz = _mm256_set1_pd(m.xz());
+	const __m256d yx = _mm256_set1_pd(m.yx()), yy = _mm256_set1_pd(m.yy()), yz = _mm256_set1_pd(m.yz());
+	const __m256d zx = _mm256_set1_pd(m.zx()), zy = _mm256_set1_pd(m.zy()), zz = _mm256_set1_pd(m.zz());
+	const __m256d tx = _mm256_set1_pd(m.tx()), ty = _mm256_set1_pd(m.ty()), tz = _mm256_set1_pd(m.tz());
+
+	std::size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		double* n0 = &planes[i].normal().x();
+		double* n1 = &planes[i + 1].normal().x();
+		double* n2 = &planes[i + 2].normal().x();
+		double* n3 = &planes[i + 3].normal().x();
+		double* d0 = &planes[i].dist();
+		double* d1 = &planes[i + 1].dist();
+		double* d2 = &planes[i + 2].dist();
+		double* d3 = &planes[i + 3].dist();
+
+		__m256d x = load4(n0, n1, n2, n3);
+		__m256d y = load4(n0 + 1, n1 + 1, n2 + 1, n3 + 1);
+		__m256d z = load4(n0 + 2, n1 + 2, n2 + 2, n3 + 2);
+		__m256d dist = load4(d0, d1, d2, d3);
+
+		__m256d nx = dot4(xx, x, yx, y, zx, z);
+		__m256d ny = dot4(xy, x, yy, y, zy, z);
+		__m256d nz = dot4(xz, x, yz, y, zz, z);
+
+		__m256d newDist = _mm256_add_pd(_mm256_add_pd(
+			_mm256_mul_pd(nx, _mm256_sub_pd(_mm256_mul_pd(dist, nx), tx)),
+			_mm256_mul_pd(ny, _mm256_sub_pd(_mm256_mul_pd(dist, ny), ty))),
+			_mm256_mul_pd(nz, _mm256_sub_pd(_mm256_mul_pd(dist, nz), tz)));
+
+		store4(nx, n0, n1, n2, n3);
+		store4(ny, n0 + 1, n1 + 1, n2 + 1, n3 + 1);
+		store4(nz, n0 + 2, n1 + 2, n2 + 2, n3 + 2);
+		store4(newDist, d0, d1, d2, d3);
+	}
+
+	transformPlanesScalar(m, planes + i, count - i);
+}
+
+BATCHOPS_TARGET_AVX void transformAABBsAVX(const Matrix4& m, AABB* boxes, std::size_t count)
+{
+	const __m256d xx = _mm256_set1_pd(m.xx()), xy = _mm256_set1_pd(m.xy()), xz = _mm256_set1_pd(m.xz());
+	const __m256d yx = _mm256_set1_pd(m.yx()), yy = _mm256_set1_pd(m.yy()), yz = _mm256_set1_pd(m.yz());
+	const __m256d zx = _mm256_set1_pd(m.zx()), zy = _mm256_set1_pd(m.zy()), zz = _mm256_set1_pd(m.zz());
+	const __m256d tx = _mm256_set1_pd(m.tx()), ty = _mm256_set1_pd(m.ty()), tz = _mm256_set1_pd(m.tz());
+
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d max = _mm256_set1_pd(FLT_MAX);
+	const __m256d min = _mm256_set1_pd(-FLT_MAX);
+
+	std::size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		double* o[4];
+		double* e[4];
+
+		for (std::size_t j = 0; j < 4; ++j)
+		{
+			o[j] = &boxes[i + j].origin.x();
+			e[j] = &boxes[i + j].extents.x();
+		}
+
+		__m256d ox = load4(o[0], o[1], o[2], o[3]);
+		__m256d oy = load4(o[0] + 1, o[1] + 1, o[2] + 1, o[3] + 1);
+		__m256d oz = load4(o[0] + 2, o[1] + 2, o[2] + 2, o[3] + 2);
+		__m256d ex = load4(e[0], e[1], e[2], e[3]);
+		__m256d ey = load4(e[0] + 1, e[1] + 1, e[2] + 1, e[3] + 1);
+		__m256d ez = load4(e[0] + 2, e[1] + 2, e[2] + 2, e[3] + 2);
+
+		// Same conditions as AABB::isValid(), invalid boxes keep their values
+		__m256d invalid = _mm256_setzero_pd();
+
+		for (__m256d v : { ox, oy, oz })
+		{
+			invalid = _mm256_or_pd(invalid, _mm256_or_pd(
+				_mm256_cmp_pd(v, min, _CMP_LT_OQ), _mm256_cmp_pd(v, max, _CMP_GT_OQ)));
+		}
+
+		for (__m256d v : { ex, ey, ez })
+		{
+			invalid = _mm256_or_pd(invalid, _mm256_or_pd(
+				_mm256_cmp_pd(v, zero, _CMP_LT_OQ), _mm256_cmp_pd(v, max, _CMP_GT_OQ)));
+		}
+
+		__m256d newOx = _mm256_add_pd(dot4(xx, ox, yx, oy, zx, oz), tx);
+		__m256d newOy = _mm256_add_pd(dot4(xy, ox, yy, oy, zy, oz), ty);
+		__m256d newOz = _mm256_add_pd(dot4(xz, ox, yz, oy, zz, oz), tz);
+
+		__m256d newEx = _mm256_add_pd(_mm256_add_pd(abs4(_mm256_mul_pd(xx, ex)), abs4(_mm256_mul_pd(yx, ey))), abs4(_mm256_mul_pd(zx, ez)));
+		__m256d newEy = _mm256_add_pd(_mm256_add_pd(abs4(_mm256_mul_pd(xy, ex)), abs4(_mm256_mul_pd(yy, ey))), abs4(_mm256_mul_pd(zy, ez)));
+		__m256d newEz = _mm256_add_pd(_mm256_add_pd(abs4(_mm256_mul_pd(xz, ex)), abs4(_mm256_mul_pd(yz, ey))), abs4(_mm256_mul_pd(zz, ez)));
+
+		store4(_mm256_blendv_pd(newOx, ox, invalid), o[0], o[1], o[2], o[3]);
+		store4(_mm256_blendv_pd(newOy, oy, invalid), o[0] + 1, o[1] + 1, o[2] + 1, o[3] + 1);
+		store4(_mm256_blendv_pd(newOz, oz, invalid), o[0] + 2, o[1] + 2, o[2] + 2, o[3] + 2);
+		store4(_mm256_blendv_pd(newEx, ex, invalid), e[0], e[1], e[2], e[3]);
+		store4(_mm256_blendv_pd(newEy, ey, invalid), e[0] + 1, e[1] + 1, e[2] + 1, e[3] + 1);
+		store4(_mm256_blendv_pd(newEz, ez, invalid), e[0] + 2, e[1] + 2, e[2] + 2, e[3] + 2);
+	}
+
+	transformAABBsScalar(m, boxes + i, count - i);
+}
+
+BATCHOPS_TARGET_AVX void getPlaneDistancesAVX(const Plane3& plane, const char* base, std::size_t count,
+	double* distances, std::size_t stride)
+{
+	const __m256d nx = _mm256_set1_pd(plane.normal().x());
+	const __m256d ny = _mm256_set1_pd(plane.normal().y());
+	const __m256d nz = _mm256_set1_pd(plane.normal().z());
+	const __m256d dist = _mm256_set1_pd(plane.dist());
+
+	std::size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		const double* p0 = elementAt(base, stride, i);
+		const double* p1 = elementAt(base, stride, i + 1);
+		const double* p2 = elementAt(base, stride, i + 2);
+		const double* p3 = elementAt(base, stride, i + 3);
+
+		__m256d x = load4(p0, p1, p2, p3);
+		__m256d y = load4(p0 + 1, p1 + 1, p2 + 1, p3 + 1);
+		__m256d z = load4(p0 + 2, p1 + 2, p2 + 2, p3 + 2);
+
+		_mm256_storeu_pd(distances + i, _mm256_sub_pd(dot4(x, nx, y, ny, z, nz), dist));
+	}
+
+	getPlaneDistancesScalar(plane, base + stride * i, count - i, distances + i, stride);
+}
+
+bool cpuSupportsAVX()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+
+	// The OS needs to save the AVX registers on context switches too
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+
+	return osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx") != 0;
+#endif
+}
+
+#endif
+
+InstructionSet getBestInstructionSet()
+{
+#ifdef BATCHOPS_AVX
+	if (cpuSupportsAVX())
+	{
+		return InstructionSet::AVX;
+	}
+#endif
+
+#ifdef BATCHOPS_SSE2
+	return InstructionSet::SSE2;
+#else
+	return InstructionSet::Scalar;
+#endif
+}
+
+InstructionSet& activeInstructionSet()
+{
+	static InstructionSet set = getBestInstructionSet();
+	return set;
+}
+
+}
+
+bool isInstructionSetSupported(InstructionSet set)
+{
+	return set <= getBestInstructionSet();
+}
+
+InstructionSet getInstructionSet()
+{
+	return activeInstructionSet();
+}
+
+void setInstructionSet(InstructionSet set)
+{
+	InstructionSet best = getBestInstructionSet();
+	activeInstructionSet() = set <= best ? set : best;
+}
+
+void transformPoints(const Matrix4& matrix, Vector3* points, std::size_t count, std::size_t stride)
+{
+	char* base = reinterpret_cast<char*>(points);
+
+	switch (activeInstructionSet())
+	{
+#ifdef BATCHOPS_AVX
+	case InstructionSet::AVX:
+		transformPointsAVX(matrix, base, count, stride);
+		return;
+#endif
+#ifdef BATCHOPS_SSE2
+	case InstructionSet::SSE2:
+		transformPointsSSE2(matrix, base, count, stride);
+		return;
+#endif
+	default:
+		transformPointsScalar(matrix, base, count, stride);
+	}
+}
+
+void transformPlanes(const Matrix4& matrix, Plane3* planes, std::size_t count)
+{
+	switch (activeInstructionSet())
+	{
+#ifdef BATCHOPS_AVX
+	case InstructionSet::AVX:
+		transformPlanesAVX(matrix, planes, count);
+		return;
+#endif
+#ifdef BATCHOPS_SSE2
+	case InstructionSet::SSE2:
+		transformPlanesSSE2(matrix, planes, count);
+		return;
+#endif
+	default:
+		transformPlanesScalar(matrix, planes, count);
+	}
+}
+
+void transformAABBs(const Matrix4& matrix, AABB* boxes, std::size_t count)
+{
+	switch (activeInstructionSet())
+	{
+#ifdef BATCHOPS_AVX
+	case InstructionSet::AVX:
+		transformAABBsAVX(matrix, boxes, count);
+		return;
+#endif
+#ifdef BATCHOPS_SSE2
+	case InstructionSet::SSE2:
+		transformAABBsSSE2(matrix, boxes, count);
+		return;
+#endif
+	default:
+		transformAABBsScalar(matrix, boxes, count);
+	}
+}
+
+void getPlaneDistances(const Plane3& plane, const Vector3* points, std::size_t count,
+	double* distances, std::size_t stride)
+{
+	const char* base = reinterpret_cast<const char*>(points);
+
+	switch (activeInstructionSet())
+	{
+#ifdef BATCHOPS_AVX
+	case InstructionSet::AVX:
+		getPlaneDistancesAVX(plane, base, count, distances, stride);
+		return;
+#endif
+#ifdef BATCHOPS_SSE2
+	case InstructionSet::SSE2:
+		getPlaneDistancesSSE2(plane, base, count, distances, stride);
+		return;
+#endif
+	default:
+		getPlaneDistancesScalar(plane, base, count, distances, stride);
+	}
+}
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+/// \file
+/// \brief Operations applying the same matrix or plane to many elements at once.
+
+#include <cstddef>
+
+#include "math/Vector3.h"
+
+class Matrix4;
+class Plane3;
+class AABB;
+
+/**
+ * \brief
+ * Batch versions of the per-element math operations, producing the same
+ * results as calling the named per-element method on each element.
+ *
+ * The elements are processed in groups of two (SSE2) or four (AVX), the
+ * coordinates of each group being rearranged into one register per axis.
+ * The fastest instruction set supported by the CPU is picked at runtime.
+ *
+ * Point arrays take a stride (in bytes) to allow for processing points
+ * embedded in larger structures, like the vertex of a PatchControl.
+ */
+namespace math
+{
+
+enum class InstructionSet
+{
+	Scalar,
+	SSE2,
+	AVX,
+};
+
+/// Returns true if the given instruction set can be used on this machine
+bool isInstructionSetSupported(InstructionSet set);
+
+/// Returns the instruction set used by the batch operations
+InstructionSet getInstructionSet();
+
+/// Use the given instruction set for all subsequent batch operations (for
+/// testing and benchmarking). Unsupported sets are replaced by the best
+/// supported one below them.
+void setInstructionSet(InstructionSet set);
+
+/// Transforms the points in place, like Matrix4::transformPoint()
+void transformPoints(const Matrix4& matrix, Vector3* points, std::size_t count,
+	std::size_t stride = sizeof(Vector3));
+
+/// Transforms the planes in place, like Plane3::transform()
+void transformPlanes(const Matrix4& matrix, Plane3* planes, std::size_t count);
+
+/// Replaces the boxes by the axis-aligned bounds of the transformed boxes,
+/// like AABB::createFromOrientedAABBSafe() (invalid boxes are left untouched)
+void transformAABBs(const Matrix4& matrix, AABB* boxes, std::size_t count);
+
+/// Writes the signed distance of each point to the plane into distances,
+/// like Plane3::distanceToPoint()
+void getPlaneDistances(const Plane3& plane, const Vector3* points, std::size_t count,
+	double* distances, std::size_t stride = sizeof(Vector3));
+
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+/// \file
+/// \brief Single precision AABB storage for testing many boxes at once.
+
+#include <vector>
+#include <cfloat>
+#include <cstdint>
+
+#include "math/AABB.h"
+#include "math/Frustum.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define PACKED_AABBS_SSE
+#endif
+
+/**
+ * \brief
+ * A list of axis-aligned bounding boxes, stored as separate arrays of
+ * single precision min/max coordinates ("structure of arrays").
+ *
+ * This layout allows the frustum test to process four boxes at once.
+ * Invalid boxes are stored as infinitely large ones, they're never culled.
+ */
+class PackedAABBs
+{
+private:
+	std::vector<float> _minX, _minY, _minZ;
+	std::vector<float> _maxX, _maxY, _maxZ;
+
+public:
+	/// Boxes closer than this to the outside of a frustum plane are still
+	/// considered visible, this is covering the rounding errors of the float
+	/// arithmetic for coordinates within the map limits.
+	static constexpr float PLANE_TOLERANCE = 1.0f;
+
+	std::size_t size() const
+	{
+		return _minX.size();
+	}
+
+	bool empty() const
+	{
+		return _minX.empty();
+	}
+
+	void push_back(const AABB& aabb)
+	{
+		if (!aabb.isValid())
+		{
+			appendBox(-FLT_MAX, -FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX);
+			return;
+		}
+
+		Vector3 min = aabb.origin - aabb.extents;
+		Vector3 max = aabb.origin + aabb.extents;
+
+		appendBox(static_cast<float>(min.x()), static_cast<float>(min.y()), static_cast<float>(min.z()),
+			static_cast<float>(max.x()), static_cast<float>(max.y()), static_cast<float>(max.z()));
+	}
+
+	/// Removes the box at the given index, the following boxes move up by one
+	void erase(std::size_t index)
+	{
+		for (auto* values : { &_minX, &_minY, &_minZ, &_maxX, &_maxY, &_maxZ })
+		{
+			values->erase(values->begin() + index);
+		}
+	}
+
+	/// Appends all boxes of the other list to this one
+	void append(const PackedAABBs& other)
+	{
+		_minX.insert(_minX.end(), other._minX.begin(), other._minX.end());
+		_minY.insert(_minY.end(), other._minY.begin(), other._minY.end());
+		_minZ.insert(_minZ.end(), other._minZ.begin(), other._minZ.end());
+		_maxX.insert(_maxX.end(), other._maxX.begin(), other._maxX.end());
+		_maxY.insert(_maxY.end(), other._maxY.begin(), other._maxY.end());
+		_maxZ.insert(_maxZ.end(), other._maxZ.begin(), other._maxZ.end());
+	}
+
+	void clear()
+	{
+		for (auto* values : { &_minX, &_minY, &_minZ, &_maxX, &_maxY, &_maxZ })
+		{
+			values->clear();
+		}
+	}
+
+	/**
+	 * \brief
+	 * Tests all boxes against the planes of the given frustum.
+	 *
+	 * Sets visibility[i] to 0 if the i-th box is entirely outside the frustum,
+	 * and to 1 if it is (partially) inside. Returns the number of boxes outside.
+	 * In contrast to Frustum::testIntersection() no distinction is made between
+	 * boxes entirely or partially inside.
+	 */
+	std::size_t testFrustum(const Frustum& frustum, std::vector<std::uint8_t>& visibility) const
+	{
+		std::size_t count = size();
+		visibility.resize(count);
+
+		// For each plane, only the box corner furthest along the plane normal
+		// needs to be checked, pick the matching coordinate arrays
+		struct PackedPlane
+		{
+			float normal[3];
+			float threshold;
+			const float* coords[3];
+		};
+
+		PackedPlane planes[6];
+		const Plane3* source[6] = {
+			&frustum.right, &frustum.left, &frustum.bottom,
+			&frustum.top, &frustum.back, &frustum.front
+		};
+
+		for (std::size_t p = 0; p < 6; ++p)
+		{
+			const Vector3& normal = source[p]->normal();
+
+			planes[p].normal[0] = static_cast<float>(normal.x());
+			planes[p].normal[1] = static_cast<float>(normal.y());
+			planes[p].normal[2] = static_cast<float>(normal.z());
+			planes[p].threshold = static_cast<float>(source[p]->dist()) - PLANE_TOLERANCE;
+			planes[p].coords[0] = normal.x() >= 0 ? _maxX.data() : _minX.data();
+			planes[p].coords[1] = normal.y() >= 0 ? _maxY.data() : _minY.data();
+			planes[p].coords[2] = normal.z() >= 0 ? _maxZ.data() : _minZ.data();
+		}
+
+		std::size_t numOutside = 0;
+		std::size_t i = 0;
+
+#ifdef PACKED_AABBS_SSE
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 outside = _mm_setzero_ps();
+
+			for (const auto& plane : planes)
+			{
+				__m128 dot = _mm_mul_ps(_mm_set1_ps(plane.normal[0]), _mm_loadu_ps(plane.coords[0] + i));
+				dot = _mm_add_ps(dot, _mm_mul_ps(_mm_set1_ps(plane.normal[1]), _mm_loadu_ps(plane.coords[1] + i)));
+				dot = _mm_add_ps(dot, _mm_mul_ps(_mm_set1_ps(plane.normal[2]), _mm_loadu_ps(plane.coords[2] + i)));
+
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(dot, _mm_set1_ps(plane.threshold)));
+			}
+
+			int mask = _mm_movemask_ps(outside);
+
+			for (std::size_t j = 0; j < 4; ++j)
+			{
+				bool isOutside = (mask & (1 << j)) != 0;
+
+				visibility[i + j] = isOutside ? 0 : 1;
+				numOutside += isOutside ? 1 : 0;
+			}
+		}
+#endif
+
+		// Remaining boxes (or all of them without SSE)
+		for (; i < count; ++i)
+		{
+			bool isOutside = false;
+
+			for (const auto& plane : planes)
+			{
+				float dot = plane.normal[0] * plane.coords[0][i] +
+					plane.normal[1] * plane.coords[1][i] +
+					plane.normal[2] * plane.coords[2][i];
+
+				isOutside |= dot < plane.threshold;
+			}
+
+			visibility[i] = isOutside ? 0 : 1;
+			numOutside += isOutside ? 1 : 0;
+		}
+
+		return numOutside;
+	}
+
+private:
+	void appendBox(float minX, float minY, float minZ, float maxX, float maxY, float maxZ)
+	{
+		_minX.push_back(minX);
+		_minY.push_back(minY);
+		_minZ.push_back(minZ);
+		_maxX.push_back(maxX);
+		_maxY.push_back(maxY);
+		_maxZ.push_back(maxZ);
+	}
+};
@@ -43,6 +43,7 @@ namespace fs = boost::filesystem;
 
 #endif
 
+#include <cstdint>
 #include "string/predicate.h"
 
 namespace os
@@ -94,6 +95,17 @@ namespace os
 #endif
 	}
 
+	// Returns the last modification time of the given file as integer in the resolution
+	// of the filesystem clock, throws fs::filesystem_error if the file doesn't exist
+	inline std::int64_t getLastWriteTime(const fs::path& path)
+	{
+#ifdef DR_USE_STD_FILESYSTEM
+		return static_cast<std::int64_t>(fs::last_write_time(path).time_since_epoch().count());
+#else
+		return static_cast<std::int64_t>(fs::last_write_time(path));
+#endif
+	}
+
 	// Returns the path to a folder suitable to contain temporary files
 	inline fs::path getTemporaryPath()
 	{
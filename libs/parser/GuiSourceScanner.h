@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "string/case_conv.h"
+
+namespace parser
+{
+
+/**
+ * Lightweight scanner for GUI source text. It splits the text into the tokens
+ * the CodeTokeniser would produce (with the same delimiters), skipping comments,
+ * but it doesn't process any preprocessor directives.
+ *
+ * This is used to find certain windowDefs without constructing the GUI.
+ */
+class GuiSourceScanner
+{
+public:
+	// A windowDef or #include statement found by findStatements()
+	struct Statement
+	{
+		bool isInclude;
+
+		// Name of the windowDef or the included VFS path
+		std::string name;
+
+		// The brace depth of the statement, relative to the start of the text
+		std::size_t depth;
+	};
+
+private:
+	const std::string& _text;
+	std::size_t _pos;
+
+public:
+	GuiSourceScanner(const std::string& text) :
+		_text(text),
+		_pos(0)
+	{}
+
+	// Reads the next token, quoted tokens are returned without their quotes.
+	// Returns false at the end of the text.
+	bool nextToken(std::string& token)
+	{
+		skipWhitespaceAndComments();
+
+		if (_pos >= _text.size())
+		{
+			return false;
+		}
+
+		char c = _text[_pos];
+
+		if (std::strchr("{}(),;", c) != nullptr)
+		{
+			token.assign(1, c);
+			++_pos;
+			return true;
+		}
+
+		if (c == '"')
+		{
+			auto end = _text.find('"', _pos + 1);
+
+			if (end == std::string::npos) end = _text.size();
+
+			token.assign(_text, _pos + 1, end - _pos - 1);
+			_pos = std::min(end + 1, _text.size());
+			return true;
+		}
+
+		auto start = _pos;
+
+		while (_pos < _text.size() && !isWhitespace(_text[_pos]) && !isCommentStart() &&
+			   std::strchr("{}(),;\"", _text[_pos]) == nullptr)
+		{
+			++_pos;
+		}
+
+		token.assign(_text, start, _pos - start);
+		return true;
+	}
+
+	// Returns the #include statements and the windowDefs with one of the given
+	// (case-sensitive) names in the given text, in the order they appear
+	static std::vector<Statement> findStatements(const std::string& text,
+		const std::vector<std::string>& windowDefNames)
+	{
+		std::vector<Statement> statements;
+
+		GuiSourceScanner scanner(text);
+		std::string token;
+		std::size_t depth = 0;
+
+		while (scanner.nextToken(token))
+		{
+			if (token == "{")
+			{
+				++depth;
+			}
+			else if (token == "}")
+			{
+				if (depth > 0) --depth;
+			}
+			else if (token == "#include")
+			{
+				if (scanner.nextToken(token))
+				{
+					statements.emplace_back(Statement{ true, token, depth });
+				}
+			}
+			else
+			{
+				string::to_lower(token);
+
+				// There's a typo in one of the TDM GUIs, the GuiWindowDef parser accepts it too
+				if ((token == "windowdef" || token == "indowdef") && scanner.nextToken(token) &&
+					std::find(windowDefNames.begin(), windowDefNames.end(), token) != windowDefNames.end())
+				{
+					statements.emplace_back(Statement{ false, token, depth });
+				}
+			}
+		}
+
+		return statements;
+	}
+
+private:
+	static bool isWhitespace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	bool isCommentStart() const
+	{
+		return _text[_pos] == '/' && _pos + 1 < _text.size() &&
+			(_text[_pos + 1] == '/' || _text[_pos + 1] == '*');
+	}
+
+	void skipWhitespaceAndComments()
+	{
+		while (_pos < _text.size())
+		{
+			if (isWhitespace(_text[_pos]))
+			{
+				++_pos;
+			}
+			else if (isCommentStart())
+			{
+				bool isLineComment = _text[_pos + 1] == '/';
+				auto end = _text.find(isLineComment ? "\n" : "*/", _pos + 2);
+
+				_pos = end == std::string::npos ? _text.size() : end + (isLineComment ? 1 : 2);
+			}
+			else
+			{
+				break;
+			}
+		}
+	}
+};
+
+} // namespace
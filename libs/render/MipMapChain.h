@@ -0,0 +1,412 @@
+#pragma once
+
+#include "igl.h"
+#include "iimage.h"
+#include "RGBAImage.h"
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+
+namespace render
+{
+
+/**
+ * The complete mipmap chain of a texture as uploaded to OpenGL, either as
+ * plain RGBA pixels or S3TC compressed blocks. All levels are stored in a
+ * single buffer, the first level is the full-size image.
+ */
+struct MipMapChain
+{
+	struct Level
+	{
+		std::size_t width;
+		std::size_t height;
+
+		// Location of this level's bytes in the data buffer
+		std::size_t offset;
+		std::size_t size;
+	};
+
+	// GL_RGBA for uncompressed chains, otherwise the compressed format
+	GLenum format = GL_RGBA;
+	bool compressed = false;
+
+	std::vector<Level> levels;
+	std::vector<std::uint8_t> data;
+
+	// Colour of the smallest level, used while the texture is evicted
+	RGBAPixel averageColour = { 0, 0, 0, 255 };
+
+	const std::uint8_t* getLevelData(std::size_t level) const
+	{
+		return data.data() + levels[level].offset;
+	}
+
+	bool empty() const
+	{
+		return levels.empty();
+	}
+
+	// Builds the box-filtered RGBA mipmap chain of the given image
+	static MipMapChain CreateFromImage(const Image& image);
+
+	// Returns the S3TC compressed version of the given RGBA chain. Images
+	// with translucent pixels are stored as DXT5, all others as DXT1.
+	static MipMapChain Compress(const MipMapChain& rgba);
+};
+
+namespace detail
+{
+	inline std::uint16_t packRGB565(const int rgb[3])
+	{
+		return static_cast<std::uint16_t>(((rgb[0] >> 3) << 11) | ((rgb[1] >> 2) << 5) | (rgb[2] >> 3));
+	}
+
+	inline void unpackRGB565(std::uint16_t colour, int rgb[3])
+	{
+		int r = (colour >> 11) & 31;
+		int g = (colour >> 5) & 63;
+		int b = colour & 31;
+
+		rgb[0] = (r << 3) | (r >> 2);
+		rgb[1] = (g << 2) | (g >> 4);
+		rgb[2] = (b << 3) | (b >> 2);
+	}
+
+	// Copies the 4x4 block at the given pixel position, levels smaller
+	// than a block repeat their edge pixels
+	inline void fetchBlock(const std::uint8_t* pixels, std::size_t width, std::size_t height,
+		std::size_t x, std::size_t y, std::uint8_t block[64])
+	{
+		for (std::size_t by = 0; by < 4; ++by)
+		{
+			std::size_t sy = std::min(y + by, height - 1);
+
+			for (std::size_t bx = 0; bx < 4; ++bx)
+			{
+				std::size_t sx = std::min(x + bx, width - 1);
+				std::memcpy(block + (by * 4 + bx) * 4, pixels + (sy * width + sx) * 4, 4);
+			}
+		}
+	}
+
+	// Writes the 8 byte colour part of a DXT block, fitting the end points
+	// to the (slightly inset) bounding box diagonal best matching the block's colours
+	inline void encodeColourBlock(const std::uint8_t block[64], std::uint8_t* out)
+	{
+		int min[3] = { 255, 255, 255 };
+		int max[3] = { 0, 0, 0 };
+
+		for (std::size_t i = 0; i < 16; ++i)
+		{
+			for (std::size_t c = 0; c < 3; ++c)
+			{
+				min[c] = std::min<int>(min[c], block[i * 4 + c]);
+				max[c] = std::max<int>(max[c], block[i * 4 + c]);
+			}
+		}
+
+		// Pick the diagonal following the colours: flip the channels which are
+		// decreasing where the channel with the widest range is increasing
+		std::size_t axis = 0;
+
+		for (std::size_t c = 1; c < 3; ++c)
+		{
+			if (max[c] - min[c] > max[axis] - min[axis]) axis = c;
+		}
+
+		int covariance[3] = { 0, 0, 0 };
+
+		for (std::size_t i = 0; i < 16; ++i)
+		{
+			int reference = block[i * 4 + axis] * 2 - (min[axis] + max[axis]);
+
+			for (std::size_t c = 0; c < 3; ++c)
+			{
+				covariance[c] += (block[i * 4 + c] * 2 - (min[c] + max[c])) * reference;
+			}
+		}
+
+		for (std::size_t c = 0; c < 3; ++c)
+		{
+			if (covariance[c] < 0)
+			{
+				std::swap(min[c], max[c]);
+			}
+		}
+
+		// Inset the box, the corners are rarely hit by the actual colours
+		for (std::size_t c = 0; c < 3; ++c)
+		{
+			int inset = (max[c] - min[c]) / 16;
+			min[c] += inset;
+			max[c] -= inset;
+		}
+
+		std::uint16_t colour0 = packRGB565(max);
+		std::uint16_t colour1 = packRGB565(min);
+
+		// The first colour needs to be the larger one to select the four colour mode
+		if (colour0 < colour1)
+		{
+			std::swap(colour0, colour1);
+		}
+
+		std::uint32_t indices = 0;
+
+		if (colour0 != colour1)
+		{
+			int palette[4][3];
+			unpackRGB565(colour0, palette[0]);
+			unpackRGB565(colour1, palette[1]);
+
+			for (std::size_t c = 0; c < 3; ++c)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+
+			for (std::size_t i = 0; i < 16; ++i)
+			{
+				std::uint32_t best = 0;
+				int bestDistance = INT32_MAX;
+
+				for (std::uint32_t p = 0; p < 4; ++p)
+				{
+					int distance = 0;
+
+					for (std::size_t c = 0; c < 3; ++c)
+					{
+						int delta = block[i * 4 + c] - palette[p][c];
+						distance += delta * delta;
+					}
+
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						best = p;
+					}
+				}
+
+				indices |= best << (i * 2);
+			}
+		}
+
+		out[0] = static_cast<std::uint8_t>(colour0 & 0xff);
+		out[1] = static_cast<std::uint8_t>(colour0 >> 8);
+		out[2] = static_cast<std::uint8_t>(colour1 & 0xff);
+		out[3] = static_cast<std::uint8_t>(colour1 >> 8);
+
+		for (std::size_t b = 0; b < 4; ++b)
+		{
+			out[4 + b] = static_cast<std::uint8_t>(indices >> (b * 8));
+		}
+	}
+
+	// Writes the 8 byte alpha part of a DXT5 block
+	inline void encodeAlphaBlock(const std::uint8_t block[64], std::uint8_t* out)
+	{
+		int min = 255;
+		int max = 0;
+
+		for (std::size_t i = 0; i < 16; ++i)
+		{
+			min = std::min<int>(min, block[i * 4 + 3]);
+			max = std::max<int>(max, block[i * 4 + 3]);
+		}
+
+		std::uint64_t indices = 0;
+
+		if (min != max)
+		{
+			// Eight alpha values, interpolated between max and min
+			int palette[8] = { max, min };
+
+			for (int p = 1; p < 7; ++p)
+			{
+				palette[p + 1] = ((7 - p) * max + p * min) / 7;
+			}
+
+			for (std::size_t i = 0; i < 16; ++i)
+			{
+				std::uint64_t best = 0;
+				int bestDistance = 256;
+
+				for (std::uint64_t p = 0; p < 8; ++p)
+				{
+					int distance = std::abs(block[i * 4 + 3] - palette[p]);
+
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						best = p;
+					}
+				}
+
+				indices |= best << (i * 3);
+			}
+		}
+
+		out[0] = static_cast<std::uint8_t>(max);
+		out[1] = static_cast<std::uint8_t>(min);
+
+		for (std::size_t b = 0; b < 6; ++b)
+		{
+			out[2 + b] = static_cast<std::uint8_t>(indices >> (b * 8));
+		}
+	}
+}
+
+inline MipMapChain MipMapChain::CreateFromImage(const Image& image)
+{
+	MipMapChain chain;
+
+	std::size_t width = image.getWidth();
+	std::size_t height = image.getHeight();
+
+	if (width == 0 || height == 0) return chain;
+
+	// Determine the level layout first to allocate the buffer in one go
+	std::size_t offset = 0;
+
+	for (std::size_t w = width, h = height; ; w = std::max<std::size_t>(1, w / 2), h = std::max<std::size_t>(1, h / 2))
+	{
+		chain.levels.push_back(Level{ w, h, offset, w * h * 4 });
+		offset += w * h * 4;
+
+		if (w == 1 && h == 1) break;
+	}
+
+	chain.data.resize(offset);
+	std::memcpy(chain.data.data(), image.getPixels(), chain.levels[0].size);
+
+	// Each level averages 2x2 pixels of the previous one
+	for (std::size_t i = 1; i < chain.levels.size(); ++i)
+	{
+		const Level& source = chain.levels[i - 1];
+		const Level& target = chain.levels[i];
+
+		const std::uint8_t* in = chain.data.data() + source.offset;
+		std::uint8_t* out = chain.data.data() + target.offset;
+
+		for (std::size_t y = 0; y < target.height; ++y)
+		{
+			std::size_t y0 = std::min(y * 2, source.height - 1);
+			std::size_t y1 = std::min(y * 2 + 1, source.height - 1);
+
+			for (std::size_t x = 0; x < target.width; ++x)
+			{
+				std::size_t x0 = std::min(x * 2, source.width - 1);
+				std::size_t x1 = std::min(x * 2 + 1, source.width - 1);
+
+				const std::uint8_t* p00 = in + (y0 * source.width + x0) * 4;
+				const std::uint8_t* p01 = in + (y0 * source.width + x1) * 4;
+				const std::uint8_t* p10 = in + (y1 * source.width + x0) * 4;
+				const std::uint8_t* p11 = in + (y1 * source.width + x1) * 4;
+
+				for (std::size_t c = 0; c < 4; ++c)
+				{
+					*out++ = static_cast<std::uint8_t>((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+				}
+			}
+		}
+	}
+
+	std::memcpy(&chain.averageColour, chain.getLevelData(chain.levels.size() - 1), 4);
+
+	return chain;
+}
+
+inline MipMapChain MipMapChain::Compress(const MipMapChain& rgba)
+{
+	MipMapChain chain;
+
+	if (rgba.empty()) return chain;
+
+	// Images using their alpha channel need DXT5, DXT1 only supports 1-bit alpha
+	bool hasAlpha = false;
+
+	for (std::size_t i = 3; i < rgba.levels[0].size; i += 4)
+	{
+		if (rgba.data[i] != 255)
+		{
+			hasAlpha = true;
+			break;
+		}
+	}
+
+	std::size_t blockSize = hasAlpha ? 16 : 8;
+
+	chain.compressed = true;
+	chain.format = hasAlpha ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	chain.averageColour = rgba.averageColour;
+
+	std::size_t offset = 0;
+
+	for (const Level& level : rgba.levels)
+	{
+		std::size_t size = ((level.width + 3) / 4) * ((level.height + 3) / 4) * blockSize;
+
+		chain.levels.push_back(Level{ level.width, level.height, offset, size });
+		offset += size;
+	}
+
+	chain.data.resize(offset);
+
+	std::uint8_t block[64];
+
+	for (std::size_t i = 0; i < rgba.levels.size(); ++i)
+	{
+		const Level& level = rgba.levels[i];
+		const std::uint8_t* pixels = rgba.getLevelData(i);
+		std::uint8_t* out = chain.data.data() + chain.levels[i].offset;
+
+		for (std::size_t y = 0; y < level.height; y += 4)
+		{
+			for (std::size_t x = 0; x < level.width; x += 4)
+			{
+				detail::fetchBlock(pixels, level.width, level.height, x, y, block);
+
+				if (hasAlpha)
+				{
+					detail::encodeAlphaBlock(block, out);
+					out += 8;
+				}
+
+				detail::encodeColourBlock(block, out);
+				out += 8;
+			}
+		}
+	}
+
+	return chain;
+}
+
+// Returns a 64 bit hash of the image dimensions and pixels, never 0
+inline std::uint64_t getImageHash(const Image& image)
+{
+	// 64 bit FNV-1a over the dimensions and the pixels
+	const std::uint64_t PRIME = 0x100000001b3ULL;
+	std::uint64_t hash = 0xcbf29ce484222325ULL;
+
+	auto hashBytes = [&](const std::uint8_t* bytes, std::size_t size)
+	{
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			hash = (hash ^ bytes[i]) * PRIME;
+		}
+	};
+
+	std::uint32_t dimensions[2] = { static_cast<std::uint32_t>(image.getWidth()),
+		static_cast<std::uint32_t>(image.getHeight()) };
+
+	hashBytes(reinterpret_cast<const std::uint8_t*>(dimensions), sizeof(dimensions));
+	hashBytes(image.getPixels(), image.getWidth() * image.getHeight() * 4);
+
+	return hash != 0 ? hash : 1;
+}
+
+} // namespace render
@@ -28,13 +28,13 @@ private:
     // The view we're using for culling
     const VolumeTest& _volume;
 
+public:
     // Construct with RenderableCollector to receive renderables
     RenderableCollectionWalker(RenderableCollector& collector, const VolumeTest& volume) : 
 		_collector(collector), 
 		_volume(volume)
     {}
 
-public:
 	void dispatchRenderable(const Renderable& renderable)
 	{
 		if (_collector.supportsFullMaterials())
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdexcept>
 #include <GL/glew.h>
 
 #include "VBO.h"
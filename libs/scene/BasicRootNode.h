@@ -10,6 +10,8 @@
 #include "inamespace.h"
 #include "UndoFileChangeTracker.h"
 #include "KeyValueStore.h"
+#include "MaterialUsageIndex.h"
+#include "MapStatistics.h"
 
 namespace scene
 {
@@ -29,6 +31,8 @@ private:
     selection::ISelectionGroupManager::Ptr _selectionGroupManager;
     selection::ISelectionSetManager::Ptr _selectionSetManager;
     ILayerManager::Ptr _layerManager;
+    IMaterialUsageIndex::Ptr _materialUsageIndex;
+    IMapStatistics::Ptr _statistics;
     AABB _emptyAABB;
 
 public:
@@ -39,10 +43,15 @@ public:
         _selectionGroupManager = GlobalSelectionGroupModule().createSelectionGroupManager();
         _selectionSetManager = GlobalSelectionSetModule().createSelectionSetManager();
         _layerManager = GlobalLayerModule().createLayerManager();
+        _materialUsageIndex = std::make_shared<MaterialUsageIndex>();
+        _statistics = std::make_shared<MapStatistics>();
     }
 
     virtual ~BasicRootNode()
-    {}
+    {
+        // Remove the child nodes while the managers they're registered with are still alive
+        removeAllChildNodes();
+    }
 
     virtual void setName(const std::string& name) override
     {
@@ -79,6 +88,16 @@ public:
         return *_layerManager;
     }
 
+    IMaterialUsageIndex& getMaterialUsageIndex() override
+    {
+        return *_materialUsageIndex;
+    }
+
+    IMapStatistics& getStatistics() override
+    {
+        return *_statistics;
+    }
+
     const AABB& localAABB() const override
     {
         return _emptyAABB;
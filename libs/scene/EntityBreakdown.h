@@ -3,20 +3,22 @@
 #include <map>
 #include <string>
 #include "iscenegraph.h"
-#include "ientity.h"
-#include "ieclass.h"
+#include "imap.h"
+#include "imapstatistics.h"
 
 namespace scene
 {
 
-/** greebo: This object traverses the scenegraph on construction
- * 			counting all occurrences of each entity class.
+/** greebo: This object counts all occurrences of each entity class
+ * 			in the current scene on construction.
+ *
+ * The counts are taken from the statistics of the map root node,
+ * which are maintained incrementally, no scene traversal is needed.
  */
-class EntityBreakdown :
-	public scene::NodeVisitor
+class EntityBreakdown
 {
 public:
-	typedef std::map<std::string, std::size_t> Map;
+	typedef IMapStatistics::EntityClassCounts Map;
 
 private:
 	Map _map;
@@ -24,35 +26,12 @@ private:
 public:
 	EntityBreakdown()
 	{
-		_map.clear();
-		GlobalSceneGraph().root()->traverse(*this);
-	}
-
-	bool pre(const scene::INodePtr& node) override
-	{
-		// Is this node an entity?
-		Entity* entity = Node_getEntity(node);
+		const IMapRootNodePtr& root = GlobalSceneGraph().root();
 
-		if (entity != nullptr)
+		if (root)
 		{
-			IEntityClassConstPtr eclass = entity->getEntityClass();
-			std::string ecName = eclass->getName();
-
-			auto found = _map.find(ecName);
-
-			if (found == _map.end())
-			{
-				// Entity class not yet registered, create new entry
-				_map.emplace(ecName, 1);
-			}
-			else
-			{
-				// Eclass is known, increase the counter
-				found->second++;
-			}
+			_map = root->getStatistics().getEntityClassCounts();
 		}
-
-		return true;
 	}
 
 	// Accessor method to retrieve the entity breakdown map
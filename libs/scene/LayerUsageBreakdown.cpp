@@ -35,10 +35,23 @@ LayerUsageBreakdown LayerUsageBreakdown::CreateFromScene(bool includeHidden)
 
 	InitialiseVector(bd);
 
+	if (includeHidden)
+	{
+		// The layer manager keeps track of all members, no need to traverse the scene
+		auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
+
+		for (std::size_t layerId = 0; layerId < bd.size(); ++layerId)
+		{
+			bd[layerId] = layerManager.getLayerMemberCount(static_cast<int>(layerId));
+		}
+
+		return bd;
+	}
+
 	GlobalSceneGraph().foreachNode([&](const scene::INodePtr& node)
 	{
-		// Filter out any hidden nodes, unless we want them
-		if (!includeHidden && !node->visible()) return false;
+		// Filter out any hidden nodes
+		if (!node->visible()) return false;
 
 		// Consider only entities and primitives
 		if (!Node_isPrimitive(node) && !Node_isEntity(node)) return true;
@@ -0,0 +1,196 @@
+#include "MapStatistics.h"
+
+#include "ientity.h"
+#include "ieclass.h"
+#include "imodel.h"
+#include "modelskin.h"
+
+namespace scene
+{
+
+namespace
+{
+	bool isPrimitive(const INode& node)
+	{
+		return node.getNodeType() == INode::Type::Brush || node.getNodeType() == INode::Type::Patch;
+	}
+
+	// Decrements the counter with the given key, dropping it when reaching zero
+	template<typename MapType>
+	void decrementCount(MapType& map, const std::string& key)
+	{
+		auto found = map.find(key);
+
+		if (found != map.end() && --found->second == 0)
+		{
+			map.erase(found);
+		}
+	}
+}
+
+MapStatistics::MapStatistics() :
+	_entityCount(0),
+	_primitiveCount(0)
+{}
+
+void MapStatistics::registerNode(INode& node)
+{
+	NodeInfo info;
+	info.type = node.getNodeType();
+
+	if (!_nodes.emplace(&node, info).second) return;
+
+	if (info.type == INode::Type::Entity)
+	{
+		++_entityCount;
+	}
+	else if (isPrimitive(node))
+	{
+		++_primitiveCount;
+	}
+
+	// Entity class and model are looked up on the next query
+	if (info.type == INode::Type::Entity || info.type == INode::Type::Model)
+	{
+		_changedNodes.insert(&node);
+	}
+}
+
+void MapStatistics::unregisterNode(INode& node)
+{
+	auto found = _nodes.find(&node);
+
+	if (found == _nodes.end()) return;
+
+	if (found->second.type == INode::Type::Entity)
+	{
+		--_entityCount;
+	}
+	else if (isPrimitive(node))
+	{
+		--_primitiveCount;
+	}
+
+	removeCounts(found->second);
+
+	_nodes.erase(found);
+	_changedNodes.erase(&node);
+}
+
+void MapStatistics::onNodeChanged(INode& node)
+{
+	if (_nodes.count(&node) > 0)
+	{
+		_changedNodes.insert(&node);
+	}
+}
+
+std::size_t MapStatistics::getEntityCount()
+{
+	return _entityCount;
+}
+
+std::size_t MapStatistics::getPrimitiveCount()
+{
+	return _primitiveCount;
+}
+
+const IMapStatistics::EntityClassCounts& MapStatistics::getEntityClassCounts()
+{
+	ensureUpToDate();
+
+	return _entityClassCounts;
+}
+
+const IMapStatistics::ModelCounts& MapStatistics::getModelCounts()
+{
+	ensureUpToDate();
+
+	return _modelCounts;
+}
+
+void MapStatistics::ensureUpToDate()
+{
+	for (INode* node : _changedNodes)
+	{
+		NodeInfo& info = _nodes[node];
+		NodeInfo newInfo;
+		newInfo.type = info.type;
+
+		if (auto entityNode = dynamic_cast<IEntityNode*>(node))
+		{
+			newInfo.name = entityNode->getEntity().getEntityClass()->getName();
+		}
+		else if (auto modelNode = dynamic_cast<model::ModelNode*>(node))
+		{
+			const model::IModel& model = modelNode->getIModel();
+
+			newInfo.name = model.getModelPath();
+			newInfo.polyCount = static_cast<std::size_t>(model.getPolyCount());
+
+			if (auto skinned = dynamic_cast<SkinnedModel*>(node))
+			{
+				newInfo.skinned = true;
+				newInfo.skin = skinned->getSkin();
+			}
+		}
+
+		removeCounts(info);
+		addCounts(newInfo);
+
+		info = newInfo;
+	}
+
+	_changedNodes.clear();
+}
+
+void MapStatistics::addCounts(const NodeInfo& info)
+{
+	if (info.name.empty()) return;
+
+	if (info.type == INode::Type::Entity)
+	{
+		++_entityClassCounts[info.name];
+	}
+	else if (info.type == INode::Type::Model)
+	{
+		ModelCount& count = _modelCounts[info.name];
+
+		++count.count;
+		count.polyCount = info.polyCount;
+
+		if (info.skinned)
+		{
+			++count.skinCount[info.skin];
+		}
+	}
+}
+
+void MapStatistics::removeCounts(const NodeInfo& info)
+{
+	if (info.name.empty()) return;
+
+	if (info.type == INode::Type::Entity)
+	{
+		decrementCount(_entityClassCounts, info.name);
+	}
+	else if (info.type == INode::Type::Model)
+	{
+		auto found = _modelCounts.find(info.name);
+
+		if (found == _modelCounts.end()) return;
+
+		if (info.skinned)
+		{
+			decrementCount(found->second.skinCount, info.skin);
+		}
+
+		// Models no longer in use are dropped
+		if (--found->second.count == 0)
+		{
+			_modelCounts.erase(found);
+		}
+	}
+}
+
+} // namespace scene
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "imapstatistics.h"
+#include "inode.h"
+
+namespace scene
+{
+
+/**
+ * Default implementation of the map statistics, as owned by
+ * the map root nodes.
+ */
+class MapStatistics :
+	public IMapStatistics
+{
+private:
+	// The properties of a registered node as of the last evaluation
+	struct NodeInfo
+	{
+		INode::Type type = INode::Type::Unknown;
+
+		// Entity class name or model path, empty if not evaluated yet
+		std::string name;
+
+		// Model skin, only counted for skinnable models
+		bool skinned = false;
+		std::string skin;
+
+		std::size_t polyCount = 0;
+	};
+
+	std::unordered_map<INode*, NodeInfo> _nodes;
+
+	// Registered nodes that need to be re-evaluated before the next query
+	std::unordered_set<INode*> _changedNodes;
+
+	// The node type is fixed, these counts are always up to date
+	std::size_t _entityCount;
+	std::size_t _primitiveCount;
+
+	EntityClassCounts _entityClassCounts;
+	ModelCounts _modelCounts;
+
+public:
+	MapStatistics();
+
+	void registerNode(INode& node) override;
+	void unregisterNode(INode& node) override;
+	void onNodeChanged(INode& node) override;
+
+	std::size_t getEntityCount() override;
+	std::size_t getPrimitiveCount() override;
+	const EntityClassCounts& getEntityClassCounts() override;
+	const ModelCounts& getModelCounts() override;
+
+private:
+	// Re-evaluates the properties of all changed nodes
+	void ensureUpToDate();
+
+	void addCounts(const NodeInfo& info);
+	void removeCounts(const NodeInfo& info);
+};
+
+} // namespace scene
@@ -0,0 +1,163 @@
+#include "MaterialUsageIndex.h"
+
+#include "inode.h"
+#include "ibrush.h"
+#include "ipatch.h"
+
+namespace scene
+{
+
+namespace
+{
+	// Collects the materials of the given brush (one per face) or patch
+	std::vector<std::string> getNodeMaterials(INode& node)
+	{
+		std::vector<std::string> materials;
+
+		if (auto brushNode = dynamic_cast<IBrushNode*>(&node))
+		{
+			const IBrush& brush = brushNode->getIBrush();
+			materials.reserve(brush.getNumFaces());
+
+			for (std::size_t i = 0; i < brush.getNumFaces(); ++i)
+			{
+				materials.push_back(brush.getFace(i).getShader());
+			}
+		}
+		else if (auto patchNode = dynamic_cast<IPatchNode*>(&node))
+		{
+			materials.push_back(patchNode->getPatch().getShader());
+		}
+
+		return materials;
+	}
+}
+
+void MaterialUsageIndex::registerNode(INode& node)
+{
+	_nodeMaterials.emplace(&node, std::vector<std::string>());
+	_changedNodes.insert(&node);
+}
+
+void MaterialUsageIndex::unregisterNode(INode& node)
+{
+	auto found = _nodeMaterials.find(&node);
+
+	if (found == _nodeMaterials.end()) return;
+
+	removeUsages(node, found->second);
+
+	_nodeMaterials.erase(found);
+	_changedNodes.erase(&node);
+}
+
+void MaterialUsageIndex::onNodeMaterialsChanged(INode& node)
+{
+	if (_nodeMaterials.count(&node) > 0)
+	{
+		_changedNodes.insert(&node);
+	}
+}
+
+void MaterialUsageIndex::foreachNodeUsingMaterial(const std::string& material,
+	const std::function<void(const INodePtr&)>& functor)
+{
+	ensureUpToDate();
+
+	auto found = _usages.find(material);
+
+	if (found == _usages.end()) return;
+
+	// Copy the hits, the functor might change the materials of the nodes
+	std::vector<INodePtr> nodes;
+	nodes.reserve(found->second.nodes.size());
+
+	for (const auto& pair : found->second.nodes)
+	{
+		nodes.push_back(pair.first->getSelf());
+	}
+
+	for (const auto& node : nodes)
+	{
+		functor(node);
+	}
+}
+
+void MaterialUsageIndex::foreachMaterial(const std::function<void(const std::string& material,
+	std::size_t faceCount, std::size_t patchCount)>& functor)
+{
+	ensureUpToDate();
+
+	for (const auto& pair : _usages)
+	{
+		functor(pair.first, pair.second.faceCount, pair.second.patchCount);
+	}
+}
+
+bool MaterialUsageIndex::isMaterialInUse(const std::string& material)
+{
+	ensureUpToDate();
+
+	return _usages.count(material) > 0;
+}
+
+void MaterialUsageIndex::ensureUpToDate()
+{
+	for (INode* node : _changedNodes)
+	{
+		std::vector<std::string>& materials = _nodeMaterials[node];
+		std::vector<std::string> newMaterials = getNodeMaterials(*node);
+
+		if (newMaterials == materials) continue;
+
+		removeUsages(*node, materials);
+		addUsages(*node, newMaterials);
+
+		materials.swap(newMaterials);
+	}
+
+	_changedNodes.clear();
+}
+
+void MaterialUsageIndex::addUsages(INode& node, const std::vector<std::string>& materials)
+{
+	bool isPatch = node.getNodeType() == INode::Type::Patch;
+
+	for (const std::string& material : materials)
+	{
+		Usage& usage = _usages[material];
+
+		++usage.nodes[&node];
+		++(isPatch ? usage.patchCount : usage.faceCount);
+	}
+}
+
+void MaterialUsageIndex::removeUsages(INode& node, const std::vector<std::string>& materials)
+{
+	bool isPatch = node.getNodeType() == INode::Type::Patch;
+
+	for (const std::string& material : materials)
+	{
+		auto found = _usages.find(material);
+
+		if (found == _usages.end()) continue;
+
+		Usage& usage = found->second;
+		auto nodeCount = usage.nodes.find(&node);
+
+		if (nodeCount != usage.nodes.end() && --nodeCount->second == 0)
+		{
+			usage.nodes.erase(nodeCount);
+		}
+
+		--(isPatch ? usage.patchCount : usage.faceCount);
+
+		// Materials no longer in use are dropped from the index
+		if (usage.nodes.empty())
+		{
+			_usages.erase(found);
+		}
+	}
+}
+
+} // namespace scene
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "imaterialusage.h"
+#include "string/string.h"
+
+namespace scene
+{
+
+/**
+ * Default implementation of the material usage index, as owned by
+ * the map root nodes.
+ */
+class MaterialUsageIndex :
+	public IMaterialUsageIndex
+{
+private:
+	struct Usage
+	{
+		// The number of faces (1 for patches) of each node using the material
+		std::unordered_map<INode*, std::size_t> nodes;
+
+		std::size_t faceCount = 0;
+		std::size_t patchCount = 0;
+	};
+
+	struct MaterialNameLess
+	{
+		bool operator()(const std::string& a, const std::string& b) const
+		{
+			return string_compare_nocase(a.c_str(), b.c_str()) < 0;
+		}
+	};
+
+	std::map<std::string, Usage, MaterialNameLess> _usages;
+
+	// The materials of each registered node as of the last evaluation,
+	// one entry per face for brushes
+	std::unordered_map<INode*, std::vector<std::string>> _nodeMaterials;
+
+	// Registered nodes that need to be re-evaluated before the next query
+	std::unordered_set<INode*> _changedNodes;
+
+public:
+	void registerNode(INode& node) override;
+	void unregisterNode(INode& node) override;
+	void onNodeMaterialsChanged(INode& node) override;
+
+	void foreachNodeUsingMaterial(const std::string& material,
+		const std::function<void(const INodePtr&)>& functor) override;
+
+	void foreachMaterial(const std::function<void(const std::string& material,
+		std::size_t faceCount, std::size_t patchCount)>& functor) override;
+
+	bool isMaterialInUse(const std::string& material) override;
+
+private:
+	// Re-evaluates the materials of all changed nodes
+	void ensureUpToDate();
+
+	void addUsages(INode& node, const std::vector<std::string>& materials);
+	void removeUsages(INode& node, const std::vector<std::string>& materials);
+};
+
+} // namespace scene
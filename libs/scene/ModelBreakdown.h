@@ -3,96 +3,39 @@
 #include <map>
 #include <string>
 #include "iscenegraph.h"
-#include "imodel.h"
-#include "modelskin.h"
+#include "imap.h"
+#include "imapstatistics.h"
 
 namespace scene
 {
 
 /**
- * greebo: This object traverses the scenegraph on construction
- * counting all occurrences of each model (plus skins).
+ * greebo: This object counts all occurrences of each model (plus skins)
+ * in the current scene on construction.
+ *
+ * The counts are taken from the statistics of the map root node,
+ * which are maintained incrementally, no scene traversal is needed.
  */
-class ModelBreakdown :
-	public scene::NodeVisitor
+class ModelBreakdown
 {
 public:
-	struct ModelCount
-	{
-		std::size_t count;
-		std::size_t polyCount;
-
-		typedef std::map<std::string, std::size_t> SkinCountMap;
-		SkinCountMap skinCount;
-
-		ModelCount() :
-			count(0)
-		{}
-	};
+	typedef IMapStatistics::ModelCount ModelCount;
 
 	// The map associating model names with occurrences
-	typedef std::map<std::string, ModelCount> Map;
+	typedef IMapStatistics::ModelCounts Map;
 
 private:
-	mutable Map _map;
+	Map _map;
 
 public:
 	ModelBreakdown()
 	{
-		_map.clear();
-		GlobalSceneGraph().root()->traverseChildren(*this);
-	}
+		const IMapRootNodePtr& root = GlobalSceneGraph().root();
 
-	bool pre(const scene::INodePtr& node) override
-	{
-		// Check if this node is a model
-		model::ModelNodePtr modelNode = Node_getModel(node);
-
-		if (modelNode)
+		if (root)
 		{
-			// Get the actual model from the node
-			const model::IModel& model = modelNode->getIModel();
-
-			Map::iterator found = _map.find(model.getModelPath());
-
-			if (found == _map.end())
-			{
-				auto result = _map.emplace(model.getModelPath(), ModelCount());
-
-				found = result.first;
-
-				// Store the polycount in the map
-				found->second.polyCount = model.getPolyCount();
-				found->second.skinCount.clear();
-			}
-
-			// The iterator "found" is valid at this point
-			// Get a shortcut reference
-			ModelCount& modelCount = found->second;
-
-			modelCount.count++;
-
-			// Increase the skin count, check if we have a skinnable model
-			auto skinned = std::dynamic_pointer_cast<SkinnedModel>(node);
-
-			if (skinned)
-			{
-				std::string skinName = skinned->getSkin();
-
-				auto foundSkin = modelCount.skinCount.find(skinName);
-
-				if (foundSkin == modelCount.skinCount.end())
-				{
-					auto result = modelCount.skinCount.emplace(skinName, 0);
-
-					foundSkin = result.first;
-				}
-
-				foundSkin->second++;
-			}
+			_map = root->getStatistics().getModelCounts();
 		}
-
-		return true;
 	}
 
 	// Accessor method to retrieve the entity breakdown map
@@ -2,6 +2,9 @@
 
 #include "itransformnode.h"
 #include "iscenegraph.h"
+#include "imap.h"
+#include "imaterialusage.h"
+#include "imapstatistics.h"
 #include "debugging/debugging.h"
 #include "InstanceWalkers.h"
 
@@ -50,6 +53,9 @@ Node::Node() :
 	_local2world(Matrix4::getIdentity()),
 	_instantiated(false),
 	_forceVisible(false),
+	_layerManager(nullptr),
+	_materialUsageIndex(nullptr),
+	_mapStatistics(nullptr),
     _renderEntity(nullptr)
 {
 	// Each node is part of layer 0 by default
@@ -70,6 +76,9 @@ Node::Node(const Node& other) :
 	_instantiated(false),
 	_forceVisible(false),
 	_layers(other._layers),
+	_layerManager(nullptr),
+	_materialUsageIndex(nullptr),
+	_mapStatistics(nullptr),
     _renderEntity(other._renderEntity)
 {}
 
@@ -130,13 +139,22 @@ bool Node::excluded() const
 
 void Node::addToLayer(int layerId)
 {
+	if (_layers.contains(layerId)) return;
+
+	LayerList previousLayers = _layers;
 	_layers.insert(layerId);
+
+	notifyLayersChanged(previousLayers);
 }
 
 void Node::moveToLayer(int layerId)
 {
+	LayerList previousLayers = _layers;
+
 	_layers.clear();
 	_layers.insert(layerId);
+
+	notifyLayersChanged(previousLayers);
 }
 
 void Node::removeFromLayer(int layerId)
@@ -145,12 +163,16 @@ void Node::removeFromLayer(int layerId)
 	LayerList::iterator found = _layers.find(layerId);
 
 	if (found != _layers.end()) {
+		LayerList previousLayers = _layers;
+
 		_layers.erase(found);
 
 		// greebo: Make sure that every node is at least member of layer 0
 		if (_layers.empty()) {
 			_layers.insert(0);
 		}
+
+		notifyLayersChanged(previousLayers);
 	}
 }
 
@@ -163,10 +185,21 @@ void Node::assignToLayers(const LayerList& newLayers)
 {
 	if (!newLayers.empty())
     {
+		LayerList previousLayers = _layers;
         _layers = newLayers;
+
+		notifyLayersChanged(previousLayers);
     }
 }
 
+void Node::notifyLayersChanged(const LayerList& previousLayers)
+{
+	if (_layerManager != nullptr && _layers != previousLayers)
+	{
+		_layerManager->updateNodeMembership(*this, previousLayers);
+	}
+}
+
 void Node::addChildNode(const INodePtr& node)
 {
 	// Add the node to the TraversableNodeSet, this triggers an
@@ -298,11 +331,66 @@ void Node::onChildRemoved(const INodePtr& child)
 void Node::onInsertIntoScene(IMapRootNode& root)
 {
 	_instantiated = true;
+
+	// The root node itself is not member of any layer
+	if (getNodeType() != Type::MapRoot)
+	{
+		_layerManager = &root.getLayerManager();
+		_layerManager->registerNode(*this);
+	}
+
+	// Brushes and patches are indexed by the materials they're using
+	if (getNodeType() == Type::Brush || getNodeType() == Type::Patch)
+	{
+		_materialUsageIndex = &root.getMaterialUsageIndex();
+		_materialUsageIndex->registerNode(*this);
+	}
+
+	if (getNodeType() == Type::Entity || getNodeType() == Type::Brush ||
+		getNodeType() == Type::Patch || getNodeType() == Type::Model)
+	{
+		_mapStatistics = &root.getStatistics();
+		_mapStatistics->registerNode(*this);
+	}
 }
 
 void Node::onRemoveFromScene(IMapRootNode& root)
 {
 	_instantiated = false;
+
+	if (_layerManager != nullptr)
+	{
+		_layerManager->unregisterNode(*this);
+		_layerManager = nullptr;
+	}
+
+	if (_materialUsageIndex != nullptr)
+	{
+		_materialUsageIndex->unregisterNode(*this);
+		_materialUsageIndex = nullptr;
+	}
+
+	if (_mapStatistics != nullptr)
+	{
+		_mapStatistics->unregisterNode(*this);
+		_mapStatistics = nullptr;
+	}
+}
+
+void Node::materialsChanged()
+{
+	if (_materialUsageIndex != nullptr)
+	{
+		_materialUsageIndex->onNodeMaterialsChanged(*this);
+	}
+}
+
+void Node::statisticsChanged()
+{
+	if (_mapStatistics != nullptr)
+	{
+		_mapStatistics->onNodeChanged(*this);
+	}
 }
 
 void Node::connectUndoSystem(IMapFileChangeTracker& changeTracker)
@@ -15,6 +15,9 @@ namespace scene
 class Graph;
 typedef std::weak_ptr<Graph> GraphWeakPtr;
 
+class IMaterialUsageIndex;
+class IMapStatistics;
+
 /// Main implementation of INode
 class Node :
 	public virtual INode,
@@ -64,6 +67,18 @@ private:
 	// The list of layers this object is associated to
 	LayerList _layers;
 
+	// The layer manager of the map this node is part of, is non-null
+	// while the node is inserted in the scene
+	ILayerManager* _layerManager;
+
+	// The material usage index of the map, is non-null while a brush
+	// or patch node is inserted in the scene
+	IMaterialUsageIndex* _materialUsageIndex;
+
+	// The statistics of the map, is non-null while an entity, brush,
+	// patch or model node is inserted in the scene
+	IMapStatistics* _mapStatistics;
+
 protected:
 	// If this node is attached to a parent entity, this is the reference to it
     IRenderEntity* _renderEntity;
@@ -172,6 +187,14 @@ public:
 		return _instantiated;
 	}
 
+	// To be called by brushes and patches whenever the materials they are
+	// using changed, to keep the material usage index of the map up to date
+	void materialsChanged();
+
+	// To be called by nodes whenever a property counted by the map
+	// statistics changed (like the skin of a model)
+	void statisticsChanged();
+
 	/**
 	 * greebo: Constructs the scene path to this node. This will walk up the
 	 * ancestors until it reaches the top node, so don't expect this to be
@@ -213,6 +236,9 @@ protected:
 	virtual void removeAllChildNodes();
 
 private:
+	// Lets the layer manager know about a change of this node's layers
+	void notifyLayersChanged(const LayerList& previousLayers);
+
 	void evaluateBounds() const;
 	void evaluateChildBounds() const;
 	void evaluateTransform() const;
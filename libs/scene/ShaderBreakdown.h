@@ -2,19 +2,18 @@
 
 #include <map>
 #include <string>
-#include "ipatch.h"
-#include "ibrush.h"
-#include "iscenegraph.h"
+#include "imap.h"
+#include "imaterialusage.h"
 
 namespace scene
 {
 
 /**
- * greebo: This object traverses the scenegraph on construction
- * counting all occurrences of each shader.
+ * greebo: This object collects the number of faces and patches
+ * using each shader on construction. The counts are taken from
+ * the material usage index of the current map.
  */
-class ShaderBreakdown :
-	public scene::NodeVisitor
+class ShaderBreakdown
 {
 public:
 	struct ShaderCount
@@ -31,37 +30,23 @@ public:
 	typedef std::map<std::string, ShaderCount> Map;
 
 private:
-	mutable Map _map;
+	Map _map;
 
 public:
 	ShaderBreakdown()
 	{
-		_map.clear();
-		GlobalSceneGraph().root()->traverseChildren(*this);
-	}
-
-	bool pre(const scene::INodePtr& node) override
-	{
-		// Check if this node is a patch
-		if (Node_isPatch(node))
-		{
-			increaseShaderCount(Node_getIPatch(node)->getShader(), false);
-			return false;
-		}
+		auto root = GlobalMapModule().getRoot();
 
-		if (Node_isBrush(node))
-        {
-			auto brush = Node_getIBrush(node);
-			
-			for (std::size_t i = 0; i < brush->getNumFaces(); ++i)
-            {
-                increaseShaderCount(brush->getFace(i).getShader(), true);
-            }
+		if (!root) return;
 
-			return false;
-		}
+		root->getMaterialUsageIndex().foreachMaterial(
+			[&](const std::string& shaderName, std::size_t faceCount, std::size_t patchCount)
+		{
+			ShaderCount& count = _map[shaderName];
 
-		return true;
+			count.faceCount = faceCount;
+			count.patchCount = patchCount;
+		});
 	}
 
 	// Accessor method to retrieve the shader breakdown map
@@ -80,32 +65,6 @@ public:
 		return _map.end();
 	}
 
-private:
-	// Local helper to increase the shader occurrence count
-	void increaseShaderCount(const std::string& shaderName, bool isFace)
-	{
-		// Try to look up the shader in the map
-		auto found = _map.find(shaderName);
-
-		if (found == _map.end())
-		{
-			// Shader not yet registered, create new entry
-			auto result = _map.emplace(shaderName, ShaderCount());
-
-			found = result.first;
-		}
-
-		// Iterator is valid at this point, increase the counter
-		if (isFace)
-		{
-			found->second.faceCount++;
-		}
-		else
-		{
-			found->second.patchCount++;
-		}
-	}
-
 }; // class ShaderBreakdown
 
 } // namespace
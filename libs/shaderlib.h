@@ -7,6 +7,8 @@
 #include "iundo.h"
 #include "ipatch.h"
 #include "iselection.h"
+#include "imap.h"
+#include "imaterialusage.h"
 #include "scene/Traverse.h"
 #include "gamelib.h"
 
@@ -115,10 +117,32 @@ inline int findAndReplaceShader(const std::string& find, const std::string& repl
 			GlobalSelectionSystem().foreachPatch(std::ref(replacer));
 		}
 	}
-	else
+	else if (GlobalMapModule().getRoot())
 	{
-		scene::foreachVisibleFace(std::ref(replacer));
-		scene::foreachVisiblePatch(std::ref(replacer));
+		// Only visit the brushes and patches known to use the material
+		auto& index = GlobalMapModule().getRoot()->getMaterialUsageIndex();
+
+		index.foreachNodeUsingMaterial(find, [&](const scene::INodePtr& node)
+		{
+			if (!node->visible()) return;
+
+			if (auto brush = Node_getIBrush(node))
+			{
+				for (std::size_t i = 0; i < brush->getNumFaces(); ++i)
+				{
+					auto& face = brush->getFace(i);
+
+					if (face.isVisible())
+					{
+						replacer(face);
+					}
+				}
+			}
+			else if (auto patch = Node_getIPatch(node))
+			{
+				replacer(*patch);
+			}
+		});
 	}
 
 	return replacer.getReplacedCount();
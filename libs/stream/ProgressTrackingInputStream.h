@@ -0,0 +1,35 @@
+#pragma once
+
+#include "itextstream.h"
+#include <atomic>
+
+namespace stream
+{
+
+/**
+ * Passes through the data of another input stream, counting the number
+ * of bytes read so far. The counter can be queried from a different thread,
+ * e.g. to display the progress of a parser running in the background.
+ */
+class ProgressTrackingInputStream :
+    public TextInputStream
+{
+private:
+    TextInputStream& _source;
+    std::atomic<std::size_t>& _bytesRead;
+
+public:
+    ProgressTrackingInputStream(TextInputStream& source, std::atomic<std::size_t>& bytesRead) :
+        _source(source),
+        _bytesRead(bytesRead)
+    {}
+
+    std::size_t read(char* buffer, std::size_t length) override
+    {
+        std::size_t charsRead = _source.read(buffer, length);
+        _bytesRead += charsRead;
+        return charsRead;
+    }
+};
+
+}
@@ -1,8 +1,9 @@
 #include "GameConnection.h"
-#include "MessageTcp.h"
 #include "DiffStatus.h"
 #include "DiffDoom3MapWriter.h"
-#include "clsocket/ActiveSocket.h"
+#include "gameconn/AutomationEngine.h"
+#include "gameconn/MessageTcp.h"
+#include "gameconn/clsocket/ActiveSocket.h"
 
 #include "i18n.h"
 #include "icameraview.h"
@@ -27,9 +28,12 @@ namespace
     const char* const DEFAULT_HOST = "localhost";
     const int DEFAULT_PORT = 3879;
 
-    inline std::string seqnoPreamble(std::size_t seq) {
-        return fmt::format("seqno {0}\n", seq);
-    }
+    //tags for requests sent to automation engine
+    enum RequestTag {
+        TAG_GENERIC = 0,    //blocking requests
+        TAG_CAMERA,         //async camera updates
+        TAG_MAPUPDATE,      //async map diffs ("update map always" mode)
+    };
 
     inline std::string messagePreamble(const std::string& type) {
         return fmt::format("message \"{}\"\n", type);
@@ -46,99 +50,57 @@ namespace
 #endif
 }
 
-std::size_t GameConnection::generateNewSequenceNumber() {
-    return ++_seqno;
-}
-
-void GameConnection::sendRequest(const std::string &request) {
-    if (!isAlive())
-        return; //connection is down, drop all requests
-    assert(_seqnoInProgress == 0);
-    auto seqno = generateNewSequenceNumber();
-    std::string fullMessage = seqnoPreamble(seqno) + request;
-    _connection->writeMessage(fullMessage.data(), fullMessage.size());
-    _seqnoInProgress = seqno;
-}
-
 bool GameConnection::sendAnyPendingAsync() {
-    if (_mapObserver.getChanges().size() && _updateMapAlways) {
-        //note: this is blocking
-        doUpdateMap();
-        return true;
-    }
-    return sendPendingCameraUpdate();
+    bool sentMap = sendPendingMapUpdate();
+    bool sentCamera = sendPendingCameraUpdate();
+    return sentMap || sentCamera;
 }
 
 void GameConnection::think() {
-    if (!_connection)
+    if (!_engine)
         return; //everything disabled, so just don't do anything
-    _connection->think();
-    if (_seqnoInProgress) {
-        //check if full response is here
-        if (_connection->readMessage(_response)) {
-            //validate and remove preamble
-            int responseSeqno, lineLen;
-            int ret = sscanf(_response.data(), "response %d\n%n", &responseSeqno, &lineLen);
-            assert(ret == 1);
-            assert(static_cast<std::size_t>(responseSeqno) == _seqnoInProgress);
-            _response.erase(_response.begin(), _response.begin() + lineLen);
-            //mark request as "no longer in progress"
-            //note: response can be used in outer function
-            _seqnoInProgress = 0;
-        }
-    }
-    else {
-        //doing nothing now: send async command if present
-        sendAnyPendingAsync();
-    }
-    _connection->think();
-    if (!_connection->isAlive()) {
+    //dispatch all responses which have arrived
+    _engine->think();
+    //send async commands if present
+    //note: everything accumulated since previous think is sent at once
+    sendAnyPendingAsync();
+    _engine->think();
+    if (!_engine->isAlive()) {
         //just lost connection: disable everything
         disconnect(true);
     }
 }
 
-void GameConnection::waitAction() {
-    while (_seqnoInProgress)
-        think();
-}
-
 void GameConnection::finish()
 {
+    if (!_engine)
+        return;
     do
     {
-        //wait for current request in progress to finish
-        waitAction();
+        //wait for all requests in progress to finish
+        _engine->waitAll();
         //send pending async commands and wait for them to finish
     } while (sendAnyPendingAsync());
 }
 
 std::string GameConnection::executeRequest(const std::string &request) {
-    //make sure current request is finished (if any)
-    waitAction();
-    assert(_seqnoInProgress == 0);
-
-    //prepend seqno line and send message
-    sendRequest(request);
-
-    //wait until response is ready
-    waitAction();
-
-    return std::string(_response.begin(), _response.end());
+    if (!_engine)
+        return "";
+    return _engine->executeRequest(TAG_GENERIC, request);
 }
 
 bool GameConnection::isAlive() const {
-    return _connection && _connection->isAlive();
+    return _engine && _engine->isAlive();
 }
 
 bool GameConnection::connect() {
     if (isAlive())
         return true;    //already connected
 
-    if (_connection) {
+    if (_engine) {
         //connection recently lost: disable everything
         disconnect(true);
-        assert(!_connection);
+        assert(!_engine);
     }
 
     //connection using clsocket
@@ -151,9 +113,11 @@ bool GameConnection::connect() {
     if (!connection->Open(DEFAULT_HOST, DEFAULT_PORT))
         return false;
 
-    _connection.reset(new MessageTcp());
-    _connection->init(std::move(connection));
-    if (!_connection->isAlive())
+    std::unique_ptr<MessageTcp> messageTcp(new MessageTcp());
+    messageTcp->init(std::move(connection));
+    _engine.reset(new AutomationEngine());
+    _engine->attach(std::move(messageTcp));
+    if (!_engine->isAlive())
         return false;
 
     _thinkTimer.reset(new wxTimer());
@@ -173,7 +137,6 @@ void GameConnection::disconnect(bool force) {
     setCameraSyncEnabled(false);
     if (force) {
         //drop everything pending 
-        _seqnoInProgress = 0;
         _mapObserver.clear();
         _cameraOutPending = false;
     }
@@ -181,8 +144,8 @@ void GameConnection::disconnect(bool force) {
         //try to finish all pending
         finish();
     }
-    if (_connection)
-        _connection.reset();
+    if (_engine)
+        _engine.reset();
     if (_thinkTimer) {
         _thinkTimer->Stop();
         _thinkTimer.reset();
@@ -347,13 +310,14 @@ void GameConnection::updateCamera() {
 }
 
 bool GameConnection::sendPendingCameraUpdate() {
-    if (_cameraOutPending) {
+    //only one camera update may be in flight: all positions set meanwhile are coalesced into the latest one
+    if (_cameraOutPending && !_engine->isTagInProgress(TAG_CAMERA)) {
         std::string text = composeConExecRequest(fmt::format(
             "setviewpos  {:0.3f} {:0.3f} {:0.3f}  {:0.3f} {:0.3f} {:0.3f}",
             _cameraOutData[0].x(), _cameraOutData[0].y(), _cameraOutData[0].z(),
             -_cameraOutData[1].x(), _cameraOutData[1].y(), _cameraOutData[1].z()
         ));
-        sendRequest(text);
+        _engine->sendRequest(TAG_CAMERA, text);
         _cameraOutPending = false;
         return true;
     }
@@ -502,16 +466,66 @@ std::string saveMapDiff(const DiffEntityStatuses& entityStatuses)
     return outStream.str();
 }
 
+namespace
+{
+    inline std::string composeMapDiffRequest(const std::string& diff) {
+        return actionPreamble("reloadmap-diff") + "content:\n" + diff;
+    }
+
+    inline bool isMapDiffApplied(const std::string& response) {
+        return response.find("HotReload: SUCCESS") != std::string::npos;
+    }
+}
+
+bool GameConnection::sendPendingMapUpdate() {
+    if (!_updateMapAlways || _mapObserver.getChanges().empty())
+        return false;
+    //diffs must be applied in order: wait until previous one is finished
+    //meanwhile, all further changes are accumulated into the next diff
+    if (_engine->isTagInProgress(TAG_MAPUPDATE))
+        return false;
+
+    DiffEntityStatuses changes = _mapObserver.getChanges();
+    std::string diff = saveMapDiff(changes);
+    if (diff.empty()) {
+        //keep the changes, they are sent along with the next update
+        rError() << "GameConnection: failed to write map diff" << std::endl;
+        return false;
+    }
+
+    auto seqno = _engine->sendRequest(TAG_MAPUPDATE, composeMapDiffRequest(diff), [this, changes](const std::string& response) {
+        if (!isMapDiffApplied(response)) {
+            //keep these changes for the next update
+            rWarning() << "GameConnection: game failed to apply map diff, retrying with next update" << std::endl;
+            _mapObserver.restoreChanges(changes);
+        }
+    });
+    if (seqno == 0)
+        return false;   //connection is down, changes stay in observer
+
+    //the changes are in flight now, further changes go into the next diff
+    _mapObserver.clear();
+    return true;
+}
+
 void GameConnection::doUpdateMap() {
     if (!connect())
         return;
-    std::string diff = saveMapDiff(_mapObserver.getChanges());
+    //let async map update finish first, so that diffs are applied in order
+    _engine->waitTag(TAG_MAPUPDATE);
+    DiffEntityStatuses changes = _mapObserver.getChanges();
+    std::string diff = saveMapDiff(changes);
     if (diff.empty()) {
-        return; //TODO: fail
+        rError() << "GameConnection: failed to write map diff, map not updated" << std::endl;
+        return;
+    }
+    _mapObserver.clear();
+    std::string response = executeRequest(composeMapDiffRequest(diff));
+    if (!isMapDiffApplied(response)) {
+        //the changes are still pending, they are sent with the next update
+        _mapObserver.restoreChanges(changes);
+        rError() << "GameConnection: game failed to apply map diff: " << response << std::endl;
     }
-    std::string response = executeRequest(actionPreamble("reloadmap-diff") + "content:\n" + diff);
-    if (response.find("HotReload: SUCCESS") != std::string::npos)
-        _mapObserver.clear();
 }
 
 }
@@ -10,7 +10,7 @@
 namespace gameconn
 {
 
-class MessageTcp;
+class AutomationEngine;
 
 /**
  * stgatilov: This is TheDarkMod-only system for connecting to game process via socket.
@@ -64,11 +64,11 @@ public:
     void shutdownModule() override;
 
 private:
-    //connection to TDM game (i.e. the socket with custom message framing)
+    //connection to TDM game (i.e. the socket with custom message framing + pipelined requests)
     //it can be "dead" in two ways:
-    //  _connection is NULL --- no connection, all modes/observers disabled
-    //  *_connection is dead --- just lost connection, must call "disconnect" ASAP to disable modes/observers
-    std::unique_ptr<MessageTcp> _connection;
+    //  _engine is NULL --- no connection, all modes/observers disabled
+    //  _engine is not alive --- just lost connection, must call "disconnect" ASAP to disable modes/observers
+    std::unique_ptr<AutomationEngine> _engine;
     //when connected, this timer calls Think periodically
     std::unique_ptr<wxTimer> _thinkTimer;
 
@@ -76,15 +76,9 @@ private:
 
     //signal listener for when map is saved, loaded, unloaded, etc.
     sigc::connection _mapEventListener;
-    //sequence number of the last sent request (incremented sequentally)
-    std::size_t _seqno = 0;
-
-    //nonzero: request with this seqno sent to game, response not recieved yet
-    std::size_t _seqnoInProgress = 0;
-    //response from current in-progress request will be saved here
-    std::vector<char> _response;
 
     //true <=> cameraOutData holds new camera position, which should be sent to TDM
+    //note: while previous camera update is in flight, newer positions overwrite each other
     bool _cameraOutPending = false;
     //data for camera position (setviewpos format: X Y Z -pitch yaw roll)
     Vector3 _cameraOutData[2];
@@ -98,19 +92,13 @@ private:
     //set to true when "update map" is set to "always"
     bool _updateMapAlways = false;
 
-    
-    //every request should get unique seqno, otherwise we won't be able to distinguish their responses
-    std::size_t generateNewSequenceNumber();
-    //prepend seqno to specified request and send it to game
-    void sendRequest(const std::string &request);
-    //if there are any pending async commands (camera update), send one now
+
+    //if there are any pending async commands (camera update, map update), send them now
     //returns true iff anything was sent to game
     bool sendAnyPendingAsync();
     //check how socket is doing, accept responses and send pending async requests 
     //this should be done regularly: in fact, timer calls it often
     void think();
-    //wait until the currently executed request is finished
-    void waitAction();
     //send given request synchronously, i.e. wait until its completition (blocking)
     //returns response content
     std::string executeRequest(const std::string &request);
@@ -127,7 +115,11 @@ private:
     //called from camera modification callback: schedules async "setviewpos" action for future
     void updateCamera();
     //send request for camera update, which is pending yet
+    //does nothing while previous camera update is still in flight
     bool sendPendingCameraUpdate();
+    //send all map changes observed since the last update as one diff (non-blocking)
+    //does nothing while previous map update is still in flight
+    bool sendPendingMapUpdate();
 
     //signal observer on map saving
     void onMapEvent(IMap::MapEvent ev);
@@ -164,4 +164,16 @@ const DiffEntityStatuses& MapObserver::getChanges() const {
     return _entityChanges;
 }
 
+void MapObserver::restoreChanges(const DiffEntityStatuses& earlierChanges) {
+    if (!isEnabled())
+        return;     //observer has been reset meanwhile
+    for (const auto& pNS : earlierChanges) {
+        auto iter = _entityChanges.find(pNS.first);
+        if (iter == _entityChanges.end())
+            _entityChanges[pNS.first] = pNS.second;
+        else
+            iter->second = pNS.second.combine(iter->second);
+    }
+}
+
 }
@@ -31,6 +31,10 @@ public:
     //returns pending entity change since last clear (or since enabled)
     const DiffEntityStatuses& getChanges() const;
 
+    //put back changes which were taken (and cleared) earlier but failed to apply
+    //they are combined with all changes which happened after them
+    void restoreChanges(const DiffEntityStatuses& earlierChanges);
+
 private:
     //receives events about entity changes
     void entityUpdated(const std::string& name, const DiffStatus& diff);
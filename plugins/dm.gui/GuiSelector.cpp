@@ -111,6 +111,9 @@ void GuiSelector::fillTrees()
 	wxutil::VFSTreePopulator popOne(_oneSidedStore);
 	wxutil::VFSTreePopulator popTwo(_twoSidedStore);
 
+	// Classify the GUIs up front, this is using all cores and the persisted types
+	GlobalGuiManager().determineGuiTypes();
+
 	ReadablePopulator walker(popOne, popTwo);
 	GlobalGuiManager().foreachGui(walker);
 
@@ -4,6 +4,7 @@
 #include "ifilesystem.h"
 #include "itextstream.h"
 #include "parser/CodeTokeniser.h"
+#include "ParallelForEach.h"
 
 #include "Gui.h"
 
@@ -11,7 +12,8 @@ namespace gui
 {
 
 GuiManager::GuiManager() :
-    _guiLoader(std::bind(&GuiManager::findGuis, this))
+    _guiLoader(std::bind(&GuiManager::findGuis, this)),
+    _typeIndex(std::bind(&GuiManager::parseGuiType, this, std::placeholders::_1))
 {}
 
 void GuiManager::registerGui(const std::string& guiPath)
@@ -45,23 +47,74 @@ void GuiManager::reloadGui(const std::string& guiPath)
 
 GuiType GuiManager::getGuiType(const std::string& guiPath)
 {
-	// Get the GUI (will load the file if necessary)
-	GuiPtr gui = std::static_pointer_cast<Gui>(getGui(guiPath));
+	ensureGuisLoaded();
 
 	GuiInfoMap::iterator found = _guis.find(guiPath);
 
-	if (found == _guis.end())
+	// Parsed GUIs are inspected directly, all others are scanned
+	if (found != _guis.end() && found->second.gui)
 	{
-		return FILE_NOT_FOUND;
+		if (found->second.type == UNDETERMINED)
+		{
+			found->second.type = determineGuiType(found->second.gui);
+		}
+
+		return found->second.type;
 	}
 
-	// Gui Info found, determine readable type if necessary
-	if (found->second.type == UNDETERMINED)
+	if (found != _guis.end() && found->second.type != NOT_LOADED_YET)
 	{
-		found->second.type = determineGuiType(found->second.gui);
+		return found->second.type; // scanned before or failed to load
 	}
 
-	return found->second.type;
+	GuiType type = _typeIndex.getGuiType(guiPath);
+
+	// Load the GUI again to get the parse error into the error list
+	if (type == IMPORT_FAILURE)
+	{
+		loadGui(guiPath);
+	}
+	else if (found != _guis.end())
+	{
+		found->second.type = type;
+	}
+
+	return type;
+}
+
+void GuiManager::determineGuiTypes()
+{
+	ensureGuisLoaded();
+
+	// Collect the GUIs without a type
+	std::vector<GuiInfoMap::iterator> pending;
+
+	for (GuiInfoMap::iterator i = _guis.begin(); i != _guis.end(); ++i)
+	{
+		if (i->second.type == NOT_LOADED_YET || i->second.type == UNDETERMINED)
+		{
+			pending.push_back(i);
+		}
+	}
+
+	// Each worker is assigning the type of a different map entry
+	util::parallelForEach(pending.size(), [&](std::size_t index)
+	{
+		GuiInfo& info = pending[index]->second;
+
+		info.type = info.gui ? determineGuiType(info.gui) : _typeIndex.getGuiType(pending[index]->first);
+	});
+
+	// Load the GUIs which failed to parse again to get their errors into the error list
+	for (const auto& i : pending)
+	{
+		if (i->second.type == IMPORT_FAILURE)
+		{
+			loadGui(i->first);
+		}
+	}
+
+	_typeIndex.save();
 }
 
 GuiType GuiManager::determineGuiType(const GuiPtr& gui)
@@ -117,6 +170,7 @@ void GuiManager::clear()
     _guiLoader.reset();
 	_guis.clear();
 	_errorList.clear();
+	_typeIndex.clear();
 }
 
 IGuiPtr GuiManager::getGui(const std::string& guiPath)
@@ -128,8 +182,9 @@ IGuiPtr GuiManager::getGui(const std::string& guiPath)
 	// Path existent?
 	if (i != _guis.end())
 	{
-		// Found in the map, load if not yet attempted
-		if (i->second.type == NOT_LOADED_YET)
+		// Found in the map, load if not yet attempted. The type might
+		// already be known without the GUI having been parsed.
+		if (!i->second.gui && i->second.type != FILE_NOT_FOUND && i->second.type != IMPORT_FAILURE)
 		{
 			loadGui(guiPath);
 		}
@@ -192,6 +247,27 @@ GuiPtr GuiManager::loadGui(const std::string& guiPath)
 	}
 }
 
+GuiType GuiManager::parseGuiType(const std::string& guiPath)
+{
+	ArchiveTextFilePtr file = GlobalFileSystem().openTextFile(guiPath);
+
+	if (!file)
+	{
+		return FILE_NOT_FOUND;
+	}
+
+	try
+	{
+		parser::CodeTokeniser tokeniser(file, parser::WHITESPACE, "{}(),;");
+
+		return determineGuiType(Gui::createFromTokens(tokeniser));
+	}
+	catch (parser::ParseException&)
+	{
+		return IMPORT_FAILURE;
+	}
+}
+
 const std::string& GuiManager::getName() const
 {
 	static std::string _name(MODULE_GUIMANAGER);
@@ -218,8 +294,15 @@ void GuiManager::initialiseModule(const IApplicationContext& ctx)
 	init();
 }
 
+bool GuiManager::allowsConcurrentInitialisation() const
+{
+	// init() is just starting the GUI loader
+	return true;
+}
+
 void GuiManager::shutdownModule()
 {
+	_typeIndex.save();
 	clear();
 }
 
@@ -6,6 +6,7 @@
 #include "ifilesystem.h"
 #include "string/string.h"
 #include "ThreadedDefLoader.h"
+#include "GuiTypeIndex.h"
 
 namespace gui
 {
@@ -52,6 +53,9 @@ private:
 
     util::ThreadedDefLoader<void> _guiLoader;
 
+	// Determines the types of GUIs which haven't been parsed
+	GuiTypeIndex _typeIndex;
+
 	// A List of all the errors occuring lastly.
 	StringList _errorList;
 
@@ -71,6 +75,9 @@ public:
 	// Returns the GUI appearance type for the given GUI path
 	GuiType getGuiType(const std::string& guiPath) override;
 
+	// Determines the types of all known GUIs in parallel
+	void determineGuiTypes() override;
+
 	// Reload the gui
 	void reloadGui(const std::string& guiPath) override;
 
@@ -84,6 +91,7 @@ public:
 	const std::string& getName() const override;
 	const StringSet& getDependencies() const override;
 	void initialiseModule(const IApplicationContext& ctx) override;
+	bool allowsConcurrentInitialisation() const override;
 	void shutdownModule() override;
 
 private:
@@ -99,6 +107,10 @@ private:
 
 	GuiPtr loadGui(const std::string& guiPath);
 
+	// Parses the given GUI without storing it, returns its type or IMPORT_FAILURE.
+	// Used by the type index, this is safe to be called from multiple threads.
+	GuiType parseGuiType(const std::string& guiPath);
+
     // Used by findGuis()
     void registerGui(const std::string& guiPath);
 };
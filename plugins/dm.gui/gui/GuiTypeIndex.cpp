@@ -0,0 +1,255 @@
+#include "GuiTypeIndex.h"
+
+#include "iarchive.h"
+#include "ifilesystem.h"
+#include "itextstream.h"
+#include "imodule.h"
+
+#include <algorithm>
+#include <functional>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+
+namespace gui
+{
+
+namespace
+{
+	const char* const INDEX_FILENAME = "guitypes.index";
+
+	// The names of the windowDefs identifying readable GUIs
+	const char* const ONE_SIDED_WINDOWDEF = "body";
+	const char* const TWO_SIDED_WINDOWDEF = "leftBody";
+}
+
+GuiTypeIndex::GuiTypeIndex(const std::function<GuiType(const std::string&)>& parseGui) :
+	_loaded(false),
+	_changed(false),
+	_parseGui(parseGui)
+{}
+
+GuiType GuiTypeIndex::getGuiType(const std::string& guiPath)
+{
+	ensureLoaded();
+
+	IndexEntry entry{ NOT_LOADED_YET, 0 };
+
+	{
+		std::lock_guard<std::mutex> lock(_indexLock);
+
+		auto found = _index.find(guiPath);
+
+		if (found != _index.end())
+		{
+			entry = found->second;
+		}
+	}
+
+	// Check the modification times outside the lock
+	if (entry.type != NOT_LOADED_YET && entry.stamp == calculateStamp(guiPath, entry.includes))
+	{
+		return entry.type;
+	}
+
+	entry.includes.clear();
+
+	bool hasOneSidedBody = false;
+	bool hasTwoSidedBody = false;
+
+	// Walk the GUI and its includes, the stack is used to catch include loops
+	std::vector<std::string> fileStack;
+
+	std::function<bool(const std::string&, std::size_t)> visitFile =
+		[&](const std::string& path, std::size_t depth)
+	{
+		auto file = getScannedFile(path);
+
+		if (!file->exists)
+		{
+			return false;
+		}
+
+		fileStack.push_back(path);
+
+		for (const auto& statement : file->statements)
+		{
+			if (!statement.isInclude)
+			{
+				// The top-level windowDef is the desktop, it doesn't count
+				if (depth + statement.depth > 0)
+				{
+					hasOneSidedBody |= statement.name == ONE_SIDED_WINDOWDEF;
+					hasTwoSidedBody |= statement.name == TWO_SIDED_WINDOWDEF;
+				}
+			}
+			else if (std::find(fileStack.begin(), fileStack.end(), statement.name) == fileStack.end())
+			{
+				entry.includes.push_back(statement.name);
+				visitFile(statement.name, depth + statement.depth);
+			}
+		}
+
+		fileStack.pop_back();
+
+		return true;
+	};
+
+	if (!visitFile(guiPath, 0))
+	{
+		return FILE_NOT_FOUND;
+	}
+
+	// Readables need to be parsed to rule out import failures,
+	// the parsed GUI is also taking care of the #ifdef branches
+	entry.type = hasOneSidedBody || hasTwoSidedBody ? _parseGui(guiPath) : NO_READABLE;
+
+	if (entry.type == FILE_NOT_FOUND)
+	{
+		return FILE_NOT_FOUND;
+	}
+
+	entry.stamp = calculateStamp(guiPath, entry.includes);
+
+	std::lock_guard<std::mutex> lock(_indexLock);
+
+	_index[guiPath] = entry;
+	_changed = true;
+
+	return entry.type;
+}
+
+GuiTypeIndex::ScannedFilePtr GuiTypeIndex::getScannedFile(const std::string& path)
+{
+	auto modificationTime = GlobalFileSystem().getFileModificationTime(path);
+
+	{
+		std::lock_guard<std::mutex> lock(_scannedFilesLock);
+
+		auto found = _scannedFiles.find(path);
+
+		if (found != _scannedFiles.end() && found->second->modificationTime == modificationTime)
+		{
+			return found->second;
+		}
+	}
+
+	auto scannedFile = std::make_shared<ScannedFile>();
+	scannedFile->modificationTime = modificationTime;
+
+	auto file = GlobalFileSystem().openTextFile(path);
+	scannedFile->exists = file != nullptr;
+
+	if (file)
+	{
+		std::istream stream(&file->getInputStream());
+		std::string text((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+		scannedFile->statements = parser::GuiSourceScanner::findStatements(text,
+			{ ONE_SIDED_WINDOWDEF, TWO_SIDED_WINDOWDEF });
+	}
+
+	std::lock_guard<std::mutex> lock(_scannedFilesLock);
+
+	_scannedFiles[path] = scannedFile;
+
+	return scannedFile;
+}
+
+std::int64_t GuiTypeIndex::calculateStamp(const std::string& guiPath, const std::vector<std::string>& includes)
+{
+	auto stamp = static_cast<std::uint64_t>(GlobalFileSystem().getFileModificationTime(guiPath));
+
+	for (const auto& include : includes)
+	{
+		stamp = stamp * 31 + static_cast<std::uint64_t>(GlobalFileSystem().getFileModificationTime(include));
+	}
+
+	return static_cast<std::int64_t>(stamp);
+}
+
+void GuiTypeIndex::ensureLoaded()
+{
+	std::lock_guard<std::mutex> lock(_indexLock);
+
+	if (_loaded) return;
+
+	_loaded = true;
+	_indexPath = module::GlobalModuleRegistry().getApplicationContext().getSettingsPath() + INDEX_FILENAME;
+
+	// One GUI per line: <type> <stamp> <path> [<include>...], tab-separated
+	std::ifstream stream(_indexPath);
+	std::string line;
+
+	while (std::getline(stream, line))
+	{
+		std::istringstream fields(line);
+		std::string type, stamp, path, include;
+
+		if (!std::getline(fields, type, '\t') || !std::getline(fields, stamp, '\t') ||
+			!std::getline(fields, path, '\t'))
+		{
+			continue;
+		}
+
+		try
+		{
+			IndexEntry entry{ static_cast<GuiType>(std::stoi(type)), std::stoll(stamp) };
+
+			if (entry.type != ONE_SIDED_READABLE && entry.type != TWO_SIDED_READABLE &&
+				entry.type != NO_READABLE && entry.type != IMPORT_FAILURE)
+			{
+				continue;
+			}
+
+			while (std::getline(fields, include, '\t'))
+			{
+				entry.includes.push_back(include);
+			}
+
+			_index[path] = entry;
+		}
+		catch (std::logic_error&)
+		{
+			continue; // std::invalid_argument or std::out_of_range
+		}
+	}
+}
+
+void GuiTypeIndex::save()
+{
+	std::lock_guard<std::mutex> lock(_indexLock);
+
+	if (!_changed) return;
+
+	_changed = false;
+
+	std::ofstream stream(_indexPath);
+
+	if (!stream)
+	{
+		rWarning() << "[GuiTypeIndex] Cannot write " << _indexPath << std::endl;
+		return;
+	}
+
+	for (const auto& pair : _index)
+	{
+		stream << pair.second.type << '\t' << pair.second.stamp << '\t' << pair.first;
+
+		for (const auto& include : pair.second.includes)
+		{
+			stream << '\t' << include;
+		}
+
+		stream << '\n';
+	}
+}
+
+void GuiTypeIndex::clear()
+{
+	std::lock_guard<std::mutex> lock(_scannedFilesLock);
+
+	_scannedFiles.clear();
+}
+
+} // namespace
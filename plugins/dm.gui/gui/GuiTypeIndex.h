@@ -0,0 +1,98 @@
+#pragma once
+
+#include "igui.h"
+#include "parser/GuiSourceScanner.h"
+
+#include <map>
+#include <functional>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace gui
+{
+
+/**
+ * Determines the readable type of a GUI file by scanning it for the
+ * "body" and "leftBody" windowDefs, without constructing the GUI itself.
+ * The scan doesn't validate the GUI code, so GUIs found to be readables
+ * are handed to the given parse function, which is determining their
+ * final type (including IMPORT_FAILURE).
+ *
+ * The scanned files are kept in memory, such that include files shared by many
+ * GUIs are only read once. The resulting types are stored in an index file in
+ * the settings folder, along with the modification times of the GUI and its
+ * #includes, which is making the types of unchanged GUIs available right away.
+ *
+ * Unlike the full parser, the scan is not expanding any #define macros and
+ * is considering all #ifdef branches.
+ *
+ * All public methods are safe to be called from multiple threads.
+ */
+class GuiTypeIndex
+{
+private:
+	struct ScannedFile
+	{
+		// Modification time at the point the file has been scanned
+		std::int64_t modificationTime;
+
+		bool exists;
+
+		std::vector<parser::GuiSourceScanner::Statement> statements;
+	};
+	typedef std::shared_ptr<ScannedFile> ScannedFilePtr;
+
+	// Files scanned so far, by VFS path
+	std::map<std::string, ScannedFilePtr> _scannedFiles;
+	std::mutex _scannedFilesLock;
+
+	struct IndexEntry
+	{
+		GuiType type;
+
+		// Combined modification times of the GUI and its includes
+		std::int64_t stamp;
+
+		// All files included by the GUI, in the order they're visited
+		std::vector<std::string> includes;
+	};
+
+	// Persisted types by VFS path
+	std::map<std::string, IndexEntry> _index;
+	std::mutex _indexLock;
+
+	std::string _indexPath;
+	bool _loaded;
+	bool _changed;
+
+	// Parses the given GUI and returns its type, called from multiple threads
+	std::function<GuiType(const std::string&)> _parseGui;
+
+public:
+	GuiTypeIndex(const std::function<GuiType(const std::string&)>& parseGui);
+
+	// Returns the type of the given GUI, scanning the file if the index doesn't know
+	// the type yet or if the GUI or any of its includes changed in the meantime.
+	// Returns FILE_NOT_FOUND for non-existent files.
+	GuiType getGuiType(const std::string& guiPath);
+
+	// Writes the index to disk, if anything changed
+	void save();
+
+	// Releases the memory held by the scanned files
+	void clear();
+
+private:
+	void ensureLoaded();
+
+	// Returns the scanned file, (re-)scanning it if necessary
+	ScannedFilePtr getScannedFile(const std::string& path);
+
+	// Combines the modification times of the given files into a single stamp
+	static std::int64_t calculateStamp(const std::string& guiPath, const std::vector<std::string>& includes);
+};
+
+} // namespace
@@ -1,13 +1,190 @@
 #include "BrushInterface.h"
 
+#include "iundo.h"
 #include "../SceneNodeBuffer.h"
 #include <pybind11/stl_bind.h>
+#include <stdexcept>
 
-PYBIND11_MAKE_OPAQUE(IWinding);
+PYBIND11_MAKE_OPAQUE(script::ScriptWinding);
 
 namespace script
 {
 
+namespace
+{
+	const std::size_t PLANE_COLUMNS = 4;
+	const std::size_t TEXTURE_MATRIX_COLUMNS = 6;
+
+	typedef std::vector<IBrush*> Brushes;
+
+	Brushes getBrushes(const py::list& nodes)
+	{
+		Brushes brushes;
+
+		for (auto item : nodes)
+		{
+			IBrush* brush = Node_getIBrush(item.cast<ScriptSceneNode>());
+
+			if (brush != nullptr)
+			{
+				brushes.push_back(brush);
+			}
+		}
+
+		return brushes;
+	}
+
+	std::size_t getNumFaces(const Brushes& brushes)
+	{
+		std::size_t numFaces = 0;
+
+		for (IBrush* brush : brushes)
+		{
+			numFaces += brush->getNumFaces();
+		}
+
+		return numFaces;
+	}
+
+	// Collects one row of values per face
+	NumericArray readFaces(const Brushes& brushes, std::size_t columns,
+		const std::function<void(const IFace&, double*)>& readFace)
+	{
+		NumericArray values(getNumFaces(brushes), columns);
+		std::size_t row = 0;
+
+		for (IBrush* brush : brushes)
+		{
+			for (std::size_t i = 0; i < brush->getNumFaces(); ++i)
+			{
+				readFace(brush->getFace(i), values.row(row++));
+			}
+		}
+
+		return values;
+	}
+
+	// Applies one row of values per face, all within one undoable operation
+	void writeFaces(const Brushes& brushes, py::buffer buffer, std::size_t columns,
+		const std::string& command, const std::function<void(IFace&, const double*)>& writeFace)
+	{
+		NumericArray values = NumericArray::FromBuffer(buffer, columns);
+		std::size_t numFaces = getNumFaces(brushes);
+
+		if (values.getRows() != numFaces)
+		{
+			throw std::invalid_argument("Expected " + std::to_string(numFaces) + " rows, one per face, got " +
+				std::to_string(values.getRows()));
+		}
+
+		UndoableCommand cmd(command);
+		std::size_t row = 0;
+
+		for (IBrush* brush : brushes)
+		{
+			for (std::size_t i = 0; i < brush->getNumFaces(); ++i)
+			{
+				IFace& face = brush->getFace(i);
+
+				face.undoSave();
+				writeFace(face, values.row(row++));
+			}
+		}
+	}
+
+	void readPlane(const IFace& face, double* row)
+	{
+		const Plane3& plane = face.getPlane3();
+
+		row[0] = plane.normal().x();
+		row[1] = plane.normal().y();
+		row[2] = plane.normal().z();
+		row[3] = plane.dist();
+	}
+
+	void writePlane(IFace& face, const double* row)
+	{
+		face.setPlane3(Plane3(row[0], row[1], row[2], row[3]));
+	}
+
+	void readTextureMatrix(const IFace& face, double* row)
+	{
+		Matrix4 matrix = face.getTexDefMatrix();
+
+		row[0] = matrix.xx();
+		row[1] = matrix.yx();
+		row[2] = matrix.tx();
+		row[3] = matrix.xy();
+		row[4] = matrix.yy();
+		row[5] = matrix.ty();
+	}
+
+	void writeTextureMatrix(IFace& face, const double* row)
+	{
+		Matrix4 matrix = Matrix4::getIdentity();
+
+		matrix.xx() = row[0];
+		matrix.yx() = row[1];
+		matrix.tx() = row[2];
+		matrix.xy() = row[3];
+		matrix.yy() = row[4];
+		matrix.ty() = row[5];
+
+		face.setTexDefMatrix(matrix);
+	}
+}
+
+ScriptWindingVertex::ScriptWindingVertex() :
+	_face(nullptr),
+	_index(0)
+{}
+
+ScriptWindingVertex::ScriptWindingVertex(IFace& face, std::size_t index) :
+	_face(&face),
+	_index(index)
+{}
+
+bool ScriptWindingVertex::isValid() const
+{
+	return _face != nullptr && _index < _face->getWinding().size();
+}
+
+Vector3 ScriptWindingVertex::getVertex() const
+{
+	if (!isValid()) return Vector3(0, 0, 0);
+	return _face->getWinding()[_index].vertex;
+}
+
+Vector2 ScriptWindingVertex::getTexcoord() const
+{
+	if (!isValid()) return Vector2(0, 0);
+	return _face->getTexcoord(_index);
+}
+
+Vector3 ScriptWindingVertex::getNormal() const
+{
+	if (!isValid()) return Vector3(0, 0, 0);
+	return _face->getPlane3().normal();
+}
+
+Vector3 ScriptWindingVertex::getTangent() const
+{
+	if (!isValid()) return Vector3(0, 0, 0);
+	return ScriptFace(*_face).getTangent();
+}
+
+Vector3 ScriptWindingVertex::getBitangent() const
+{
+	if (!isValid()) return Vector3(0, 0, 0);
+	return ScriptFace(*_face).getBitangent();
+}
+
+std::size_t ScriptWindingVertex::getAdjacent() const
+{
+	if (!isValid()) return 0;
+	return _face->getWinding()[_index].adjacent;
+}
+
 ScriptFace::ScriptFace() :
 	_face(NULL)
 {}
@@ -70,14 +247,47 @@ void ScriptFace::normaliseTexture()
 	_face->normaliseTexture();
 }
 
-IWinding& ScriptFace::getWinding()
+ScriptWinding ScriptFace::getWinding()
+{
+	ScriptWinding winding;
+
+	if (_face == NULL) return winding;
+
+	for (std::size_t i = 0; i < _face->getWinding().size(); ++i)
+	{
+		winding.emplace_back(*_face, i);
+	}
+
+	return winding;
+}
+
+Vector3 ScriptFace::getNormal() const
+{
+	if (_face == NULL) return Vector3(0, 0, 0);
+	return _face->getPlane3().normal();
+}
+
+Vector3 ScriptFace::getTangent() const
 {
-	if (_face == NULL) return _emptyWinding;
-	return _face->getWinding();
+	if (_face == NULL) return Vector3(0, 0, 0);
+
+	Vector3 tangent, bitangent;
+	_face->getTextureAxes(tangent, bitangent);
+
+	return tangent;
+}
+
+Vector3 ScriptFace::getBitangent() const
+{
+	if (_face == NULL) return Vector3(0, 0, 0);
+
+	Vector3 tangent, bitangent;
+	_face->getTextureAxes(tangent, bitangent);
+
+	return bitangent;
 }
 
 std::string ScriptFace::_emptyShader;
-IWinding ScriptFace::_emptyWinding;
 
 ScriptBrushNode::ScriptBrushNode(const scene::INodePtr& node) :
 	ScriptSceneNode((node != NULL && Node_isBrush(node)) ? node : scene::INodePtr())
@@ -174,6 +384,38 @@ void ScriptBrushNode::undoSave()
 	brushNode->getIBrush().undoSave();
 }
 
+NumericArray ScriptBrushNode::getFacePlanes()
+{
+	IBrush* brush = Node_getIBrush(_node.lock());
+	if (brush == NULL) return NumericArray(0, PLANE_COLUMNS);
+
+	return readFaces(Brushes{ brush }, PLANE_COLUMNS, readPlane);
+}
+
+void ScriptBrushNode::setFacePlanes(py::buffer planes)
+{
+	IBrush* brush = Node_getIBrush(_node.lock());
+	if (brush == NULL) return;
+
+	writeFaces(Brushes{ brush }, planes, PLANE_COLUMNS, "setFacePlanes", writePlane);
+}
+
+NumericArray ScriptBrushNode::getFaceTextureMatrices()
+{
+	IBrush* brush = Node_getIBrush(_node.lock());
+	if (brush == NULL) return NumericArray(0, TEXTURE_MATRIX_COLUMNS);
+
+	return readFaces(Brushes{ brush }, TEXTURE_MATRIX_COLUMNS, readTextureMatrix);
+}
+
+void ScriptBrushNode::setFaceTextureMatrices(py::buffer matrices)
+{
+	IBrush* brush = Node_getIBrush(_node.lock());
+	if (brush == NULL) return;
+
+	writeFaces(Brushes{ brush }, matrices, TEXTURE_MATRIX_COLUMNS, "setFaceTextureMatrices", writeTextureMatrix);
+}
+
 // Checks if the given SceneNode structure is a BrushNode
 bool ScriptBrushNode::isBrush(const ScriptSceneNode& node) 
 {
@@ -203,20 +445,40 @@ ScriptSceneNode BrushInterface::createBrush()
 	return ScriptSceneNode(node);
 }
 
+NumericArray BrushInterface::getFacePlanes(const py::list& brushes)
+{
+	return readFaces(getBrushes(brushes), PLANE_COLUMNS, readPlane);
+}
+
+void BrushInterface::setFacePlanes(const py::list& brushes, py::buffer planes)
+{
+	writeFaces(getBrushes(brushes), planes, PLANE_COLUMNS, "setFacePlanes", writePlane);
+}
+
+NumericArray BrushInterface::getFaceTextureMatrices(const py::list& brushes)
+{
+	return readFaces(getBrushes(brushes), TEXTURE_MATRIX_COLUMNS, readTextureMatrix);
+}
+
+void BrushInterface::setFaceTextureMatrices(const py::list& brushes, py::buffer matrices)
+{
+	writeFaces(getBrushes(brushes), matrices, TEXTURE_MATRIX_COLUMNS, "setFaceTextureMatrices", writeTextureMatrix);
+}
+
 void BrushInterface::registerInterface(py::module& scope, py::dict& globals)
 {
-	// Define a WindingVertex structure
-	py::class_<WindingVertex> vertex(scope, "WindingVertex");
+	// Define a WindingVertex structure, all its properties are read-only
+	py::class_<ScriptWindingVertex> vertex(scope, "WindingVertex");
 	vertex.def(py::init<>());
-	vertex.def_readonly("vertex", &WindingVertex::vertex);
-	vertex.def_readonly("texcoord", &WindingVertex::texcoord);
-	vertex.def_readonly("tangent", &WindingVertex::tangent);
-	vertex.def_readonly("bitangent", &WindingVertex::bitangent);
-	vertex.def_readonly("normal", &WindingVertex::normal);
-	vertex.def_readonly("adjacent", &WindingVertex::adjacent);
+	vertex.def_property_readonly("vertex", &ScriptWindingVertex::getVertex);
+	vertex.def_property_readonly("texcoord", &ScriptWindingVertex::getTexcoord);
+	vertex.def_property_readonly("normal", &ScriptWindingVertex::getNormal);
+	vertex.def_property_readonly("tangent", &ScriptWindingVertex::getTangent);
+	vertex.def_property_readonly("bitangent", &ScriptWindingVertex::getBitangent);
+	vertex.def_property_readonly("adjacent", &ScriptWindingVertex::getAdjacent);
 	
-	// Declare the IWinding vector
-	py::bind_vector<IWinding>(scope, "Winding");
+	// Declare the winding vector
+	py::bind_vector<ScriptWinding>(scope, "Winding");
 
 	// Define a "Face" interface
 	py::class_<ScriptFace> face(scope, "Face");
@@ -231,7 +493,10 @@ void BrushInterface::registerInterface(py::module& scope, py::dict& globals)
 	face.def("fitTexture", &ScriptFace::fitTexture);
 	face.def("flipTexture", &ScriptFace::flipTexture);
 	face.def("normaliseTexture", &ScriptFace::normaliseTexture);
-	face.def("getWinding", &ScriptFace::getWinding, py::return_value_policy::reference);
+	face.def("getWinding", &ScriptFace::getWinding);
+	face.def("getNormal", &ScriptFace::getNormal);
+	face.def("getTangent", &ScriptFace::getTangent);
+	face.def("getBitangent", &ScriptFace::getBitangent);
 
 	// Define a BrushNode interface
 	py::class_<ScriptBrushNode, ScriptSceneNode> brush(scope, "BrushNode");
@@ -247,10 +512,18 @@ void BrushInterface::registerInterface(py::module& scope, py::dict& globals)
 	brush.def("getFace", &ScriptBrushNode::getFace);
 	brush.def("getDetailFlag", &ScriptBrushNode::getDetailFlag);
 	brush.def("setDetailFlag", &ScriptBrushNode::setDetailFlag);
+	brush.def("getFacePlanes", &ScriptBrushNode::getFacePlanes);
+	brush.def("setFacePlanes", &ScriptBrushNode::setFacePlanes);
+	brush.def("getFaceTextureMatrices", &ScriptBrushNode::getFaceTextureMatrices);
+	brush.def("setFaceTextureMatrices", &ScriptBrushNode::setFaceTextureMatrices);
 
 	// Define the BrushCreator interface
 	py::class_<BrushInterface> brushCreator(scope, "BrushCreator");
 	brushCreator.def("createBrush", &BrushInterface::createBrush);
+	brushCreator.def("getFacePlanes", &BrushInterface::getFacePlanes);
+	brushCreator.def("setFacePlanes", &BrushInterface::setFacePlanes);
+	brushCreator.def("getFaceTextureMatrices", &BrushInterface::getFaceTextureMatrices);
+	brushCreator.def("setFaceTextureMatrices", &BrushInterface::setFaceTextureMatrices);
 
 	// Now point the Python variable "GlobalBrushCreator" to this instance
 	globals["GlobalBrushCreator"] = this;
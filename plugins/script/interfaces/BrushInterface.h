@@ -4,16 +4,48 @@
 #include "ibrush.h"
 
 #include "SceneGraphInterface.h"
+#include "NumericArray.h"
 
 namespace script 
 {
 
+// A winding vertex as exposed to scripts. Texture coordinates, normal
+// and texture axes are not stored per vertex, they are retrieved from the face.
+class ScriptWindingVertex
+{
+private:
+	IFace* _face;
+	std::size_t _index;
+
+public:
+	ScriptWindingVertex();
+
+	ScriptWindingVertex(IFace& face, std::size_t index);
+
+	Vector3 getVertex() const;
+	Vector2 getTexcoord() const;
+	Vector3 getNormal() const;
+	Vector3 getTangent() const;
+	Vector3 getBitangent() const;
+	std::size_t getAdjacent() const;
+
+	// Needed by the vector binding
+	bool operator==(const ScriptWindingVertex& other) const
+	{
+		return _face == other._face && _index == other._index;
+	}
+
+private:
+	bool isValid() const;
+};
+
+typedef std::vector<ScriptWindingVertex> ScriptWinding;
+
 class ScriptFace
 {
 private:
 	IFace* _face;
 	static std::string _emptyShader;
-	static IWinding _emptyWinding;
 
 public:
 	ScriptFace();
@@ -38,7 +70,12 @@ public:
 
 	void normaliseTexture();
 
-	IWinding& getWinding();
+	ScriptWinding getWinding();
+
+	// Normal and texture axes, these are the same for all winding vertices
+	Vector3 getNormal() const;
+	Vector3 getTangent() const;
+	Vector3 getBitangent() const;
 };
 
 class ScriptBrushNode :
@@ -86,6 +123,22 @@ public:
 	// Call this before manipulating the brush to make your action undo-able.
 	void undoSave();
 
+	// Returns the planes of all faces as (numFaces x 4) array,
+	// each row holding the normal's x, y, z and the distance
+	NumericArray getFacePlanes();
+
+	// Assigns the planes of all faces at once, one row per face.
+	// The change is recorded as a single undo step.
+	void setFacePlanes(py::buffer planes);
+
+	// Returns the texture matrices of all faces as (numFaces x 6) array,
+	// each row holding xx, yx, tx, xy, yy, ty
+	NumericArray getFaceTextureMatrices();
+
+	// Assigns the texture matrices of all faces at once, one row per face.
+	// The change is recorded as a single undo step.
+	void setFaceTextureMatrices(py::buffer matrices);
+
 	// Checks if the given SceneNode structure is a BrushNode
 	static bool isBrush(const ScriptSceneNode& node);
 
@@ -100,6 +153,14 @@ class BrushInterface :
 public:
 	ScriptSceneNode createBrush();
 
+	// Bulk variants of the BrushNode methods, operating on the faces of all
+	// brushes in the given list (non-brush nodes are ignored). The rows are
+	// ordered by brush, then by face index. Each setter creates a single undo step.
+	NumericArray getFacePlanes(const py::list& brushes);
+	void setFacePlanes(const py::list& brushes, py::buffer planes);
+	NumericArray getFaceTextureMatrices(const py::list& brushes);
+	void setFaceTextureMatrices(const py::list& brushes, py::buffer matrices);
+
 	// IScriptInterface implementation
 	void registerInterface(py::module& scope, py::dict& globals) override;
 };
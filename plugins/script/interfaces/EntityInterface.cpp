@@ -4,13 +4,55 @@
 
 #include "ientity.h"
 #include "ieclass.h"
+#include "iundo.h"
 #include "itextstream.h"
 
 #include "../SceneNodeBuffer.h"
+#include <stdexcept>
 
 namespace script 
 {
 
+namespace
+{
+	std::vector<Entity*> getEntities(const py::list& nodes)
+	{
+		std::vector<Entity*> entities;
+
+		for (auto item : nodes)
+		{
+			Entity* entity = Node_getEntity(item.cast<ScriptSceneNode>());
+
+			if (entity != nullptr)
+			{
+				entities.push_back(entity);
+			}
+		}
+
+		return entities;
+	}
+
+	py::dict getKeyValueDict(const Entity& entity)
+	{
+		py::dict keyValues;
+
+		entity.forEachKeyValue([&](const std::string& key, const std::string& value)
+		{
+			keyValues[py::str(key)] = py::str(value);
+		});
+
+		return keyValues;
+	}
+
+	void setKeyValuesFromDict(Entity& entity, const py::dict& keyValues)
+	{
+		for (auto pair : keyValues)
+		{
+			entity.setKeyValue(pair.first.cast<std::string>(), pair.second.cast<std::string>());
+		}
+	}
+}
+
 // Constructor, checks if the passed node is actually an entity
 ScriptEntityNode::ScriptEntityNode(const scene::INodePtr& node) :
 	ScriptSceneNode((node != NULL && Node_isEntity(node)) ? node : scene::INodePtr())
@@ -69,6 +111,21 @@ void ScriptEntityNode::forEachKeyValue(EntityVisitor& visitor) {
 	}
 }
 
+py::dict ScriptEntityNode::getKeyValueTable()
+{
+	Entity* entity = Node_getEntity(*this);
+	return entity != nullptr ? getKeyValueDict(*entity) : py::dict();
+}
+
+void ScriptEntityNode::setKeyValueTable(const py::dict& keyValues)
+{
+	Entity* entity = Node_getEntity(*this);
+	if (entity == nullptr) return;
+
+	UndoableCommand cmd("setKeyValueTable");
+	setKeyValuesFromDict(*entity, keyValues);
+}
+
 // Checks if the given SceneNode structure is a BrushNode
 bool ScriptEntityNode::isEntity(const ScriptSceneNode& node) {
 	return Node_isEntity(node);
@@ -119,6 +176,36 @@ ScriptSceneNode EntityInterface::createEntity(const std::string& eclassName) {
 	return ScriptSceneNode(node);
 }
 
+py::list EntityInterface::getKeyValueTables(const py::list& entities)
+{
+	py::list tables;
+
+	for (Entity* entity : getEntities(entities))
+	{
+		tables.append(getKeyValueDict(*entity));
+	}
+
+	return tables;
+}
+
+void EntityInterface::setKeyValueTables(const py::list& entities, const py::list& keyValueTables)
+{
+	auto targets = getEntities(entities);
+
+	if (targets.size() != keyValueTables.size())
+	{
+		throw std::invalid_argument("Expected " + std::to_string(targets.size()) +
+			" dictionaries, one per entity, got " + std::to_string(keyValueTables.size()));
+	}
+
+	UndoableCommand cmd("setKeyValueTables");
+
+	for (std::size_t i = 0; i < targets.size(); ++i)
+	{
+		setKeyValuesFromDict(*targets[i], keyValueTables[i].cast<py::dict>());
+	}
+}
+
 struct EntityKeyValuePair :
 	public std::pair<std::string, std::string>
 {
@@ -148,6 +235,8 @@ void EntityInterface::registerInterface(py::module& scope, py::dict& globals)
 	entityNode.def("isModel", &ScriptEntityNode::isModel);
 	entityNode.def("isOfType", &ScriptEntityNode::isOfType);
 	entityNode.def("getKeyValuePairs", &ScriptEntityNode::getKeyValuePairs);
+	entityNode.def("getKeyValueTable", &ScriptEntityNode::getKeyValueTable);
+	entityNode.def("setKeyValueTable", &ScriptEntityNode::setKeyValueTable);
 
 	// Declare the KeyValuePairs vector
 	py::bind_vector<Entity::KeyValuePairs>(scope, "EntityKeyValuePairs");
@@ -163,6 +252,8 @@ void EntityInterface::registerInterface(py::module& scope, py::dict& globals)
 	// Add both overloads to createEntity
 	entityCreator.def("createEntity", static_cast<ScriptSceneNode(EntityInterface::*)(const std::string&)>(&EntityInterface::createEntity));
 	entityCreator.def("createEntity", static_cast<ScriptSceneNode(EntityInterface::*)(const ScriptEntityClass&)>(&EntityInterface::createEntity));
+	entityCreator.def("getKeyValueTables", &EntityInterface::getKeyValueTables);
+	entityCreator.def("setKeyValueTables", &EntityInterface::setKeyValueTables);
 
 	// Now point the Python variable "GlobalEntityCreator" to this instance
 	globals["GlobalEntityCreator"] = this;
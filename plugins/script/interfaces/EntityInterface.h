@@ -39,6 +39,13 @@ public:
 	// Visit each keyvalue, wraps to the contained entity
 	void forEachKeyValue(EntityVisitor& visitor);
 
+	// Returns all spawnargs of this entity as key => value dictionary
+	py::dict getKeyValueTable();
+
+	// Assigns all key/value pairs of the given dictionary at once (an empty
+	// value removes the key). The change is recorded as a single undo step.
+	void setKeyValueTable(const py::dict& keyValues);
+
 	// Checks if the given SceneNode structure is an EntityNode
 	static bool isEntity(const ScriptSceneNode& node);
 
@@ -78,6 +85,12 @@ public:
 	// Creates a new entity for the named entityclass
 	ScriptSceneNode createEntity(const std::string& eclassName);
 
+	// Bulk variants of the EntityNode methods: returns one dictionary per entity
+	// in the given list, and assigns one dictionary per entity (non-entity nodes
+	// are ignored). The setter creates a single undo step.
+	py::list getKeyValueTables(const py::list& entities);
+	void setKeyValueTables(const py::list& entities, const py::list& keyValueTables);
+
 	// IScriptInterface implementation
 	void registerInterface(py::module& scope, py::dict& globals) override;
 };
@@ -1,4 +1,5 @@
 #include "MathInterface.h"
+#include "NumericArray.h"
 
 #include <pybind11/pybind11.h>
 #include <pybind11/operators.h>
@@ -114,6 +115,9 @@ void MathInterface::registerInterface(py::module& scope, py::dict& globals)
 	aabb.def("getRadius", &AABB::getRadius);
 	aabb.def("includePoint", &AABB::includePoint);
 	aabb.def("includeAABB", &AABB::includeAABB);
+
+	// Array type used by the bulk accessors of the other interfaces
+	NumericArray::Register(scope);
 }
 
 } // namespace script
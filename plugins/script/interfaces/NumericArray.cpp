@@ -0,0 +1,130 @@
+#include "NumericArray.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace script
+{
+
+NumericArray::NumericArray(std::size_t rows, std::size_t columns) :
+	_data(rows * columns, 0.0),
+	_rows(rows),
+	_columns(columns)
+{}
+
+std::size_t NumericArray::getRows() const
+{
+	return _rows;
+}
+
+std::size_t NumericArray::getColumns() const
+{
+	return _columns;
+}
+
+double* NumericArray::row(std::size_t index)
+{
+	return _data.data() + index * _columns;
+}
+
+const double* NumericArray::row(std::size_t index) const
+{
+	return _data.data() + index * _columns;
+}
+
+NumericArray NumericArray::FromBuffer(py::buffer buffer, std::size_t columns)
+{
+	py::buffer_info info = buffer.request();
+
+	bool isDouble = info.format == py::format_descriptor<double>::format();
+	bool isFloat = info.format == py::format_descriptor<float>::format();
+
+	if (!isDouble && !isFloat)
+	{
+		throw std::invalid_argument("Expected a buffer of float64 or float32 values, got format " + info.format);
+	}
+
+	if (info.itemsize != (isDouble ? sizeof(double) : sizeof(float)))
+	{
+		throw std::invalid_argument("Unexpected item size " + std::to_string(info.itemsize) + " for format " + info.format);
+	}
+
+	if (info.ndim < 1 || info.ndim > 2 || info.shape.size() != info.ndim || info.strides.size() != info.ndim)
+	{
+		throw std::invalid_argument("Expected a one- or two-dimensional buffer, got " + std::to_string(info.ndim) + " dimensions");
+	}
+
+	if (columns == 0)
+	{
+		throw std::invalid_argument("The number of columns must not be zero");
+	}
+
+	// Shape and strides are stored unsigned, but strides are negative for
+	// reversed views, all offsets are calculated in signed arithmetic
+	py::ssize_t columnCount = static_cast<py::ssize_t>(columns);
+	py::ssize_t rows = 0;
+	py::ssize_t rowStride = 0;
+	py::ssize_t columnStride = 0;
+
+	if (info.ndim == 2 && static_cast<py::ssize_t>(info.shape[1]) == columnCount)
+	{
+		rows = static_cast<py::ssize_t>(info.shape[0]);
+		rowStride = static_cast<py::ssize_t>(info.strides[0]);
+		columnStride = static_cast<py::ssize_t>(info.strides[1]);
+	}
+	else if (info.ndim == 1 && static_cast<py::ssize_t>(info.shape[0]) % columnCount == 0)
+	{
+		rows = static_cast<py::ssize_t>(info.shape[0]) / columnCount;
+		columnStride = static_cast<py::ssize_t>(info.strides[0]);
+		rowStride = columnStride * columnCount;
+	}
+	else
+	{
+		throw std::invalid_argument("Expected a buffer with " + std::to_string(columns) + " values per row");
+	}
+
+	if (rows < 0)
+	{
+		throw std::invalid_argument("Invalid buffer shape");
+	}
+
+	NumericArray array(static_cast<std::size_t>(rows), columns);
+	const char* data = static_cast<const char*>(info.ptr);
+
+	for (py::ssize_t r = 0; r < rows; ++r)
+	{
+		double* target = array.row(static_cast<std::size_t>(r));
+
+		for (py::ssize_t c = 0; c < columnCount; ++c)
+		{
+			const char* source = data + r * rowStride + c * columnStride;
+
+			target[c] = isDouble ? *reinterpret_cast<const double*>(source) :
+				static_cast<double>(*reinterpret_cast<const float*>(source));
+		}
+	}
+
+	return array;
+}
+
+void NumericArray::Register(py::module& scope)
+{
+	py::class_<NumericArray> array(scope, "NumericArray", py::buffer_protocol());
+	array.def(py::init<std::size_t, std::size_t>());
+	array.def("getRows", &NumericArray::getRows);
+	array.def("getColumns", &NumericArray::getColumns);
+	array.def("__len__", &NumericArray::getRows);
+	array.def_buffer([](NumericArray& self)
+	{
+		return py::buffer_info(
+			self._data.data(),
+			sizeof(double),
+			py::format_descriptor<double>::format(),
+			2,
+			{ self._rows, self._columns },
+			{ sizeof(double) * self._columns, sizeof(double) }
+		);
+	});
+}
+
+} // namespace script
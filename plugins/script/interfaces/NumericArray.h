@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+namespace script
+{
+
+/**
+ * A two-dimensional, row-major array of doubles, used to pass bulk data
+ * (face planes, texture matrices, control points, ...) between C++ and Python
+ * in a single call instead of one call per element.
+ *
+ * Python sees this as an object supporting the buffer protocol, scripts can
+ * wrap it using memoryview() or numpy.asarray() without copying the data.
+ */
+class NumericArray
+{
+private:
+	std::vector<double> _data;
+	std::size_t _rows;
+	std::size_t _columns;
+
+public:
+	NumericArray(std::size_t rows, std::size_t columns);
+
+	std::size_t getRows() const;
+	std::size_t getColumns() const;
+
+	double* row(std::size_t index);
+	const double* row(std::size_t index) const;
+
+	// Copies the contents of the given Python buffer, which must hold float64
+	// or float32 values and have the given number of columns, either in a
+	// two-dimensional (rows x columns) or in a flat one-dimensional layout.
+	// Any strides are accepted, including the negative ones of reversed views.
+	// Throws std::invalid_argument (ValueError in Python) on mismatch.
+	static NumericArray FromBuffer(py::buffer buffer, std::size_t columns);
+
+	// Declares the NumericArray type in the given Python module
+	static void Register(py::module& scope);
+};
+
+} // namespace script
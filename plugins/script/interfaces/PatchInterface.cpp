@@ -4,13 +4,111 @@
 #include <pybind11/stl_bind.h>
 
 #include "ipatch.h"
+#include "iundo.h"
 #include "itextstream.h"
 
 #include "../SceneNodeBuffer.h"
+#include <stdexcept>
 
 namespace script 
 {
 
+namespace
+{
+	const std::size_t CONTROL_POINT_COLUMNS = 5;
+
+	typedef std::vector<IPatch*> Patches;
+
+	Patches getPatches(const py::list& nodes)
+	{
+		Patches patches;
+
+		for (auto item : nodes)
+		{
+			IPatch* patch = Node_getIPatch(item.cast<ScriptSceneNode>());
+
+			if (patch != nullptr)
+			{
+				patches.push_back(patch);
+			}
+		}
+
+		return patches;
+	}
+
+	NumericArray readControlPoints(const Patches& patches)
+	{
+		std::size_t numPoints = 0;
+
+		for (IPatch* patch : patches)
+		{
+			numPoints += patch->getWidth() * patch->getHeight();
+		}
+
+		NumericArray values(numPoints, CONTROL_POINT_COLUMNS);
+		std::size_t index = 0;
+
+		for (IPatch* patch : patches)
+		{
+			for (std::size_t row = 0; row < patch->getHeight(); ++row)
+			{
+				for (std::size_t col = 0; col < patch->getWidth(); ++col)
+				{
+					const PatchControl& ctrl = patch->ctrlAt(row, col);
+					double* target = values.row(index++);
+
+					target[0] = ctrl.vertex.x();
+					target[1] = ctrl.vertex.y();
+					target[2] = ctrl.vertex.z();
+					target[3] = ctrl.texcoord.x();
+					target[4] = ctrl.texcoord.y();
+				}
+			}
+		}
+
+		return values;
+	}
+
+	void writeControlPoints(const Patches& patches, py::buffer buffer)
+	{
+		NumericArray values = NumericArray::FromBuffer(buffer, CONTROL_POINT_COLUMNS);
+		std::size_t numPoints = 0;
+
+		for (IPatch* patch : patches)
+		{
+			numPoints += patch->getWidth() * patch->getHeight();
+		}
+
+		if (values.getRows() != numPoints)
+		{
+			throw std::invalid_argument("Expected " + std::to_string(numPoints) +
+				" rows, one per control point, got " + std::to_string(values.getRows()));
+		}
+
+		UndoableCommand cmd("setPatchControlPoints");
+		std::size_t index = 0;
+
+		for (IPatch* patch : patches)
+		{
+			patch->undoSave();
+
+			for (std::size_t row = 0; row < patch->getHeight(); ++row)
+			{
+				for (std::size_t col = 0; col < patch->getWidth(); ++col)
+				{
+					PatchControl& ctrl = patch->ctrlAt(row, col);
+					const double* source = values.row(index++);
+
+					ctrl.vertex = Vector3(source[0], source[1], source[2]);
+					ctrl.texcoord = Vector2(source[3], source[4]);
+				}
+			}
+
+			patch->controlPointsChanged();
+		}
+	}
+}
+
 ScriptPatchNode::ScriptPatchNode(const scene::INodePtr& node) :
 	ScriptSceneNode((node != NULL && Node_isPatch(node)) ? node : scene::INodePtr())
 {}
@@ -135,6 +233,22 @@ void ScriptPatchNode::controlPointsChanged()
 	patchNode->getPatch().controlPointsChanged();
 }
 
+NumericArray ScriptPatchNode::getControlPoints() const
+{
+	IPatch* patch = Node_getIPatch(_node.lock());
+	if (patch == NULL) return NumericArray(0, CONTROL_POINT_COLUMNS);
+
+	return readControlPoints(Patches{ patch });
+}
+
+void ScriptPatchNode::setControlPoints(py::buffer controlPoints)
+{
+	IPatch* patch = Node_getIPatch(_node.lock());
+	if (patch == NULL) return;
+
+	writeControlPoints(Patches{ patch }, controlPoints);
+}
+
 const std::string& ScriptPatchNode::getShader() const
 {
 	IPatchNodePtr patchNode = std::dynamic_pointer_cast<IPatchNode>(_node.lock());
@@ -211,6 +325,16 @@ ScriptSceneNode PatchInterface::createPatchDef3()
 	return ScriptSceneNode(node);
 }
 
+NumericArray PatchInterface::getControlPoints(const py::list& patches)
+{
+	return readControlPoints(getPatches(patches));
+}
+
+void PatchInterface::setControlPoints(const py::list& patches, py::buffer controlPoints)
+{
+	writeControlPoints(getPatches(patches), controlPoints);
+}
+
 void PatchInterface::registerInterface(py::module& scope, py::dict& globals) 
 {
 	py::class_<PatchControl> patchControl(scope, "PatchMeshControl");
@@ -266,12 +390,16 @@ void PatchInterface::registerInterface(py::module& scope, py::dict& globals)
 	patchNode.def("setFixedSubdivisions", &ScriptPatchNode::setFixedSubdivisions);
 	patchNode.def("controlPointsChanged", &ScriptPatchNode::controlPointsChanged);
 	patchNode.def("getTesselatedPatchMesh", &ScriptPatchNode::getTesselatedPatchMesh);
+	patchNode.def("getControlPoints", &ScriptPatchNode::getControlPoints);
+	patchNode.def("setControlPoints", &ScriptPatchNode::setControlPoints);
 
 	// Define the GlobalPatchCreator interface
 	py::class_<PatchInterface> patchCreator(scope, "PatchCreator");
 
 	patchCreator.def("createPatchDef2", &PatchInterface::createPatchDef2);
 	patchCreator.def("createPatchDef3", &PatchInterface::createPatchDef3);
+	patchCreator.def("getControlPoints", &PatchInterface::getControlPoints);
+	patchCreator.def("setControlPoints", &PatchInterface::setControlPoints);
 
 	// Now point the Python variable "GlobalPatchCreator" to this instance
 	globals["GlobalPatchCreator"] = this;
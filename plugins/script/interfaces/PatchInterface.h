@@ -4,6 +4,7 @@
 #include "ipatch.h"
 
 #include "SceneGraphInterface.h"
+#include "NumericArray.h"
 
 namespace script
 {
@@ -50,6 +51,14 @@ public:
 
 	void controlPointsChanged();
 
+	// Returns all control points as (width*height x 5) array, each row
+	// holding x, y, z, s, t. Rows are ordered row by row, then by column.
+	NumericArray getControlPoints() const;
+
+	// Assigns all control points at once, in the same layout as returned
+	// by getControlPoints(). The change is recorded as a single undo step.
+	void setControlPoints(py::buffer controlPoints);
+
 	// Shader handling
 	const std::string& getShader() const;
 	void setShader(const std::string& name);
@@ -68,6 +77,12 @@ public:
 	ScriptSceneNode createPatchDef2();
 	ScriptSceneNode createPatchDef3();
 
+	// Bulk variants of the PatchNode methods, operating on the control points of
+	// all patches in the given list (non-patch nodes are ignored). The rows are
+	// ordered by patch, then by control point. The setter creates a single undo step.
+	NumericArray getControlPoints(const py::list& patches);
+	void setControlPoints(const py::list& patches, py::buffer controlPoints);
+
 	// IScriptInterface implementation
 	void registerInterface(py::module& scope, py::dict& globals) override;
 };
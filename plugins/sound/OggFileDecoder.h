@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdexcept>
+
+#include <vorbis/vorbisfile.h>
+#include <fmt/format.h>
+
+#include "iarchive.h"
+#include "itextstream.h"
+#include "SoundDecoder.h"
+#include "OggFileStream.h"
+
+namespace sound
+{
+
+/**
+ * Decoder class turning an OGG file into 16 bit PCM data.
+ *
+ * The compressed file is held in memory, the PCM data is decoded
+ * chunk by chunk as it is requested.
+ */
+class OggFileDecoder :
+	public SoundDecoder
+{
+private:
+	OggFileStream _stream;
+	OggVorbis_File _oggFile;
+	SoundFileInfo _info;
+
+public:
+	/**
+	 * @throws: std::runtime_error if the file cannot be opened.
+	 */
+	OggFileDecoder(ArchiveFile& file) :
+		_stream(file)
+	{
+		// Setup the callbacks and point them to the helper class
+		ov_callbacks callbacks;
+		callbacks.read_func = OggFileStream::oggReadFunc;
+		callbacks.seek_func = OggFileStream::oggSeekFunc;
+		callbacks.close_func = OggFileStream::oggCloseFunc;
+		callbacks.tell_func = OggFileStream::oggTellFunc;
+
+		// Open the OGG data stream using the custom callbacks
+		// The OggVorbis_File is cleaned up by vorbisfile if this fails
+		int openResult = ov_open_callbacks(static_cast<void*>(&_stream), &_oggFile, nullptr, 0, callbacks);
+
+		if (openResult != 0)
+		{
+			throw std::runtime_error(fmt::format("Error opening OGG file (error code: {0})", openResult));
+		}
+
+		// Get some information about the OGG file
+		vorbis_info* vorbisInfo = ov_info(&_oggFile, -1);
+
+		_info.channels = static_cast<unsigned int>(vorbisInfo->channels);
+		_info.sampleRate = static_cast<unsigned int>(vorbisInfo->rate);
+		_info.bitsPerSample = 16; // as requested from ov_read
+		_info.duration = static_cast<float>(ov_time_total(&_oggFile, -1));
+	}
+
+	~OggFileDecoder()
+	{
+		// Clean up the OGG routines
+		ov_clear(&_oggFile);
+	}
+
+	const SoundFileInfo& getInfo() const override
+	{
+		return _info;
+	}
+
+	std::size_t read(char* buffer, std::size_t size) override
+	{
+		std::size_t bytesRead = 0;
+
+		while (bytesRead < size)
+		{
+			int bitStream;
+
+			// Read a chunk of decoded data from the vorbis file (little endian, 16 bit, signed)
+			long bytes = ov_read(&_oggFile, buffer + bytesRead, static_cast<int>(size - bytesRead), 0, 2, 1, &bitStream);
+
+			if (bytes == OV_HOLE)
+			{
+				rError() << "Error decoding OGG: OV_HOLE.\n";
+				break;
+			}
+			else if (bytes == OV_EBADLINK)
+			{
+				rError() << "Error decoding OGG: OV_EBADLINK.\n";
+				break;
+			}
+			else if (bytes <= 0)
+			{
+				break; // end of file or unrecoverable error
+			}
+
+			bytesRead += static_cast<std::size_t>(bytes);
+		}
+
+		return bytesRead;
+	}
+
+	void rewind() override
+	{
+		ov_pcm_seek(&_oggFile, 0);
+	}
+};
+
+}
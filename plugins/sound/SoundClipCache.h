@@ -0,0 +1,120 @@
+#pragma once
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <string>
+
+#ifdef __APPLE__
+#include <OpenAL/al.h>
+#else
+#include <AL/al.h>
+#endif
+
+namespace sound
+{
+
+/**
+ * The fully decoded PCM data of a short sound file.
+ */
+struct DecodedSoundClip
+{
+	ALenum format;
+	ALsizei sampleRate;
+	std::vector<char> data;
+
+	typedef std::shared_ptr<DecodedSoundClip> Ptr;
+};
+
+/**
+ * Keeps the most recently played short clips in memory, such that replaying
+ * them doesn't need to decode them again. The least recently used clips are
+ * evicted as soon as the total size exceeds the capacity.
+ *
+ * This class can be accessed from multiple threads.
+ */
+class SoundClipCache
+{
+private:
+	typedef std::pair<std::string, DecodedSoundClip::Ptr> Entry;
+
+	// The most recently used clip is at the front
+	std::list<Entry> _clips;
+	std::map<std::string, std::list<Entry>::iterator> _clipsByName;
+
+	std::size_t _size;
+	std::size_t _capacity;
+
+	std::mutex _lock;
+
+public:
+	// Clips larger than this are not going to be cached
+	static const std::size_t MAX_CLIP_SIZE = 2 * 1024 * 1024;
+
+	SoundClipCache(std::size_t capacity = 32 * 1024 * 1024) :
+		_size(0),
+		_capacity(capacity)
+	{}
+
+	// Returns the clip decoded from the given VFS path, or an empty pointer
+	DecodedSoundClip::Ptr find(const std::string& name)
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+
+		auto found = _clipsByName.find(name);
+
+		if (found == _clipsByName.end())
+		{
+			return DecodedSoundClip::Ptr();
+		}
+
+		// Move it to the front
+		_clips.splice(_clips.begin(), _clips, found->second);
+
+		return found->second->second;
+	}
+
+	void insert(const std::string& name, const DecodedSoundClip::Ptr& clip)
+	{
+		if (clip->data.size() > MAX_CLIP_SIZE) return;
+
+		std::lock_guard<std::mutex> lock(_lock);
+
+		removeClip(name);
+
+		_clips.emplace_front(name, clip);
+		_clipsByName[name] = _clips.begin();
+		_size += clip->data.size();
+
+		// Evict the least recently used clips, the new one is always kept
+		while (_size > _capacity && _clips.size() > 1)
+		{
+			removeClip(_clips.back().first);
+		}
+	}
+
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+
+		_clips.clear();
+		_clipsByName.clear();
+		_size = 0;
+	}
+
+private:
+	void removeClip(const std::string& name)
+	{
+		auto found = _clipsByName.find(name);
+
+		if (found == _clipsByName.end()) return;
+
+		_size -= found->second->second->data.size();
+		_clips.erase(found->second);
+		_clipsByName.erase(found);
+	}
+};
+
+}
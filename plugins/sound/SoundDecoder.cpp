@@ -0,0 +1,41 @@
+#include "SoundDecoder.h"
+
+#include "os/path.h"
+#include "string/case_conv.h"
+
+#include "WavFileDecoder.h"
+#include "OggFileDecoder.h"
+
+namespace sound
+{
+
+SoundDecoder::Ptr SoundDecoder::Create(const ArchiveFilePtr& file)
+{
+	if (string::to_lower_copy(os::getExtension(file->getName())) == "ogg")
+	{
+		return Ptr(new OggFileDecoder(*file));
+	}
+
+	// Must be a wave file
+	return Ptr(new WavFileDecoder(file));
+}
+
+SoundFileInfo SoundDecoder::ReadFileInfo(const ArchiveFilePtr& file)
+{
+	auto extension = string::to_lower_copy(os::getExtension(file->getName()));
+
+	if (extension == "wav")
+	{
+		// The header is sufficient, don't create a decoder
+		unsigned int dataSize;
+		return WavFileDecoder::ReadFileInfo(file->getInputStream(), dataSize);
+	}
+	else if (extension == "ogg")
+	{
+		return OggFileDecoder(*file).getInfo();
+	}
+
+	throw std::runtime_error("Unsupported sound file extension: " + extension);
+}
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory>
+#include <cstddef>
+
+#ifdef __APPLE__
+#include <OpenAL/al.h>
+#else
+#include <AL/al.h>
+#endif
+
+#include "iarchive.h"
+
+namespace sound
+{
+
+/**
+ * Format and length of a sound file.
+ */
+struct SoundFileInfo
+{
+	unsigned int channels;
+	unsigned int sampleRate;
+	unsigned int bitsPerSample;
+
+	// Length in seconds
+	float duration;
+
+	SoundFileInfo() :
+		channels(0),
+		sampleRate(0),
+		bitsPerSample(0),
+		duration(0.0f)
+	{}
+
+	ALenum getAlFormat() const
+	{
+		if (channels == 1)
+		{
+			return bitsPerSample == 8 ? AL_FORMAT_MONO8 : AL_FORMAT_MONO16;
+		}
+
+		return bitsPerSample == 8 ? AL_FORMAT_STEREO8 : AL_FORMAT_STEREO16;
+	}
+
+	// The number of PCM bytes covering one second of playback
+	std::size_t getBytesPerSecond() const
+	{
+		return static_cast<std::size_t>(sampleRate) * channels * (bitsPerSample >> 3);
+	}
+};
+
+/**
+ * Incremental decoder turning a sound file into PCM data, which can be
+ * passed to OpenAL in chunks of arbitrary size.
+ */
+class SoundDecoder
+{
+public:
+	typedef std::unique_ptr<SoundDecoder> Ptr;
+
+	virtual ~SoundDecoder() {}
+
+	virtual const SoundFileInfo& getInfo() const = 0;
+
+	// Decodes up to <size> bytes of PCM data into the given buffer, returns
+	// the number of bytes written. Returns 0 when the end of the file is reached.
+	virtual std::size_t read(char* buffer, std::size_t size) = 0;
+
+	// Moves back to the beginning of the file
+	virtual void rewind() = 0;
+
+	/**
+	 * Creates a decoder for the given OGG or WAV file, based on its extension.
+	 * @throws: std::runtime_error if the file cannot be decoded.
+	 */
+	static Ptr Create(const ArchiveFilePtr& file);
+
+	/**
+	 * Determines format and length of the given file, decoding as little as possible.
+	 * @throws: std::runtime_error if the file cannot be decoded.
+	 */
+	static SoundFileInfo ReadFileInfo(const ArchiveFilePtr& file);
+};
+
+}
@@ -5,15 +5,11 @@
 #include "icommandsystem.h"
 
 #include "debugging/ScopedDebugTimer.h"
-#include "os/path.h"
-#include "string/case_conv.h"
+#include "ParallelForEach.h"
 
 #include <algorithm>
 #include "itextstream.h"
 
-#include "WavFileLoader.h"
-#include "OggFileLoader.h"
-
 namespace sound
 {
 
@@ -89,7 +85,7 @@ bool SoundManager::playSound(const std::string& fileName, bool loopSound)
 
 	if (file && _soundPlayer)
 	{
-		_soundPlayer->play(*file, loopSound);
+		_soundPlayer->play(file, loopSound);
 		return true;
 	}
 
@@ -157,6 +153,17 @@ void SoundManager::ensureShadersLoaded()
 }
 
 void SoundManager::initialiseModule(const IApplicationContext& ctx)
+{
+    _defLoader.start();
+}
+
+bool SoundManager::allowsConcurrentInitialisation() const
+{
+    // initialiseModule() is just starting the def loader
+    return true;
+}
+
+void SoundManager::finishModuleInitialisation(const IApplicationContext& ctx)
 {
     GlobalCommandSystem().addCommand("ReloadSounds", 
         std::bind(&SoundManager::reloadSoundsCmd, this, std::placeholders::_1));
@@ -174,12 +181,21 @@ void SoundManager::initialiseModule(const IApplicationContext& ctx)
     {
         rMessage() << "SoundManager: sound output disabled" << std::endl;
     }
-
-    _defLoader.start();
 }
 
-float SoundManager::getSoundFileDuration(const std::string& vfsPath)
+SoundFileInfo SoundManager::getSoundFileInfo(const std::string& vfsPath)
 {
+    {
+        std::lock_guard<std::mutex> lock(_fileInfoLock);
+
+        auto found = _fileInfos.find(vfsPath);
+
+        if (found != _fileInfos.end())
+        {
+            return found->second;
+        }
+    }
+
     auto file = openSoundFile(vfsPath);
 
     if (!file)
@@ -187,18 +203,20 @@ float SoundManager::getSoundFileDuration(const std::string& vfsPath)
         throw std::out_of_range("Could not resolve sound file " + vfsPath);
     }
 
-    auto extension = string::to_lower_copy(os::getExtension(file->getName()));
+    // Read the file outside the lock, this might take a while for OGGs
+    auto info = SoundDecoder::ReadFileInfo(file);
 
+    std::lock_guard<std::mutex> lock(_fileInfoLock);
+    _fileInfos[vfsPath] = info;
+
+    return info;
+}
+
+float SoundManager::getSoundFileDuration(const std::string& vfsPath)
+{
     try
     {
-        if (extension == "wav")
-        {
-            return WavFileLoader::GetDuration(file->getInputStream());
-        }
-        else if (extension == "ogg")
-        {
-            return OggFileLoader::GetDuration(*file);
-        }
+        return getSoundFileInfo(vfsPath).duration;
     }
     catch (const std::runtime_error& ex)
     {
@@ -208,8 +226,33 @@ float SoundManager::getSoundFileDuration(const std::string& vfsPath)
     return 0.0f;
 }
 
+void SoundManager::cacheSoundFileDurations(const std::vector<std::string>& vfsPaths)
+{
+    util::parallelForEach(vfsPaths.size(), [&](std::size_t i)
+    {
+        try
+        {
+            getSoundFileInfo(vfsPaths[i]);
+        }
+        catch (const std::out_of_range&)
+        {} // unresolvable paths are reported when querying the duration
+        catch (const std::runtime_error& ex)
+        {
+            rError() << "Error determining sound file duration " << ex.what() << std::endl;
+        }
+    });
+}
+
 void SoundManager::reloadSounds()
 {
+    // The sound files might have changed too
+    {
+        std::lock_guard<std::mutex> lock(_fileInfoLock);
+        _fileInfos.clear();
+    }
+
+    if (_soundPlayer) _soundPlayer->clearClipCache();
+
     _defLoader.reset();
     _defLoader.start();
 }
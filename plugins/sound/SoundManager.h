@@ -7,7 +7,9 @@
 #include "icommandsystem.h"
 
 #include "ThreadedDefLoader.h"
+#include "SoundDecoder.h"
 #include <map>
+#include <mutex>
 
 namespace sound {
 
@@ -33,6 +35,10 @@ private: /* FIELDS */
 	// The helper class for playing the sounds
 	std::unique_ptr<SoundPlayer> _soundPlayer;
 
+	// Format and length of the sound files queried so far, by VFS path
+	std::map<std::string, SoundFileInfo> _fileInfos;
+	std::mutex _fileInfoLock;
+
     sigc::signal<void> _sigSoundShadersReloaded;
 
 private:
@@ -40,6 +46,10 @@ private:
     void ensureShadersLoaded();
     void reloadSoundsCmd(const cmd::ArgumentList& args);
 
+    // Returns the (cached) info of the given file, throws std::out_of_range if
+    // the file cannot be found and std::runtime_error if it cannot be decoded
+    SoundFileInfo getSoundFileInfo(const std::string& vfsPath);
+
 public:
 	SoundManager();
 
@@ -51,12 +61,15 @@ public:
 	void stopSound() override;
     void reloadSounds() override;
     float getSoundFileDuration(const std::string& vfsPath) override;
+    void cacheSoundFileDurations(const std::vector<std::string>& vfsPaths) override;
     sigc::signal<void>& signal_soundShadersReloaded() override;
 
 	// RegisterableModule implementation
 	const std::string& getName() const override;
 	const StringSet& getDependencies() const override;
 	void initialiseModule(const IApplicationContext& ctx) override;
+	bool allowsConcurrentInitialisation() const override;
+	void finishModuleInitialisation(const IApplicationContext& ctx) override;
 };
 
 }
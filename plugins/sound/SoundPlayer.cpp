@@ -1,12 +1,9 @@
 #include "SoundPlayer.h"
 
-#include <vorbis/vorbisfile.h>
 #include <iostream>
 #include <vector>
-#include "string/case_conv.h"
 
 #include "stream/TextFileInputStream.h"
-#include "os/path.h"
 #include <memory>
 
 // We need the usleep() command. Be sure to include the windows.h
@@ -18,8 +15,7 @@
 #include <unistd.h>
 #endif
 
-#include "WavFileLoader.h"
-#include "OggFileLoader.h"
+#include "SoundStream.h"
 
 namespace sound
 {
@@ -110,10 +106,18 @@ void SoundPlayer::onTimerIntervalReached(wxTimerEvent& ev)
 			_timer.Stop();
 		}
 	}
+	else if (_stream && _stream->isFinished())
+	{
+		// The stream has been played to the end, free its buffers
+		clearBuffer();
+	}
 }
 
 void SoundPlayer::clearBuffer()
 {
+	// Stop the worker thread first, it's using the source
+	_stream.reset();
+
 	// Check if there is an active buffer
 	if (_source != 0) {
 		// Stop playing
@@ -136,7 +140,12 @@ void SoundPlayer::stop()
 	clearBuffer();
 }
 
-void SoundPlayer::play(ArchiveFile& file, bool loopSound) 
+void SoundPlayer::clearClipCache()
+{
+	_clipCache.clear();
+}
+
+void SoundPlayer::play(const ArchiveFilePtr& file, bool loopSound)
 {
 	// If we're not initialised yet, do it now
 	if (!_initialised) 
@@ -147,68 +156,44 @@ void SoundPlayer::play(ArchiveFile& file, bool loopSound)
 	// Stop any previous playback operations, that might be still active
 	clearBuffer();
 
-	// Retrieve the extension
-	std::string ext = os::getExtension(file.getName());
+	alGenSources(1, &_source);
 
-	if (string::to_lower_copy(ext) == "ogg")
+	auto clip = _clipCache.find(file->getName());
+
+	if (clip)
 	{
-		createBufferDataFromOgg(file);
+		playClip(*clip, loopSound);
 	}
-	else 
+	else
 	{
-		createBufferDataFromWav(file);
+		// Decoding and playback is handled by the stream's worker thread
+		_stream.reset(new SoundStream(file, loopSound, _source, _clipCache));
 	}
 
-	if (_buffer != 0) 
-	{
-		alGenSources(1, &_source);
-
-		// Assign the buffer to the source and play it
-		alSourcei(_source, AL_BUFFER, _buffer);
+	// Enable the periodic buffer check, this destructs the buffer
+	// as soon as the playback has finished
+	_timer.Start(200);
+}
 
-		// Set the looping flag
-		alSourcei(_source, AL_LOOPING, loopSound ? AL_TRUE : AL_FALSE);
+void SoundPlayer::playClip(const DecodedSoundClip& clip, bool loopSound)
+{
+	alGenBuffers(1, &_buffer);
 
-		// greebo: Wait 10 msec. to fix a problem with buffers not being played
-		// maybe the AL needs time to push the data?
-		usleep(10000);
+	// Upload the decoded data, this doesn't involve any decoding
+	alBufferData(_buffer, clip.format, clip.data.data(),
+		static_cast<ALsizei>(clip.data.size()), clip.sampleRate);
 
-		alSourcePlay(_source);
+	// Assign the buffer to the source and play it
+	alSourcei(_source, AL_BUFFER, _buffer);
 
-		// Enable the periodic buffer check, this destructs the buffer
-		// as soon as the playback has finished
-		_timer.Start(200);
-	}
-}
+	// Set the looping flag
+	alSourcei(_source, AL_LOOPING, loopSound ? AL_TRUE : AL_FALSE);
 
-void SoundPlayer::createBufferDataFromWav(ArchiveFile& file)
-{
-	// Must be a wave file
-	try
-	{
-		// Create an AL sound buffer directly from the buffer in memory
-		_buffer = WavFileLoader::LoadFromStream(file.getInputStream());
-	}
-	catch (std::runtime_error& e)
-	{
-		rError() << "SoundPlayer: Error opening WAV file: " << e.what() << std::endl;
-		_buffer = 0;
-	}
-}
+	// greebo: Wait 10 msec. to fix a problem with buffers not being played
+	// maybe the AL needs time to push the data?
+	usleep(10000);
 
-void SoundPlayer::createBufferDataFromOgg(ArchiveFile& file)
-{
-    // Must be an OGG file
-    try
-    {
-        // Create an AL sound buffer directly from the buffer in memory
-        _buffer = OggFileLoader::LoadFromFile(file);
-    }
-    catch (std::runtime_error & e)
-    {
-        rError() << "SoundPlayer: Error opening OGG file: " << e.what() << std::endl;
-        _buffer = 0;
-    }
+	alSourcePlay(_source);
 }
 
 } // namespace sound
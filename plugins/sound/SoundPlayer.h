@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <memory>
 
 #ifdef __APPLE__
 #include <OpenAL/al.h>
@@ -12,10 +13,13 @@
 
 #include <wx/timer.h>
 
-class ArchiveFile;
+#include "iarchive.h"
+#include "SoundClipCache.h"
 
 namespace sound {
 
+class SoundStream;
+
 class SoundPlayer :
 	public wxEvtHandler
 {
@@ -25,12 +29,19 @@ protected:
 
 	ALCcontext* _context;
 
-	// The buffer containing the currently played audio data
+	// The buffer containing the currently played audio data,
+	// only used when playing a clip from the cache
 	ALuint _buffer;
 
 	// The source playing the buffer
 	ALuint _source;
 
+	// Feeds the source when playing a file which is not in the cache
+	std::unique_ptr<SoundStream> _stream;
+
+	// Recently played short clips
+	SoundClipCache _clipCache;
+
 	// The timer object to check whether the sound is done playing
 	// to destroy the buffer afterwards
 	wxTimer _timer;
@@ -45,14 +56,18 @@ public:
 	virtual ~SoundPlayer();
 
 	/** greebo: Call this with the ArchiveFile object containing
-	 * 			the file to be played.
+	 * 			the file to be played. Unless the file is found in the
+	 * 			clip cache, it is decoded in the background while playing.
 	 */
-	virtual void play(ArchiveFile& file, bool loopSound);
+	virtual void play(const ArchiveFilePtr& file, bool loopSound);
 
 	/** greebo: Stops the playback immediately.
 	 */
 	virtual void stop();
 
+	// Discards all cached clips
+	void clearClipCache();
+
 protected:
 	// Initialises the AL context
 	void initialise();
@@ -63,8 +78,7 @@ protected:
 	// This is called periodically to check whether the buffer can be cleared
 	void onTimerIntervalReached(wxTimerEvent& ev);
 
-	void createBufferDataFromOgg(ArchiveFile& file);
-	void createBufferDataFromWav(ArchiveFile& file);
+	void playClip(const DecodedSoundClip& clip, bool loopSound);
 };
 
 } // namespace sound
@@ -0,0 +1,220 @@
+#include "SoundStream.h"
+
+#include <chrono>
+#include <algorithm>
+#include "itextstream.h"
+
+namespace sound
+{
+
+namespace
+{
+	// Number of buffers in the ring, and the playback time covered by each of them
+	const std::size_t NUM_BUFFERS = 4;
+	const std::size_t BUFFERS_PER_SECOND = 4;
+
+	// The interval the worker thread checks the source for processed buffers
+	const std::size_t POLL_INTERVAL_MSECS = 20;
+}
+
+SoundStream::SoundStream(const ArchiveFilePtr& file, bool loop, ALuint source, SoundClipCache& clipCache) :
+	_file(file),
+	_loop(loop),
+	_source(source),
+	_clipCache(clipCache),
+	_stopRequested(false),
+	_finished(false)
+{
+	_thread = std::thread(&SoundStream::run, this);
+}
+
+SoundStream::~SoundStream()
+{
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		_stopRequested = true;
+	}
+
+	_stopCondition.notify_all();
+	_thread.join();
+
+	alSourceStop(_source);
+
+	// Detach all queued buffers from the source before deleting them
+	alSourcei(_source, AL_BUFFER, 0);
+
+	if (!_buffers.empty())
+	{
+		alDeleteBuffers(static_cast<ALsizei>(_buffers.size()), _buffers.data());
+	}
+}
+
+bool SoundStream::isFinished() const
+{
+	return _finished;
+}
+
+bool SoundStream::waitFor(std::size_t milliseconds)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+
+	_stopCondition.wait_for(lock, std::chrono::milliseconds(milliseconds), [this] { return _stopRequested; });
+
+	return !_stopRequested;
+}
+
+void SoundStream::run()
+{
+	SoundDecoder::Ptr decoder;
+
+	try
+	{
+		decoder = SoundDecoder::Create(_file);
+	}
+	catch (const std::runtime_error& ex)
+	{
+		rError() << "SoundPlayer: Error opening " << _file->getName() << ": " << ex.what() << std::endl;
+		_finished = true;
+		return;
+	}
+
+	const auto& info = decoder->getInfo();
+
+	// Each buffer holds a fixed amount of playback time, rounded to whole sample frames
+	std::size_t frameSize = info.channels * (info.bitsPerSample >> 3);
+	std::size_t chunkSize = std::max(info.getBytesPerSecond() / BUFFERS_PER_SECOND / frameSize, std::size_t(1024)) * frameSize;
+
+	std::vector<char> chunk(chunkSize);
+
+	// Short clips are collected while being played, to be stored in the cache
+	DecodedSoundClip::Ptr clip;
+
+	if (info.duration * info.getBytesPerSecond() <= SoundClipCache::MAX_CLIP_SIZE)
+	{
+		clip = std::make_shared<DecodedSoundClip>();
+		clip->format = info.getAlFormat();
+		clip->sampleRate = static_cast<ALsizei>(info.sampleRate);
+	}
+
+	_buffers.resize(NUM_BUFFERS);
+	alGenBuffers(static_cast<ALsizei>(_buffers.size()), _buffers.data());
+
+	// Fill the whole ring before starting the source
+	std::size_t numQueued = 0;
+	bool endOfData = false;
+
+	for (auto buffer : _buffers)
+	{
+		if (!fillBuffer(*decoder, buffer, chunk, clip))
+		{
+			endOfData = true;
+			break;
+		}
+
+		alSourceQueueBuffers(_source, 1, &buffer);
+		++numQueued;
+	}
+
+	if (numQueued == 0)
+	{
+		_finished = true;
+		return;
+	}
+
+	alSourcePlay(_source);
+
+	while (waitFor(POLL_INTERVAL_MSECS))
+	{
+		ALint processed = 0;
+		alGetSourcei(_source, AL_BUFFERS_PROCESSED, &processed);
+
+		// Refill the played buffers and append them to the queue again
+		for (ALint i = 0; i < processed; ++i)
+		{
+			ALuint buffer = 0;
+			alSourceUnqueueBuffers(_source, 1, &buffer);
+			--numQueued;
+
+			if (!endOfData && fillBuffer(*decoder, buffer, chunk, clip))
+			{
+				alSourceQueueBuffers(_source, 1, &buffer);
+				++numQueued;
+			}
+			else
+			{
+				endOfData = true;
+			}
+		}
+
+		if (numQueued == 0)
+		{
+			// Everything has been played
+			_finished = true;
+			return;
+		}
+
+		// The source stops by itself if it ran out of queued data before
+		// we could refill the buffers, resume it in that case
+		ALint state;
+		alGetSourcei(_source, AL_SOURCE_STATE, &state);
+
+		if (state == AL_STOPPED)
+		{
+			alSourcePlay(_source);
+		}
+	}
+}
+
+bool SoundStream::fillBuffer(SoundDecoder& decoder, ALuint buffer, std::vector<char>& chunk,
+	DecodedSoundClip::Ptr& clip)
+{
+	auto bytes = decoder.read(chunk.data(), chunk.size());
+
+	if (bytes == 0)
+	{
+		// The first pass is complete, the clip data can be cached
+		if (clip)
+		{
+			_clipCache.insert(_file->getName(), clip);
+			clip.reset();
+		}
+
+		if (!_loop)
+		{
+			return false;
+		}
+
+		decoder.rewind();
+		bytes = decoder.read(chunk.data(), chunk.size());
+	}
+
+	const auto& info = decoder.getInfo();
+
+	// Truncated files might end with a partial sample frame, OpenAL doesn't accept that
+	bytes -= bytes % (info.channels * (info.bitsPerSample >> 3));
+
+	if (bytes == 0)
+	{
+		return false;
+	}
+
+	if (clip)
+	{
+		if (clip->data.size() + bytes > SoundClipCache::MAX_CLIP_SIZE)
+		{
+			// The header underestimated the length, don't cache this one
+			clip.reset();
+		}
+		else
+		{
+			clip->data.insert(clip->data.end(), chunk.data(), chunk.data() + bytes);
+		}
+	}
+
+	alBufferData(buffer, info.getAlFormat(), chunk.data(), static_cast<ALsizei>(bytes),
+		static_cast<ALsizei>(info.sampleRate));
+
+	return true;
+}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <condition_variable>
+
+#include "iarchive.h"
+#include "SoundDecoder.h"
+#include "SoundClipCache.h"
+
+namespace sound
+{
+
+/**
+ * Plays a sound file through the given OpenAL source by queueing a small
+ * ring of buffers, which are refilled by a background thread as soon as
+ * the source has played them. Opening and decoding the file happens on the
+ * worker thread too, such that starting the playback is not blocking.
+ *
+ * If the decoded file turns out to be small enough, its PCM data is
+ * stored in the clip cache after the first pass.
+ */
+class SoundStream
+{
+private:
+	ArchiveFilePtr _file;
+	bool _loop;
+
+	// The source is owned by the SoundPlayer, the buffers by this class
+	ALuint _source;
+	std::vector<ALuint> _buffers;
+
+	SoundClipCache& _clipCache;
+
+	std::thread _thread;
+	std::mutex _lock;
+	std::condition_variable _stopCondition;
+	bool _stopRequested;
+
+	// Set by the worker thread when all data has been played
+	std::atomic<bool> _finished;
+
+public:
+	SoundStream(const ArchiveFilePtr& file, bool loop, ALuint source, SoundClipCache& clipCache);
+
+	// Stops the playback and waits for the worker thread to exit
+	~SoundStream();
+
+	// Returns true if the stream has been played to the end (or failed to start)
+	bool isFinished() const;
+
+private:
+	void run();
+
+	// Fills the given buffer with the next chunk, returns false at the end of the data
+	bool fillBuffer(SoundDecoder& decoder, ALuint buffer, std::vector<char>& chunk,
+		DecodedSoundClip::Ptr& clip);
+
+	// Waits for the given amount of time, returns false if the stream should stop
+	bool waitFor(std::size_t milliseconds);
+};
+
+}
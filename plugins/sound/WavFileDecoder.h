@@ -1,25 +1,27 @@
 #pragma once
 
 #include <stdexcept>
+#include <string>
+#include <algorithm>
 #include "idatastream.h"
-
-#ifdef __APPLE__
-#include <OpenAL/al.h>
-#else
-#include <AL/al.h>
-#endif
+#include "ifilesystem.h"
+#include "SoundDecoder.h"
 
 class InputStream;
 
 namespace sound {
 
 /**
- * greebo: Loader class creating an AL buffer from a WAV file.
+ * greebo: Decoder class reading the PCM data of a WAV file.
  *
  * Modeled after the one used by the Ogre3D people, found it posted
  * somewhere on the net.
+ *
+ * The data is read from the file's input stream as it is requested,
+ * rewinding is re-opening the file.
  */
-class WavFileLoader
+class WavFileDecoder :
+    public SoundDecoder
 {
 private:
     struct FileInfo
@@ -38,28 +40,32 @@ private:
             fileFormat[4] = '\0';
             audioFormat = 0;
         }
-
-        ALenum getAlFormat() const
-        {
-            if (channels == 1)
-            {
-                return bps == 8 ? AL_FORMAT_MONO8 : AL_FORMAT_MONO16;
-            }
-            else
-            {
-                return  bps == 8 ? AL_FORMAT_STEREO16 : AL_FORMAT_STEREO16;
-            }
-        }
     };
 
     typedef StreamBase::byte_type byte;
 
+    ArchiveFilePtr _file;
+    SoundFileInfo _info;
+
+    // Bytes of PCM data left to read from the current stream
+    unsigned int _remainingSize;
+
 public:
     /**
-     * greebo: Determines the WAV file length in seconds.
+     * @throws: std::runtime_error if the file is not a PCM wave file.
+     */
+    WavFileDecoder(const ArchiveFilePtr& file) :
+        _file(file)
+    {
+        _info = ReadFileInfo(_file->getInputStream(), _remainingSize);
+    }
+
+    /**
+     * Parses the WAV header, leaves the stream at the beginning of
+     * the sound data and returns the size of the data in bytes.
      * @throws: std::runtime_error if an error occurs.
      */
-    static float GetDuration(InputStream& stream)
+    static SoundFileInfo ReadFileInfo(InputStream& stream, unsigned int& dataSize)
     {
         FileInfo info;
         ParseFileInfo(stream, info);
@@ -67,46 +73,61 @@ public:
         SkipToRemainingData(stream);
 
         // The next four bytes are the remaining size of the file
-        unsigned int remainingSize = 0;
-        stream.read(reinterpret_cast<byte*>(&remainingSize), sizeof(remainingSize));
+        dataSize = 0;
+        stream.read(reinterpret_cast<byte*>(&dataSize), sizeof(dataSize));
+
+        if (info.channels == 0 || info.freq == 0 || (info.bps != 8 && info.bps != 16))
+        {
+            throw std::runtime_error("Unsupported sample format.");
+        }
+
+        SoundFileInfo result;
+
+        result.channels = info.channels;
+        result.sampleRate = info.freq;
+        result.bitsPerSample = info.bps;
 
         // Calculate how many samples we have in the payload, then calculate the duration
-        auto numSamples = remainingSize / (info.bps >> 3);
+        auto numSamples = dataSize / (info.bps >> 3);
         auto numSamplesPerChannel = numSamples / info.channels;
 
-        return static_cast<float>(numSamplesPerChannel) / info.freq;
+        result.duration = static_cast<float>(numSamplesPerChannel) / info.freq;
+
+        return result;
     }
 
-	/**
-	 * greebo: Loads a WAV file from a stream into OpenAL,
-     * returns the openAL buffer handle.
-	 *
-	 * @throws: std::runtime_error if an error occurs.
-	 */
-	static ALuint LoadFromStream(InputStream& stream)
+    const SoundFileInfo& getInfo() const override
     {
-        FileInfo info;
-        ParseFileInfo(stream, info);
+        return _info;
+    }
 
-        SkipToRemainingData(stream);
+    std::size_t read(char* buffer, std::size_t size) override
+    {
+        auto bytesToRead = std::min(static_cast<std::size_t>(_remainingSize), size);
 
-		// The next four bytes are the remaining size of the file
-		unsigned int remainingSize = 0;
-		stream.read(reinterpret_cast<byte*>(&remainingSize), sizeof(remainingSize));
+        auto bytesRead = _file->getInputStream().read(reinterpret_cast<byte*>(buffer), bytesToRead);
+        _remainingSize -= static_cast<unsigned int>(bytesRead);
 
-		ALuint bufferNum = 0;
-		alGenBuffers(1, &bufferNum);
+        return bytesRead;
+    }
 
-        std::vector<byte> data(remainingSize);
-        stream.read(data.data(), remainingSize);
+    void rewind() override
+    {
+        // The archive streams can only be read forwards, open the file once more
+        auto file = GlobalFileSystem().openFile(_file->getName());
 
-		alBufferData(bufferNum, info.getAlFormat(), data.data(), static_cast<ALsizei>(remainingSize), info.freq);
+        if (!file)
+        {
+            _remainingSize = 0;
+            return;
+        }
 
-		return bufferNum;
-	}
+        _file = file;
+        ReadFileInfo(_file->getInputStream(), _remainingSize);
+    }
 
 private:
-    // Assuming that the FMT chunk has been parsed, this seeks forward to the 
+    // Assuming that the FMT chunk has been parsed, this seeks forward to the
     // beginning of the sound data
     static void SkipToRemainingData(InputStream& stream)
     {
@@ -135,7 +156,7 @@ private:
             }
         }
     }
-    
+
     // Reads the file header, leaves the stream right after the end of the first chunk
     static void ParseFileInfo(InputStream& stream, FileInfo& info)
     {
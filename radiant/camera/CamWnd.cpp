@@ -975,6 +975,9 @@ void CamWnd::Cam_Draw()
         render::RenderableCollectionWalker::CollectRenderablesInScene(renderer, _view);
         _renderStats.frontEndComplete();
 
+        const auto& traversalStats = GlobalSceneGraph().getVolumeTraversalStatistics();
+        _renderStats.setNodeCounts(traversalStats.visitedNodes, traversalStats.culledNodes);
+
         // Render any active mousetools
         for (const ActiveMouseTools::value_type& i : _activeMouseTools)
         {
@@ -1054,6 +1057,7 @@ void CamWnd::Cam_Draw()
     if (!statString.empty())
         statString += " | ";
     statString += _renderStats.getStatString();
+    statString += " | " + _renderStats.getTextureMemoryString();
     GlobalOpenGL().drawString(statString);
 
     drawTime();
@@ -1,13 +1,62 @@
 #include "ClipboardModule.h"
 
 #include "itextstream.h"
+#include <random>
 #include <wx/clipbrd.h>
+#include <fmt/format.h>
 
 #include "module/StaticModule.h"
 
 namespace ui
 {
 
+namespace
+{
+	// Custom clipboard format carrying the token of deferred content
+	const char* const CONTENT_TOKEN_FORMAT = "application/x-darkradiant-clipboard-token";
+
+	// Text data object invoking the producer the first time the text is requested
+	class DeferredTextDataObject :
+		public wxTextDataObject
+	{
+	private:
+		mutable radiant::IClipboard::StringProducer _producer;
+		mutable wxString _text;
+
+	public:
+		DeferredTextDataObject(const radiant::IClipboard::StringProducer& producer) :
+			_producer(producer)
+		{}
+
+		size_t GetTextLength() const override
+		{
+			return getText().Len() + 1;
+		}
+
+		wxString GetText() const override
+		{
+			return getText();
+		}
+
+	private:
+		const wxString& getText() const
+		{
+			if (_producer)
+			{
+				_text = _producer();
+				_producer = nullptr;
+			}
+
+			return _text;
+		}
+	};
+}
+
+ClipboardModule::ClipboardModule() :
+	_sessionId(fmt::format("{0:x}", std::random_device()())),
+	_nextToken(1)
+{}
+
 std::string ClipboardModule::getString()
 {
 	std::string returnValue;
@@ -37,6 +86,60 @@ void ClipboardModule::setString(const std::string& str)
 	}
 }
 
+std::size_t ClipboardModule::setDeferredString(const StringProducer& producer)
+{
+	auto token = _nextToken++;
+
+	if (wxTheClipboard->Open())
+	{
+		auto tokenString = getTokenString(token);
+
+		auto tokenData = new wxCustomDataObject(wxDataFormat(CONTENT_TOKEN_FORMAT));
+		tokenData->SetData(tokenString.size(), tokenString.data());
+
+		// The text is the preferred format, it's what other applications are interested in
+		auto data = new wxDataObjectComposite;
+		data->Add(new DeferredTextDataObject(producer), true);
+		data->Add(tokenData);
+
+		// The clipboard takes ownership of the data objects
+		wxTheClipboard->SetData(data);
+		wxTheClipboard->Close();
+	}
+
+	return token;
+}
+
+bool ClipboardModule::containsContent(std::size_t token)
+{
+	bool result = false;
+
+	if (wxTheClipboard->Open())
+	{
+		wxDataFormat format(CONTENT_TOKEN_FORMAT);
+
+		if (wxTheClipboard->IsSupported(format))
+		{
+			wxCustomDataObject data(format);
+
+			if (wxTheClipboard->GetData(data))
+			{
+				result = std::string(static_cast<const char*>(data.GetData()), data.GetSize()) ==
+					getTokenString(token);
+			}
+		}
+
+		wxTheClipboard->Close();
+	}
+
+	return result;
+}
+
+std::string ClipboardModule::getTokenString(std::size_t token) const
+{
+	return fmt::format("{0}:{1}", _sessionId, token);
+}
+
 const std::string& ClipboardModule::getName() const
 {
 	static std::string _name(MODULE_CLIPBOARD);
@@ -54,6 +157,13 @@ void ClipboardModule::initialiseModule(const IApplicationContext& ctx)
 	rMessage() << getName() << "::initialiseModule called." << std::endl;
 }
 
+void ClipboardModule::shutdownModule()
+{
+	// Hand our clipboard contents over to the system, to keep them
+	// available after the application has exited
+	wxTheClipboard->Flush();
+}
+
 module::StaticModule<ClipboardModule> clipboardModule;
 
 }
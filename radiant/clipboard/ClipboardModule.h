@@ -8,13 +8,27 @@ namespace ui
 class ClipboardModule :
 	public radiant::IClipboard
 {
+private:
+	// Distinguishes the content tokens of this process from other instances
+	std::string _sessionId;
+
+	std::size_t _nextToken;
+
 public:
+	ClipboardModule();
+
 	std::string getString() override;
 	void setString(const std::string& str) override;
+	std::size_t setDeferredString(const StringProducer& producer) override;
+	bool containsContent(std::size_t token) override;
 
 	const std::string& getName() const override;
 	const StringSet& getDependencies() const override;
 	void initialiseModule(const IApplicationContext& ctx) override;
+	void shutdownModule() override;
+
+private:
+	std::string getTokenString(std::size_t token) const;
 };
 
 }
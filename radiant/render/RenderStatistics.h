@@ -1,6 +1,7 @@
 #pragma once
 
 #include <wx/stopwatch.h>
+#include "ishaders.h"
 #include "string/string.h"
 
 namespace render
@@ -19,23 +20,51 @@ class RenderStatistics
     int _visibleLights = 0;
     int _culledLights = 0;
 
+    // Count of scene nodes passed to the front-end, and of the ones culled
+    // by their own bounds (nodes in culled octree nodes are not counted)
+    std::size_t _visitedNodes = 0;
+    std::size_t _culledNodes = 0;
+
 public:
 
-    /// Return the constructed string for display
-    std::string getStatString()
+    /// Return the constructed string for display, views not processing
+    /// any lights can omit the light counts
+    std::string getStatString(bool includeLights = true)
     {
         // Calculate times for render front-end and back-end
         long totTime = _timer.Time();
         long beTime = totTime - _feTime;
 
-        return "lights: " + std::to_string(_visibleLights)
-             + " / " + std::to_string(_visibleLights + _culledLights)
+        std::string lights = includeLights ?
+            " | lights: " + std::to_string(_visibleLights)
+            + " / " + std::to_string(_visibleLights + _culledLights) : "";
+
+        return "nodes: " + std::to_string(_visitedNodes)
+             + " / " + std::to_string(_visitedNodes + _culledNodes)
+             + lights
              + " | f/e: " + std::to_string(_feTime) + " ms"
              + " | b/e: " + std::to_string(beTime) + " ms"
              + " | tot: " + std::to_string(totTime) + " ms"
              + " | fps: " + (totTime > 0 ? std::to_string(1000 / totTime) : "-");
     }
 
+    /// Return the texture memory used by the material images, including the
+    /// budget and the number of evicted textures if a budget is set
+    std::string getTextureMemoryString() const
+    {
+        auto usage = GlobalMaterialManager().getTextureMemoryUsage();
+
+        std::string result = "tex: " + std::to_string(usage.residentBytes >> 20) + " MB";
+
+        if (usage.budgetBytes > 0)
+        {
+            result += " / " + std::to_string(usage.budgetBytes >> 20) + " MB"
+                + " (" + std::to_string(usage.numEvicted) + " evicted)";
+        }
+
+        return result;
+    }
+
     /// Mark the front-end render stage as completed, storing the time internally
     void frontEndComplete()
     {
@@ -51,10 +80,18 @@ public:
             ++_culledLights;
     }
 
+    /// Store the node counts of the front-end scene traversal
+    void setNodeCounts(std::size_t visited, std::size_t culled)
+    {
+        _visitedNodes = visited;
+        _culledNodes = culled;
+    }
+
     /// Reset statistics at the beginning of a frame render
     void resetStats()
     {
         _visibleLights = _culledLights = 0;
+        _visitedNodes = _culledNodes = 0;
 
         _feTime = 0;
         _timer.Start();
@@ -13,9 +13,9 @@ FaceItem::FaceItem(IFace& sourceFace) :
 	_winding(sourceFace.getWinding())
 {
 	// Allocate a vertex item for each winding vertex
-	for (auto& vertex : _winding)
+	for (std::size_t i = 0; i < _winding.size(); ++i)
 	{
-		_children.emplace_back(new FaceVertexItem(_sourceFace, vertex, *this));
+		_children.emplace_back(new FaceVertexItem(_sourceFace, i, *this));
 	}
 }
 
@@ -23,9 +23,10 @@ AABB FaceItem::getExtents()
 {
 	AABB returnValue;
 
-	for (const auto& vertex : _winding)
+	for (std::size_t i = 0; i < _winding.size(); ++i)
 	{
-		returnValue.includePoint(Vector3(vertex.texcoord[0], vertex.texcoord[1], 0));
+		Vector2 texcoord = _sourceFace.getTexcoord(i);
+		returnValue.includePoint(Vector3(texcoord[0], texcoord[1], 0));
 	}
 
 	return returnValue;
@@ -46,9 +47,10 @@ void FaceItem::render()
 
 	glBegin(GL_TRIANGLE_FAN);
 
-	for (const auto& vertex : _winding)
+	for (std::size_t i = 0; i < _winding.size(); ++i)
 	{
-		glVertex2d(vertex.texcoord[0], vertex.texcoord[1]);
+		Vector2 texcoord = _sourceFace.getTexcoord(i);
+		glVertex2d(texcoord[0], texcoord[1]);
 	}
 
 	glEnd();
@@ -109,9 +111,9 @@ void FaceItem::transformSelected(const Matrix4& matrix)
 Vector2 FaceItem::getCentroid() const {
 	Vector2 texCentroid;
 
-	for (const auto& vertex : _winding)
+	for (std::size_t i = 0; i < _winding.size(); ++i)
 	{
-		texCentroid += vertex.texcoord;
+		texCentroid += _sourceFace.getTexcoord(i);
 	}
 
 	// Take the average value of all the winding texcoords to retrieve the centroid
@@ -124,7 +126,7 @@ bool FaceItem::testSelect(const Rectangle& rectangle)
 {
 	Vector2 texCentroid;
 
-	for (const auto& vertex : _winding)
+	for (std::size_t i = 0; i < _winding.size(); ++i)
 	{
 		/*if (rectangle.contains(i->texcoord))
 		{
@@ -132,7 +134,7 @@ bool FaceItem::testSelect(const Rectangle& rectangle)
 		}*/
 
 		// Otherwise, just continue summing up the texcoords for the centroid check
-		texCentroid += vertex.texcoord;
+		texCentroid += _sourceFace.getTexcoord(i);
 	}
 
 	// Take the average value of all the winding texcoords to retrieve the centroid
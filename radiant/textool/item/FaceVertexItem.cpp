@@ -21,12 +21,17 @@ namespace textool
 	}
 
 // Constructor, allocates all child FacItems
-FaceVertexItem::FaceVertexItem(IFace& sourceFace, WindingVertex& windingVertex, FaceItem& parent) :
+FaceVertexItem::FaceVertexItem(IFace& sourceFace, std::size_t vertexIndex, FaceItem& parent) :
 	_sourceFace(sourceFace),
-	_windingVertex(windingVertex),
+	_vertexIndex(vertexIndex),
 	_parent(parent)
 {}
 
+Vector2 FaceVertexItem::getTexcoord() const
+{
+	return _sourceFace.getTexcoord(_vertexIndex);
+}
+
 void FaceVertexItem::beginTransformation()
 {
 	_sourceFace.undoSave();
@@ -34,16 +39,16 @@ void FaceVertexItem::beginTransformation()
 
 bool FaceVertexItem::testSelect(const Rectangle& rectangle)
 {
-	return rectangle.contains(_windingVertex.texcoord);
+	return rectangle.contains(getTexcoord());
 }
 
 Vector2 FaceVertexItem::getTexCentroid()
 {
 	Vector2 texCentroid(0,0);
 
-	for (const auto& vertex : _sourceFace.getWinding())
+	for (std::size_t i = 0; i < _sourceFace.getWinding().size(); ++i)
 	{
-		texCentroid += vertex.texcoord;
+		texCentroid += _sourceFace.getTexcoord(i);
 	}
 
 	// Take the average value of all the winding texcoords to retrieve the centroid
@@ -56,9 +61,10 @@ AABB FaceVertexItem::getTexAABB()
 {
 	AABB aabb;
 
-	for (const auto& vertex : _sourceFace.getWinding())
+	for (std::size_t i = 0; i < _sourceFace.getWinding().size(); ++i)
 	{
-		aabb.includePoint(Vector3(vertex.texcoord.x(), vertex.texcoord.y(), 0));
+		Vector2 texcoord = _sourceFace.getTexcoord(i);
+		aabb.includePoint(Vector3(texcoord.x(), texcoord.y(), 0));
 	}
 
 	return aabb;
@@ -70,7 +76,8 @@ void FaceVertexItem::transform(const Matrix4& matrix)
 	Vector2 translation(matrix.tx(), matrix.ty());
 
 	// Get the translated texture position
-	Vector2 newTexPosition = _windingVertex.texcoord + translation;
+	Vector2 texcoord = getTexcoord();
+	Vector2 newTexPosition = texcoord + translation;
 
 	// Construct the pivot
 	Vector2 pivot;
@@ -91,14 +98,14 @@ void FaceVertexItem::transform(const Matrix4& matrix)
 
 		pivot = boxOrigin + boxExtentsS + boxExtentsT;
 
-		pivot = getFurthestPivot(_windingVertex.texcoord, pivot, boxOrigin - boxExtentsS + boxExtentsT);
-		pivot = getFurthestPivot(_windingVertex.texcoord, pivot, boxOrigin - boxExtentsS - boxExtentsT);
-		pivot = getFurthestPivot(_windingVertex.texcoord, pivot, boxOrigin + boxExtentsS - boxExtentsT);
+		pivot = getFurthestPivot(texcoord, pivot, boxOrigin - boxExtentsS + boxExtentsT);
+		pivot = getFurthestPivot(texcoord, pivot, boxOrigin - boxExtentsS - boxExtentsT);
+		pivot = getFurthestPivot(texcoord, pivot, boxOrigin + boxExtentsS - boxExtentsT);
 	}
 
 	// Take the centroid as pivot
 	Vector2 newDist = newTexPosition - pivot;
-	Vector2 dist = _windingVertex.texcoord - pivot;
+	Vector2 dist = texcoord - pivot;
 
 	// First, move the texture to the 0,0 origin in UV space
 	// Second, apply the scale
@@ -126,12 +133,13 @@ void FaceVertexItem::snapSelectedToGrid(float grid)
 	if (_selected)
 	{
 		// Calculate how far we need to move our vertex
-		Vector2 snapped = _windingVertex.texcoord;
+		Vector2 texcoord = getTexcoord();
+		Vector2 snapped = texcoord;
 
 		snapped[0] = float_snapped(snapped[0], grid);
 		snapped[1] = float_snapped(snapped[1], grid);
 
-		Vector2 translation = snapped - _windingVertex.texcoord;
+		Vector2 translation = snapped - texcoord;
 
 		if (translation.getLength() == 0)
 		{
@@ -160,7 +168,7 @@ void FaceVertexItem::render()
 		glColor3f(1, 1, 1);
 	}
 
-	glVertex2dv(_windingVertex.texcoord);
+	glVertex2dv(getTexcoord());
 
 	glEnd();
 
@@ -15,13 +15,14 @@ class FaceVertexItem :
 	// The face this control is referring to
 	IFace& _sourceFace;
 
-	WindingVertex& _windingVertex;
+	// The index of the winding vertex
+	std::size_t _vertexIndex;
 
 	FaceItem& _parent;
 
 public:
 	// Constructor, allocates all child FacItems
-	FaceVertexItem(IFace& sourceFace, WindingVertex& windingVertex, FaceItem& parent);
+	FaceVertexItem(IFace& sourceFace, std::size_t vertexIndex, FaceItem& parent);
 
     // destructor
 	virtual ~FaceVertexItem() {}
@@ -42,6 +43,9 @@ public:
 	virtual void render();
 
 private:
+	// The texture coordinates of the winding vertex
+	Vector2 getTexcoord() const;
+
 	Vector2 getTexCentroid();
 
 	// Returns the bounds in UV space of the whole winding
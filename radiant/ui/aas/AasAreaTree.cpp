@@ -0,0 +1,235 @@
+#include "AasAreaTree.h"
+
+#include <algorithm>
+#include <numeric>
+#include "ivolumetest.h"
+
+namespace map
+{
+
+namespace
+{
+    // Nodes holding this many areas or fewer are not subdivided further
+    const std::size_t MAX_AREAS_PER_LEAF = 8;
+
+    // Squared distance from the given point to the closest point of the box
+    inline double getDistanceSquared(const AABB& aabb, const Vector3& point)
+    {
+        double distanceSquared = 0;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            double delta = std::abs(point[i] - aabb.origin[i]) - aabb.extents[i];
+
+            if (delta > 0)
+            {
+                distanceSquared += delta * delta;
+            }
+        }
+
+        return distanceSquared;
+    }
+
+    // Squared distance from the given point to the farthest point of the box
+    inline double getMaxDistanceSquared(const AABB& aabb, const Vector3& point)
+    {
+        double distanceSquared = 0;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            double delta = std::abs(point[i] - aabb.origin[i]) + aabb.extents[i];
+            distanceSquared += delta * delta;
+        }
+
+        return distanceSquared;
+    }
+}
+
+void AasAreaTree::build(const IAasFile& aasFile)
+{
+    clear();
+
+    std::size_t numAreas = aasFile.getNumAreas();
+
+    if (numAreas == 0) return;
+
+    _areaNums.resize(numAreas);
+    std::iota(_areaNums.begin(), _areaNums.end(), 0);
+
+    // Bounds are indexed by area number while building the nodes
+    std::vector<AABB> bounds(numAreas);
+
+    for (std::size_t i = 0; i < numAreas; ++i)
+    {
+        bounds[i] = aasFile.getArea(static_cast<int>(i)).bounds;
+    }
+
+    _areaBounds.swap(bounds);
+
+    buildNode(0, numAreas);
+
+    // Bring the bounds into the same order as the area numbers
+    bounds.resize(numAreas);
+
+    for (std::size_t i = 0; i < numAreas; ++i)
+    {
+        bounds[i] = _areaBounds[_areaNums[i]];
+    }
+
+    _areaBounds.swap(bounds);
+}
+
+void AasAreaTree::clear()
+{
+    _nodes.clear();
+    _areaNums.clear();
+    _areaBounds.clear();
+}
+
+bool AasAreaTree::empty() const
+{
+    return _nodes.empty();
+}
+
+std::size_t AasAreaTree::buildNode(std::size_t firstArea, std::size_t numAreas)
+{
+    std::size_t nodeIndex = _nodes.size();
+    _nodes.push_back(Node{ AABB(), firstArea, numAreas, 0 });
+
+    // _areaBounds is still indexed by area number at this point
+    AABB nodeBounds;
+
+    for (std::size_t i = firstArea; i < firstArea + numAreas; ++i)
+    {
+        nodeBounds.includeAABB(_areaBounds[_areaNums[i]]);
+    }
+
+    _nodes[nodeIndex].bounds = nodeBounds;
+
+    if (numAreas <= MAX_AREAS_PER_LEAF)
+    {
+        return nodeIndex;
+    }
+
+    // Split at the median area center along the longest axis of the node
+    const Vector3& extents = nodeBounds.getExtents();
+    int axis = extents.x() > extents.y() ? (extents.x() > extents.z() ? 0 : 2) : (extents.y() > extents.z() ? 1 : 2);
+
+    auto begin = _areaNums.begin() + firstArea;
+    auto middle = begin + numAreas / 2;
+
+    std::nth_element(begin, middle, begin + numAreas, [&](int a, int b)
+    {
+        return _areaBounds[a].origin[axis] < _areaBounds[b].origin[axis];
+    });
+
+    std::size_t numLeft = numAreas / 2;
+
+    buildNode(firstArea, numLeft);
+
+    std::size_t secondChild = buildNode(firstArea + numLeft, numAreas - numLeft);
+    _nodes[nodeIndex].secondChild = secondChild;
+
+    return nodeIndex;
+}
+
+std::size_t AasAreaTree::getNumAreas() const
+{
+    return _areaNums.size();
+}
+
+int AasAreaTree::getAreaNum(std::size_t areaIndex) const
+{
+    return _areaNums[areaIndex];
+}
+
+const AABB& AasAreaTree::getAreaBounds(std::size_t areaIndex) const
+{
+    return _areaBounds[areaIndex];
+}
+
+std::size_t AasAreaTree::getNumNodes() const
+{
+    return _nodes.size();
+}
+
+std::size_t AasAreaTree::getFirstArea(std::size_t nodeIndex) const
+{
+    return _nodes[nodeIndex].firstArea;
+}
+
+std::size_t AasAreaTree::getNumAreas(std::size_t nodeIndex) const
+{
+    return _nodes[nodeIndex].numAreas;
+}
+
+void AasAreaTree::forEachVisible(const VolumeTest& volume, const Vector3& viewOrigin, double maxDistanceSquared,
+    const std::function<void(std::size_t nodeIndex)>& nodeVisitor,
+    const std::function<void(std::size_t areaIndex)>& areaVisitor) const
+{
+    if (_nodes.empty()) return;
+
+    visitNode(0, volume, false, viewOrigin, maxDistanceSquared, nodeVisitor, areaVisitor);
+}
+
+void AasAreaTree::visitNode(std::size_t nodeIndex, const VolumeTest& volume, bool fullyInside,
+    const Vector3& viewOrigin, double maxDistanceSquared,
+    const std::function<void(std::size_t)>& nodeVisitor,
+    const std::function<void(std::size_t)>& areaVisitor) const
+{
+    const Node& node = _nodes[nodeIndex];
+
+    // Area centers are inside the node bounds, so nothing below can be closer than this
+    if (maxDistanceSquared > 0 && getDistanceSquared(node.bounds, viewOrigin) > maxDistanceSquared)
+    {
+        return;
+    }
+
+    if (!fullyInside)
+    {
+        VolumeIntersectionValue intersection = volume.TestAABB(node.bounds);
+
+        if (intersection == VOLUME_OUTSIDE)
+        {
+            return;
+        }
+
+        // No need to test the children against the volume
+        fullyInside = intersection == VOLUME_INSIDE;
+    }
+
+    // Pass the whole subtree if none of its areas can be culled
+    if (fullyInside && (maxDistanceSquared <= 0 ||
+        getMaxDistanceSquared(node.bounds, viewOrigin) <= maxDistanceSquared))
+    {
+        nodeVisitor(nodeIndex);
+        return;
+    }
+
+    if (node.secondChild == 0)
+    {
+        for (std::size_t i = node.firstArea; i < node.firstArea + node.numAreas; ++i)
+        {
+            const AABB& areaBounds = _areaBounds[i];
+
+            if (maxDistanceSquared > 0 && (areaBounds.getOrigin() - viewOrigin).getLengthSquared() > maxDistanceSquared)
+            {
+                continue;
+            }
+
+            if (!fullyInside && volume.TestAABB(areaBounds) == VOLUME_OUTSIDE)
+            {
+                continue;
+            }
+
+            areaVisitor(i);
+        }
+
+        return;
+    }
+
+    visitNode(nodeIndex + 1, volume, fullyInside, viewOrigin, maxDistanceSquared, nodeVisitor, areaVisitor);
+    visitNode(node.secondChild, volume, fullyInside, viewOrigin, maxDistanceSquared, nodeVisitor, areaVisitor);
+}
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include "iaasfile.h"
+#include "math/AABB.h"
+
+class VolumeTest;
+
+namespace map
+{
+
+/**
+ * Bounding volume hierarchy over the area bounds of an AAS file.
+ *
+ * Used by the AAS renderable to find the areas intersecting the view
+ * volume (and lying within the hide distance) without having to test
+ * every single area of the file in each frame.
+ */
+class AasAreaTree
+{
+private:
+    struct Node
+    {
+        // Bounds enclosing all areas below this node
+        AABB bounds;
+
+        // Range of this node's areas in the _areaNums array
+        std::size_t firstArea;
+        std::size_t numAreas;
+
+        // Index of the second child, the first child is always at (this + 1)
+        // This is 0 for leaf nodes
+        std::size_t secondChild;
+    };
+
+    // Nodes stored in depth-first order, the root node is at index 0
+    std::vector<Node> _nodes;
+
+    // Area numbers, sorted such that each node references a contiguous range
+    std::vector<int> _areaNums;
+
+    // Area bounds, in the same order as _areaNums
+    std::vector<AABB> _areaBounds;
+
+public:
+    // Builds the tree from the area bounds of the given file, discarding any previous data
+    void build(const IAasFile& aasFile);
+
+    void clear();
+
+    bool empty() const;
+
+    // Number of areas in the tree. Areas are addressed by their index in the
+    // tree order, which keeps the areas of each node in a contiguous range.
+    std::size_t getNumAreas() const;
+
+    // The area number and bounds of the area at the given tree order index
+    int getAreaNum(std::size_t areaIndex) const;
+    const AABB& getAreaBounds(std::size_t areaIndex) const;
+
+    std::size_t getNumNodes() const;
+
+    // The range of areas (in tree order) below the given node
+    std::size_t getFirstArea(std::size_t nodeIndex) const;
+    std::size_t getNumAreas(std::size_t nodeIndex) const;
+
+    // Visits the areas intersecting the given volume. Subtrees which are entirely
+    // visible are passed to the nodeVisitor as a whole, the remaining visible areas
+    // are passed one by one to the areaVisitor (with their tree order index).
+    // If maxDistanceSquared is positive, areas whose center is farther away from
+    // the view origin than that are skipped.
+    void forEachVisible(const VolumeTest& volume, const Vector3& viewOrigin, double maxDistanceSquared,
+        const std::function<void(std::size_t nodeIndex)>& nodeVisitor,
+        const std::function<void(std::size_t areaIndex)>& areaVisitor) const;
+
+private:
+    std::size_t buildNode(std::size_t firstArea, std::size_t numAreas);
+
+    void visitNode(std::size_t nodeIndex, const VolumeTest& volume, bool fullyInside,
+        const Vector3& viewOrigin, double maxDistanceSquared,
+        const std::function<void(std::size_t)>& nodeVisitor,
+        const std::function<void(std::size_t)>& areaVisitor) const;
+};
+
+}
@@ -5,6 +5,7 @@
 #include "imainframe.h"
 #include "iuimanager.h"
 #include "ifilesystem.h"
+#include "itextstream.h"
 
 #include <wx/event.h>
 #include <wx/button.h>
@@ -12,17 +13,28 @@
 #include <wx/tglbtn.h>
 #include <wx/sizer.h>
 #include <wx/artprov.h>
+#include <fmt/format.h>
 #include <memory>
+#include "os/fs.h"
+#include "stream/ProgressTrackingInputStream.h"
+#include "wxutil/dialog/MessageBox.h"
 
 namespace ui
 {
 
+namespace
+{
+    const int LOAD_POLL_INTERVAL_MSECS = 100;
+}
+
 AasControl::AasControl(wxWindow* parent, const map::AasFileInfo& info) :
     _toggle(nullptr),
     _refreshButton(nullptr),
     _buttonHBox(nullptr),
     _updateActive(nullptr),
-    _info(info)
+    _info(info),
+    _bytesLoaded(0),
+    _fileSize(0)
 {
     // Create the main toggle
 	_toggle = new wxToggleButton(parent, wxID_ANY, info.type.fileExtension);
@@ -36,12 +48,22 @@ AasControl::AasControl(wxWindow* parent, const map::AasFileInfo& info) :
 	_buttonHBox = new wxBoxSizer(wxHORIZONTAL);
 	_buttonHBox->Add(_refreshButton, 0, wxEXPAND);
 
+    _loadTimer.Bind(wxEVT_TIMER, &AasControl::onLoadTimer, this);
+
     // Refresh the Control
 	update();
 }
 
 AasControl::~AasControl()
 {
+    _loadTimer.Stop();
+
+    // The worker is referencing our members, wait for it to finish
+    if (isLoading())
+    {
+        _loadResult.wait();
+    }
+
     // Detach before destruction
     if (_toggle->GetValue())
     {
@@ -66,24 +88,123 @@ void AasControl::update()
 
 void AasControl::ensureAasFileLoaded()
 {
-    if (_aasFile) return;
+    if (_aasFile || isLoading()) return;
 
     ArchiveTextFilePtr file = GlobalFileSystem().openTextFileInAbsolutePath(_info.absolutePath);
 
-    if (file)
+    if (!file) return;
+
+    map::IAasFileLoaderPtr loader;
+
     {
         std::istream stream(&file->getInputStream());
-        map::IAasFileLoaderPtr loader = GlobalAasFileManager().getLoaderForStream(stream);
+        loader = GlobalAasFileManager().getLoaderForStream(stream);
 
-        if (loader && loader->canLoad(stream))
-        {
-            stream.seekg(0, std::ios_base::beg);
+        if (!loader || !loader->canLoad(stream)) return;
+    }
 
-            _aasFile = loader->loadFromStream(stream);
+    // The header has been consumed by the checks above, re-open the file for parsing
+    file = GlobalFileSystem().openTextFileInAbsolutePath(_info.absolutePath);
 
-            // Construct a renderable to attach to the rendersystem
-            _renderable.setAasFile(_aasFile);
-        }
+    if (!file) return;
+
+    try
+    {
+        _fileSize = static_cast<std::size_t>(fs::file_size(_info.absolutePath));
+    }
+    catch (const fs::filesystem_error&)
+    {
+        _fileSize = 0; // no progress information
+    }
+
+    _bytesLoaded = 0;
+
+    // Large AAS files take a while to parse, do this in the background
+    _loadResult = std::async(std::launch::async, [this, file, loader]()
+    {
+        stream::ProgressTrackingInputStream progressStream(file->getInputStream(), _bytesLoaded);
+        std::istream stream(&progressStream);
+
+        return loader->loadFromStream(stream);
+    });
+
+    updateProgress();
+    _loadTimer.Start(LOAD_POLL_INTERVAL_MSECS);
+}
+
+bool AasControl::isLoading() const
+{
+    return _loadResult.valid();
+}
+
+void AasControl::onLoadFinished()
+{
+    _loadTimer.Stop();
+    _toggle->SetLabel(_info.type.fileExtension);
+
+    try
+    {
+        _aasFile = _loadResult.get();
+    }
+    catch (const std::exception& ex)
+    {
+        onLoadFailed(ex.what());
+        return;
+    }
+
+    if (!_aasFile)
+    {
+        // The loader has already written the details to the console
+        onLoadFailed(_("The file could not be parsed, check the console for details."));
+        return;
+    }
+
+    // Construct the renderables, this is visible right away if we're attached
+    _renderable.setAasFile(_aasFile);
+
+    GlobalMainFrame().updateAllWindows();
+}
+
+void AasControl::onLoadFailed(const std::string& reason)
+{
+    rError() << "Failed to load AAS file " << _info.absolutePath << ": " << reason << std::endl;
+
+    // Nothing to show, switch the control off again
+    if (_toggle->GetValue())
+    {
+        _toggle->SetValue(false);
+        GlobalRenderSystem().detachRenderable(_renderable);
+    }
+
+    wxutil::Messagebox::ShowError(
+        fmt::format(_("Failed to load the AAS file {0}:\n{1}"), _info.absolutePath, reason),
+        wxGetTopLevelParent(_toggle));
+
+    GlobalMainFrame().updateAllWindows();
+}
+
+void AasControl::updateProgress()
+{
+    std::size_t percentage = _fileSize > 0 ? std::min<std::size_t>(_bytesLoaded * 100 / _fileSize, 100) : 0;
+
+    _toggle->SetLabel(fmt::format(_("{0} (loading {1:d}%)"), _info.type.fileExtension, percentage));
+}
+
+void AasControl::onLoadTimer(wxTimerEvent& ev)
+{
+    if (!isLoading())
+    {
+        _loadTimer.Stop();
+        return;
+    }
+
+    if (_loadResult.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        onLoadFinished();
+    }
+    else
+    {
+        updateProgress();
     }
 }
 
@@ -91,6 +212,7 @@ void AasControl::onToggle(wxCommandEvent& ev)
 {
     if (_toggle->GetValue())
     {
+        // The renderable stays empty until the file has been parsed
         ensureAasFileLoaded();
         GlobalRenderSystem().attachRenderable(_renderable);
     }
@@ -105,17 +227,32 @@ void AasControl::onToggle(wxCommandEvent& ev)
 
 void AasControl::onRefresh(wxCommandEvent& ev)
 {
-    // Detach renderable
+    // Discard any load in progress, it might refer to an outdated file
+    if (isLoading())
+    {
+        _loadTimer.Stop();
+        _toggle->SetLabel(_info.type.fileExtension);
+
+        try
+        {
+            _loadResult.get();
+        }
+        catch (const std::exception& ex)
+        {
+            // The result is discarded anyway, the file is parsed again below
+            rWarning() << "Discarding failed load of AAS file " << _info.absolutePath << ": " << ex.what() << std::endl;
+        }
+    }
+
     _aasFile.reset();
+    _renderable.setAasFile(_aasFile);
 
     if (_toggle->GetValue())
     {
-		GlobalRenderSystem().detachRenderable(_renderable);
-
         ensureAasFileLoaded();
-
-        GlobalRenderSystem().attachRenderable(_renderable);
     }
+
+    GlobalMainFrame().updateAllWindows();
 }
 
 } // namespace ui
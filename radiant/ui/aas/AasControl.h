@@ -1,6 +1,9 @@
 #pragma once
 
 #include <wx/event.h>
+#include <wx/timer.h>
+#include <atomic>
+#include <future>
 #include <memory>
 #include "iaasfile.h"
 #include "RenderableAasFile.h"
@@ -40,6 +43,16 @@ private:
     // The renderable that is attached to the rendersystem when active
     map::RenderableAasFile _renderable;
 
+    // The AAS file is parsed in a worker thread, this is its result
+    std::future<map::IAasFilePtr> _loadResult;
+
+    // Parse progress, updated by the worker thread
+    std::atomic<std::size_t> _bytesLoaded;
+    std::size_t _fileSize;
+
+    // Polls the worker while the AAS file is loading
+    wxTimer _loadTimer;
+
 public:
 	AasControl(wxWindow* parent, const map::AasFileInfo& info);
 
@@ -53,10 +66,19 @@ public:
 	void update();
 
 private:
+    // Starts parsing the AAS file in the background, if not loaded yet
     void ensureAasFileLoaded();
+    bool isLoading() const;
+
+    void onLoadFinished();
+
+    // Reports the error and switches the control off
+    void onLoadFailed(const std::string& reason);
+    void updateProgress();
 
 	void onToggle(wxCommandEvent& ev);
 	void onRefresh(wxCommandEvent& ev);
+	void onLoadTimer(wxTimerEvent& ev);
 };
 typedef std::shared_ptr<AasControl> AasControlPtr;
 
@@ -3,12 +3,72 @@
 #include "iregistry.h"
 #include "imainframe.h"
 #include "ivolumetest.h"
+#include "igl.h"
 
 #include "registry/registry.h"
+#include "string/convert.h"
+#include "math/Matrix4.h"
+#include "math/AABB.h"
 
 namespace map
 {
 
+namespace
+{
+    // Corner indices (as returned by AABB::getCorners) of the six box quads,
+    // in the order of the face normals in aabb_normals
+    const std::size_t BOX_QUAD_INDICES[24] =
+    {
+        2, 1, 5, 6,
+        1, 0, 4, 5,
+        0, 1, 2, 3,
+        0, 3, 7, 4,
+        3, 2, 6, 7,
+        7, 6, 5, 4,
+    };
+}
+
+void AasAreaBoxes::build(const AasAreaTree& areaTree)
+{
+    std::size_t numAreas = areaTree.getNumAreas();
+
+    _vertices.clear();
+    _vertices.reserve(numAreas * 24);
+
+    for (std::size_t areaIndex = 0; areaIndex < numAreas; ++areaIndex)
+    {
+        Vector3 corners[8];
+        areaTree.getAreaBounds(areaIndex).getCorners(corners);
+
+        for (std::size_t i = 0; i < 24; ++i)
+        {
+            const Vector3& normal = aabb_normals[i / 4];
+            const Vector3& corner = corners[BOX_QUAD_INDICES[i]];
+
+            _vertices.push_back(Vertex
+            {
+                Vector3f(static_cast<float>(corner.x()), static_cast<float>(corner.y()), static_cast<float>(corner.z())),
+                Vector3f(static_cast<float>(normal.x()), static_cast<float>(normal.y()), static_cast<float>(normal.z()))
+            });
+        }
+    }
+}
+
+void AasAreaBoxes::clear()
+{
+    _vertices.clear();
+}
+
+void AasAreaBoxes::render(std::size_t firstArea, std::size_t numAreas) const
+{
+    if (_vertices.empty() || numAreas == 0) return;
+
+    glVertexPointer(3, GL_FLOAT, sizeof(Vertex), &_vertices.front().vertex);
+    glNormalPointer(GL_FLOAT, sizeof(Vertex), &_vertices.front().normal);
+
+    glDrawArrays(GL_QUADS, static_cast<GLint>(firstArea * 24), static_cast<GLsizei>(numAreas * 24));
+}
+
 RenderableAasFile::RenderableAasFile() :
 	_renderNumbers(registry::getValue<bool>(RKEY_SHOW_AAS_AREA_NUMBERS)),
 	_hideDistantAreas(registry::getValue<bool>(RKEY_HIDE_DISTANT_AAS_AREAS)),
@@ -38,26 +98,21 @@ void RenderableAasFile::setRenderSystem(const RenderSystemPtr& renderSystem)
 
 void RenderableAasFile::renderSolid(RenderableCollector& collector, const VolumeTest& volume) const
 {
-	if (!_aasFile) return;
+	if (!_aasFile || _areaTree.empty()) return;
 
 	// Get the camera position for distance clipping
 	Matrix4 invModelView = volume.GetModelview().getFullInverse();
 	Vector3 viewPos = invModelView.t().getProjected();
 
-	for (const RenderableSolidAABB& aabb : _renderableAabbs)
-	{
-		if (_hideDistantAreas && (aabb.getAABB().getOrigin() - viewPos).getLengthSquared() > _hideDistanceSquared)
+	_areaTree.forEachVisible(volume, viewPos, _hideDistantAreas ? _hideDistanceSquared : 0,
+		[&](std::size_t nodeIndex)
 		{
-			continue;
-		}
-
-		collector.addRenderable(*_normalShader, aabb, Matrix4::getIdentity());
-	}
-
-	if (_renderNumbers)
-	{
-		collector.addRenderable(*_normalShader, *this, Matrix4::getIdentity());
-	}
+			collector.addRenderable(*_normalShader, _nodeRanges[nodeIndex], Matrix4::getIdentity());
+		},
+		[&](std::size_t areaIndex)
+		{
+			collector.addRenderable(*_normalShader, _areaRanges[areaIndex], Matrix4::getIdentity());
+		});
 }
 
 void RenderableAasFile::renderWireframe(RenderableCollector& collector, const VolumeTest& volume) const
@@ -77,27 +132,31 @@ void RenderableAasFile::setAasFile(const IAasFilePtr& aasFile)
 	prepare();
 }
 
-void RenderableAasFile::render(const RenderInfo& info) const
+void RenderableAasFile::renderAreas(std::size_t firstArea, std::size_t numAreas) const
 {
-	// draw label
-	// Render the area numbers
-	for (std::size_t areaNum = 0; areaNum < _aasFile->getNumAreas(); ++areaNum)
-	{
-		const IAasFile::Area& area = _aasFile->getArea(static_cast<int>(areaNum));
+	_areaBoxes.render(firstArea, numAreas);
 
-		if (_hideDistantAreas && (area.center - info.getViewerLocation()).getLengthSquared() > _hideDistanceSquared)
-		{
-			continue;
-		}
+	if (!_renderNumbers) return;
 
-		glRasterPos3dv(area.center);
+	for (std::size_t i = firstArea; i < firstArea + numAreas; ++i)
+	{
+		int areaNum = _areaTree.getAreaNum(i);
+
+		glRasterPos3dv(_aasFile->getArea(areaNum).center);
 		GlobalOpenGL().drawString(string::to_string(areaNum));
 	}
 }
 
 void RenderableAasFile::prepare()
 {
-	if (!_aasFile) return;
+	if (!_aasFile)
+	{
+		_areaTree.clear();
+		_areaBoxes.clear();
+		_nodeRanges.clear();
+		_areaRanges.clear();
+		return;
+	}
 
 	_normalShader = GlobalRenderSystem().capture("$AAS_AREA");
 
@@ -106,13 +165,23 @@ void RenderableAasFile::prepare()
 
 void RenderableAasFile::constructRenderables()
 {
-	_renderableAabbs.clear();
+	_areaTree.build(*_aasFile);
+	_areaBoxes.build(_areaTree);
+
+	_nodeRanges.clear();
+	_nodeRanges.reserve(_areaTree.getNumNodes());
 
-	for (std::size_t areaNum = 0; areaNum < _aasFile->getNumAreas(); ++areaNum)
+	for (std::size_t nodeIndex = 0; nodeIndex < _areaTree.getNumNodes(); ++nodeIndex)
 	{
-		const IAasFile::Area& area = _aasFile->getArea(static_cast<int>(areaNum));
+		_nodeRanges.emplace_back(*this, _areaTree.getFirstArea(nodeIndex), _areaTree.getNumAreas(nodeIndex));
+	}
+
+	_areaRanges.clear();
+	_areaRanges.reserve(_areaTree.getNumAreas());
 
-		_renderableAabbs.push_back(RenderableSolidAABB(area.bounds));
+	for (std::size_t areaIndex = 0; areaIndex < _areaTree.getNumAreas(); ++areaIndex)
+	{
+		_areaRanges.emplace_back(*this, areaIndex, 1);
 	}
 }
 
@@ -1,13 +1,14 @@
 #pragma once
 
-#include <list>
+#include <vector>
 #include <sigc++/trackable.h>
 
 #include "irenderable.h"
 #include "irender.h"
 #include "iaasfile.h"
+#include "math/Vector3.h"
 
-#include "entitylib.h"
+#include "AasAreaTree.h"
 
 namespace map
 {
@@ -16,21 +17,78 @@ const char* const RKEY_SHOW_AAS_AREA_NUMBERS = "user/ui/aasViewer/showNumbers";
 const char* const RKEY_HIDE_DISTANT_AAS_AREAS = "user/ui/aasViewer/hideDistantAreas";
 const char* const RKEY_AAS_AREA_HIDE_DISTANCE = "user/ui/aasViewer/hideDistance";
 
+// Draws the bounds of the areas of an AAS file.
+// The box faces of all areas (including their normals) are kept in one
+// client-side vertex array, in the order of the area tree, so the areas
+// below any tree node can be drawn with a single call.
+// No GL objects are owned, so this can be destroyed without a current GL context.
+class AasAreaBoxes
+{
+private:
+    struct Vertex
+    {
+        Vector3f vertex;
+        Vector3f normal;
+    };
+
+    // 24 vertices (six quads) per area, in tree order
+    std::vector<Vertex> _vertices;
+
+public:
+    void build(const AasAreaTree& areaTree);
+
+    void clear();
+
+    // Draws the given range of areas (in tree order)
+    void render(std::size_t firstArea, std::size_t numAreas) const;
+};
+
 // Renderable drawing all the area bounds of the attached AAS file,
-// optionally showing the area numbers too
+// optionally showing the area numbers too.
+// Only the areas intersecting the view (and within the hide distance)
+// are submitted, which are looked up in a bounding volume hierarchy.
 class RenderableAasFile :
     public Renderable,
-	public OpenGLRenderable,
 	public sigc::trackable
 {
 private:
+    // A range of areas (in tree order) submitted to the collector. There's
+    // one for every tree node and one for every single area, so the objects
+    // submitted for each view are never changed after submission.
+    class AreaRange :
+        public OpenGLRenderable
+    {
+    private:
+        const RenderableAasFile& _owner;
+        std::size_t _firstArea;
+        std::size_t _numAreas;
+
+    public:
+        AreaRange(const RenderableAasFile& owner, std::size_t firstArea, std::size_t numAreas) :
+            _owner(owner),
+            _firstArea(firstArea),
+            _numAreas(numAreas)
+        {}
+
+        void render(const RenderInfo& info) const override
+        {
+            _owner.renderAreas(_firstArea, _numAreas);
+        }
+    };
+
     RenderSystemPtr _renderSystem;
 
     IAasFilePtr _aasFile;
 
 	ShaderPtr _normalShader;
 
-    std::list<RenderableSolidAABB> _renderableAabbs;
+    AasAreaTree _areaTree;
+
+    AasAreaBoxes _areaBoxes;
+
+    // Indexed by tree node and by area (in tree order), respectively
+    std::vector<AreaRange> _nodeRanges;
+    std::vector<AreaRange> _areaRanges;
 
 	bool _renderNumbers;
 	bool _hideDistantAreas;
@@ -46,11 +104,11 @@ public:
 
 	void setAasFile(const IAasFilePtr& aasFile);
 
-	void render(const RenderInfo& info) const override;
-
 private:
 	void prepare();
 	void constructRenderables();
+
+	void renderAreas(std::size_t firstArea, std::size_t numAreas) const;
 };
 
 } // namespace
@@ -18,6 +18,11 @@
 namespace ui
 {
 
+namespace
+{
+    const int THUMBNAIL_POLL_INTERVAL_MSECS = 100;
+}
+
 // Constructor. Create widgets.
 
 TexturePreviewCombo::TexturePreviewCombo(wxWindow* parent) :
@@ -44,6 +49,13 @@ TexturePreviewCombo::TexturePreviewCombo(wxWindow* parent) :
 		new wxutil::StockIconTextMenuItem(_("Copy shader name"), wxART_COPY),
         std::bind(&TexturePreviewCombo::_onCopyTexName, this)
     );
+
+    _thumbnailTimer.Bind(wxEVT_TIMER, &TexturePreviewCombo::_onThumbnailTimer, this);
+}
+
+TexturePreviewCombo::~TexturePreviewCombo()
+{
+    _thumbnailTimer.Stop();
 }
 
 // Update the selected texture
@@ -98,6 +110,11 @@ void TexturePreviewCombo::_onContextMenu(wxDataViewEvent& ev)
 	_contextMenu->show(_infoTable);
 }
 
+void TexturePreviewCombo::_onThumbnailTimer(wxTimerEvent& ev)
+{
+	_glWidget->Refresh();
+}
+
 // CALLBACKS
 bool TexturePreviewCombo::_onRender()
 {
@@ -127,10 +144,15 @@ bool TexturePreviewCombo::_onRender()
 		// Get a reference to the selected shader
 		MaterialPtr shader = GlobalMaterialManager().getMaterialForName(_texName);
 
-		// This is an "ordinary" texture, take the editor image
-		TexturePtr tex = shader->getEditorImage();
+		// This is an "ordinary" texture, take the editor image thumbnail
+		TexturePtr tex = shader->getEditorImageThumbnail();
 
-		if (tex != NULL)
+		if (!tex)
+		{
+			// Check back until the thumbnail has been generated
+			_thumbnailTimer.StartOnce(THUMBNAIL_POLL_INTERVAL_MSECS);
+		}
+		else
 		{
 			glBindTexture(GL_TEXTURE_2D, tex->getGLTexNum());
 
@@ -3,6 +3,7 @@
 #include <string>
 #include "wxutil/menu/PopupMenu.h"
 #include <wx/panel.h>
+#include <wx/timer.h>
 
 namespace wxutil
 { 
@@ -34,12 +35,17 @@ class TexturePreviewCombo :
 	// Context menu
 	wxutil::PopupMenuPtr _contextMenu;
 
+	// Refreshes the preview until the thumbnail is available
+	wxTimer _thumbnailTimer;
+
 public:
 
 	/** Constructor creates widgets.
 	 */
 	TexturePreviewCombo(wxWindow* parent);
 
+	~TexturePreviewCombo();
+
 	/** Set the texture to preview.
 	 *
 	 * @param tex
@@ -59,6 +65,8 @@ private:
 
 	// Popupmenu event
 	void _onContextMenu(wxDataViewEvent& ev);
+
+	void _onThumbnailTimer(wxTimerEvent& ev);
 };
 
 } // namespace
@@ -23,6 +23,7 @@
 
 #include "string/predicate.h"
 #include <functional>
+#include <map>
 
 #include <wx/panel.h>
 #include <wx/wxprec.h>
@@ -51,6 +52,8 @@ namespace
 
     const int VIEWPORT_BORDER = 12;
     const int TILE_BORDER = 6;
+
+    const int THUMBNAIL_POLL_INTERVAL_MSECS = 100;
 }
 
 class TextureBrowser::TextureTile
@@ -62,6 +65,9 @@ public:
     Vector2i position;
     MaterialPtr material;
 
+    // The editor image thumbnail, requested once the tile is scrolled into view
+    TexturePtr texture;
+
     TextureTile(TextureBrowser& owner) :
         _owner(owner)
     {}
@@ -78,20 +84,47 @@ public:
             return;
         }
 
-        TexturePtr texture = material->getEditorImage();
-        if (!texture) return;
-
         // Is this texture visible?
         if ((position.y() - size.y() - FONT_HEIGHT() < _owner.getOriginY()) &&
             (position.y() > _owner.getOriginY() - _owner.getViewportHeight()))
         {
             drawBorder();
-            drawTextureQuad(texture->getGLTexNum());
+
+            if (!texture)
+            {
+                requestThumbnail();
+            }
+
+            if (texture)
+            {
+                drawTextureQuad(texture->getGLTexNum());
+            }
+
             drawTextureName();
         }
     }
 
 private:
+    void requestThumbnail()
+    {
+        texture = material->getEditorImageThumbnail();
+
+        if (!texture)
+        {
+            // Still being generated, check back later
+            _owner._thumbnailsPending = true;
+            return;
+        }
+
+        // Tiles without thumbnail are laid out as squares, re-arrange the
+        // tiles if this one has a different aspect ratio
+        if (_owner.getTextureWidth(*texture) != size.x() ||
+            _owner.getTextureHeight(*texture) != size.y())
+        {
+            _owner.queueUpdate();
+        }
+    }
+
     void drawBorder()
     {
         // borders rules:
@@ -225,7 +258,8 @@ TextureBrowser::TextureBrowser(wxWindow* parent) :
     _showOtherMaterials(registry::getValue<bool>(RKEY_TEXTURES_SHOW_OTHER_MATERIALS)),
     _uniformTextureSize(registry::getValue<int>(RKEY_TEXTURE_UNIFORM_SIZE)),
     _maxNameLength(registry::getValue<int>(RKEY_TEXTURE_MAX_NAME_LENGTH)),
-    _updateNeeded(true)
+    _updateNeeded(true),
+    _thumbnailsPending(false)
 {
     observeKey(RKEY_TEXTURES_HIDE_UNUSED);
     observeKey(RKEY_TEXTURES_SHOW_OTHER_MATERIALS);
@@ -260,6 +294,7 @@ TextureBrowser::TextureBrowser(wxWindow* parent) :
         sigc::mem_fun(this, &TextureBrowser::onActiveShadersChanged));
 
     Connect(wxEVT_IDLE, wxIdleEventHandler(TextureBrowser::onIdle), nullptr, this);
+    _thumbnailTimer.Bind(wxEVT_TIMER, &TextureBrowser::onThumbnailTimer, this);
 
     SetSizer(new wxBoxSizer(wxHORIZONTAL));
 
@@ -347,6 +382,8 @@ TextureBrowser::TextureBrowser(wxWindow* parent) :
 
 TextureBrowser::~TextureBrowser()
 {
+    _thumbnailTimer.Stop();
+
     GlobalTextureBrowser().unregisterTextureBrowser(this);
 }
 
@@ -481,10 +518,10 @@ public:
 };
 
 TextureBrowser::Vector2i TextureBrowser::getPositionForTexture(
-    CurrentPosition& currentPos, const Texture& tex) const
+    CurrentPosition& currentPos, const Vector2i& size) const
 {
-    int nWidth = getTextureWidth(tex);
-    int nHeight = getTextureHeight(tex);
+    int nWidth = size.x();
+    int nHeight = size.y();
 
     // Wrap to the next row if there is not enough horizontal space for this
     // texture
@@ -604,6 +641,18 @@ void TextureBrowser::performUpdate()
 {
     _updateNeeded = false;
 
+    // Keep the thumbnails of the tiles drawn so far, the others
+    // are requested by the tiles once they are scrolled into view
+    std::map<MaterialPtr, TexturePtr> thumbnails;
+
+    for (const TextureTile& tile : _tiles)
+    {
+        if (tile.texture)
+        {
+            thumbnails.emplace(tile.material, tile.texture);
+        }
+    }
+
     // Update all renderable items
     _tiles.clear();
 
@@ -625,11 +674,22 @@ void TextureBrowser::performUpdate()
 
         tile.material = mat;
 
-        Texture& texture = *tile.material->getEditorImage();
+        auto thumbnail = thumbnails.find(mat);
+
+        if (thumbnail != thumbnails.end())
+        {
+            tile.texture = thumbnail->second;
+            tile.size.x() = getTextureWidth(*tile.texture);
+            tile.size.y() = getTextureHeight(*tile.texture);
+        }
+        else
+        {
+            // Reserve a square tile until the thumbnail is known
+            tile.size.x() = _uniformTextureSize;
+            tile.size.y() = _uniformTextureSize;
+        }
 
-        tile.position = getPositionForTexture(layout, texture);
-        tile.size.x() = getTextureWidth(texture);
-        tile.size.y() = getTextureHeight(texture);
+        tile.position = getPositionForTexture(layout, tile.size);
 
         _entireSpaceHeight = std::max(
             _entireSpaceHeight,
@@ -740,11 +800,19 @@ void TextureBrowser::draw()
     glEnable (GL_TEXTURE_2D);
 	glPolygonMode (GL_FRONT_AND_BACK, GL_FILL);
 
+    _thumbnailsPending = false;
+
     for (TextureTile& tile : _tiles)
     {
         tile.render();
     }
 
+    // Draw again once the requested thumbnails have been generated
+    if (_thumbnailsPending && !_thumbnailTimer.IsRunning())
+    {
+        _thumbnailTimer.StartOnce(THUMBNAIL_POLL_INTERVAL_MSECS);
+    }
+
 	debug::assertNoGlErrors();
 
     // reset the current texture
@@ -944,6 +1012,15 @@ void TextureBrowser::onIdle(wxIdleEvent& ev)
     }
 }
 
+void TextureBrowser::onThumbnailTimer(wxTimerEvent& ev)
+{
+    // The visible tiles pick up the thumbnails generated in the meantime
+    if (IsShownOnScreen())
+    {
+        queueDraw();
+    }
+}
+
 bool TextureBrowser::onRender()
 {
     if (!GlobalMainFrame().screenUpdatesEnabled())
@@ -9,6 +9,7 @@
 
 #include "TextureBrowserManager.h"
 #include <wx/panel.h>
+#include <wx/timer.h>
 
 namespace wxutil
 {
@@ -117,6 +118,13 @@ class TextureBrowser :
 
     // renderable items will be updated next round
     bool _updateNeeded;
+
+    // Set by the tiles if a thumbnail they requested in this draw pass
+    // is still being generated
+    bool _thumbnailsPending;
+
+    // Polls for thumbnails which are still being generated
+    wxTimer _thumbnailTimer;
     
 public:
     // Constructor
@@ -156,11 +164,11 @@ private:
     int getTextureWidth(const Texture& tex) const;
     int getTextureHeight(const Texture& tex) const;
 
-    // Get a new position for the given texture, and advance the CurrentPosition
-    // state object.
+    // Get a new position for a tile of the given size, and advance the
+    // CurrentPosition state object.
     class CurrentPosition;
     Vector2i getPositionForTexture(CurrentPosition& layout,
-                                   const Texture& texture) const;
+                                   const Vector2i& size) const;
 
     bool checkSeekInMediaBrowser(); // sensitivity check
     void onSeekInMediaBrowser();
@@ -226,6 +234,7 @@ private:
 
 	// wx callbacks
     void onIdle(wxIdleEvent& ev);
+    void onThumbnailTimer(wxTimerEvent& ev);
 	bool onRender();
 	void onScrollChanged(wxScrollEvent& ev);
 	void onGLResize(wxSizeEvent& ev);
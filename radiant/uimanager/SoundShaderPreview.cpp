@@ -162,13 +162,16 @@ void SoundShaderPreview::update()
 			// Retrieve the list of associated filenames (VFS paths)
 			auto list = shader->getSoundFileList();
 
+            // Files without known duration, these are queried in one go
+            std::vector<std::string> unknownDurations;
+
 			for (std::size_t i = 0; i < list.size(); ++i)
 			{
 				auto row = _listStore->AddItem();
                 const auto& soundFile = list[i];
 
 				row[_columns.soundFile] = soundFile;
-				row[_columns.duration] = getDurationOrPlaceholder(soundFile);
+				row[_columns.duration] = getDurationOrPlaceholder(soundFile, unknownDurations);
 
 				row.SendItemAdded();
 
@@ -179,6 +182,11 @@ void SoundShaderPreview::update()
 				}
 			}
 
+            if (!unknownDurations.empty())
+            {
+                loadFileDurationsAsync(unknownDurations);
+            }
+
 			_shaderNameLabel->SetLabel(shader->getName());
 			_shaderFileLabel->SetLabel(shader->getShaderFilePath());
 			_shaderDescriptionSizer->Layout();
@@ -269,7 +277,8 @@ void SoundShaderPreview::onStop(wxCommandEvent& ev)
 	_statusLabel->SetLabel("");
 }
 
-std::string SoundShaderPreview::getDurationOrPlaceholder(const std::string& soundFile)
+std::string SoundShaderPreview::getDurationOrPlaceholder(const std::string& soundFile,
+    std::vector<std::string>& unknownDurations)
 {
     {
         std::lock_guard<std::mutex> lock(_durationsLock);
@@ -282,65 +291,56 @@ std::string SoundShaderPreview::getDurationOrPlaceholder(const std::string& soun
         }
     }
 
-    // No duration known yet, queue a task
-    loadFileDurationAsync(soundFile);
+    // No duration known yet, the caller will queue a task
+    unknownDurations.push_back(soundFile);
     return "--:--";
 }
 
-void SoundShaderPreview::loadFileDurationAsync(const std::string& soundFile)
+void SoundShaderPreview::loadFileDurationsAsync(const std::vector<std::string>& soundFiles)
 {
-    _durationQueries.enqueue([this, soundFile] // copy strings into lambda
+    _durationQueries.enqueue([this, soundFiles] // copy strings into lambda
     {
-        try
+        // Let the sound manager decode the file headers in parallel
+        GlobalSoundManager().cacheSoundFileDurations(soundFiles);
+
+        for (const auto& soundFile : soundFiles)
         {
-            // In case the duration has been calculated in the meantime
-            // check if there's still need for this task to run
-            float duration = -1.0f;
+            try
             {
-                std::lock_guard<std::mutex> lock(_durationsLock);
+                // This is not decoding anything anymore, unless the file is broken
+                float duration = GlobalSoundManager().getSoundFileDuration(soundFile);
 
-                auto existing = _durations.find(soundFile);
-                
-                if (existing != _durations.end())
                 {
-                    duration = existing->second;
+                    // Store the duration in the local cache
+                    std::lock_guard<std::mutex> lock(_durationsLock);
+                    _durations[soundFile] = duration;
                 }
-            }
 
-            if (duration < 0)
-            {
-                // Duration still unknown, run the query
-                duration = GlobalSoundManager().getSoundFileDuration(soundFile);
+                if (_isShuttingDown)
+                {
+                    // Don't dispatch anything if we're shutting down
+                    return;
+                }
 
-                // Store the duration in the local cache
-                std::lock_guard<std::mutex> lock(_durationsLock);
-                _durations[soundFile] = duration;
+                // Dispatch to UI thread when we're done
+                GetUserInterfaceModule().dispatch([this, soundFile, duration]()
+                {
+                    // Load into treeview
+                    auto item = _listStore->FindString(soundFile, _columns.soundFile);
+
+                    if (item.IsOk())
+                    {
+                        wxutil::TreeModel::Row row(item, *_listStore);
+                        row[_columns.duration] = getDurationString(duration);
+                        row.SendItemChanged();
+                    }
+                });
             }
-
-            if (_isShuttingDown)
+            catch (const std::out_of_range& ex)
             {
-                // Don't dispatch anything if we're shutting down
-                return;
+                rError() << "Cannot query sound file duration of " << soundFile
+                    << ": " << ex.what() << std::endl;
             }
-
-            // Dispatch to UI thread when we're done
-            GetUserInterfaceModule().dispatch([this, soundFile, duration]()
-            {
-                // Load into treeview
-                auto item = _listStore->FindString(soundFile, _columns.soundFile);
-
-                if (item.IsOk())
-                {
-                    wxutil::TreeModel::Row row(item, *_listStore);
-                    row[_columns.duration] = getDurationString(duration);
-                    row.SendItemChanged();
-                }
-            });
-        }
-        catch (const std::out_of_range& ex)
-        {
-            rError() << "Cannot query sound file duration of " << soundFile 
-                << ": " << ex.what() << std::endl;
         }
     });
 }
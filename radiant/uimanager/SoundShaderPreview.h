@@ -3,6 +3,7 @@
 #include <string>
 #include <mutex>
 #include <map>
+#include <vector>
 #include <memory>
 #include "wxutil/TreeModel.h"
 #include "wxutil/TreeView.h"
@@ -108,8 +109,12 @@ private:
 	void playSelectedFile(bool loop);
 	void handleSelectionChange();
 
-    void loadFileDurationAsync(const std::string& soundFile);
-    std::string getDurationOrPlaceholder(const std::string& soundFile);
+    // Queries the durations of the given files in a single background task
+    void loadFileDurationsAsync(const std::vector<std::string>& soundFiles);
+
+    // Returns the formatted duration, or a placeholder after adding the file to the given list
+    std::string getDurationOrPlaceholder(const std::string& soundFile,
+        std::vector<std::string>& unknownDurations);
 };
 
 } // namespace ui
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <vector>
+#include "render/VBO.h"
+#include "render/Vertex3f.h"
+
+namespace ui
+{
+
+/**
+ * Single-coloured geometry drawn by the ortho views in addition to the
+ * scene (grid lines, camera icon, etc.), kept in a vertex buffer between
+ * frames.
+ *
+ * The geometry is identified by a key holding all the values it has been
+ * generated from (grid size, zoom level, viewport...). Clients only need
+ * to regenerate it if isOutdated() reports a different key. Geometry
+ * following the view can be generated relative to a fixed origin and drawn
+ * with an offset, so it doesn't need to be regenerated when panning.
+ *
+ * The vertex buffer is not deleted on destruction, as there might be no GL
+ * context left at that point. The owning view calls releaseBuffer() while
+ * tearing down its GL context.
+ */
+class CachedGeometry
+{
+public:
+    typedef std::vector<double> Key;
+    typedef std::vector<Vertex3f> Vertices;
+
+private:
+    // All batches, one after the other
+    Vertices _vertices;
+
+    // Start index and size of each batch
+    std::vector<std::pair<std::size_t, std::size_t>> _batches;
+
+    // The vertex buffer is created on the next render call if this is 0
+    mutable GLuint _vbo;
+
+    GLenum _mode;
+
+    Key _key;
+    bool _valid;
+
+public:
+    CachedGeometry() :
+        _vbo(0),
+        _mode(GL_LINES),
+        _valid(false)
+    {}
+
+    CachedGeometry(const CachedGeometry& other) = delete;
+    CachedGeometry& operator=(const CachedGeometry& other) = delete;
+
+    // Returns true if the stored geometry has not been generated from the given values
+    bool isOutdated(const Key& key) const
+    {
+        return !_valid || key != _key;
+    }
+
+    // Replaces the geometry, the batches are drawn one after the other using the given mode
+    void update(const Key& key, GLenum mode, const std::vector<Vertices>& batches)
+    {
+        Vertices vertices;
+        _batches.clear();
+
+        for (const auto& batch : batches)
+        {
+            if (batch.empty()) continue;
+
+            _batches.emplace_back(vertices.size(), batch.size());
+            vertices.insert(vertices.end(), batch.begin(), batch.end());
+        }
+
+        // Keep the buffer if the new vertices fit in, it's deleted otherwise
+        if (!vertices.empty())
+        {
+            render::replaceVBODataIfPossible(GL_ARRAY_BUFFER, _vbo, _vertices, vertices);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+
+        _vertices.swap(vertices);
+
+        _mode = mode;
+        _key = key;
+        _valid = true;
+    }
+
+    // Convenience overload for geometry consisting of a single batch
+    void update(const Key& key, GLenum mode, const Vertices& vertices)
+    {
+        update(key, mode, std::vector<Vertices>(1, vertices));
+    }
+
+    // Drops the geometry, the next isOutdated() call will return true
+    void clear()
+    {
+        _valid = false;
+    }
+
+    // Deletes the vertex buffer, this needs the GL context to be current.
+    // The buffer is created again when rendering the next time.
+    void releaseBuffer()
+    {
+        render::deleteVBO(_vbo);
+    }
+
+    // Draws the geometry using the current colour and GL state
+    void render() const
+    {
+        if (_vertices.empty()) return;
+
+        if (_vbo == 0)
+        {
+            _vbo = render::makeVBOFromArray(GL_ARRAY_BUFFER, _vertices);
+        }
+
+        glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+        glEnableClientState(GL_VERTEX_ARRAY);
+
+        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+        glVertexPointer(3, GL_DOUBLE, sizeof(Vertex3f), nullptr);
+
+        for (const auto& batch : _batches)
+        {
+            glDrawArrays(_mode, static_cast<GLint>(batch.first), static_cast<GLsizei>(batch.second));
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glPopClientAttrib();
+    }
+
+    // Draws the geometry translated by the given offset
+    void render(const Vector3& offset) const
+    {
+        glPushMatrix();
+        glTranslated(offset.x(), offset.y(), offset.z());
+
+        render();
+
+        glPopMatrix();
+    }
+};
+
+}
@@ -43,6 +43,7 @@ namespace
 	const std::string RKEY_SHOW_OUTLINE = RKEY_XYVIEW_ROOT + "/showOutline";
 	const std::string RKEY_SHOW_AXES = RKEY_XYVIEW_ROOT + "/showAxes";
 	const std::string RKEY_SHOW_WORKZONE = RKEY_XYVIEW_ROOT + "/showWorkzone";
+	const std::string RKEY_SHOW_RENDER_STATS = RKEY_XYVIEW_ROOT + "/showRenderStatistics";
 	const std::string RKEY_DEFAULT_BLOCKSIZE = "user/ui/xyview/defaultBlockSize";
 	const std::string RKEY_TRANSLATE_CONSTRAINED = "user/ui/xyview/translateConstrained";
 
@@ -154,6 +155,19 @@ void XYWndManager::destroyViews()
 	_activeXY = XYWndPtr();
 }
 
+void XYWndManager::foreachView(const std::function<void(const XYWnd&)>& functor) const
+{
+	for (const XYWndMap::value_type& i : _xyWnds)
+	{
+		functor(*i.second);
+	}
+}
+
+OrthoFrontEnd& XYWndManager::getFrontEnd()
+{
+	return *_frontEnd;
+}
+
 void XYWndManager::registerCommands() 
 {
 	GlobalCommandSystem().addCommand("NewOrthoView", std::bind(&XYWndManager::createXYFloatingOrthoView, this, std::placeholders::_1));
@@ -196,6 +210,7 @@ void XYWndManager::constructPreferences()
 	page.appendCheckBox(_("Show Axes"), RKEY_SHOW_AXES);
 	page.appendCheckBox(_("Show Window Outline"), RKEY_SHOW_OUTLINE);
 	page.appendCheckBox(_("Show Workzone"), RKEY_SHOW_WORKZONE);
+	page.appendCheckBox(_("Show Render Statistics"), RKEY_SHOW_RENDER_STATS);
 	page.appendCheckBox(_("Translate Manipulator always constrained to Axis"), RKEY_TRANSLATE_CONSTRAINED);
 	page.appendCheckBox(_("Higher Selection Priority for Entities"), RKEY_HIGHER_ENTITY_PRIORITY);
 }
@@ -214,6 +229,7 @@ void XYWndManager::refreshFromRegistry()
 	_showOutline = registry::getValue<bool>(RKEY_SHOW_OUTLINE);
 	_showAxes = registry::getValue<bool>(RKEY_SHOW_AXES);
 	_showWorkzone = registry::getValue<bool>(RKEY_SHOW_WORKZONE);
+	_showRenderStats = registry::getValue<bool>(RKEY_SHOW_RENDER_STATS);
 	_defaultBlockSize = registry::getValue<int>(RKEY_DEFAULT_BLOCKSIZE);
 	updateAllViews();
 }
@@ -259,6 +275,10 @@ bool XYWndManager::showWorkzone() const {
 	return _showWorkzone;
 }
 
+bool XYWndManager::showRenderStats() const {
+	return _showRenderStats;
+}
+
 bool XYWndManager::showGrid() const {
 	return _showGrid;
 }
@@ -269,6 +289,12 @@ bool XYWndManager::showSizeInfo() const {
 
 void XYWndManager::updateAllViews(bool force)
 {
+	// Anything might have changed, let the next view collect the scene again
+	if (_frontEnd)
+	{
+		_frontEnd->invalidate();
+	}
+
 	for (const XYWndMap::value_type& i : _xyWnds)
 	{
         if (force)
@@ -636,6 +662,8 @@ const StringSet& XYWndManager::getDependencies() const
 		_dependencies.insert(MODULE_COMMANDSYSTEM);
 		_dependencies.insert(MODULE_UIMANAGER);
         _dependencies.insert(MODULE_MOUSETOOLMANAGER);
+		_dependencies.insert(MODULE_SCENEGRAPH);
+		_dependencies.insert(MODULE_SELECTIONSYSTEM);
 	}
 
 	return _dependencies;
@@ -666,6 +694,7 @@ void XYWndManager::initialiseModule(const IApplicationContext& ctx)
 	observeKey(RKEY_SHOW_OUTLINE);
 	observeKey(RKEY_SHOW_AXES);
 	observeKey(RKEY_SHOW_WORKZONE);
+	observeKey(RKEY_SHOW_RENDER_STATS);
 	observeKey(RKEY_DEFAULT_BLOCKSIZE);
 
 	// Trigger loading the values of the observed registry keys
@@ -686,6 +715,8 @@ void XYWndManager::initialiseModule(const IApplicationContext& ctx)
 
 	XYWnd::captureStates();
 
+	_frontEnd.reset(new OrthoFrontEnd);
+
     // Add default XY tools
     IMouseToolGroup& toolGroup = GlobalMouseToolManager().getGroup(IMouseToolGroup::Type::OrthoView);
 
@@ -703,6 +734,8 @@ void XYWndManager::shutdownModule()
 	// Release all owned XYWndPtrs
 	destroyViews();
 
+	_frontEnd.reset();
+
 	XYWnd::releaseStates();
 }
 
@@ -2,6 +2,8 @@
 
 #include <list>
 #include <map>
+#include <memory>
+#include <functional>
 #include "iorthoview.h"
 #include "iclipper.h"
 #include "iregistry.h"
@@ -9,6 +11,7 @@
 #include "imousetoolmanager.h"
 
 #include "XYWnd.h"
+#include "OrthoFrontEnd.h"
 
 class wxMouseEvent;
 
@@ -41,9 +44,13 @@ class XYWndManager :
 	bool _showOutline;
 	bool _showAxes;
 	bool _showWorkzone;
+	bool _showRenderStats;
 
 	unsigned int _defaultBlockSize;
 
+	// The collection pass shared by all views
+	std::unique_ptr<OrthoFrontEnd> _frontEnd;
+
 private:
 
 	// Get a unique ID for the XYWnd map
@@ -67,6 +74,7 @@ public:
 	bool showOutline() const;
 	bool showAxes() const;
 	bool showWorkzone() const;
+	bool showRenderStats() const;
 	bool showSizeInfo() const;
 
 	unsigned int defaultBlockSize() const;
@@ -78,6 +86,12 @@ public:
 	// Free all the allocated views from the heap
 	void destroyViews() override;
 
+	// Invokes the given functor for each allocated view
+	void foreachView(const std::function<void(const XYWnd&)>& functor) const;
+
+	// Returns the front-end pass shared by all views
+	OrthoFrontEnd& getFrontEnd();
+
 	// Saves the current state of all open views to the registry
 	void saveState();
 	// Restores the xy windows according to the state saved in the XMLRegistry
@@ -0,0 +1,381 @@
+#include "OrthoFrontEnd.h"
+
+#include <algorithm>
+#include "imap.h"
+#include "iselection.h"
+#include "ispacepartition.h"
+#include "ivolumetest.h"
+#include "math/AABB.h"
+
+#include "render/RenderableCollectionWalker.h"
+#include "GlobalXYWnd.h"
+#include "XYWnd.h"
+
+namespace ui
+{
+
+namespace
+{
+	// Primitives with a smaller on-screen size (in pixels) are drawn as part of an outline batch
+	const double LOD_PIXEL_SIZE = 1.0;
+
+	// The edges of an AABB, as indices into the array filled by AABB::getCorners()
+	const std::size_t BOX_EDGES[12][2] =
+	{
+		{ 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 },
+		{ 4, 5 }, { 5, 6 }, { 6, 7 }, { 7, 4 },
+		{ 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 },
+	};
+
+	// Volume containing everything that is (partially) visible in any of the given views.
+	// The views are of the same type and scale, so they're only differing by their
+	// translation: plane tests give the same result for each of them, and the
+	// view-dependent queries are answered by the first one.
+	class ViewUnion :
+		public VolumeTest
+	{
+	private:
+		std::vector<const VolumeTest*> _views;
+
+	public:
+		ViewUnion(const std::vector<const VolumeTest*>& views) :
+			_views(views)
+		{
+			assert(!_views.empty());
+		}
+
+		bool TestPoint(const Vector3& point) const override
+		{
+			return std::any_of(_views.begin(), _views.end(), [&](const VolumeTest* v) { return v->TestPoint(point); });
+		}
+
+		bool TestLine(const Segment& segment) const override
+		{
+			return std::any_of(_views.begin(), _views.end(), [&](const VolumeTest* v) { return v->TestLine(segment); });
+		}
+
+		bool TestPlane(const Plane3& plane) const override
+		{
+			return std::any_of(_views.begin(), _views.end(), [&](const VolumeTest* v) { return v->TestPlane(plane); });
+		}
+
+		bool TestPlane(const Plane3& plane, const Matrix4& localToWorld) const override
+		{
+			return std::any_of(_views.begin(), _views.end(), [&](const VolumeTest* v) { return v->TestPlane(plane, localToWorld); });
+		}
+
+		VolumeIntersectionValue TestAABB(const AABB& aabb) const override
+		{
+			return combine([&](const VolumeTest* v) { return v->TestAABB(aabb); });
+		}
+
+		VolumeIntersectionValue TestAABB(const AABB& aabb, const Matrix4& localToWorld) const override
+		{
+			return combine([&](const VolumeTest* v) { return v->TestAABB(aabb, localToWorld); });
+		}
+
+		bool fill() const override
+		{
+			return _views.front()->fill();
+		}
+
+		const Matrix4& GetViewProjection() const override
+		{
+			return _views.front()->GetViewProjection();
+		}
+
+		const Matrix4& GetViewport() const override
+		{
+			return _views.front()->GetViewport();
+		}
+
+		const Matrix4& GetProjection() const override
+		{
+			return _views.front()->GetProjection();
+		}
+
+		const Matrix4& GetModelview() const override
+		{
+			return _views.front()->GetModelview();
+		}
+
+	private:
+		template<typename TestFunc>
+		VolumeIntersectionValue combine(const TestFunc& test) const
+		{
+			VolumeIntersectionValue result = VOLUME_OUTSIDE;
+
+			for (const VolumeTest* view : _views)
+			{
+				VolumeIntersectionValue value = test(view);
+
+				if (value == VOLUME_INSIDE)
+				{
+					return VOLUME_INSIDE;
+				}
+
+				if (value == VOLUME_PARTIAL)
+				{
+					result = VOLUME_PARTIAL;
+				}
+			}
+
+			return result;
+		}
+	};
+
+	// Collects the renderables of the visible nodes, merging the outlines
+	// of sub-pixel primitives into one batch per octree node
+	class OrthoCollectionWalker :
+		public scene::Graph::SpacePartitionWalker
+	{
+	private:
+		RenderableCollector& _collector;
+		render::RenderableCollectionWalker _walker;
+
+		OrthoFrontEnd::OutlineBatches& _batches;
+
+		// Primitives smaller than this (in world units) are collapsed, 0 disables batching
+		double _maxCollapsedSize;
+
+	public:
+		OrthoCollectionWalker(RenderableCollector& collector, const VolumeTest& volume,
+			OrthoFrontEnd::OutlineBatches& batches, double maxCollapsedSize) :
+			_collector(collector),
+			_walker(collector, volume),
+			_batches(batches),
+			_maxCollapsedSize(maxCollapsedSize)
+		{}
+
+		void visitSPNode(const scene::ISPNode& node) override
+		{
+			if (_maxCollapsedSize <= 0) return;
+
+			auto batch = _batches.find(&node);
+
+			if (batch == _batches.end())
+			{
+				batch = _batches.emplace(&node, OrthoFrontEnd::OutlineBatch()).first;
+
+				// The batch covers all members, not just the ones intersecting the current views
+				for (const scene::INodePtr& member : node.getMembers())
+				{
+					if (member->visible() && isCollapsible(member))
+					{
+						addOutline(batch->second, *member);
+					}
+				}
+			}
+
+			// Batches are never highlighted, reset the flags set by the last visited node
+			_collector.setHighlightFlag(RenderableCollector::Highlight::Faces, false);
+			_collector.setHighlightFlag(RenderableCollector::Highlight::Primitives, false);
+			_collector.setHighlightFlag(RenderableCollector::Highlight::GroupMember, false);
+
+			for (const auto& lines : batch->second)
+			{
+				_collector.addRenderable(*lines.first, lines.second, Matrix4::getIdentity());
+			}
+		}
+
+		bool visit(const scene::INodePtr& node) override
+		{
+			// Collapsed primitives are part of their octree node's batch
+			if (_maxCollapsedSize > 0 && isCollapsible(node))
+			{
+				return true;
+			}
+
+			return _walker.visit(node);
+		}
+
+		void dispatchRenderable(const Renderable& renderable)
+		{
+			_walker.dispatchRenderable(renderable);
+		}
+
+	private:
+		bool isCollapsible(const scene::INodePtr& node) const
+		{
+			auto type = node->getNodeType();
+
+			if (type != scene::INode::Type::Brush && type != scene::INode::Type::Patch)
+			{
+				return false;
+			}
+
+			// Highlighted primitives need to be drawn individually
+			if (node->getHighlightFlags() != Renderable::Highlight::NoHighlight)
+			{
+				return false;
+			}
+
+			auto parent = node->getParent();
+
+			if (parent && parent->getHighlightFlags() != Renderable::Highlight::NoHighlight)
+			{
+				return false;
+			}
+
+			if (node->getRenderEntity() == nullptr)
+			{
+				return false;
+			}
+
+			const AABB& bounds = node->worldAABB();
+
+			return bounds.isValid() &&
+				std::max({ bounds.extents.x(), bounds.extents.y(), bounds.extents.z() }) * 2 < _maxCollapsedSize;
+		}
+
+		static void addOutline(OrthoFrontEnd::OutlineBatch& batch, const scene::INode& node)
+		{
+			const ShaderPtr& shader = node.getRenderEntity()->getWireShader();
+
+			if (!shader) return;
+
+			auto& lines = batch.try_emplace(shader, GL_LINES).first->second;
+
+			Vector3 corners[8];
+			node.worldAABB().getCorners(corners);
+
+			for (const auto& edge : BOX_EDGES)
+			{
+				lines.push_back(VertexCb(corners[edge[0]]));
+				lines.push_back(VertexCb(corners[edge[1]]));
+			}
+		}
+	};
+}
+
+OrthoFrontEnd::OrthoFrontEnd() :
+	_globalstate(0),
+	_traversalStats{ 0, 0, 0, 0 },
+	_traversalCount(0),
+	_outlineScale(0),
+	_outlineRevision(0),
+	_outlinesNeedUpdate(true)
+{
+	GlobalSceneGraph().addSceneObserver(this);
+
+	_selectionChangedConn = GlobalSelectionSystem().signal_selectionChanged().connect(
+		[this](const ISelectable&)
+		{
+			// Highlighted primitives are excluded from the outline batches
+			invalidate();
+			_outlinesNeedUpdate = true;
+		}
+	);
+}
+
+OrthoFrontEnd::~OrthoFrontEnd()
+{
+	_selectionChangedConn.disconnect();
+	GlobalSceneGraph().removeSceneObserver(this);
+}
+
+const XYRenderer& OrthoFrontEnd::collect(const XYWnd& view, RenderStateFlags globalstate,
+	Shader* selectedShader, Shader* selectedShaderGroup)
+{
+	const VolumeTest& viewVolume = view.getVolumeTest();
+	auto pending = _pendingViews.find(view.getId());
+
+	if (_renderer && _globalstate == globalstate && pending != _pendingViews.end())
+	{
+		// Each view renders a recorded pass at most once
+		bool unchanged = pending->second == viewVolume.GetViewProjection();
+		_pendingViews.erase(pending);
+
+		// The recorded renderables include view-dependent node state (like the
+		// visible brush edges), which any later traversal re-evaluates for its own view
+		if (unchanged && GlobalSceneGraph().getVolumeTraversalCount() == _traversalCount)
+		{
+			// The view hasn't moved since the pass has been culled against it
+			return *_renderer;
+		}
+	}
+
+	float scale = view.getScale();
+
+	_renderer.reset(new XYRenderer(globalstate, selectedShader, selectedShaderGroup));
+	_globalstate = globalstate;
+	_pendingViews.clear();
+
+	// Collect for the other views of the same type and scale which are about to be
+	// redrawn, the requesting view comes first. Views looking from another direction
+	// need their own pass, as the view-dependent state of the nodes is evaluated once.
+	std::vector<const VolumeTest*> views(1, &viewVolume);
+
+	GlobalXYWnd().foreachView([&](const XYWnd& other)
+	{
+		if (&other != &view && other.isDrawPending() && other.getScale() == scale &&
+			other.getViewType() == view.getViewType())
+		{
+			views.push_back(&other.getVolumeTest());
+			_pendingViews.emplace(other.getId(), other.getVolumeTest().GetViewProjection());
+		}
+	});
+
+	ViewUnion unionVolume(views);
+	const VolumeTest& volume = views.size() > 1 ? static_cast<const VolumeTest&>(unionVolume) : viewVolume;
+
+	prepareOutlineBatches(scale);
+
+	OrthoCollectionWalker walker(*_renderer, volume, _outlineBatches, LOD_PIXEL_SIZE / scale);
+
+	GlobalSceneGraph().foreachVisibleNodeInVolume(volume, walker);
+
+	// Other traversals might run before the pending views are drawn
+	_traversalStats = GlobalSceneGraph().getVolumeTraversalStatistics();
+	_traversalCount = GlobalSceneGraph().getVolumeTraversalCount();
+
+	// Submit any renderables that have been directly attached to the RenderSystem
+	GlobalRenderSystem().forEachRenderable([&](const Renderable& renderable)
+	{
+		walker.dispatchRenderable(renderable);
+	});
+
+	return *_renderer;
+}
+
+const scene::Graph::VolumeTraversalStatistics& OrthoFrontEnd::getTraversalStatistics() const
+{
+	return _traversalStats;
+}
+
+void OrthoFrontEnd::invalidate()
+{
+	_renderer.reset();
+	_pendingViews.clear();
+}
+
+void OrthoFrontEnd::prepareOutlineBatches(float scale)
+{
+	// Evaluate any pending bounds changes first, these might cause nodes to be
+	// re-linked in the octree, which needs to be reflected by the revision
+	const scene::IMapRootNodePtr& root = GlobalSceneGraph().root();
+
+	if (root)
+	{
+		root->worldAABB();
+	}
+
+	std::size_t revision = GlobalSceneGraph().getSpacePartition()->getRevision();
+
+	if (_outlinesNeedUpdate || scale != _outlineScale || revision != _outlineRevision)
+	{
+		_outlineBatches.clear();
+		_outlineScale = scale;
+		_outlineRevision = revision;
+		_outlinesNeedUpdate = false;
+	}
+}
+
+void OrthoFrontEnd::onSceneGraphChange()
+{
+	// Nodes might have been removed, or their visibility changed
+	invalidate();
+	_outlinesNeedUpdate = true;
+}
+
+}
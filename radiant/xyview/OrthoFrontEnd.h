@@ -0,0 +1,98 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <sigc++/connection.h>
+
+#include "iscenegraph.h"
+#include "irender.h"
+#include "render.h"
+
+#include "XYRenderer.h"
+
+namespace ui
+{
+
+class XYWnd;
+
+/**
+ * The front-end (collection) pass shared by all ortho views.
+ *
+ * Several ortho views of the same type are usually redrawn together and
+ * show the same region of the map at the same zoom level. Instead of
+ * traversing the scene once per view, the first view to be drawn collects
+ * the renderables for all views of the same type and scale waiting for a
+ * redraw, the others render the recorded result using their own projection.
+ * A view which has not been part of the pass, has moved since, or draws
+ * again (e.g. on mouse movement) triggers a new collection pass for its own
+ * volume. So does any other scene traversal in between, since it changes
+ * the view-dependent state of the recorded nodes.
+ *
+ * When zoomed out, brushes and patches smaller than a pixel are not
+ * submitted one by one. Their bounds outlines are merged into one line
+ * batch per octree node, which is kept until the octree or the zoom
+ * level changes.
+ */
+class OrthoFrontEnd :
+    public scene::Graph::Observer
+{
+public:
+    // The outlines of the collapsed primitives in a single octree node,
+    // one line list per wire shader
+    typedef std::map<ShaderPtr, RenderablePointVector> OutlineBatch;
+    typedef std::map<const scene::ISPNode*, OutlineBatch> OutlineBatches;
+
+private:
+    std::unique_ptr<XYRenderer> _renderer;
+
+    // The render flags the current pass has been collected for
+    RenderStateFlags _globalstate;
+
+    // The IDs of the views the current pass has been collected for, which
+    // haven't rendered it yet, mapped to the view-projection used for culling
+    std::map<int, Matrix4> _pendingViews;
+
+    // The scenegraph counters of the traversal which recorded the current pass
+    scene::Graph::VolumeTraversalStatistics _traversalStats;
+
+    // The scenegraph's volume traversal count right after recording the current pass
+    std::size_t _traversalCount;
+
+    OutlineBatches _outlineBatches;
+
+    // The zoom level and octree revision the outline batches are valid for
+    float _outlineScale;
+    std::size_t _outlineRevision;
+
+    // Set when the batches need to be rebuilt for other reasons (selection, filters)
+    bool _outlinesNeedUpdate;
+
+    sigc::connection _selectionChangedConn;
+
+public:
+    OrthoFrontEnd();
+    ~OrthoFrontEnd();
+
+    /**
+     * Returns the renderer holding the scene renderables to be rendered
+     * into the given view, running a new collection pass if necessary.
+     * The reference is valid until the next call to collect().
+     */
+    const XYRenderer& collect(const XYWnd& view, RenderStateFlags globalstate,
+                              Shader* selectedShader, Shader* selectedShaderGroup);
+
+    // Returns the counters of the traversal the pass returned by collect() has
+    // been recorded in, views re-using a pass report the same numbers
+    const scene::Graph::VolumeTraversalStatistics& getTraversalStatistics() const;
+
+    // Discards the current pass, the next view to be drawn collects the scene again
+    void invalidate();
+
+    // scene::Graph::Observer implementation
+    void onSceneGraphChange() override;
+
+private:
+    void prepareOutlineBatches(float scale);
+};
+
+}
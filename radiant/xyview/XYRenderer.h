@@ -1,8 +1,16 @@
 #pragma once
 
+#include <vector>
 #include "irenderable.h"
+#include "math/Matrix4.h"
 
-/// RenderableCollector implementation for the ortho view
+/**
+ * RenderableCollector implementation for the ortho view.
+ *
+ * The collected renderables are recorded instead of being passed to
+ * the shaders right away, such that the result of a single collection
+ * pass can be rendered into several views, each with its own projection.
+ */
 class XYRenderer: public RenderableCollector
 {
     // State type structure
@@ -18,9 +26,21 @@ class XYRenderer: public RenderableCollector
         {}
     };
 
+    // A renderable as it has been submitted to a shader
+    struct Submission
+    {
+        Shader* shader;
+        const OpenGLRenderable* renderable;
+        Matrix4 world;
+        const LightSources* lights;
+        const IRenderEntity* entity;
+    };
+
     State _state;
     RenderStateFlags _globalstate;
 
+    std::vector<Submission> _submissions;
+
     // Shader to use for highlighted objects
     Shader* _selectedShader;
     Shader* _selectedShaderGroup;
@@ -61,13 +81,12 @@ public:
         if (_state.highlightPrimitives)
         {
             if (_state.highlightAsGroupMember)
-                _selectedShaderGroup->addRenderable(renderable, world,
-                                                    lights, entity);
+                _submissions.push_back({ _selectedShaderGroup, &renderable, world, lights, entity });
             else
-                _selectedShader->addRenderable(renderable, world, lights, entity);
+                _submissions.push_back({ _selectedShader, &renderable, world, lights, entity });
         }
 
-        shader.addRenderable(renderable, world, lights, entity);
+        _submissions.push_back({ &shader, &renderable, world, lights, entity });
     }
 
     void addLitRenderable(Shader& shader,
@@ -76,11 +95,24 @@ public:
                           const LitObject& /* litObject */,
                           const IRenderEntity* entity = nullptr) override
     {
-        shader.addRenderable(renderable, localToWorld, nullptr, entity);
+        _submissions.push_back({ &shader, &renderable, localToWorld, nullptr, entity });
+    }
+
+    // Passes the recorded renderables to their shaders, this can be done
+    // any number of times, once for each render pass
+    void submit() const
+    {
+        for (const auto& s : _submissions)
+        {
+            s.shader->addRenderable(*s.renderable, s.world, s.lights, s.entity);
+        }
     }
 
-    void render(const Matrix4& modelview, const Matrix4& projection)
+    // Submits the recorded renderables and renders everything
+    // which has been added to the shaders since the last pass
+    void render(const Matrix4& modelview, const Matrix4& projection) const
     {
+        submit();
         GlobalRenderSystem().render(_globalstate, modelview, projection);
     }
 }; // class XYRenderer
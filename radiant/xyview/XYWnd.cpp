@@ -13,6 +13,7 @@
 
 #include "wxutil/MouseButton.h"
 #include "wxutil/GLWidget.h"
+#include "wxutil/GLContext.h"
 #include "string/string.h"
 #include "selectionlib.h"
 
@@ -32,7 +33,6 @@
 #include "gamelib.h"
 #include "scenelib.h"
 #include "maplib.h"
-#include "render/RenderableCollectionWalker.h"
 
 #include <wx/frame.h>
 #include <fmt/format.h>
@@ -70,6 +70,7 @@ XYWnd::XYWnd(int id, wxWindow* parent) :
 	_id(id),
 	_wxGLWidget(new wxutil::GLWidget(parent, std::bind(&XYWnd::onRender, this), "XYWnd")),
     _drawing(false),
+    _drawPending(false),
 	_minWorldCoord(game::current::getValue<float>("/defaults/minWorldCoord")),
 	_maxWorldCoord(game::current::getValue<float>("/defaults/maxWorldCoord")),
 	_defaultCursor(wxCURSOR_DEFAULT),
@@ -166,9 +167,29 @@ void XYWnd::destroyXYView()
     GlobalSceneGraph().removeSceneObserver(this);
 
     _sigCameraChanged.disconnect();
+
+    releaseCachedGeometry();
     _wxGLWidget = nullptr;
 }
 
+void XYWnd::releaseCachedGeometry()
+{
+    // The buffers belong to the shared context, which needs to be made current
+    // first. If this is not possible anymore, they are left to the context.
+    auto context = std::dynamic_pointer_cast<wxutil::GLContext>(GlobalOpenGLContext().getSharedContext());
+
+    if (!context || _wxGLWidget == nullptr || !_wxGLWidget->IsShownOnScreen() ||
+        !_wxGLWidget->SetCurrent(context->get()))
+    {
+        return;
+    }
+
+    for (CachedGeometry* geometry : { &_minorGrid, &_majorGrid, &_blockGrid, &_sizeInfo, &_cameraIcon })
+    {
+        geometry->releaseBuffer();
+    }
+}
+
 void XYWnd::setScale(float f) {
     _scale = f;
     updateProjection();
@@ -262,6 +283,8 @@ void XYWnd::forceRedraw()
         return;
     }
 
+    _drawPending = true;
+
 	_wxGLWidget->Refresh(false);
     _wxGLWidget->Update();
 }
@@ -273,9 +296,16 @@ void XYWnd::queueDraw()
         return; // deny redraw requests if we're currently drawing
     }
 
+    _drawPending = true;
+
 	_wxGLWidget->Refresh(false);
 }
 
+bool XYWnd::isDrawPending() const
+{
+    return _drawPending;
+}
+
 void XYWnd::onSceneGraphChange() {
     // Pass the call to queueDraw.
     queueDraw();
@@ -724,113 +754,124 @@ void XYWnd::drawGrid()
                 sizeFactor = 0.95;
             }
 
-            switch (look)
+            if (look == GRIDLOOK_MOREDOTLINES)
             {
-                case GRIDLOOK_DOTS:
-                    glBegin (GL_POINTS);
-                    for (double x = xb ; x < xe ; x += cur_step)
-                    {
-                        for (double y = yb ; y < ye ; y += cur_step)
-                        {
-                            glVertex2d (x, y);
-                        }
-                    }
-                    glEnd();
-                    break;
+                density = 8;
+            }
 
-                case GRIDLOOK_BIGDOTS:
-                    glPointSize(3);
-                    glEnable(GL_POINT_SMOOTH);
-                    glBegin (GL_POINTS);
-                    for (double x = xb ; x < xe ; x += cur_step)
-                    {
-                        for (double y = yb ; y < ye ; y += cur_step)
-                        {
-                            glVertex2d (x, y);
-                        }
-                    }
-                    glEnd();
-                    glDisable(GL_POINT_SMOOTH);
-                    glPointSize(1);
-                    break;
+            // The grid is generated relative to its (major step aligned) lower left corner
+            // and translated into place, so panning the view doesn't invalidate it.
+            // Only the crosses are depending on the zoom level.
+            double width = xe - xb;
+            double height = ye - yb;
 
-                case GRIDLOOK_SQUARES:
-                    glPointSize(3);
-                    glBegin (GL_POINTS);
-                    for (double x = xb ; x < xe ; x += cur_step)
-                    {
-                        for (double y = yb ; y < ye ; y += cur_step)
+            CachedGeometry& geometry = gf ? _majorGrid : _minorGrid;
+            CachedGeometry::Key key{ double(look), cur_step, minor_step, density, sizeFactor,
+                double(mask), width, height, look == GRIDLOOK_CROSSES ? _scale : 0 };
+
+            if (geometry.isOutdated(key))
+            {
+                CachedGeometry::Vertices vertices;
+                GLenum mode = GL_POINTS;
+
+                switch (look)
+                {
+                    case GRIDLOOK_DOTS:
+                    case GRIDLOOK_BIGDOTS:
+                    case GRIDLOOK_SQUARES:
+                        for (double x = 0 ; x < width ; x += cur_step)
                         {
-                            glVertex2d (x, y);
+                            for (double y = 0 ; y < height ; y += cur_step)
+                            {
+                                vertices.emplace_back(x, y, 0);
+                            }
                         }
-                    }
-                    glEnd();
-                    glPointSize(1);
-                    break;
-
-                case GRIDLOOK_MOREDOTLINES:
-                    density = 8;
+                        break;
 
-                case GRIDLOOK_DOTLINES:
-                    glBegin (GL_POINTS);
-                    for (double x = xb ; x < xe ; x += cur_step)
-                    {
-                        for (double y = yb ; y < ye ; y += minor_step / density)
+                    case GRIDLOOK_MOREDOTLINES:
+                    case GRIDLOOK_DOTLINES:
+                        for (double x = 0 ; x < width ; x += cur_step)
                         {
-                            glVertex2d (x, y);
+                            for (double y = 0 ; y < height ; y += minor_step / density)
+                            {
+                                vertices.emplace_back(x, y, 0);
+                            }
                         }
-                    }
 
-                    for (double y = yb ; y < ye ; y += cur_step)
-                    {
-                        for (double x = xb ; x < xe ; x += minor_step / density)
+                        for (double y = 0 ; y < height ; y += cur_step)
                         {
-                            glVertex2d (x, y);
+                            for (double x = 0 ; x < width ; x += minor_step / density)
+                            {
+                                vertices.emplace_back(x, y, 0);
+                            }
                         }
-                    }
-                    glEnd();
-                    break;
+                        break;
 
-                case GRIDLOOK_CROSSES:
-                    glBegin (GL_LINES);
-                    for (double x = xb ; x <= xe ; x += cur_step)
-                    {
-                        for (double y = yb ; y <= ye ; y += cur_step)
+                    case GRIDLOOK_CROSSES:
+                        mode = GL_LINES;
+                        for (double x = 0 ; x <= width ; x += cur_step)
                         {
-                            glVertex2d (x - sizeFactor / _scale, y);
-                            glVertex2d (x + sizeFactor / _scale, y);
-                            glVertex2d (x, y - sizeFactor / _scale);
-                            glVertex2d (x, y + sizeFactor / _scale);
+                            for (double y = 0 ; y <= height ; y += cur_step)
+                            {
+                                vertices.emplace_back(x - sizeFactor / _scale, y, 0);
+                                vertices.emplace_back(x + sizeFactor / _scale, y, 0);
+                                vertices.emplace_back(x, y - sizeFactor / _scale, 0);
+                                vertices.emplace_back(x, y + sizeFactor / _scale, 0);
+                            }
                         }
-                    }
-                    glEnd();
-                    break;
+                        break;
 
-                case GRIDLOOK_LINES:
-                default:
-                    glBegin (GL_LINES);
-                    int i = 0;
-                    for (double x = xb ; x < xe ; x += cur_step, ++i)
+                    case GRIDLOOK_LINES:
+                    default:
                     {
-                        if (gf == 1 || (i & mask) != 0) // greebo: No mask check for major grid
+                        mode = GL_LINES;
+                        int i = 0;
+                        for (double x = 0 ; x < width ; x += cur_step, ++i)
                         {
-                            glVertex2d (x, yb);
-                            glVertex2d (x, ye);
+                            if (gf == 1 || (i & mask) != 0) // greebo: No mask check for major grid
+                            {
+                                vertices.emplace_back(x, 0, 0);
+                                vertices.emplace_back(x, height, 0);
+                            }
                         }
-                    }
 
-                    i = 0;
+                        i = 0;
 
-                    for (double y = yb ; y < ye ; y += cur_step, ++i)
-                    {
-                        if (gf == 1 || (i & mask) != 0) // greebo: No mask check for major grid
+                        for (double y = 0 ; y < height ; y += cur_step, ++i)
                         {
-                            glVertex2d (xb, y);
-                            glVertex2d (xe, y);
+                            if (gf == 1 || (i & mask) != 0) // greebo: No mask check for major grid
+                            {
+                                vertices.emplace_back(0, y, 0);
+                                vertices.emplace_back(width, y, 0);
+                            }
                         }
+                        break;
                     }
+                }
+
+                geometry.update(key, mode, vertices);
+            }
+
+            Vector3 gridOrigin(xb, yb, 0);
+
+            switch (look)
+            {
+                case GRIDLOOK_BIGDOTS:
+                    glPointSize(3);
+                    glEnable(GL_POINT_SMOOTH);
+                    geometry.render(gridOrigin);
+                    glDisable(GL_POINT_SMOOTH);
+                    glPointSize(1);
+                    break;
+
+                case GRIDLOOK_SQUARES:
+                    glPointSize(3);
+                    geometry.render(gridOrigin);
+                    glPointSize(1);
+                    break;
 
-                    glEnd();
+                default:
+                    geometry.render(gridOrigin);
                     break;
             }
         }
@@ -979,21 +1020,33 @@ void XYWnd::drawBlockGrid()
     glColor3dv(GlobalColourSchemeManager().getColour("grid_block"));
     glLineWidth (2);
 
-    glBegin (GL_LINES);
+    // Generated relative to the lower left block corner, like the regular grid
+    float width = xe - xb;
+    float height = ye - yb;
 
-    for (x=xb ; x<=xe ; x+=blockSize) {
-        glVertex2f (x, yb);
-        glVertex2f (x, ye);
-    }
+    CachedGeometry::Key key{ double(blockSize), width, height, double(_viewType) };
+
+    if (_blockGrid.isOutdated(key))
+    {
+        CachedGeometry::Vertices vertices;
+
+        for (x=0 ; x<=width ; x+=blockSize) {
+            vertices.emplace_back(x, 0, 0);
+            vertices.emplace_back(x, height, 0);
+        }
 
-    if (_viewType == XY) {
-        for (y=yb ; y<=ye ; y+=blockSize) {
-            glVertex2f (xb, y);
-            glVertex2f (xe, y);
+        if (_viewType == XY) {
+            for (y=0 ; y<=height ; y+=blockSize) {
+                vertices.emplace_back(0, y, 0);
+                vertices.emplace_back(width, y, 0);
+            }
         }
+
+        _blockGrid.update(key, GL_LINES, vertices);
     }
 
-    glEnd();
+    _blockGrid.render(Vector3(xb, yb, 0));
+
     glLineWidth (1);
 
     // draw coordinate text if needed
@@ -1042,20 +1095,28 @@ void XYWnd::drawCameraIcon()
         }
 
         glColor3dv(GlobalColourSchemeManager().getColour("camera_icon"));
-        glBegin(GL_LINE_STRIP);
-        glVertex3f(x - box, y, 0);
-        glVertex3f(x, y + (box / 2), 0);
-        glVertex3f(x + box, y, 0);
-        glVertex3f(x, y - (box / 2), 0);
-        glVertex3f(x - box, y, 0);
-        glVertex3f(x + box, y, 0);
-        glEnd();
 
-        glBegin(GL_LINE_STRIP);
-        glVertex3f(x + static_cast<float>(fov * cos(a + c_pi / 4)), y + static_cast<float>(fov * sin(a + c_pi / 4)), 0);
-        glVertex3f(x, y, 0);
-        glVertex3f(x + static_cast<float>(fov * cos(a - c_pi / 4)), y + static_cast<float>(fov * sin(a - c_pi / 4)), 0);
-        glEnd();
+        CachedGeometry::Key key{ x, y, a, _scale };
+
+        if (_cameraIcon.isOutdated(key))
+        {
+            std::vector<CachedGeometry::Vertices> strips(2);
+
+            strips[0].emplace_back(x - box, y, 0);
+            strips[0].emplace_back(x, y + (box / 2), 0);
+            strips[0].emplace_back(x + box, y, 0);
+            strips[0].emplace_back(x, y - (box / 2), 0);
+            strips[0].emplace_back(x - box, y, 0);
+            strips[0].emplace_back(x + box, y, 0);
+
+            strips[1].emplace_back(x + static_cast<float>(fov * cos(a + c_pi / 4)), y + static_cast<float>(fov * sin(a + c_pi / 4)), 0);
+            strips[1].emplace_back(x, y, 0);
+            strips[1].emplace_back(x + static_cast<float>(fov * cos(a - c_pi / 4)), y + static_cast<float>(fov * sin(a - c_pi / 4)), 0);
+
+            _cameraIcon.update(key, GL_LINE_STRIP, strips);
+        }
+
+        _cameraIcon.render();
     }
     catch (const std::runtime_error&)
     {
@@ -1078,33 +1139,47 @@ void XYWnd::drawSizeInfo(int nDim1, int nDim2, const Vector3& vMinBounds, const
 
   glColor3dv(GlobalColourSchemeManager().getColour("brush_size_info"));
 
-  std::ostringstream dimensions;
+  // The dimension lines are the same for all view types, only the 3D placement differs
+  CachedGeometry::Key key{ vMinBounds[nDim1], vMinBounds[nDim2], vMaxBounds[nDim1], vMaxBounds[nDim2],
+    _scale, double(_viewType) };
 
-  if (_viewType == XY)
+  if (_sizeInfo.isOutdated(key))
   {
-    glBegin (GL_LINES);
+    auto toWorld = [&](double a, double b)
+    {
+      return _viewType == XY ? Vertex3f(a, b, 0) : _viewType == XZ ? Vertex3f(a, 0, b) : Vertex3f(0, a, b);
+    };
 
-    glVertex3d(vMinBounds[nDim1], vMinBounds[nDim2] - 6.0f  / _scale, 0.0f);
-    glVertex3d(vMinBounds[nDim1], vMinBounds[nDim2] - 10.0f / _scale, 0.0f);
+    CachedGeometry::Vertices vertices
+    {
+      toWorld(vMinBounds[nDim1], vMinBounds[nDim2] - 6.0f  / _scale),
+      toWorld(vMinBounds[nDim1], vMinBounds[nDim2] - 10.0f / _scale),
+
+      toWorld(vMinBounds[nDim1], vMinBounds[nDim2] - 10.0f  / _scale),
+      toWorld(vMaxBounds[nDim1], vMinBounds[nDim2] - 10.0f  / _scale),
 
-    glVertex3d(vMinBounds[nDim1], vMinBounds[nDim2] - 10.0f  / _scale, 0.0f);
-    glVertex3d(vMaxBounds[nDim1], vMinBounds[nDim2] - 10.0f  / _scale, 0.0f);
+      toWorld(vMaxBounds[nDim1], vMinBounds[nDim2] - 6.0f  / _scale),
+      toWorld(vMaxBounds[nDim1], vMinBounds[nDim2] - 10.0f / _scale),
 
-    glVertex3d(vMaxBounds[nDim1], vMinBounds[nDim2] - 6.0f  / _scale, 0.0f);
-    glVertex3d(vMaxBounds[nDim1], vMinBounds[nDim2] - 10.0f / _scale, 0.0f);
+      toWorld(vMaxBounds[nDim1] + 6.0f  / _scale, vMinBounds[nDim2]),
+      toWorld(vMaxBounds[nDim1] + 10.0f  / _scale, vMinBounds[nDim2]),
 
+      toWorld(vMaxBounds[nDim1] + 10.0f  / _scale, vMinBounds[nDim2]),
+      toWorld(vMaxBounds[nDim1] + 10.0f  / _scale, vMaxBounds[nDim2]),
 
-    glVertex3d(vMaxBounds[nDim1] + 6.0f  / _scale, vMinBounds[nDim2], 0.0f);
-    glVertex3d(vMaxBounds[nDim1] + 10.0f  / _scale, vMinBounds[nDim2], 0.0f);
+      toWorld(vMaxBounds[nDim1] + 6.0f  / _scale, vMaxBounds[nDim2]),
+      toWorld(vMaxBounds[nDim1] + 10.0f  / _scale, vMaxBounds[nDim2]),
+    };
 
-    glVertex3d(vMaxBounds[nDim1] + 10.0f  / _scale, vMinBounds[nDim2], 0.0f);
-    glVertex3d(vMaxBounds[nDim1] + 10.0f  / _scale, vMaxBounds[nDim2], 0.0f);
+    _sizeInfo.update(key, GL_LINES, vertices);
+  }
 
-    glVertex3d(vMaxBounds[nDim1] + 6.0f  / _scale, vMaxBounds[nDim2], 0.0f);
-    glVertex3d(vMaxBounds[nDim1] + 10.0f  / _scale, vMaxBounds[nDim2], 0.0f);
+  _sizeInfo.render();
 
-    glEnd();
+  std::ostringstream dimensions;
 
+  if (_viewType == XY)
+  {
     glRasterPos3f (Betwixt(vMinBounds[nDim1], vMaxBounds[nDim1]),  vMinBounds[nDim2] - 20.0f  / _scale, 0.0f);
     dimensions << g_pDimStrings[nDim1] << vSize[nDim1];
     GlobalOpenGL().drawString(dimensions.str());
@@ -1121,29 +1196,6 @@ void XYWnd::drawSizeInfo(int nDim1, int nDim2, const Vector3& vMinBounds, const
   }
   else if (_viewType == XZ)
   {
-    glBegin (GL_LINES);
-
-    glVertex3f(vMinBounds[nDim1], 0, vMinBounds[nDim2] - 6.0f  / _scale);
-    glVertex3f(vMinBounds[nDim1], 0, vMinBounds[nDim2] - 10.0f / _scale);
-
-    glVertex3f(vMinBounds[nDim1], 0,vMinBounds[nDim2] - 10.0f  / _scale);
-    glVertex3f(vMaxBounds[nDim1], 0,vMinBounds[nDim2] - 10.0f  / _scale);
-
-    glVertex3f(vMaxBounds[nDim1], 0,vMinBounds[nDim2] - 6.0f  / _scale);
-    glVertex3f(vMaxBounds[nDim1], 0,vMinBounds[nDim2] - 10.0f / _scale);
-
-
-    glVertex3f(vMaxBounds[nDim1] + 6.0f  / _scale, 0,vMinBounds[nDim2]);
-    glVertex3f(vMaxBounds[nDim1] + 10.0f  / _scale, 0,vMinBounds[nDim2]);
-
-    glVertex3f(vMaxBounds[nDim1] + 10.0f  / _scale, 0,vMinBounds[nDim2]);
-    glVertex3f(vMaxBounds[nDim1] + 10.0f  / _scale, 0,vMaxBounds[nDim2]);
-
-    glVertex3f(vMaxBounds[nDim1] + 6.0f  / _scale, 0,vMaxBounds[nDim2]);
-    glVertex3f(vMaxBounds[nDim1] + 10.0f  / _scale, 0,vMaxBounds[nDim2]);
-
-    glEnd();
-
     glRasterPos3f (Betwixt(vMinBounds[nDim1], vMaxBounds[nDim1]), 0, vMinBounds[nDim2] - 20.0f  / _scale);
     dimensions << g_pDimStrings[nDim1] << vSize[nDim1];
     GlobalOpenGL().drawString(dimensions.str());
@@ -1160,29 +1212,6 @@ void XYWnd::drawSizeInfo(int nDim1, int nDim2, const Vector3& vMinBounds, const
   }
   else
   {
-    glBegin (GL_LINES);
-
-    glVertex3f(0, vMinBounds[nDim1], vMinBounds[nDim2] - 6.0f  / _scale);
-    glVertex3f(0, vMinBounds[nDim1], vMinBounds[nDim2] - 10.0f / _scale);
-
-    glVertex3f(0, vMinBounds[nDim1], vMinBounds[nDim2] - 10.0f  / _scale);
-    glVertex3f(0, vMaxBounds[nDim1], vMinBounds[nDim2] - 10.0f  / _scale);
-
-    glVertex3f(0, vMaxBounds[nDim1], vMinBounds[nDim2] - 6.0f  / _scale);
-    glVertex3f(0, vMaxBounds[nDim1], vMinBounds[nDim2] - 10.0f / _scale);
-
-
-    glVertex3f(0, vMaxBounds[nDim1] + 6.0f  / _scale, vMinBounds[nDim2]);
-    glVertex3f(0, vMaxBounds[nDim1] + 10.0f  / _scale, vMinBounds[nDim2]);
-
-    glVertex3f(0, vMaxBounds[nDim1] + 10.0f  / _scale, vMinBounds[nDim2]);
-    glVertex3f(0, vMaxBounds[nDim1] + 10.0f  / _scale, vMaxBounds[nDim2]);
-
-    glVertex3f(0, vMaxBounds[nDim1] + 6.0f  / _scale, vMaxBounds[nDim2]);
-    glVertex3f(0, vMaxBounds[nDim1] + 10.0f  / _scale, vMaxBounds[nDim2]);
-
-    glEnd();
-
     glRasterPos3f (0, Betwixt(vMinBounds[nDim1], vMaxBounds[nDim1]),  vMinBounds[nDim2] - 20.0f  / _scale);
     dimensions << g_pDimStrings[nDim1] << vSize[nDim1];
     GlobalOpenGL().drawString(dimensions.str());
@@ -1278,6 +1307,8 @@ void XYWnd::updateModelview() {
 
 void XYWnd::draw()
 {
+    _renderStats.resetStats();
+
     // clear
     glViewport(0, 0, _width, _height);
     Vector3 colourGridBack = GlobalColourSchemeManager().getColour("grid_background");
@@ -1328,21 +1359,26 @@ void XYWnd::draw()
     }
 
     {
-        // Construct the renderer and render the scene
-        XYRenderer renderer(flagsMask, _selectedShader.get(), _selectedShaderGroup.get());
+        // First pass (scenegraph traversal), this is shared with the other views
+        const XYRenderer& sceneRenderer = xyWndManager.getFrontEnd().collect(*this, flagsMask,
+            _selectedShader.get(), _selectedShaderGroup.get());
 
-        // First pass (scenegraph traversal)
-        render::RenderableCollectionWalker::CollectRenderablesInScene(renderer,
-                                                                      _view);
+        _renderStats.frontEndComplete();
 
+        // Views re-using the shared pass report the counts of the traversal that recorded it
+        const auto& traversalStats = xyWndManager.getFrontEnd().getTraversalStatistics();
+        _renderStats.setNodeCounts(traversalStats.visitedNodes, traversalStats.culledNodes);
+
+        // The active mousetools are specific to this view
+        XYRenderer renderer(flagsMask, _selectedShader.get(), _selectedShaderGroup.get());
 
-		// Render any active mousetools
 		for (const ActiveMouseTools::value_type& i : _activeMouseTools)
 		{
 			i.second->render(GlobalRenderSystem(), renderer, _view);
 		}
 
         // Second pass (GL calls)
+        sceneRenderer.submit();
         renderer.render(_modelView, _projection);
     }
 
@@ -1476,6 +1512,11 @@ void XYWnd::draw()
         }
     }
 
+    if (xyWndManager.showRenderStats())
+    {
+        drawRenderStats();
+    }
+
     debug::assertNoGlErrors();
 
     // Reset the depth mask to its initial value (enabled)
@@ -1485,6 +1526,22 @@ void XYWnd::draw()
     glFinish();
 }
 
+void XYWnd::drawRenderStats()
+{
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(0, _width, 0, _height, 0, 1);
+
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+
+    glColor3dv(GlobalColourSchemeManager().getColour("grid_text"));
+    glRasterPos2f(4.0f, 4.0f);
+
+    // The ortho views don't process any lights
+    GlobalOpenGL().drawString(_renderStats.getStatString(false));
+}
+
 void XYWnd::mouseToPoint(int x, int y, Vector3& point)
 {
     point = convertXYToWorld(x, y);
@@ -1557,6 +1614,7 @@ bool XYWnd::onRender()
 	if (GlobalMainFrame().screenUpdatesEnabled())
 	{
         util::ScopedBoolLock drawLock(_drawing);
+        _drawPending = false;
 
 		draw();
 
@@ -15,9 +15,11 @@
 #include <sigc++/connection.h>
 
 #include "render/View.h"
+#include "render/RenderStatistics.h"
 #include "imousetool.h"
 #include "tools/XYMouseToolEvent.h"
 #include "wxutil/MouseToolHandler.h"
+#include "CachedGeometry.h"
 
 namespace ui
 {
@@ -35,6 +37,9 @@ protected:
     wxutil::GLWidget* _wxGLWidget;
     bool _drawing;
 
+    // Set when a redraw has been requested and not carried out yet
+    bool _drawPending;
+
     // The maximum/minimum values of a coordinate
     double _minWorldCoord;
     double _maxWorldCoord;
@@ -86,6 +91,15 @@ protected:
 
     sigc::connection _sigCameraChanged;
 
+    // Decorations kept in vertex buffers, regenerated when their key changes
+    CachedGeometry _minorGrid;
+    CachedGeometry _majorGrid;
+    CachedGeometry _blockGrid;
+    CachedGeometry _sizeInfo;
+    CachedGeometry _cameraIcon;
+
+    render::RenderStatistics _renderStats;
+
 public:
     // Constructor, this allocates the GL widget
     XYWnd(int uniqueId, wxWindow* parent);
@@ -104,6 +118,9 @@ public:
     void queueDraw() override;
     void forceRedraw() override;
 
+    // True if this view has been asked to redraw and hasn't done so yet
+    bool isDrawPending() const;
+
     // Capture and release the selected shader
     static void captureStates();
     static void releaseStates();
@@ -156,6 +173,9 @@ protected:
     // Disconnects all widgets and unsubscribes as observer
     void destroyXYView();
 
+    // Deletes the vertex buffers of the cached geometry, as part of the GL teardown
+    void releaseCachedGeometry();
+
     // Required overrides being a MouseToolHandler
     virtual MouseTool::Result processMouseDownEvent(const MouseToolPtr& tool, const Vector2& point) override;
     virtual MouseTool::Result processMouseUpEvent(const MouseToolPtr& tool, const Vector2& point) override;
@@ -170,6 +190,7 @@ private:
     void onContextMenu();
     void drawSizeInfo(int nDim1, int nDim2, const Vector3& vMinBounds, const Vector3& vMaxBounds);
     void drawCameraIcon();
+    void drawRenderStats();
 
     // callbacks
     bool checkChaseMouse(unsigned int state);
@@ -12,6 +12,7 @@
 #include "math/Ray.h"
 
 #include <functional>
+#include "ParallelForEach.h"
 
 namespace {
     /// \brief Returns true if edge (\p x, \p y) is smaller than the epsilon used to classify winding points against a plane.
@@ -230,6 +231,28 @@ void Brush::evaluateBRep() const {
     }
 }
 
+void Brush::evaluateBReps(const std::vector<Brush*>& brushes)
+{
+    std::vector<Brush*> outdated;
+
+    for (Brush* brush : brushes)
+    {
+        // This is calling back into the owning node, keep it on this thread
+        brush->evaluateTransform();
+
+        if (brush->m_planeChanged)
+        {
+            outdated.push_back(brush);
+        }
+    }
+
+    // Every brush is only touching its own faces and windings from here on
+    util::parallelForEach(outdated.size(), [&](std::size_t index)
+    {
+        outdated[index]->evaluateBRep();
+    });
+}
+
 void Brush::transformChanged() {
     m_transformChanged = true;
     onFacePlaneChanged();
@@ -283,9 +306,20 @@ void Brush::translate(const Vector3& translation)
 
 void Brush::transform(const Matrix4& matrix)
 {
+    // Transform the planes of all faces in one batch
+    std::vector<Plane3> planes;
+    planes.reserve(m_faces.size());
+
     for (const FacePtr& face : m_faces)
     {
-        face->transform(matrix);
+        planes.push_back(face->getPlaneTransformed().getPlane());
+    }
+
+    FacePlane::transformPlanes(matrix, planes.data(), planes.size());
+
+    for (std::size_t i = 0; i < m_faces.size(); ++i)
+    {
+        m_faces[i]->transform(matrix, planes[i]);
     }
 }
 
@@ -428,6 +462,8 @@ void Brush::push_back(Faces::value_type face) {
         (*i)->push_back(*face);
         (*i)->DEBUG_verify();
     }
+
+    _owner.materialsChanged();
 }
 
 void Brush::pop_back()
@@ -442,6 +478,8 @@ void Brush::pop_back()
         (*i)->pop_back();
         (*i)->DEBUG_verify();
     }
+
+    _owner.materialsChanged();
 }
 
 void Brush::erase(std::size_t index)
@@ -456,6 +494,8 @@ void Brush::erase(std::size_t index)
         (*i)->erase(index);
         (*i)->DEBUG_verify();
     }
+
+    _owner.materialsChanged();
 }
 
 void Brush::onFacePlaneChanged()
@@ -469,6 +509,9 @@ void Brush::onFaceShaderChanged()
 {
     onFacePlaneChanged();
 
+    // Let the map's material index know
+    _owner.materialsChanged();
+
     // Queue an UI update of the texture tools if any of them is listening
 	signal_faceShaderChanged().emit();
 }
@@ -500,6 +543,8 @@ void Brush::clear()
         (*i)->clear();
         (*i)->DEBUG_verify();
     }
+
+    _owner.materialsChanged();
 }
 
 std::size_t Brush::getNumFaces() const
@@ -1096,7 +1141,7 @@ bool Brush::isBounded() {
     return true;
 }
 
-/// \brief Constructs the polygon windings for each face of the brush. Also updates the brush bounding-box and face texture-coordinates.
+/// \brief Constructs the polygon windings for each face of the brush. Also updates the brush bounding-box and invalidates the face texture-coordinates.
 bool Brush::buildWindings() {
     {
         m_aabb_local = AABB();
@@ -1117,12 +1162,10 @@ bool Brush::buildWindings() {
 				{
                     m_aabb_local.includePoint(wv.vertex);
                 }
-
-                // update texture coordinates
-                f.EmitTextureCoordinates();
             }
 
             // greebo: Update the winding, now that it's constructed
+            // Texture coordinates are evaluated when they're needed
             f.updateWinding();
         }
     }
@@ -201,6 +201,12 @@ public:
 
 	void evaluateBRep() const override;
 
+	// Evaluates the outdated B-Reps of the given brushes, distributing the work
+	// over several threads. Pending transforms are evaluated on the calling
+	// thread first. Use this after changing a large number of brushes at once,
+	// to not have them evaluated one after the other when they're rendered.
+	static void evaluateBReps(const std::vector<Brush*>& brushes);
+
     void transformChanged();
     void evaluateTransform();
 
@@ -321,7 +327,7 @@ private:
 	/// \brief Returns true if the brush is a finite volume. A brush without a finite volume extends past the maximum world bounds and is not valid.
 	bool isBounded();
 
-	/// \brief Constructs the polygon windings for each face of the brush. Also updates the brush bounding-box and face texture-coordinates.
+	/// \brief Constructs the polygon windings for each face of the brush. Also updates the brush bounding-box and invalidates the face texture-coordinates.
 	bool buildWindings();
 
 	/// \brief Constructs the face windings and updates anything that depends on them.
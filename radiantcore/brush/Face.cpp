@@ -41,7 +41,8 @@ Face::Face(Brush& owner) :
     _owner(owner),
     _shader(texdef_name_default(), _owner.getBrushNode().getRenderSystem()),
     _undoStateSaver(nullptr),
-    _faceIsVisible(true)
+    _faceIsVisible(true),
+    _texcoordsValid(false)
 {
     setupSurfaceShader();
 
@@ -64,7 +65,8 @@ Face::Face(
     _shader(shader, _owner.getBrushNode().getRenderSystem()),
     _texdef(projection),
     _undoStateSaver(nullptr),
-    _faceIsVisible(true)
+    _faceIsVisible(true),
+    _texcoordsValid(false)
 {
     setupSurfaceShader();
     m_plane.initialiseFromPoints(p0, p1, p2);
@@ -76,7 +78,8 @@ Face::Face(Brush& owner, const Plane3& plane) :
     _owner(owner),
     _shader("", _owner.getBrushNode().getRenderSystem()),
     _undoStateSaver(nullptr),
-    _faceIsVisible(true)
+    _faceIsVisible(true),
+    _texcoordsValid(false)
 {
     setupSurfaceShader();
     m_plane.setPlane(plane);
@@ -89,7 +92,8 @@ Face::Face(Brush& owner, const Plane3& plane, const Matrix4& texdef,
     _owner(owner),
     _shader(shader, _owner.getBrushNode().getRenderSystem()),
     _undoStateSaver(nullptr),
-    _faceIsVisible(true)
+    _faceIsVisible(true),
+    _texcoordsValid(false)
 {
     setupSurfaceShader();
     m_plane.setPlane(plane);
@@ -108,7 +112,8 @@ Face::Face(Brush& owner, const Face& other) :
     _shader(other._shader.getMaterialName(), _owner.getBrushNode().getRenderSystem()),
     _texdef(other.getProjection()),
     _undoStateSaver(nullptr),
-    _faceIsVisible(other._faceIsVisible)
+    _faceIsVisible(other._faceIsVisible),
+    _texcoordsValid(false)
 {
     setupSurfaceShader();
     planepts_assign(m_move_planepts, other.m_move_planepts);
@@ -228,6 +233,8 @@ void Face::renderSolid(RenderableCollector& collector,
                        const Matrix4& localToWorld, const IRenderEntity& entity,
                        const LightSources& lights) const
 {
+    updateTextureCoordinates();
+
     collector.addRenderable(*_shader.getGLShader(), m_winding, localToWorld,
                             &lights, &entity);
 }
@@ -271,13 +278,21 @@ void Face::translate(const Vector3& translation)
 
 void Face::transform(const Matrix4& matrix)
 {
-    if (GlobalBrush().textureLockEnabled()) 
+    // Transform the FacePlane using the given matrix
+    FacePlane plane = m_planeTransformed;
+    plane.transform(matrix);
+
+    transform(matrix, plane.getPlane());
+}
+
+void Face::transform(const Matrix4& matrix, const Plane3& transformedPlane)
+{
+    if (GlobalBrush().textureLockEnabled())
     {
         m_texdefTransformed.transformLocked(_shader.getWidth(), _shader.getHeight(), m_plane.getPlane(), matrix);
     }
 
-    // Transform the FacePlane using the given matrix
-    m_planeTransformed.transform(matrix);
+    m_planeTransformed.setPlane(transformedPlane);
     _owner.onFacePlaneChanged();
     updateWinding();
 }
@@ -310,17 +325,18 @@ void Face::freezeTransform() {
 
 void Face::updateWinding() {
     m_winding.updateNormals(m_plane.getPlane().normal());
+    invalidateTextureCoordinates();
 }
 
 void Face::update_move_planepts_vertex(std::size_t index, PlanePoints planePoints) {
-    std::size_t numpoints = getWinding().size();
+    std::size_t numpoints = m_winding.size();
     ASSERT_MESSAGE(index < numpoints, "update_move_planepts_vertex: invalid index");
 
-    std::size_t opposite = getWinding().opposite(index);
-    std::size_t adjacent = getWinding().wrap(opposite + numpoints - 1);
-    planePoints[0] = getWinding()[opposite].vertex;
-    planePoints[1] = getWinding()[index].vertex;
-    planePoints[2] = getWinding()[adjacent].vertex;
+    std::size_t opposite = m_winding.opposite(index);
+    std::size_t adjacent = m_winding.wrap(opposite + numpoints - 1);
+    planePoints[0] = m_winding[opposite].vertex;
+    planePoints[1] = m_winding[index].vertex;
+    planePoints[2] = m_winding[adjacent].vertex;
     // winding points are very inaccurate, so they must be quantised before using them to generate the face-plane
     planepts_quantise(planePoints, GRID_MIN);
 }
@@ -351,7 +367,7 @@ void Face::testSelect_centroid(SelectionTest& test, SelectionIntersection& best)
 
 void Face::shaderChanged()
 {
-    EmitTextureCoordinates();
+    invalidateTextureCoordinates();
     _owner.onFaceShaderChanged();
 
     // Update the visibility flag, but leave out the contributes() check
@@ -390,7 +406,7 @@ void Face::revertTexdef()
 void Face::texdefChanged()
 {
     revertTexdef();
-    EmitTextureCoordinates();
+    invalidateTextureCoordinates();
 
     // Fire the signal to update the Texture Tools
     signal_texdefChanged().emit();
@@ -488,13 +504,13 @@ void Face::applyShaderFromFace(const Face& other)
     SetTexdef(projection);
 
     // The list of shared vertices
-    std::vector<Winding::const_iterator> thisVerts, otherVerts;
+    std::vector<std::size_t> thisVerts, otherVerts;
 
     // Let's see whether this face is sharing any 3D coordinates with the other one
-    for (Winding::const_iterator i = other.m_winding.begin(); i != other.m_winding.end(); ++i) {
-        for (Winding::const_iterator j = m_winding.begin(); j != m_winding.end(); ++j) {
+    for (std::size_t i = 0; i < other.m_winding.size(); ++i) {
+        for (std::size_t j = 0; j < m_winding.size(); ++j) {
             // Check if the vertices are matching
-            if (j->vertex.isEqual(i->vertex, 0.001))
+            if (m_winding[j].vertex.isEqual(other.m_winding[i].vertex, 0.001))
             {
                 // Match found, add to list
                 thisVerts.push_back(j);
@@ -508,7 +524,7 @@ void Face::applyShaderFromFace(const Face& other)
     }
 
     // Calculate the distance in texture space of the first shared vertices
-    Vector2 dist = thisVerts[0]->texcoord - otherVerts[0]->texcoord;
+    Vector2 dist = getTexcoord(thisVerts[0]) - other.getTexcoord(otherVerts[0]);
 
     // Shift the texture to match
     shiftTexdef(static_cast<float>(dist.x()), static_cast<float>(dist.y()));
@@ -554,12 +570,25 @@ void Face::flipTexture(unsigned int flipAxis) {
 void Face::alignTexture(AlignEdge align)
 {
     undoSave();
+    updateTextureCoordinates();
     _texdef.alignTexture(align, m_winding);
     texdefChanged();
 }
 
-void Face::EmitTextureCoordinates() {
-    m_texdefTransformed.emitTextureCoordinates(m_winding, plane3().normal(), Matrix4::getIdentity());
+void Face::invalidateTextureCoordinates()
+{
+    _texcoordsValid = false;
+    m_winding.invalidateRenderVertices();
+}
+
+void Face::updateTextureCoordinates() const
+{
+    if (_texcoordsValid) return;
+
+    _texcoordsValid = true;
+
+    // Use the transformed plane as it is, plane3() would trigger a brush evaluation
+    m_texdefTransformed.emitTextureCoordinates(m_winding, m_planeTransformed.getPlane().normal(), Matrix4::getIdentity());
 }
 
 void Face::applyDefaultTextureScale()
@@ -584,6 +613,20 @@ Winding& Face::getWinding() {
     return m_winding;
 }
 
+Vector2 Face::getTexcoord(std::size_t vertexIndex) const
+{
+    updateTextureCoordinates();
+    return m_winding.getTexcoord(vertexIndex);
+}
+
+void Face::getTextureAxes(Vector3& tangent, Vector3& bitangent) const
+{
+    updateTextureCoordinates();
+
+    tangent = m_winding.getTangent();
+    bitangent = m_winding.getBitangent();
+}
+
 const Plane3& Face::plane3() const
 {
     _owner.onFaceEvaluateTransform();
@@ -595,6 +638,12 @@ const Plane3& Face::getPlane3() const
     return m_plane.getPlane();
 }
 
+void Face::setPlane3(const Plane3& plane)
+{
+    m_plane.setPlane(plane);
+    planeChanged();
+}
+
 FacePlane& Face::getPlane() {
     return m_plane;
 }
@@ -602,11 +651,22 @@ const FacePlane& Face::getPlane() const {
     return m_plane;
 }
 
+const FacePlane& Face::getPlaneTransformed() const
+{
+    return m_planeTransformed;
+}
+
 Matrix4 Face::getTexDefMatrix() const
 {
     return _texdef.matrix.getTransform();
 }
 
+void Face::setTexDefMatrix(const Matrix4& matrix)
+{
+    _texdef.matrix = TextureMatrix(matrix);
+    texdefChanged();
+}
+
 SurfaceShader& Face::getFaceShader() {
     return _shader;
 }
@@ -630,17 +690,17 @@ bool Face::is_bounded() const {
 void Face::normaliseTexture() {
     undoSave();
 
-    Winding::const_iterator nearest = m_winding.begin();
+    if (m_winding.empty()) return;
+
+    Vector2 texcoord = getTexcoord(0);
 
     // Find the vertex with the minimal distance to the origin
-    for (Winding::const_iterator i = m_winding.begin(); i != m_winding.end(); ++i) {
-        if (nearest->texcoord.getLength() > i->texcoord.getLength()) {
-            nearest = i;
+    for (std::size_t i = 1; i < m_winding.size(); ++i) {
+        if (texcoord.getLength() > getTexcoord(i).getLength()) {
+            texcoord = getTexcoord(i);
         }
     }
 
-    Vector2 texcoord = nearest->texcoord;
-
     // The floored values
     Vector2 floored(floor(fabs(texcoord[0])), floor(fabs(texcoord[1])));
 
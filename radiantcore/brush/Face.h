@@ -53,7 +53,10 @@ private:
 	TextureProjection _texdef;
 	TextureProjection m_texdefTransformed;
 
-	Winding m_winding;
+	// The texture coordinates and texture axes of the winding are a cache,
+	// filled on demand by const accessors like getTexcoord() or renderSolid().
+	// Like the rest of the brush this must only be accessed from the main thread.
+	mutable Winding m_winding;
 	Vector3 m_centroid;
 
 	IUndoStateSaver* _undoStateSaver;
@@ -61,6 +64,9 @@ private:
 	// Cached visibility flag, queried during front end rendering
 	bool _faceIsVisible;
 
+	// False if the winding texture coordinates need to be re-evaluated
+	mutable bool _texcoordsValid;
+
 public:
 
 	// Constructors
@@ -113,6 +119,10 @@ public:
 
 	void transform(const Matrix4& matrix) override;
 
+	// Applies the transformation, the face plane has already been transformed
+	// by the caller (see Brush::transform)
+	void transform(const Matrix4& matrix, const Plane3& transformedPlane);
+
 	void assign_planepts(const PlanePoints planepts);
 
 	/// \brief Reverts the transformable state of the brush to identity.
@@ -173,7 +183,9 @@ public:
 	 */
 	void normaliseTexture();
 
-	void EmitTextureCoordinates();
+	// Marks the texture coordinates of the winding as outdated,
+	// they will be evaluated again the next time they're requested
+	void invalidateTextureCoordinates();
 
     // When constructing faces with a default-constructed TextureProjection the scale is very small
     // fix that by calling this method.
@@ -183,18 +195,26 @@ public:
 
 	void construct_centroid();
 
-	const Winding& getWinding() const;
-	Winding& getWinding();
+	const Winding& getWinding() const override;
+	Winding& getWinding() override;
+
+	Vector2 getTexcoord(std::size_t vertexIndex) const override;
+	void getTextureAxes(Vector3& tangent, Vector3& bitangent) const override;
 
 	const Plane3& plane3() const;
 
 	// Returns the Doom 3 plane
-	const Plane3& getPlane3() const;
+	const Plane3& getPlane3() const override;
+	void setPlane3(const Plane3& plane) override;
 
 	FacePlane& getPlane();
 	const FacePlane& getPlane() const;
 
-	Matrix4 getTexDefMatrix() const;
+	// The plane including the current transformation, without evaluating pending changes
+	const FacePlane& getPlaneTransformed() const;
+
+	Matrix4 getTexDefMatrix() const override;
+	void setTexDefMatrix(const Matrix4& matrix) override;
 
 	Matrix4 getProjectionMatrix() override;
 	void setProjectionMatrix(const Matrix4& projection) override;
@@ -215,6 +235,9 @@ public:
 private:
 	void realiseShader();
 
+	// Emits the texture coordinates to the winding, if they are outdated
+	void updateTextureCoordinates() const;
+
 	// Connects surface shader signals and calls realiseShader() if possible
 	void setupSurfaceShader();
 
@@ -1,6 +1,7 @@
 #include "FacePlane.h"
 
 #include "math/Matrix4.h"
+#include "math/BatchOps.h"
 
 void FacePlane::reverse()
 {
@@ -18,17 +19,28 @@ void FacePlane::translate(const Vector3& translation)
 
 void FacePlane::transform(const Matrix4& matrix)
 {
-    // Prepare the plane to be transformed (negate the distance)
-    m_plane.dist() = -m_plane.dist();
+    transformPlanes(matrix, &m_plane, 1);
+}
 
-    // Transform the plane
-    m_plane.transform(matrix);
+void FacePlane::transformPlanes(const Matrix4& matrix, Plane3* planes, std::size_t count)
+{
+    // Prepare the planes to be transformed (negate the distance)
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        planes[i].dist() = -planes[i].dist();
+    }
 
-    // Re-negate the distance
-    m_plane.dist() = -m_plane.dist();
+    // Transform the planes
+    math::transformPlanes(matrix, planes, count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        // Re-negate the distance
+        planes[i].dist() = -planes[i].dist();
 
-    // Now normalise the plane, otherwise the next transformation will screw up
-    m_plane.normalise();
+        // Now normalise the plane, otherwise the next transformation will screw up
+        planes[i].normalise();
+    }
 }
 
 void FacePlane::offset(float offset)
@@ -46,6 +46,10 @@ public:
     /// Transform the plane by an arbitrary matrix
     void transform(const Matrix4& matrix);
 
+    /// Transform several planes (in face plane representation) by the same
+    /// matrix, with the same result as calling transform() on each of them
+    static void transformPlanes(const Matrix4& matrix, Plane3* planes, std::size_t count);
+
     void offset(float offset);
 
 }; // class FacePlane
@@ -3,6 +3,7 @@
 #include "Brush.h"
 #include "Winding.h"
 #include "itextstream.h"
+#include "math/BatchOps.h"
 
 namespace {
 	inline bool float_is_largest_absolute(double axis, double other) {
@@ -132,7 +133,20 @@ void FixedWinding::clip(const Plane3& plane, const Plane3& clipPlane, std::size_
 		return; // Degenerate winding, exit
 	}
 
-	PlaneClassification classification = Winding::classifyDistance(clipPlane.distanceToPoint(back().vertex), ON_EPSILON);
+	// Calculate the distances of all vertices to the clip plane in one batch
+	double fixedDistances[MAX_POINTS_ON_WINDING];
+	std::vector<double> dynamicDistances;
+	double* distances = fixedDistances;
+
+	if (size() > MAX_POINTS_ON_WINDING)
+	{
+		dynamicDistances.resize(size());
+		distances = dynamicDistances.data();
+	}
+
+	math::getPlaneDistances(clipPlane, &front().vertex, size(), distances, sizeof(FixedWindingVertex));
+
+	PlaneClassification classification = Winding::classifyDistance(distances[size() - 1], ON_EPSILON);
 	PlaneClassification nextClassification;
 
 	// for each edge
@@ -140,7 +154,7 @@ void FixedWinding::clip(const Plane3& plane, const Plane3& clipPlane, std::size_
 		 next != size();
 		 i = next, ++next, classification = nextClassification)
 	{
-		nextClassification = Winding::classifyDistance(clipPlane.distanceToPoint((*this)[next].vertex), ON_EPSILON);
+		nextClassification = Winding::classifyDistance(distances[next], ON_EPSILON);
 		const FixedWindingVertex& vertex = (*this)[i];
 
 		// if first vertex of edge is ON
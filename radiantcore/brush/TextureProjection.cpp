@@ -254,7 +254,7 @@ void TextureProjection::alignTexture(IFace::AlignEdge align, const Winding& wind
     // Calculate all edges in texture space
     for (std::size_t i = 0, j = 1; i < winding.size(); ++i, j = winding.next(j))
     {
-        texEdges[i] = winding[j].texcoord - winding[i].texcoord;
+        texEdges[i] = winding.getTexcoord(j) - winding.getTexcoord(i);
     }
 
     // Find the edge which is nearest to the s,t base vector, to classify them as "top" or "left"
@@ -264,13 +264,13 @@ void TextureProjection::alignTexture(IFace::AlignEdge align, const Winding& wind
     std::size_t topEdge = findBestEdgeForDirection(Vector2(-1,0), texEdges);
 
     // The bottom edge is the one with the larger T texture coordinate
-    if (winding[topEdge].texcoord.y() > winding[bottomEdge].texcoord.y())
+    if (winding.getTexcoord(topEdge).y() > winding.getTexcoord(bottomEdge).y())
     {
         std::swap(topEdge, bottomEdge);
     }
 
     // The right edge is the one with the larger S texture coordinate
-    if (winding[rightEdge].texcoord.x() < winding[leftEdge].texcoord.x())
+    if (winding.getTexcoord(rightEdge).x() < winding.getTexcoord(leftEdge).x())
     {
         std::swap(rightEdge, leftEdge);
     }
@@ -300,12 +300,12 @@ void TextureProjection::alignTexture(IFace::AlignEdge align, const Winding& wind
         break;
     };
 
-    Vector2 snapped = winding[windingIndex].texcoord;
+    Vector2 snapped = winding.getTexcoord(windingIndex);
 
     // Snap the dimension we're going to change only (s for left/right, t for top/bottom)
     snapped[dim] = float_snapped(snapped[dim], 1.0);
 
-    Vector2 delta = snapped - winding[windingIndex].texcoord;
+    Vector2 delta = snapped - winding.getTexcoord(windingIndex);
 
     // Shift the texture such that we hit the snapped coordinate
     // be sure to invert the s coordinate
@@ -339,8 +339,8 @@ Matrix4 TextureProjection::getWorldToTexture(const Vector3& normal, const Matrix
 }
 
 /* greebo: This method calculates the texture coordinates for the brush winding vertices
- * via matrix operations and stores the results into the Winding vertices (together with the
- * tangent and bitangent vectors)
+ * via matrix operations and stores the results into the Winding vertices (the
+ * tangent and bitangent vectors are stored in the Winding itself)
  *
  * Note: The matrix localToWorld is basically useless at the moment, as it is the identity matrix for faces, and this method
  * gets called on face operations only... */
@@ -379,16 +379,14 @@ void TextureProjection::emitTextureCoordinates(Winding& w, const Vector3& normal
 
     // Cycle through the winding vertices and apply the texture transformation matrix
     // onto each of them.
-    for (Winding::iterator i = w.begin(); i != w.end(); ++i)
+    for (std::size_t i = 0; i < w.size(); ++i)
     {
-        Vector3 texcoord = local2tex.transformPoint(i->vertex);
+        Vector3 texcoord = local2tex.transformPoint(w[i].vertex);
 
         // Store the s,t coordinates into the winding texcoord vector
-        i->texcoord[0] = texcoord[0];
-        i->texcoord[1] = texcoord[1];
-
-        // Save the tangent and bitangent vectors, they are the same for all the face vertices
-        i->tangent = tangent;
-        i->bitangent = bitangent;
+        w.setTexcoord(i, Vector2(texcoord[0], texcoord[1]));
     }
+
+    // Save the tangent and bitangent vectors, they are the same for all the face vertices
+    w.setTextureAxes(tangent, bitangent);
 }
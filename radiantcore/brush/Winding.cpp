@@ -42,6 +42,11 @@ namespace {
 		std::size_t x, y, z;
 	};
 
+	inline Vector3f toVector3f(const Vector3& v)
+	{
+		return Vector3f(static_cast<float>(v.x()), static_cast<float>(v.y()), static_cast<float>(v.z()));
+	}
+
 	inline indexremap_t indexremap_for_projectionaxis(const ProjectionAxis axis) {
 		switch (axis) {
 			case eProjectionAxisX:
@@ -54,6 +59,10 @@ namespace {
 	}
 }
 
+Winding::Winding() :
+	_renderVerticesValid(false)
+{}
+
 void Winding::drawWireframe() const
 {
 	if (!empty())
@@ -71,6 +80,11 @@ void Winding::render(const RenderInfo& info) const
 		return;
 	}
 
+    if (!_renderVerticesValid)
+    {
+        updateRenderVertices();
+    }
+
     // Our vertex colours are always white, if requested
     glDisableClientState(GL_COLOR_ARRAY);
     if (info.checkFlag(RENDER_VERTEX_COLOUR))
@@ -80,10 +94,10 @@ void Winding::render(const RenderInfo& info) const
 
 	// A shortcut pointer to the first array element to avoid
 	// massive calls to std::vector<>::begin()
-	const WindingVertex& firstElement = front();
+	const RenderVertex& firstElement = _renderVertices.front();
 
 	// Set the vertex pointer first
-	glVertexPointer(3, GL_DOUBLE, sizeof(WindingVertex), &firstElement.vertex);
+	glVertexPointer(3, GL_FLOAT, sizeof(RenderVertex), &firstElement.vertex);
 
     // Check render flags. Multiple flags may be set, so the order matters.
     if (info.checkFlag(RENDER_TEXTURE_CUBEMAP))
@@ -93,7 +107,7 @@ void Winding::render(const RenderInfo& info) const
         // etc.
         glEnableClientState(GL_TEXTURE_COORD_ARRAY);
         glTexCoordPointer(
-            3, GL_DOUBLE, sizeof(WindingVertex), &firstElement.vertex
+            3, GL_FLOAT, sizeof(RenderVertex), &firstElement.vertex
         );
     }
 	else if (info.checkFlag(RENDER_BUMP))
@@ -101,16 +115,16 @@ void Winding::render(const RenderInfo& info) const
         // Lighting mode, submit normals, tangents and texcoords to the shader
         // program.
 		glVertexAttribPointer(
-            ATTR_NORMAL, 3, GL_DOUBLE, 0, sizeof(WindingVertex), &firstElement.normal
+            ATTR_NORMAL, 3, GL_FLOAT, 0, sizeof(RenderVertex), &firstElement.normal
         );
 		glVertexAttribPointer(
-            ATTR_TEXCOORD, 2, GL_DOUBLE, 0, sizeof(WindingVertex), &firstElement.texcoord
+            ATTR_TEXCOORD, 2, GL_FLOAT, 0, sizeof(RenderVertex), &firstElement.texcoord
         );
 		glVertexAttribPointer(
-            ATTR_TANGENT, 3, GL_DOUBLE, 0, sizeof(WindingVertex), &firstElement.tangent
+            ATTR_TANGENT, 3, GL_FLOAT, 0, sizeof(RenderVertex), &firstElement.tangent
         );
 		glVertexAttribPointer(
-            ATTR_BITANGENT, 3, GL_DOUBLE, 0, sizeof(WindingVertex), &firstElement.bitangent
+            ATTR_BITANGENT, 3, GL_FLOAT, 0, sizeof(RenderVertex), &firstElement.bitangent
         );
 	}
 	else
@@ -118,7 +132,7 @@ void Winding::render(const RenderInfo& info) const
         // Submit normals in lighting mode
 		if (info.checkFlag(RENDER_LIGHTING))
         {
-			glNormalPointer(GL_DOUBLE, sizeof(WindingVertex), &firstElement.normal);
+			glNormalPointer(GL_FLOAT, sizeof(RenderVertex), &firstElement.normal);
 		}
 
         // Set texture coordinates in 2D texture mode
@@ -126,7 +140,7 @@ void Winding::render(const RenderInfo& info) const
         {
             glEnableClientState(GL_TEXTURE_COORD_ARRAY);
             glTexCoordPointer(
-                2, GL_DOUBLE, sizeof(WindingVertex), &firstElement.texcoord
+                2, GL_FLOAT, sizeof(RenderVertex), &firstElement.texcoord
             );
 		}
 	}
@@ -137,6 +151,34 @@ void Winding::render(const RenderInfo& info) const
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 }
 
+void Winding::updateRenderVertices() const
+{
+    _renderVertices.resize(size());
+
+    Vector3f normal = toVector3f(_normal);
+    Vector3f tangent = toVector3f(_tangent);
+    Vector3f bitangent = toVector3f(_bitangent);
+
+    for (std::size_t i = 0; i < size(); ++i)
+    {
+        const WindingVertex& source = (*this)[i];
+        RenderVertex& target = _renderVertices[i];
+
+        target.vertex = toVector3f(source.vertex);
+        target.normal = normal;
+        target.texcoord = i < _texcoords.size() ? _texcoords[i] : BasicVector2<float>(0, 0);
+        target.tangent = tangent;
+        target.bitangent = bitangent;
+    }
+
+    _renderVerticesValid = true;
+}
+
+void Winding::invalidateRenderVertices()
+{
+    _renderVerticesValid = false;
+}
+
 void Winding::testSelect(SelectionTest& test, SelectionIntersection& best)
 {
 	if (empty()) return;
@@ -146,11 +188,47 @@ void Winding::testSelect(SelectionTest& test, SelectionIntersection& best)
 
 void Winding::updateNormals(const Vector3& normal)
 {
-	// Copy all normals into the winding vertices
-	for (iterator i = begin(); i != end(); ++i)
+	_normal = normal;
+	_renderVerticesValid = false;
+}
+
+Vector2 Winding::getTexcoord(std::size_t index) const
+{
+	assert(index < _texcoords.size());
+	return Vector2(_texcoords[index].x(), _texcoords[index].y());
+}
+
+void Winding::setTexcoord(std::size_t index, const Vector2& texcoord)
+{
+	if (_texcoords.size() != size())
 	{
-		i->normal = normal;
+		_texcoords.resize(size());
 	}
+
+	_texcoords[index] = BasicVector2<float>(static_cast<float>(texcoord.x()), static_cast<float>(texcoord.y()));
+	_renderVerticesValid = false;
+}
+
+void Winding::setTextureAxes(const Vector3& tangent, const Vector3& bitangent)
+{
+	_tangent = tangent;
+	_bitangent = bitangent;
+	_renderVerticesValid = false;
+}
+
+const Vector3& Winding::getNormal() const
+{
+	return _normal;
+}
+
+const Vector3& Winding::getTangent() const
+{
+	return _tangent;
+}
+
+const Vector3& Winding::getBitangent() const
+{
+	return _bitangent;
 }
 
 AABB Winding::aabb() const
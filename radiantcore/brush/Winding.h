@@ -44,17 +44,58 @@ class Winding :
 	public IWinding,
     public OpenGLRenderable
 {
+private:
+	// Normal and texture axes, these are the same for every vertex
+	Vector3 _normal;
+	Vector3 _tangent;
+	Vector3 _bitangent;
+
+	// Texture coordinates, one per vertex, evaluated by the owning face
+	std::vector<BasicVector2<float>> _texcoords;
+
+	// Single-precision vertex data as submitted to OpenGL
+	struct RenderVertex
+	{
+		Vector3f vertex;
+		Vector3f normal;
+		BasicVector2<float> texcoord;
+		Vector3f tangent;
+		Vector3f bitangent;
+	};
+
+	// Built from the winding vertices the first time this winding is rendered
+	mutable std::vector<RenderVertex> _renderVertices;
+	mutable bool _renderVerticesValid;
+
 public:
+	Winding();
+
 	/** greebo: Calculates the AABB of this winding
 	 */
 	AABB aabb() const;
 
 	void testSelect(SelectionTest& test, SelectionIntersection& best);
 
-	// greebo: Updates the array containing the normal vectors of this winding
-	// The normal is the same for each vertex, so this just copies the values
+	// greebo: Sets the normal vector of this winding
+	// The normal is the same for each vertex, so this is stored only once
 	void updateNormals(const Vector3& normal);
 
+	// Sets the texture space axes, which are the same for each vertex
+	void setTextureAxes(const Vector3& tangent, const Vector3& bitangent);
+
+	// Returns the texture coordinates of the vertex with the given index
+	Vector2 getTexcoord(std::size_t index) const;
+
+	// Stores the texture coordinates of the vertex with the given index
+	void setTexcoord(std::size_t index, const Vector2& texcoord);
+
+	const Vector3& getNormal() const;
+	const Vector3& getTangent() const;
+	const Vector3& getBitangent() const;
+
+	// Discards the render data, to be called after the vertices have been changed
+	void invalidateRenderVertices();
+
 	// Submits this winding to OpenGL
 	void render(const RenderInfo& info) const;
 
@@ -96,6 +137,9 @@ public:
 
 	/// \brief Returns true if any point in \p w1 is in front of plane2, or any point in \p w2 is in front of plane1
 	static bool planesConcave(const Winding& w1, const Winding& w2, const Plane3& plane1, const Plane3& plane2);
+
+private:
+	void updateRenderVertices() const;
 };
 
 #endif
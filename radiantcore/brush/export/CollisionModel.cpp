@@ -8,6 +8,9 @@
 #include "brush/Brush.h"
 #include "brush/Winding.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace cmutil {
 
 	namespace
@@ -21,6 +24,16 @@ namespace cmutil {
 		const std::size_t SIZEOF_FACE = 16;
 	}
 
+// Returns the cell of the welding grid the given vertex is located in
+VertexCell getVertexCell(const Vector3& vertex)
+{
+	return VertexCell{
+		static_cast<long long>(std::floor(vertex.x() / MAX_PRECISION)),
+		static_cast<long long>(std::floor(vertex.y() / MAX_PRECISION)),
+		static_cast<long long>(std::floor(vertex.z() / MAX_PRECISION))
+	};
+}
+
 // Writes the given Vector3 in the format ( 0 1 2 ) to the given stream
 void writeVector(std::ostream& st, const Vector3& vector)
 {
@@ -32,9 +45,17 @@ void writeVector(std::ostream& st, const Vector3& vector)
 	st << ")";
 }
 
+// Writes the bounds of the given AABB as two vertices
+void writeBounds(std::ostream& st, const AABB& aabb)
+{
+	writeVector(st, aabb.origin - aabb.extents);
+	st << " ";
+	writeVector(st, aabb.origin + aabb.extents);
+}
+
 // Writes a single polygon to the given stream <st>
-std::ostream& operator<< (std::ostream& st, const Polygon poly) {
-	st << poly.numEdges;
+void writePolygon(std::ostream& st, const Polygon& poly, const std::string& shader) {
+	st << poly.edges.size();
 
 	// Edge List
 	st << " (";
@@ -44,67 +65,79 @@ std::ostream& operator<< (std::ostream& st, const Polygon poly) {
 	st << " ) ";
 
 	// Plane normal
-	writeVector(st, poly.plane.normal());
-	st << " " << poly.plane.dist() << " ";
-	writeVector(st, poly.min);
-	st << " ";
-	writeVector(st, poly.max);
-	st << " \"" << poly.shader.c_str() << "\"";
-	return st;
+	const Plane3& plane = poly.face->plane3();
+	writeVector(st, plane.normal());
+	st << " " << plane.dist() << " ";
+	writeBounds(st, poly.face->getWinding().aabb());
+	st << " \"" << shader << "\"";
 }
 
-std::ostream& operator<< (std::ostream& st, const BrushStruc b) {
-	st << b.numFaces << " {\n";
+void writeBrush(std::ostream& st, const Brush& brush) {
+	st << brush.getNumFaces() << " {\n";
 
 	// Write all the planes
-	for (std::size_t i = 0; i < b.planes.size(); i++) {
+	for (Brush::const_iterator i = brush.begin(); i != brush.end(); i++) {
 		st << "\t\t";
-		writeVector(st, b.planes[i].normal());
-		st << " " << b.planes[i].dist() << "\n";
+		writeVector(st, (*i)->plane3().normal());
+		st << " " << (*i)->plane3().dist() << "\n";
 	}
 
 	st << "\t} ";
 
 	// Write the two AABB vertices
-	writeVector(st, b.min);
-	st << " ";
-	writeVector(st, b.max);
+	writeBounds(st, brush.localAABB());
 	st << " ";
 
 	// Now append the "solid"
 	st << "\"solid\"";
-	return st;
 }
 
 CollisionModel::CollisionModel() {
 	// Create the "NULL" edge (numVertices = 0)
 	_edges[0] = Edge(0);
+	_edgeIndices[EdgeKey(0, 0)] = 0;
 }
 
 int CollisionModel::findVertex(const Vector3& vertex) const {
-	for (VertexMap::const_iterator i = _vertices.begin();
-		i != _vertices.end();
-		++i)
-	{
-		if (i->second == vertex) {
-			return static_cast<int>(i->first);
+	VertexCell cell = getVertexCell(vertex);
+	int foundIndex = -1;
+
+	// Vertices within the tolerance are at most one cell away
+	for (long long x = cell.x - 1; x <= cell.x + 1; ++x) {
+		for (long long y = cell.y - 1; y <= cell.y + 1; ++y) {
+			for (long long z = cell.z - 1; z <= cell.z + 1; ++z) {
+				auto found = _vertexCells.find(VertexCell{ x, y, z });
+
+				if (found == _vertexCells.end()) {
+					continue;
+				}
+
+				for (std::size_t index : found->second) {
+					if ((foundIndex == -1 || index < static_cast<std::size_t>(foundIndex)) &&
+						_weldPositions[index].isEqual(vertex, static_cast<double>(MAX_PRECISION)))
+					{
+						foundIndex = static_cast<int>(index);
+					}
+				}
+			}
 		}
 	}
-	return -1;
+
+	return foundIndex;
 }
 
 std::size_t CollisionModel::addVertex(const Vector3& vertex)
 {
-	Vector3 snapped = vertex.getSnapped(MAX_PRECISION);
-
 	// Try to lookup the index of the given vertex
-	int foundIndex = findVertex(snapped);
+	int foundIndex = findVertex(vertex);
 
 	if (foundIndex == -1) {
 		// Insert the vertex at the end of the VertexMap
 		// The size of the map is the highest index + 1
 		std::size_t lastIndex = _vertices.size();
-		_vertices[lastIndex] = snapped;
+		_vertices[lastIndex] = vertex.getSnapped(MAX_PRECISION);
+		_weldPositions.push_back(vertex);
+		_vertexCells[getVertexCell(vertex)].push_back(lastIndex);
 
 		return lastIndex;
 	}
@@ -115,21 +148,16 @@ std::size_t CollisionModel::addVertex(const Vector3& vertex)
 }
 
 int CollisionModel::findEdge(const Edge& edge) const {
-	for (EdgeMap::const_iterator i = _edges.begin();
-		 i != _edges.end();
-		 i++)
-	{
-		// Direction match?
-		if (i->second.from == edge.from && i->second.to == edge.to) {
-			return static_cast<int>(i->first);
-		}
+	auto found = _edgeIndices.find(EdgeKey(std::min(edge.from, edge.to), std::max(edge.from, edge.to)));
 
-		// Opposite direction match?
-		if (i->second.from == edge.to && i->second.to == edge.from) {
-			return -static_cast<int>(i->first);
-		}
+	if (found == _edgeIndices.end()) {
+		return 0;
 	}
-	return 0;
+
+	// The sign tells whether the existing edge is running in the same direction
+	const Edge& existing = _edges.at(found->second);
+
+	return existing.from == edge.from ? static_cast<int>(found->second) : -static_cast<int>(found->second);
 }
 
 std::size_t CollisionModel::addEdge(const Edge& edge) {
@@ -140,6 +168,9 @@ std::size_t CollisionModel::addEdge(const Edge& edge) {
 		// NULL edge found, insert the edge with a new index
 		std::size_t edgeIndex = _edges.size();
 		_edges[edgeIndex] = edge;
+
+		// Degenerate edges keep resolving to the NULL edge, don't replace it
+		_edgeIndices.emplace(EdgeKey(std::min(edge.from, edge.to), std::max(edge.from, edge.to)), edgeIndex);
 		return edgeIndex;
 	}
 	else {
@@ -147,33 +178,19 @@ std::size_t CollisionModel::addEdge(const Edge& edge) {
 	}
 }
 
-int CollisionModel::findPolygon(const EdgeList& otherEdges) {
-	for (std::size_t p = 0; p < _polygons.size(); p++) {
-		// Check if the edge count matches
-		if (otherEdges.size() == _polygons[p].numEdges) {
-			// The match count
-			std::size_t matches = 0;
-
-			// See through the current polygon and count the matches
-			for (std::size_t i = 0; i < _polygons[p].edges.size(); i++) {
-				for (std::size_t j = 0; j < otherEdges.size(); j++) {
-					if (abs(_polygons[p].edges[i]) == abs(otherEdges[j])) {
-						matches++;
-					}
-				}
-			}
+bool CollisionModel::removeMatchingPolygon(const EdgeList& otherEdges) {
+	auto found = _polygonIndices.find(otherEdges);
 
-			// If the polygons are the same, all the edge indices matched
-			if (matches == otherEdges.size()) {
-				// Remove the duplicate polygon
-				PolygonList::iterator i = _polygons.begin() + p;
-				_polygons.erase(i);
-				rMessage() << "CollisionModel: Removed duplicate polygon.\n";
-				return static_cast<int>(p);
-			}
-		}
+	if (found == _polygonIndices.end()) {
+		return false;
 	}
-	return -1;
+
+	// Remove the duplicate polygon
+	_polygons.erase(found->second);
+	_polygonIndices.erase(found);
+	rMessage() << "CollisionModel: Removed duplicate polygon.\n";
+
+	return true;
 }
 
 void CollisionModel::addPolygon(
@@ -193,17 +210,20 @@ void CollisionModel::addPolygon(
 		poly.edges.push_back(findEdge(edge));
 	}
 
-	if (findPolygon(poly.edges) == -1) {
-		AABB faceAABB = face.getWinding().aabb();
+	// Polygons are matched by their edges, regardless of order and direction
+	EdgeList key;
+	key.reserve(poly.edges.size());
+
+	for (int edge : poly.edges) {
+		key.push_back(abs(edge));
+	}
+
+	std::sort(key.begin(), key.end());
 
-		poly.numEdges = poly.edges.size();
-		poly.plane = face.plane3();
-		poly.min = faceAABB.origin - faceAABB.extents;
-		poly.max = faceAABB.origin + faceAABB.extents;
-		//poly.shader = face.GetShader();
-		poly.shader = game::current::getValue<std::string>(GKEY_COLLISION_SHADER);
+	if (!removeMatchingPolygon(key)) {
+		poly.face = &face;
 
-		_polygons.push_back(poly);
+		_polygonIndices[key] = _polygons.insert(_polygons.end(), poly);
 	}
 }
 
@@ -239,31 +259,16 @@ VertexList CollisionModel::addWinding(
 }
 
 void CollisionModel::addBrush(Brush& brush) {
-	BrushStruc b;
-
-	// The number of faces
-	b.numFaces = brush.getNumFaces();
-
-	// Get the AABB of this brush
-	AABB brushAABB = brush.localAABB();
-
-	b.min = brushAABB.origin - brushAABB.extents;
-	b.max = brushAABB.origin + brushAABB.extents;
-
-	// Populate the FaceList
+	// Parse the windings of the faces for vertices/edges
 	for (Brush::const_iterator i = brush.begin(); i != brush.end(); i++) {
-		// Store the plane into the brush
-		b.planes.push_back((*i)->plane3());
-
-		// Parse the winding of this Face for vertices/edges
 		VertexList vertexList = addWinding((*i)->getWinding());
 
 		// Pass the Face& and the VertexList to create the polygon
 		addPolygon(*(*i), vertexList);
 	}
 
-	// Store the BrushStruc into the list
-	_brushes.push_back(b);
+	// Planes and bounds are written from the brush itself
+	_brushes.push_back(&brush);
 }
 
 void CollisionModel::setModel(const std::string& model) {
@@ -274,39 +279,34 @@ std::size_t CollisionModel::getBrushMemory(const BrushList& brushes) {
 	std::size_t faceCount = 0;
 	// Count the faces
 	for (std::size_t b = 0; b < brushes.size(); b++) {
-		faceCount += brushes[b].numFaces;
+		faceCount += brushes[b]->getNumFaces();
 	}
 	return faceCount*SIZEOF_FACE + brushes.size()*SIZEOF_BRUSH;
 }
 
-// The friend stream insertion operator
-std::ostream& operator<<(std::ostream& st, const CollisionModel& cm) {
+void CollisionModel::write(std::ostream& st) const {
 	// Write the header
 	st << "CM \"1.00\"\n\n0\n\n";
 
-	st << "collisionModel \"" << cm._model.c_str() << "\" {\n";
+	st << "collisionModel \"" << _model << "\" {\n";
 
 	// Export the vertices
-	st << "\tvertices { /* numVertices = */ " << cm._vertices.size() << "\n";
-	for (VertexMap::const_iterator i = cm._vertices.begin();
-		 i != cm._vertices.end();
-		 i++)
+	st << "\tvertices { /* numVertices = */ " << _vertices.size() << "\n";
+	for (const auto& pair : _vertices)
 	{
-		st << "\t/* " << i->first << " */ ";
-		writeVector(st, i->second);
+		st << "\t/* " << pair.first << " */ ";
+		writeVector(st, pair.second);
 		st << "\n";
 	}
 	st << "\t}\n";
 
 	// Export the edges
-	st << "\tedges { /* numEdges = */ " << cm._edges.size() << "\n";
-	for (EdgeMap::const_iterator i = cm._edges.begin();
-		 i != cm._edges.end();
-		 ++i)
+	st << "\tedges { /* numEdges = */ " << _edges.size() << "\n";
+	for (const auto& pair : _edges)
 	{
-		st << "\t/* " << i->first << " */ ";
-		st << "( " << i->second.from << " " << i->second.to << " ) ";
-		st << "0 " << i->second.numVertices << "\n";
+		st << "\t/* " << pair.first << " */ ";
+		st << "( " << pair.second.from << " " << pair.second.to << " ) ";
+		st << "0 " << pair.second.numVertices << "\n";
 	}
 	st << "\t}\n";
 
@@ -315,25 +315,36 @@ std::ostream& operator<<(std::ostream& st, const CollisionModel& cm) {
 	st << "\t( -1 0 )\n";
 	st << "\t}\n";
 
-	// Export the polygons
+	// Export the polygons, they all share the collision shader
+	std::string shader = game::current::getValue<std::string>(GKEY_COLLISION_SHADER);
+
 	st << "\tpolygons {\n";
-	for (std::size_t i = 0; i < cm._polygons.size(); i++) {
-		st << "\t" << cm._polygons[i] << "\n";
+	for (const Polygon& polygon : _polygons) {
+		st << "\t";
+		writePolygon(st, polygon, shader);
+		st << "\n";
 	}
 	st << "\t}\n";
 
 	// Export the brushes, the header first
 	st << "\tbrushes /* brushMemory = */ ";
-	st << CollisionModel::getBrushMemory(cm._brushes);
+	st << getBrushMemory(_brushes);
 	st << " {\n";
 
 	// Now cycle through all the brushes
-	for (std::size_t i = 0; i < cm._brushes.size(); i++) {
-		st << "\t" << cm._brushes[i] << "\n";
+	for (const Brush* brush : _brushes) {
+		st << "\t";
+		writeBrush(st, *brush);
+		st << "\n";
 	}
 	st << "\t}\n";
 
 	st << "}\n"; // end CollisionModel
+}
+
+// The friend stream insertion operator
+std::ostream& operator<<(std::ostream& st, const CollisionModel& cm) {
+	cm.write(st);
 	return st;
 }
 
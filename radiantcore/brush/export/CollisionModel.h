@@ -2,6 +2,9 @@
 
 #include "Geometry.h"
 #include <memory>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
 
 class Winding;
 class Brush;
@@ -17,11 +20,25 @@ class CollisionModel
 	PolygonList _polygons;
 	BrushList _brushes;
 
+	// The unsnapped positions of the vertices, these are compared
+	// when welding vertices
+	std::vector<Vector3> _weldPositions;
+
+	// Lookups to find existing vertices, edges and polygons without
+	// scanning the containers above. Vertices are sorted into grid
+	// cells of the welding tolerance's size.
+	std::unordered_map<VertexCell, std::vector<std::size_t>, VertexCellHash> _vertexCells;
+	std::unordered_map<EdgeKey, std::size_t, EdgeKeyHash> _edgeIndices;
+	std::unordered_map<EdgeList, PolygonList::iterator, PolygonKeyHash> _polygonIndices;
+
 	std::string _model;
 
 public:
 	CollisionModel();
 
+	/** Adds the geometry of the given brush. The brush is referenced
+	 * until the model has been written, see write().
+	 */
 	void addBrush(Brush& brush);
 
 	/** greebo: Stream insertion operator, use this to write
@@ -30,6 +47,12 @@ public:
 	 */
 	friend std::ostream& operator<<(std::ostream& st, const CollisionModel& cm);
 
+	/** Writes the collision model to the given stream, section by section.
+	 * Planes and bounds are read from the added brushes on the fly, so these
+	 * must not be modified or destroyed before the model has been written.
+	 */
+	void write(std::ostream& stream) const;
+
 	/** greebo: Sets the model path this CM is associated with
 	 */
 	void setModel(const std::string& model);
@@ -48,7 +71,10 @@ private:
 	 */
 	std::size_t addVertex(const Vector3& vertex);
 
-	/** greebo: Tries to lookup the index of the given vertex.
+	/** Tries to lookup the index of a vertex close to the given one.
+	 * Vertices are welded if none of their coordinates differ by more
+	 * than the welding tolerance. If several vertices qualify, the one
+	 * with the lowest index is returned.
 	 *
 	 * @returns: the index of the vertex or -1 if not found
 	 */
@@ -78,15 +104,17 @@ private:
 	 */
 	int findEdge(const Edge& edge) const;
 
-	/** greebo: Tries to lookup the index of the matching polygon.
-	 * 			All the Edge indices are compared regardless of
-	 * 			their order.
+	/** greebo: Tries to lookup the matching polygon. All the Edge
+	 * 			indices are compared regardless of their order and
+	 * 			direction. A matching polygon is removed, since the two
+	 * 			faces are touching each other and cancel each other out.
 	 *
-	 * @returns: the index of the polygon or -1 if not found
+	 * @returns: true if a matching polygon was found (and removed)
 	 */
-	int findPolygon(const EdgeList& otherEdges);
+	bool removeMatchingPolygon(const EdgeList& otherEdges);
 
 	/** greebo: Adds a polygon basing on the given face & vertexlist.
+	 * 			The face is referenced until the model has been written.
 	 * 			Be sure to add the first vertex a second time
 	 * 			to the end of the pass a "closed" winding.
 	 * 			Duplicate polygons are not added.
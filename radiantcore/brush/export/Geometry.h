@@ -2,9 +2,13 @@
 #define CM_GEOMETRY_H_
 
 #include <map>
+#include <list>
 #include <vector>
+#include <functional>
 #include "math/Vector3.h"
-#include "math/Plane3.h"
+
+class Brush;
+class Face;
 
 /** greebo: This contains all the geometry subtypes of a Doom3 CollisionModel.
  **/
@@ -17,6 +21,30 @@ typedef std::vector<std::size_t> VertexList;
 // The indexed vertices of the collisionmodel
 typedef std::map<std::size_t, Vector3> VertexMap;
 
+// The integer coordinates of a cell in the grid used to find welded vertices
+struct VertexCell
+{
+	long long x;
+	long long y;
+	long long z;
+
+	bool operator==(const VertexCell& other) const
+	{
+		return x == other.x && y == other.y && z == other.z;
+	}
+};
+
+struct VertexCellHash
+{
+	std::size_t operator()(const VertexCell& cell) const
+	{
+		std::hash<long long> hasher;
+		std::size_t hash = hasher(cell.x);
+		hash = hash * 31 + hasher(cell.y);
+		return hash * 31 + hasher(cell.z);
+	}
+};
+
 struct Edge {
 	std::size_t from;	// The starting vertex index
 	std::size_t to;	// The end vertex index
@@ -34,39 +62,48 @@ typedef std::map<std::size_t, Edge> EdgeMap;
 // A vector of Edges defining a polygon (the sign indicates the direction)
 typedef std::vector<int> EdgeList;
 
-struct Polygon {
-	// The number of edges of this polygon
-	std::size_t numEdges;
+// The two vertex indices of an edge, the smaller one first
+typedef std::pair<std::size_t, std::size_t> EdgeKey;
 
-	// The indices of the edges forming this polygon
-	EdgeList edges;
+struct EdgeKeyHash
+{
+	std::size_t operator()(const EdgeKey& key) const
+	{
+		return key.first * 2654435761u ^ key.second;
+	}
+};
 
-	// The plane (normal + distance)
-	Plane3 plane;
+// The sorted, unsigned edge indices of a polygon
+struct PolygonKeyHash
+{
+	std::size_t operator()(const EdgeList& edges) const
+	{
+		std::size_t hash = edges.size();
 
-	// Two vertices defining the AABB
-	Vector3 min;
-	Vector3 max;
+		for (int edge : edges)
+		{
+			hash = hash * 31 + static_cast<std::size_t>(edge);
+		}
 
-	// The shadername (this is textures/common/collision for
-	// proper Doom3 hulls, but it can be different as well).
-	std::string shader;
+		return hash;
+	}
 };
 
-// The unsorted list of Polygons
-typedef std::vector<Polygon> PolygonList;
-
-typedef std::vector<Plane3> PlaneList;
+struct Polygon {
+	// The indices of the edges forming this polygon
+	EdgeList edges;
 
-struct BrushStruc {
-	std::size_t numFaces;
-	PlaneList planes;
-	// Two points defining the AABB
-	Vector3 min;
-	Vector3 max;
+	// The face this polygon has been created from. Plane and bounds
+	// are read from it when the collision model is written.
+	const Face* face;
 };
 
-typedef std::vector<BrushStruc> BrushList;
+// The unsorted list of Polygons (a list, since duplicates are removed while adding)
+typedef std::list<Polygon> PolygonList;
+
+// The brushes of the collisionmodel, their planes and bounds are
+// read when the collision model is written
+typedef std::vector<const Brush*> BrushList;
 
 } // namespace cmutil
 
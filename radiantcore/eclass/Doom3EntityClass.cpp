@@ -610,4 +610,26 @@ void Doom3EntityClass::parseFromTokens(parser::DefTokeniser& tokeniser)
     _changedSignal.emit();
 }
 
+void Doom3EntityClass::takeContentsFrom(Doom3EntityClass& other)
+{
+    _fileInfo = other._fileInfo;
+    _parent = nullptr;
+    _isLight = other._isLight;
+    _colour = other._colour;
+    _colourTransparent = other._colourTransparent;
+    _fillShader = other._fillShader;
+    _wireShader = other._wireShader;
+    _fixedSize = other._fixedSize;
+    _attributes.swap(other._attributes);
+    _model = other._model;
+    _skin = other._skin;
+    _inheritanceResolved = false;
+    _modName = other._modName;
+    _attachments.swap(other._attachments);
+    _parseStamp = other._parseStamp;
+
+    // Notify the observers
+    _changedSignal.emit();
+}
+
 } // namespace eclass
@@ -215,6 +215,14 @@ public:
     // Initialises this class from the given tokens
     void parseFromTokens(parser::DefTokeniser& tokeniser);
 
+    /**
+     * Takes over the parsed contents of the given class, which has the same
+     * name but has been parsed separately (e.g. by a worker thread). This
+     * object's identity and its observers are kept, the inheritance needs
+     * to be resolved again afterwards.
+     */
+    void takeContentsFrom(Doom3EntityClass& other);
+
     void setParseStamp(std::size_t parseStamp)
     {
         _parseStamp = parseStamp;
@@ -13,7 +13,11 @@
 #include "Doom3ModelDef.h"
 
 #include "string/case_conv.h"
+#include "ParallelForEach.h"
 #include <functional>
+#include <chrono>
+#include <iterator>
+#include <sstream>
 
 #include "debugging/ScopedDebugTimer.h"
 #include "module/StaticModule.h"
@@ -129,13 +133,242 @@ void EClassManager::parseDefFiles()
 	// Increase the parse stamp for this run
 	_curParseStamp++;
 
-	{
-		ScopedDebugTimer timer("EntityDefs parsed: ");
-        GlobalFileSystem().forEachFile(
-            "def/", "def",
-            [&](const vfs::FileInfo& fileInfo) { parseFile(fileInfo); }
-        );
-	}
+	auto startTime = std::chrono::steady_clock::now();
+
+    // Collect the files first, the enumeration order defines the merge order
+    std::vector<ParsedDefFile> files;
+
+    GlobalFileSystem().forEachFile(
+        "def/", "def",
+        [&](const vfs::FileInfo& fileInfo)
+        {
+            files.emplace_back();
+            files.back().fileInfo = fileInfo;
+
+            auto existing = _defFiles.find(fileInfo.fullPath());
+
+            if (existing != _defFiles.end())
+            {
+                files.back().previous = &existing->second;
+            }
+        }
+    );
+
+    // Files which have been parsed before, but are not present anymore
+    std::set<std::string> removedFiles;
+
+    for (const auto& pair : _defFiles)
+    {
+        removedFiles.insert(pair.first);
+    }
+
+    for (const auto& file : files)
+    {
+        removedFiles.erase(file.fileInfo.fullPath());
+    }
+
+    // Parse all new or modified files
+    util::parallelForEach(files.size(), [&](std::size_t i) { parseFile(files[i]); });
+
+    std::set<std::string> affectedFiles = removedFiles;
+    bool filesSkipped = false;
+
+    for (const auto& file : files)
+    {
+        if (file.parsed)
+        {
+            affectedFiles.insert(file.fileInfo.fullPath());
+        }
+        else
+        {
+            filesSkipped = true;
+        }
+    }
+
+    // Unchanged files referring to changed definitions need to be parsed again,
+    // their classes have been resolved against the previous contents
+    if (filesSkipped)
+    {
+        addDependentFiles(affectedFiles, files);
+
+        std::vector<std::size_t> dependentFiles;
+
+        for (std::size_t i = 0; i < files.size(); ++i)
+        {
+            if (!files[i].parsed && affectedFiles.count(files[i].fileInfo.fullPath()) > 0)
+            {
+                files[i].previous = nullptr;
+                dependentFiles.push_back(i);
+            }
+        }
+
+        util::parallelForEach(dependentFiles.size(), [&](std::size_t i) { parseFile(files[dependentFiles[i]]); });
+    }
+
+    // Merge the results in a deterministic order, later definitions replace earlier ones
+    std::size_t numParsedFiles = 0;
+
+    for (auto& file : files)
+    {
+        if (!file.parsed) continue;
+
+        mergeParsedFile(file);
+        ++numParsedFiles;
+    }
+
+    // Forget about removed files
+    for (const auto& path : removedFiles)
+    {
+        _defFiles.erase(path);
+    }
+
+    auto totalTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime);
+
+    rMessage() << "[eclassmgr] Parsed " << numParsedFiles << " of " << files.size() << " def files in "
+        << totalTime.count() << " msec, " << (files.size() - numParsedFiles) << " unchanged" << std::endl;
+}
+
+void EClassManager::addDependentFiles(std::set<std::string>& affectedFiles, const std::vector<ParsedDefFile>& parsedFiles)
+{
+    std::set<std::string> entityDefs;
+    std::set<std::string> modelDefs;
+
+    // Collect the previous and the current definitions of the given files
+    auto collectDefinitions = [&](const std::string& path)
+    {
+        auto record = _defFiles.find(path);
+
+        if (record != _defFiles.end())
+        {
+            entityDefs.insert(record->second.entityDefs.begin(), record->second.entityDefs.end());
+            modelDefs.insert(record->second.modelDefs.begin(), record->second.modelDefs.end());
+        }
+
+        for (const auto& file : parsedFiles)
+        {
+            if (file.fileInfo.fullPath() != path) continue;
+
+            for (const auto& eclass : file.entityDefs)
+            {
+                entityDefs.insert(eclass->getName());
+            }
+
+            for (const auto& model : file.modelDefs)
+            {
+                modelDefs.insert(model->name);
+            }
+        }
+    };
+
+    for (const auto& path : affectedFiles)
+    {
+        collectDefinitions(path);
+    }
+
+    // Walk the dependencies until no more files are added
+    bool filesAdded = true;
+
+    while (filesAdded)
+    {
+        filesAdded = false;
+
+        for (const auto& pair : _defFiles)
+        {
+            if (affectedFiles.count(pair.first) > 0) continue;
+
+            bool isAffected = false;
+
+            for (const auto& name : pair.second.entityDefs)
+            {
+                auto eclass = _entityClasses.find(name);
+
+                if (entityDefs.count(name) > 0 || (eclass != _entityClasses.end() &&
+                    (entityDefs.count(eclass->second->getAttribute("inherit").getValue()) > 0 ||
+                     modelDefs.count(eclass->second->getAttribute("model").getValue()) > 0)))
+                {
+                    isAffected = true;
+                    break;
+                }
+            }
+
+            for (const auto& name : pair.second.modelDefs)
+            {
+                auto model = _models.find(name);
+
+                if (modelDefs.count(name) > 0 || (model != _models.end() && modelDefs.count(model->second->parent) > 0))
+                {
+                    isAffected = true;
+                    break;
+                }
+            }
+
+            if (isAffected)
+            {
+                affectedFiles.insert(pair.first);
+                collectDefinitions(pair.first);
+                filesAdded = true;
+            }
+        }
+    }
+}
+
+void EClassManager::mergeParsedFile(ParsedDefFile& file)
+{
+    auto& record = _defFiles[file.fileInfo.fullPath()];
+
+    record.contentHash = file.contentHash;
+    record.entityDefs.clear();
+    record.modelDefs.clear();
+
+    for (const auto& eclass : file.entityDefs)
+    {
+        record.entityDefs.push_back(eclass->getName());
+
+        auto i = _entityClasses.find(eclass->getName());
+
+        if (i == _entityClasses.end())
+        {
+            eclass->setParseStamp(_curParseStamp);
+            _entityClasses.emplace(eclass->getName(), eclass);
+            continue;
+        }
+
+        // EntityDef already exists, compare the parse stamp
+        if (i->second->getParseStamp() == _curParseStamp)
+        {
+            rWarning() << "[eclassmgr]: EntityDef "
+                << eclass->getName() << " redefined" << std::endl;
+        }
+
+        // Keep the existing object, any IEntityClassPtrs remain intact
+        eclass->setParseStamp(_curParseStamp);
+        i->second->takeContentsFrom(*eclass);
+    }
+
+    for (const auto& model : file.modelDefs)
+    {
+        record.modelDefs.push_back(model->name);
+
+        model->setParseStamp(_curParseStamp);
+
+        auto i = _models.find(model->name);
+
+        if (i == _models.end())
+        {
+            _models.emplace(model->name, model);
+            continue;
+        }
+
+        // Model already exists, compare the parse stamp
+        if (i->second->getParseStamp() == _curParseStamp)
+        {
+            rWarning() << "[eclassmgr]: Model "
+                << model->name << " redefined" << std::endl;
+        }
+
+        *i->second = *model;
+    }
 }
 
 void EClassManager::resolveInheritance()
@@ -153,6 +386,12 @@ void EClassManager::resolveInheritance()
 	{
 		// Tell the class to resolve its own inheritance using the given
 		// map as a source for parent lookup
+        // Classes which haven't been parsed in this run are already resolved
+        if (pair.second->getParseStamp() != _curParseStamp)
+        {
+            continue;
+        }
+
         pair.second->resolveInheritance(_entityClasses);
 
         // If the entity has a model path ("model" key), lookup the actual
@@ -252,11 +491,13 @@ void EClassManager::forEachModelDef(ModelDefVisitor& visitor)
 void EClassManager::reloadDefs()
 {
 	// greebo: Leave all current entityclasses as they are, just invoke the
-	// FileLoader again. It will parse the files again, and look up
+	// FileLoader again. It will parse the modified files again, and look up
 	// the eclass names in the existing map. If found, the eclass
-	// will be asked to clear itself and re-parse from the tokens.
+	// will take over the contents of the freshly parsed one.
 	// This is to assure that any IEntityClassPtrs remain intact during
-	// the process, only the class contents change.
+	// the process, only the class contents change. Unmodified files (and
+	// the classes in them) are left alone, unless they depend on a
+	// definition which has been changed.
 	parseDefFiles();
 
 	// Resolve the eclass inheritance again
@@ -289,8 +530,18 @@ void EClassManager::initialiseModule(const IApplicationContext& ctx)
 {
 	rMessage() << "EntityClassDoom3::initialiseModule called." << std::endl;
 
-	GlobalFileSystem().addObserver(*this);
 	realise();
+}
+
+bool EClassManager::allowsConcurrentInitialisation() const
+{
+	// realise() is just starting the def loader
+	return true;
+}
+
+void EClassManager::finishModuleInitialisation(const IApplicationContext& ctx)
+{
+	GlobalFileSystem().addObserver(*this);
 
 	GlobalCommandSystem().addCommand("ReloadDefs", std::bind(&EClassManager::reloadDefsCmd, this, std::placeholders::_1));
 }
@@ -310,6 +561,7 @@ void EClassManager::shutdownModule()
 	// Clear member structures
 	_entityClasses.clear();
 	_models.clear();
+	_defFiles.clear();
 }
 
 // This takes care of relading the entityDefs and refreshing the scenegraph
@@ -334,11 +586,10 @@ void EClassManager::onFileSystemShutdown()
 
 // Parse the provided stream containing the contents of a single .def file.
 // Extract all entitydefs and create objects accordingly.
-void EClassManager::parse(TextInputStream& inStr, const vfs::FileInfo& fileInfo, const std::string& modDir)
+void EClassManager::parse(std::istream& stream, ParsedDefFile& file)
 {
 	// Construct a tokeniser for the stream
-	std::istream is(&inStr);
-    parser::BasicDefTokeniser<std::istream> tokeniser(is);
+    parser::BasicDefTokeniser<std::istream> tokeniser(stream);
 
     while (tokeniser.hasMoreTokens())
 	{
@@ -351,93 +602,62 @@ void EClassManager::parse(TextInputStream& inStr, const vfs::FileInfo& fileInfo,
 			const std::string sName =
     			string::to_lower_copy(tokeniser.nextToken());
 
-			// Ensure that an Entity class with this name already exists
-			// When reloading entityDef declarations, most names will already be registered
-			auto i = _entityClasses.find(sName);
-
-			if (i == _entityClasses.end())
-			{
-				// Not existing yet, allocate a new class
-				auto result = _entityClasses.emplace(sName, std::make_shared<Doom3EntityClass>(sName, fileInfo));
-
-				i = result.first;
-			}
-			else
-			{
-				// EntityDef already exists, compare the parse stamp
-				if (i->second->getParseStamp() == _curParseStamp)
-				{
-					rWarning() << "[eclassmgr]: EntityDef "
-						<< sName << " redefined" << std::endl;
-				}
-			}
-
-			// At this point, i is pointing to a valid entityclass
-
-			i->second->setParseStamp(_curParseStamp);
+			// Always allocate a new class, it's merged into the existing one later on
+			auto eclass = std::make_shared<Doom3EntityClass>(sName, file.fileInfo);
+			file.entityDefs.push_back(eclass);
 
         	// Parse the contents of the eclass (excluding name)
-			i->second->parseFromTokens(tokeniser);
+			eclass->parseFromTokens(tokeniser);
 
 			// Set the mod directory
-        	i->second->setModName(modDir);
+        	eclass->setModName(file.modName);
         }
         else if (blockType == "model")
 		{
 			// Read the name
 			std::string modelDefName = tokeniser.nextToken();
 
-			// Ensure that an Entity class with this name already exists
-			// When reloading entityDef declarations, most names will already be registered
-			Models::iterator i = _models.find(modelDefName);
+			// Allocate an empty ModelDef
+			auto model = std::make_shared<Doom3ModelDef>(modelDefName);
+			file.modelDefs.push_back(model);
 
-			if (i == _models.end())
-			{
-				// Does not exist yet, allocate a new one
+        	model->parseFromTokens(tokeniser);
+			model->setModName(file.modName);
+        }
+    }
+}
 
-				// Allocate an empty ModelDef
-        		Doom3ModelDefPtr model(new Doom3ModelDef(modelDefName));
+void EClassManager::parseFile(ParsedDefFile& file)
+{
+	auto textFile = GlobalFileSystem().openTextFile(file.fileInfo.fullPath());
 
-				std::pair<Models::iterator, bool> result = _models.insert(
-					Models::value_type(modelDefName, model)
-				);
+	if (!textFile) return;
 
-				i = result.first;
-			}
-			else
-			{
-				// Model already exists, compare the parse stamp
-				if (i->second->getParseStamp() == _curParseStamp)
-				{
-					rWarning() << "[eclassmgr]: Model "
-						<< modelDefName << " redefined" << std::endl;
-				}
-			}
+	std::istream stream(&textFile->getInputStream());
+	std::string contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
 
-			// Model structure is allocated and in the map,
-            // invoke the parser routine
-			i->second->setParseStamp(_curParseStamp);
+	file.modName = textFile->getModName();
+	file.contentHash = std::hash<std::string>()(contents);
 
-        	i->second->parseFromTokens(tokeniser);
-			i->second->setModName(modDir);
-        }
-    }
-}
+	// Don't parse the file again if its contents are the same as before
+	if (file.previous != nullptr && file.previous->contentHash == file.contentHash)
+	{
+		return;
+	}
 
-void EClassManager::parseFile(const vfs::FileInfo& fileInfo)
-{
-	auto file = GlobalFileSystem().openTextFile(fileInfo.fullPath());
+	file.parsed = true;
 
-	if (!file) return;
+	ScopedDebugTimer timer("Parsed " + file.fileInfo.fullPath());
 
 	try
     {
 		// Parse entity defs from the file
-		parse(file->getInputStream(), fileInfo, file->getModName());
+		std::istringstream contentStream(contents);
+		parse(contentStream, file);
 	}
     catch (parser::ParseException& e)
     {
-		rError() << "[eclassmgr] failed to parse " << fileInfo.fullPath()
+		rError() << "[eclassmgr] failed to parse " << file.fileInfo.fullPath()
 				 << " (" << e.what() << ")" << std::endl;
 	}
 }
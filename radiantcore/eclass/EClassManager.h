@@ -6,6 +6,9 @@
 #include "itextstream.h"
 #include "ThreadedDefLoader.h"
 
+#include <set>
+#include <vector>
+
 #include "Doom3EntityClass.h"
 #include "Doom3ModelDef.h"
 
@@ -48,6 +51,35 @@ class EClassManager :
 	// definitions have been parsed
 	std::size_t _curParseStamp;
 
+    // Bookkeeping of each parsed .def file, used to skip
+    // unchanged files when reloading the definitions
+    struct DefFileRecord
+    {
+        std::size_t contentHash = 0;
+        std::vector<std::string> entityDefs;
+        std::vector<std::string> modelDefs;
+    };
+
+    // Records by mod-relative file path
+    std::map<std::string, DefFileRecord> _defFiles;
+
+    // The result of parsing a single .def file, produced by a worker thread
+    struct ParsedDefFile
+    {
+        vfs::FileInfo fileInfo;
+        std::string modName;
+        std::size_t contentHash = 0;
+
+        // The previous record of this file, if the file is allowed to be skipped
+        const DefFileRecord* previous = nullptr;
+
+        // False if the file couldn't be opened or has not been changed
+        bool parsed = false;
+
+        std::vector<Doom3EntityClassPtr> entityDefs;
+        std::vector<Doom3ModelDefPtr> modelDefs;
+    };
+
     sigc::signal<void> _defsLoadedSignal;
     sigc::signal<void> _defsReloadedSignal;
 
@@ -80,11 +112,14 @@ public:
 	const std::string& getName() const override;
     const StringSet& getDependencies() const override;
     void initialiseModule(const IApplicationContext& ctx) override;
+    bool allowsConcurrentInitialisation() const override;
+    void finishModuleInitialisation(const IApplicationContext& ctx) override;
     void shutdownModule() override;
 
 private:
-	// Method loading the DEF files
-    void parseFile(const vfs::FileInfo& fileInfo);
+    // Reads and parses a single .def file into new, unconnected definitions,
+    // this is thread-safe and runs on the worker threads
+    static void parseFile(ParsedDefFile& file);
 
     // Since loading is happening in a worker thread, we need to ensure
     // that it's done loading before accessing any defs or models.
@@ -99,7 +134,14 @@ private:
     Doom3EntityClassPtr findInternal(const std::string& name);
 
 	// Parses the given inputstream for DEFs.
-	void parse(TextInputStream& inStr, const vfs::FileInfo& fileInfo, const std::string& modDir);
+	static void parse(std::istream& stream, ParsedDefFile& file);
+
+    // Moves the definitions of the given file into the class and model maps
+    void mergeParsedFile(ParsedDefFile& file);
+
+    // Extends the given set of changed files by all unchanged files whose
+    // definitions depend on (or redefine) any of the definitions in those files
+    void addDependentFiles(std::set<std::string>& affectedFiles, const std::vector<ParsedDefFile>& parsedFiles);
 
 	// Recursively resolves the inheritance of the model defs
 	void resolveModelInheritance(const std::string& name, const Doom3ModelDefPtr& model);
@@ -60,6 +60,12 @@ void FontManager::initialiseModule(const IApplicationContext& ctx)
     _loader.start();
 }
 
+bool FontManager::allowsConcurrentInitialisation() const
+{
+    // Only the font loader is started, it doesn't touch other modules
+    return true;
+}
+
 void FontManager::shutdownModule()
 {
     _loader.reset();
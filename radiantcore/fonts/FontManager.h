@@ -30,6 +30,7 @@ public:
     const std::string& getName() const override;
     const StringSet& getDependencies() const override;
     void initialiseModule(const IApplicationContext& ctx) override;
+    bool allowsConcurrentInitialisation() const override;
     void shutdownModule() override;
 
 	// Returns the info structure of a specific font (current language),
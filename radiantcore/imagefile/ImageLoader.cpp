@@ -90,6 +90,26 @@ ImagePtr ImageLoader::imageFromVFS(const std::string& name) const
 	return ImagePtr();
 }
 
+std::string ImageLoader::findImageFile(const std::string& name) const
+{
+    for (const auto& extension : _extensions)
+    {
+        auto loaderIter = _loadersByExtension.find(extension);
+
+        if (loaderIter == _loadersByExtension.end()) continue;
+
+        // Same naming rules as in imageFromVFS
+        std::string fullName = loaderIter->second->getPrefix() + name + "." + extension;
+
+        if (GlobalFileSystem().getFileCount(fullName) > 0)
+        {
+            return fullName;
+        }
+    }
+
+    return std::string();
+}
+
 ImagePtr ImageLoader::imageFromFile(const std::string& filename) const
 {
     ImagePtr image;
@@ -15,6 +15,7 @@
 #include "LayerInfoFileModule.h"
 
 #include <functional>
+#include <queue>
 
 namespace scene
 {
@@ -23,6 +24,25 @@ namespace
 {
 	const char* const DEFAULT_LAYER_NAME = N_("Default");
 	const int DEFAULT_LAYER = 0;
+
+	// Checks whether any direct child of a node is not hidden by layers
+	class VisibleChildFinder :
+		public NodeVisitor
+	{
+	public:
+		bool found = false;
+
+		bool pre(const INodePtr& node) override
+		{
+			if (!node->checkStateFlag(Node::eLayered))
+			{
+				found = true;
+			}
+
+			// Don't descend, a shown grandchild implies a shown child
+			return false;
+		}
+	};
 }
 
 LayerManager::LayerManager() :
@@ -51,14 +71,8 @@ int LayerManager::createLayer(const std::string& name, int layerID)
 		return -1;
 	}
 
-	// Update the visibility cache, so get the highest ID
-	int highestID = getHighestLayerID();
-
-	// Make sure the vector has allocated enough memory
-	_layerVisibility.resize(highestID+1);
-
 	// Set the newly created layer to "visible"
-	_layerVisibility[result.first->first] = true;
+	_visibleLayers.insert(result.first->first);
 
 	// Layers have changed
 	onLayersChanged();
@@ -105,7 +119,7 @@ void LayerManager::deleteLayer(const std::string& name)
 	_layers.erase(layerID);
 
 	// Reset the visibility flag to TRUE
-	_layerVisibility[layerID] = true;
+	_visibleLayers.insert(layerID);
 
 	if (layerID == _activeLayer)
 	{
@@ -136,8 +150,8 @@ void LayerManager::reset()
 	_layers.clear();
 	_layers.insert(LayerMap::value_type(DEFAULT_LAYER, _(DEFAULT_LAYER_NAME)));
 
-	_layerVisibility.resize(1);
-	_layerVisibility[DEFAULT_LAYER] = true;
+	_visibleLayers.clear();
+	_visibleLayers.insert(DEFAULT_LAYER);
 
 	// Update the LayerControlDialog
 	_layersChangedSignal.emit();
@@ -171,7 +185,7 @@ int LayerManager::getFirstVisibleLayer() const
 	// Iterate over all IDs and check the visibility status, return the first visible
 	for (LayerMap::const_iterator i = _layers.begin(); i != _layers.end(); ++i)
 	{
-		if (_layerVisibility[i->first])
+		if (_visibleLayers.contains(i->first))
 		{
 			return i->first;
 		}
@@ -210,23 +224,23 @@ bool LayerManager::layerIsVisible(const std::string& layerName)
 		return false;
 	}
 
-	return _layerVisibility[layerID];
+	return _visibleLayers.contains(layerID);
 }
 
 bool LayerManager::layerIsVisible(int layerID) {
 	// Sanity check
-	if (layerID < 0 || layerID >= static_cast<int>(_layerVisibility.size())) {
+	if (layerID < 0 || layerID > getHighestLayerID()) {
 		rMessage() << "LayerSystem: Querying invalid layer ID: " << layerID << std::endl;
 		return false;
 	}
 
-	return _layerVisibility[layerID];
+	return _visibleLayers.contains(layerID);
 }
 
 void LayerManager::setLayerVisibility(int layerID, bool visible)
 {
 	// Sanity check
-	if (layerID < 0 || layerID >= static_cast<int>(_layerVisibility.size()))
+	if (layerID < 0 || layerID > getHighestLayerID())
 	{
 		rMessage() <<
 			"LayerSystem: Setting visibility of invalid layer ID: " <<
@@ -235,7 +249,14 @@ void LayerManager::setLayerVisibility(int layerID, bool visible)
 	}
 
 	// Set the visibility
-	_layerVisibility[layerID] = visible;
+	if (visible)
+	{
+		_visibleLayers.insert(layerID);
+	}
+	else
+	{
+		_visibleLayers.erase(layerID);
+	}
 
 	if (!visible && layerID == _activeLayer)
 	{
@@ -245,14 +266,13 @@ void LayerManager::setLayerVisibility(int layerID, bool visible)
     
     // If the active layer is hidden (which can occur after "hide all")
     // re-set the active layer to this one as it has been made visible
-    if (visible && _activeLayer < static_cast<int>(_layerVisibility.size()) && 
-        !_layerVisibility[_activeLayer])
+    if (visible && !_visibleLayers.contains(_activeLayer))
     {
         _activeLayer = layerID;
     }
 
 	// Fire the visibility changed event
-	onLayerVisibilityChanged();
+	onLayerVisibilityChanged(layerID);
 }
 
 void LayerManager::setLayerVisibility(const std::string& layerName, bool visible) 
@@ -279,6 +299,76 @@ void LayerManager::updateSceneGraphVisibility()
 	SceneChangeNotify();
 }
 
+void LayerManager::updateLayerMemberVisibility(int layerID)
+{
+	// Nodes are processed bottom-up, deepest first, such that each parent
+	// gets to see the updated state of its children
+	typedef std::pair<std::size_t, INode*> DepthAndNode;
+	std::priority_queue<DepthAndNode> pending;
+	std::unordered_set<INode*> queued;
+
+	auto members = _layerMembers.find(layerID);
+
+	if (members != _layerMembers.end())
+	{
+		for (INode* node : members->second)
+		{
+			std::size_t depth = 0;
+
+			for (auto parent = node->getParent(); parent; parent = parent->getParent())
+			{
+				++depth;
+			}
+
+			pending.push(DepthAndNode(depth, node));
+			queued.insert(node);
+		}
+	}
+
+	while (!pending.empty())
+	{
+		std::size_t depth = pending.top().first;
+		INodePtr node = pending.top().second->getSelf();
+		pending.pop();
+
+		bool wasHidden = node->checkStateFlag(Node::eLayered);
+
+		// Same rules as the UpdateNodeVisibilityWalker: a node is shown if one
+		// of its own layers is visible or if any of its children is shown
+		if (!updateNodeVisibility(node))
+		{
+			VisibleChildFinder finder;
+			node->traverseChildren(finder);
+
+			if (finder.found)
+			{
+				node->disable(Node::eLayered);
+			}
+		}
+
+		bool isHidden = node->checkStateFlag(Node::eLayered);
+
+		if (isHidden)
+		{
+			// Node is hidden by layers after update, de-select
+			Node_setSelected(node, false);
+		}
+
+		if (isHidden == wasHidden) continue;
+
+		// The parent might need to follow this node's state
+		auto parent = node->getParent();
+
+		if (parent && !parent->isRoot() && queued.insert(parent.get()).second)
+		{
+			pending.push(DepthAndNode(depth - 1, parent.get()));
+		}
+	}
+
+	// Redraw
+	SceneChangeNotify();
+}
+
 void LayerManager::onLayersChanged()
 {
 	_layersChangedSignal.emit();
@@ -291,10 +381,10 @@ void LayerManager::onNodeMembershipChanged()
 	updateSceneGraphVisibility();
 }
 
-void LayerManager::onLayerVisibilityChanged()
+void LayerManager::onLayerVisibilityChanged(int layerID)
 {
-	// Update all nodes and views
-	updateSceneGraphVisibility();
+	// Only the members of this layer (and their parents) can be affected
+	updateLayerMemberVisibility(layerID);
 
 	// Update the LayerControlDialog
 	_layerVisibilityChangedSignal.emit();
@@ -383,26 +473,76 @@ void LayerManager::removeSelectionFromLayer(int layerID) {
 
 bool LayerManager::updateNodeVisibility(const scene::INodePtr& node)
 {
-	// Get the list of layers the node is associated with
-	const auto& layers = node->getLayers();
+	// The node is visible as soon as one of its layers is visible
+	if (node->getLayers().intersects(_visibleLayers))
+	{
+		node->disable(Node::eLayered);
+		return true;
+	}
 
-	// We start with the assumption that a node is hidden
+	// Node is hidden, return FALSE
 	node->enable(Node::eLayered);
+	return false;
+}
+
+void LayerManager::registerNode(INode& node)
+{
+	addToMemberIndex(node, node.getLayers());
+}
+
+void LayerManager::unregisterNode(INode& node)
+{
+	removeFromMemberIndex(node, node.getLayers());
+}
+
+void LayerManager::updateNodeMembership(INode& node, const LayerList& previousLayers)
+{
+	removeFromMemberIndex(node, previousLayers);
+	addToMemberIndex(node, node.getLayers());
+}
+
+std::size_t LayerManager::getLayerMemberCount(int layerID) const
+{
+	auto found = _layerMemberCounts.find(layerID);
+
+	return found != _layerMemberCounts.end() ? found->second : 0;
+}
+
+void LayerManager::addToMemberIndex(INode& node, const LayerList& layers)
+{
+	auto type = node.getNodeType();
+	bool isCounted = type == INode::Type::Entity || type == INode::Type::Brush || type == INode::Type::Patch;
 
-	// Cycle through the Node's layers, and show the node as soon as
-	// a visible layer is found.
 	for (int layerId : layers)
 	{
-		if (_layerVisibility[layerId])
+		if (_layerMembers[layerId].insert(&node).second && isCounted)
 		{
-			// The layer is visible, set the visibility to true and quit
-			node->disable(Node::eLayered);
-			return true;
+			++_layerMemberCounts[layerId];
 		}
 	}
+}
 
-	// Node is hidden, return FALSE
-	return false;
+void LayerManager::removeFromMemberIndex(INode& node, const LayerList& layers)
+{
+	auto type = node.getNodeType();
+	bool isCounted = type == INode::Type::Entity || type == INode::Type::Brush || type == INode::Type::Patch;
+
+	for (int layerId : layers)
+	{
+		auto members = _layerMembers.find(layerId);
+
+		if (members == _layerMembers.end() || members->second.erase(&node) == 0) continue;
+
+		if (isCounted && --_layerMemberCounts[layerId] == 0)
+		{
+			_layerMemberCounts.erase(layerId);
+		}
+
+		if (members->second.empty())
+		{
+			_layerMembers.erase(members);
+		}
+	}
 }
 
 void LayerManager::setSelected(int layerID, bool selected)
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_set>
 #include "ilayer.h"
 #include "imap.h"
 
@@ -12,16 +13,21 @@ class LayerManager :
 	public ILayerManager
 {
 private:
-	// greebo: An array of booleans reflects the visibility status
-	// of all layers. Indexed by the layer id, it can be used to
-	// quickly check whether a layer is visible or not.
-	typedef std::vector<bool> LayerVisibilityList;
-	LayerVisibilityList _layerVisibility;
+	// greebo: The set of visible layer IDs. Checking a node's layers
+	// against this set needs a few bitwise operations only.
+	LayerList _visibleLayers;
 
 	// The list of named layers, indexed by an integer ID
 	typedef std::map<int, std::string> LayerMap;
 	LayerMap _layers;
 
+	// All registered scene nodes, by the layers they're member of
+	typedef std::unordered_set<INode*> LayerMembers;
+	std::map<int, LayerMembers> _layerMembers;
+
+	// Number of entities and primitives in each layer
+	std::map<int, std::size_t> _layerMemberCounts;
+
 	// The ID of the active layer
 	int _activeLayer;
 
@@ -111,6 +117,13 @@ public:
 
 	bool updateNodeVisibility(const scene::INodePtr& node) override;
 
+	// Member index maintenance
+	void registerNode(INode& node) override;
+	void unregisterNode(INode& node) override;
+	void updateNodeMembership(INode& node, const LayerList& previousLayers) override;
+
+	std::size_t getLayerMemberCount(int layerID) const override;
+
 	// Selects/unselects an entire layer
 	void setSelected(int layerID, bool selected) override;
 
@@ -122,8 +135,8 @@ private:
 	// Internal event emitter
 	void onLayersChanged();
 
-	// Internal event, updates the scenegraph
-	void onLayerVisibilityChanged();
+	// Internal event, updates the members of the given layer
+	void onLayerVisibilityChanged(int layerID);
 
 	// Internal event emitter
 	void onNodeMembershipChanged();
@@ -131,6 +144,14 @@ private:
 	// Updates the visibility state of the entire scenegraph
 	void updateSceneGraphVisibility();
 
+	// Updates the visibility state of the given layer's members and their
+	// ancestors, without traversing the rest of the scene
+	void updateLayerMemberVisibility(int layerID);
+
+	// Adds/removes the node to/from the index of the given layers
+	void addToMemberIndex(INode& node, const LayerList& layers);
+	void removeFromMemberIndex(INode& node, const LayerList& layers);
+
 	// Returns the highest used layer Id
 	int getHighestLayerID() const;
 
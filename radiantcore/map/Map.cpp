@@ -426,7 +426,7 @@ void Map::saveDirect(const std::string& filename, const MapFormatPtr& mapFormat)
 
     try
     {
-        MapResource::saveFile(*format, GlobalSceneGraph().root(), scene::traverse, filename);
+        MapResource::saveFile(*format, GlobalSceneGraph().root(), scene::traverse, filename, true);
     }
     catch (const IMapResource::OperationException& ex)
     {
@@ -765,7 +765,8 @@ void Map::exportMap(const cmd::ArgumentList& args)
         MapResource::saveFile(*fileInfo.mapFormat,
             GlobalSceneGraph().root(),
             scene::traverse,
-            fileInfo.fullPath);
+            fileInfo.fullPath,
+            true);
 
         GlobalMap().emitMapEvent(MapSaved);
     }
@@ -11,6 +11,7 @@
 #include "ifilesystem.h"
 #include "iregistry.h"
 #include "imapinfofile.h"
+#include "imapstatistics.h"
 
 #include "map/Map.h"
 #include "map/RootNode.h"
@@ -36,6 +37,7 @@
 #include "infofile/InfoFileExporter.h"
 #include "scene/ChildPrimitives.h"
 #include "messages/MapFileOperation.h"
+#include "brush/Brush.h"
 
 namespace map
 {
@@ -44,6 +46,25 @@ namespace
 {
 	const char* const GKEY_INFO_FILE_EXTENSION = "/mapFormat/infoFileExtension";
 
+	void evaluateBrushes(const scene::INodePtr& root)
+	{
+		std::vector<Brush*> brushes;
+
+		root->foreachNode([&](const scene::INodePtr& node)
+		{
+			Brush* brush = Node_getBrush(node);
+
+			if (brush != nullptr)
+			{
+				brushes.push_back(brush);
+			}
+
+			return true;
+		});
+
+		Brush::evaluateBReps(brushes);
+	}
+
 	// name may be absolute or relative
 	inline std::string rootPath(const std::string& name) {
 		return GlobalFileSystem().findRoot(
@@ -157,7 +178,7 @@ void MapResource::save(const MapFormatPtr& mapFormat)
 	}
 
 	// Save the actual file (throws on fail)
-	saveFile(*format, _mapRoot, scene::traverse, fullpath);
+	saveFile(*format, _mapRoot, scene::traverse, fullpath, true);
 
 	mapSave();
 }
@@ -332,6 +353,9 @@ bool MapResource::loadFile(std::istream& mapStream, const MapFormat& format, con
 		// Prepare child primitives
 		scene::addOriginToChildPrimitives(root);
 
+		// Build the brush geometry now, in parallel, instead of on first render
+		evaluateBrushes(root);
+
 		if (!format.allowInfoFileCreation())
 		{
 			// No info file handling, just return success
@@ -463,7 +487,8 @@ void MapResource::throwIfNotWriteable(const fs::path& path)
 }
 
 void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr& root,
-						   const GraphTraversalFunc& traverse, const std::string& filename)
+						   const GraphTraversalFunc& traverse, const std::string& filename,
+						   bool isFullMap)
 {
 	// Actual output file paths
 	fs::path outFile = filename;
@@ -505,8 +530,20 @@ void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr
 	rMessage() << "success" << std::endl;
 
 	// Check the total count of nodes to traverse
-	NodeCounter counter;
-	traverse(root, counter);
+	std::size_t nodeCount = 0;
+
+	if (isFullMap && root->inScene())
+	{
+		// The whole map is exported, the statistics already know the count
+		auto& statistics = root->getStatistics();
+		nodeCount = statistics.getEntityCount() + statistics.getPrimitiveCount();
+	}
+	else
+	{
+		NodeCounter counter;
+		traverse(root, counter);
+		nodeCount = counter.getCount();
+	}
 		
 	// Create our main MapExporter walker, and pass the desired 
 	// format to it. The constructor will prepare the scene
@@ -517,11 +554,11 @@ void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr
 
 	if (format.allowInfoFileCreation())
 	{
-		exporter.reset(new MapExporter(*mapWriter, root, outFileStream, *auxFileStream, counter.getCount()));
+		exporter.reset(new MapExporter(*mapWriter, root, outFileStream, *auxFileStream, nodeCount));
 	}
 	else
 	{
-		exporter.reset(new MapExporter(*mapWriter, root, outFileStream, counter.getCount())); // no aux stream
+		exporter.reset(new MapExporter(*mapWriter, root, outFileStream, nodeCount)); // no aux stream
 	}
 
 	try
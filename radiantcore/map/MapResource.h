@@ -44,8 +44,11 @@ public:
 
 	// Save the map contents to the given filename using the given MapFormat export module
 	// Throws an OperationException if anything prevents successful completion
+	// Pass isFullMap = true if the traversal visits every node of the map, the node count
+	// is then taken from the map statistics instead of an extra traversal.
 	static void saveFile(const MapFormat& format, const scene::IMapRootNodePtr& root,
-						 const GraphTraversalFunc& traverse, const std::string& filename);
+						 const GraphTraversalFunc& traverse, const std::string& filename,
+						 bool isFullMap = false);
 
 private:
 	void mapSave();
@@ -1,6 +1,8 @@
 #include "RootNode.h"
 
 #include "inode.h"
+#include "scene/MaterialUsageIndex.h"
+#include "scene/MapStatistics.h"
 
 namespace map
 {
@@ -28,6 +30,9 @@ RootNode::RootNode(const std::string& name) :
 
 	_layerManager = GlobalLayerModule().createLayerManager();
 	assert(_layerManager);
+
+	_materialUsageIndex = std::make_shared<scene::MaterialUsageIndex>();
+	_statistics = std::make_shared<scene::MapStatistics>();
 }
 
 RootNode::~RootNode()
@@ -68,6 +73,16 @@ scene::ILayerManager& RootNode::getLayerManager()
 	return *_layerManager;
 }
 
+scene::IMaterialUsageIndex& RootNode::getMaterialUsageIndex()
+{
+	return *_materialUsageIndex;
+}
+
+scene::IMapStatistics& RootNode::getStatistics()
+{
+	return *_statistics;
+}
+
 std::string RootNode::name() const 
 {
 	return _name;
@@ -3,6 +3,8 @@
 #include "inamespace.h"
 #include "imap.h"
 #include "ilayer.h"
+#include "imaterialusage.h"
+#include "imapstatistics.h"
 #include "ientity.h"
 #include "iselectiongroup.h"
 #include "iselectionset.h"
@@ -46,6 +48,10 @@ private:
 
     scene::ILayerManager::Ptr _layerManager;
 
+    scene::IMaterialUsageIndex::Ptr _materialUsageIndex;
+
+    scene::IMapStatistics::Ptr _statistics;
+
 	AABB _emptyAABB;
 
 public:
@@ -62,6 +68,8 @@ public:
     selection::ISelectionGroupManager& getSelectionGroupManager() override;
     selection::ISelectionSetManager& getSelectionSetManager() override;
     scene::ILayerManager& getLayerManager() override;
+    scene::IMaterialUsageIndex& getMaterialUsageIndex() override;
+    scene::IMapStatistics& getStatistics() override;
 
 	// Renderable implementation (empty)
 	void renderSolid(RenderableCollector& collector, const VolumeTest& volume) const override
@@ -1,6 +1,5 @@
 #include "ComplexName.h"
 
-#include <climits>
 #include "string/trim.h"
 #include "string/convert.h"
 
@@ -23,35 +22,22 @@ std::string ComplexName::getFullname() const
     return _name + (_postFix != EMPTY_POSTFIX ? _postFix : "");
 }
 
-namespace
+std::string ComplexName::makePostfixUnique(const PostfixSet& postfixes)
 {
-    // Find the first integer not in the given set
-    std::string findFirstUnusedNumber(const PostfixSet& set)
+    // If our postfix is already in the set, change it to a unique value
+    if (postfixes.contains(_postFix))
     {
-        static const int LOWEST_VAL = 1;
-
-        for (int i = LOWEST_VAL; i < INT_MAX; ++i)
-        {
-			std::string testPostfix = string::to_string(i);
-
-            if (set.find(testPostfix) == set.end())
-            {
-                // Found an unused value
-                return testPostfix;
-            }
-        }
-
-        // Pathological case, could not find a value
-        return string::to_string(INT_MAX);
+        _postFix = string::to_string(postfixes.getLowestUnusedNumber());
     }
+
+    return _postFix;
 }
 
-std::string ComplexName::makePostfixUnique(const PostfixSet& postfixes)
+std::string ComplexName::makePostfixUnique(const PostfixSet& postfixes, const PostfixSet& reserved)
 {
-    // If our postfix is already in the set, change it to a unique value
-    if (postfixes.find(_postFix) != postfixes.end())
+    if (postfixes.contains(_postFix) || reserved.contains(_postFix))
     {
-        _postFix = findFirstUnusedNumber(postfixes);
+        _postFix = string::to_string(postfixes.getLowestUnusedNumber(reserved));
     }
 
     return _postFix;
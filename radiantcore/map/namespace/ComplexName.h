@@ -1,10 +1,7 @@
 #pragma once
 
 #include <string>
-#include <set>
-
-/// Set of unique postfixes, e.g. "1", "6" or "04"
-typedef std::set<std::string> PostfixSet;
+#include "PostfixSet.h"
 
 /// Name consisting of initial text and optional unique-making number-postfix 
 /// e.g. "Carl" + "6", or "Mary" + "03"
@@ -46,4 +43,11 @@ public:
      * Set of existing postfixes which must not be used.
      */
     std::string makePostfixUnique(const PostfixSet& postfixes);
+
+    /**
+     * \brief
+     * Change (if necessary) the postfix such that it is neither used in the
+     * given postfixes nor in the reserved ones, and return the new value.
+     */
+    std::string makePostfixUnique(const PostfixSet& postfixes, const PostfixSet& reserved);
 };
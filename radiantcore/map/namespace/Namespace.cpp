@@ -257,11 +257,10 @@ void Namespace::ensureNoConflicts(const scene::INodePtr& root)
     rDebug() << "Namespace::ensureNoConflicts(): imported set of "
              << walker.result.size() << " namespaced nodes" << std::endl;
 
-    // Build a union set containing all imported names and all existing names.
-    // We need to know all existing names to ensure that newly created names are
-    // unique in *both* namespaces
-    UniqueNameSet allNames = _uniqueNames;
-    allNames.merge(foreignNamespace._uniqueNames);
+    // The imported names plus the ones assigned below. New names need to be
+    // unique in *both* namespaces, the existing names are passed as reserved
+    // set instead of copying them into a combined one.
+    UniqueNameSet importedNames = foreignNamespace._uniqueNames;
 
     // Process each object in the to-be-imported tree of nodes, ensuring that it
     // has a unique name
@@ -272,7 +271,7 @@ void Namespace::ensureNoConflicts(const scene::INodePtr& root)
         if (_uniqueNames.nameExists(n->getName()))
         {
             // Name exists in the target namespace, get a new name
-            std::string uniqueName = allNames.insertUnique(n->getName());
+            std::string uniqueName = importedNames.insertUnique(n->getName(), _uniqueNames);
 
             rMessage() << "Namespace::ensureNoConflicts(): '" << n->getName()
                        << "' already exists in this namespace. Rename it to '"
@@ -282,13 +281,6 @@ void Namespace::ensureNoConflicts(const scene::INodePtr& root)
             // observers in the foreign namespace
             n->changeName(uniqueName);
         }
-        else
-        {
-            // Name does not exist yet, insert it into the local combined
-            // namespace (but not our destination namespace, this will be
-            // populated in the subsequent call to connect()).
-            allNames.insert(n->getName());
-        }
     }
 
     // at this point, all names in the foreign namespace have been converted to
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <set>
+#include <map>
+#include <string>
+#include <climits>
+#include <iterator>
+#include <algorithm>
+
+/**
+ * \brief
+ * Set of unique postfixes, e.g. "1", "6" or "04".
+ *
+ * Plain numbers are stored as ranges of consecutive used values, such that the
+ * lowest unused number can be looked up without testing every candidate.
+ * Postfixes with leading zeros, the empty postfix "-" and numbers exceeding
+ * the int range are stored in their string form.
+ */
+class PostfixSet
+{
+    // Ranges of used numbers, mapping the first to the last value of the range
+    // Ranges never overlap or touch each other, e.g. [1..5] [7..7] [10..12]
+    typedef std::map<int, int> Ranges;
+    Ranges _ranges;
+
+    // Postfixes which cannot be represented by a plain number
+    std::set<std::string> _others;
+
+public:
+    bool empty() const
+    {
+        return _ranges.empty() && _others.empty();
+    }
+
+    /// Returns true if the given postfix is part of this set
+    bool contains(const std::string& postfix) const
+    {
+        int number;
+        return toNumber(postfix, number) ? containsNumber(number) : _others.count(postfix) > 0;
+    }
+
+    /// Inserts the postfix, returns TRUE if it has not been in the set before
+    bool insert(const std::string& postfix)
+    {
+        int number;
+
+        if (!toNumber(postfix, number))
+        {
+            return _others.insert(postfix).second;
+        }
+
+        if (containsNumber(number))
+        {
+            return false;
+        }
+
+        insertRange(number, number);
+        return true;
+    }
+
+    /// Removes the postfix, returns TRUE if it has been in the set
+    bool erase(const std::string& postfix)
+    {
+        int number;
+
+        if (!toNumber(postfix, number))
+        {
+            return _others.erase(postfix) > 0;
+        }
+
+        auto range = findRange(number);
+
+        if (range == _ranges.end())
+        {
+            return false;
+        }
+
+        // Split the range, keeping the values below and above the erased one
+        int first = range->first;
+        int last = range->second;
+
+        _ranges.erase(range);
+
+        if (first < number)
+        {
+            _ranges.emplace(first, number - 1);
+        }
+
+        if (number < last)
+        {
+            _ranges.emplace(number + 1, last);
+        }
+
+        return true;
+    }
+
+    /// Adds all postfixes of the other set to this one
+    void merge(const PostfixSet& other)
+    {
+        for (const auto& range : other._ranges)
+        {
+            insertRange(range.first, range.second);
+        }
+
+        _others.insert(other._others.begin(), other._others.end());
+    }
+
+    /// Returns the lowest number (starting from 1) which is not used in this set
+    int getLowestUnusedNumber() const
+    {
+        return getNextUnusedNumber(LOWEST_NUMBER);
+    }
+
+    /// Returns the lowest number (starting from 1) which is neither used in
+    /// this nor in the other set
+    int getLowestUnusedNumber(const PostfixSet& other) const
+    {
+        int candidate = LOWEST_NUMBER;
+
+        while (true)
+        {
+            int next = other.getNextUnusedNumber(getNextUnusedNumber(candidate));
+
+            // Stop if neither of the sets moved the candidate any further
+            if (next == candidate)
+            {
+                return candidate;
+            }
+
+            candidate = next;
+        }
+    }
+
+private:
+    static const int LOWEST_NUMBER = 1;
+
+    // Converts the postfix to a number, which only succeeds if
+    // the number converts back to the exact same string
+    static bool toNumber(const std::string& postfix, int& number)
+    {
+        // Longer strings might not fit into an int
+        if (postfix.empty() || postfix.size() > 9 || (postfix[0] == '0' && postfix.size() > 1))
+        {
+            return false;
+        }
+
+        number = 0;
+
+        for (char c : postfix)
+        {
+            if (c < '0' || c > '9')
+            {
+                return false;
+            }
+
+            number = number * 10 + (c - '0');
+        }
+
+        return true;
+    }
+
+    // Returns the range containing the given number, or end() if it's not used
+    Ranges::const_iterator findRange(int number) const
+    {
+        auto range = _ranges.upper_bound(number);
+
+        if (range == _ranges.begin())
+        {
+            return _ranges.end();
+        }
+
+        --range;
+
+        return number <= range->second ? range : _ranges.end();
+    }
+
+    bool containsNumber(int number) const
+    {
+        return findRange(number) != _ranges.end();
+    }
+
+    // Returns the lowest number >= candidate which is not used in this set
+    // In the pathological case of all numbers being in use, INT_MAX is returned
+    int getNextUnusedNumber(int candidate) const
+    {
+        auto range = findRange(candidate);
+
+        if (range == _ranges.end())
+        {
+            return candidate;
+        }
+
+        return range->second < INT_MAX ? range->second + 1 : INT_MAX;
+    }
+
+    // Marks the numbers [first..last] as used, joining all affected ranges
+    void insertRange(int first, int last)
+    {
+        auto range = _ranges.upper_bound(first);
+
+        // Check if the preceding range overlaps or touches the new one
+        if (range != _ranges.begin() && std::prev(range)->second >= first - 1)
+        {
+            --range;
+            first = range->first;
+        }
+
+        // Absorb all following ranges which overlap or touch the new one
+        while (range != _ranges.end() && (last == INT_MAX || range->first <= last + 1))
+        {
+            last = std::max(last, range->second);
+            range = _ranges.erase(range);
+        }
+
+        _ranges.emplace(first, last);
+    }
+};
@@ -1,7 +1,7 @@
 #pragma once
 
-#include <set>
-#include <map>
+#include <cassert>
+#include <unordered_map>
 
 #include "ComplexName.h"
 
@@ -15,7 +15,7 @@ class UniqueNameSet
     // This maps name prefixes to a set of used postfixes
     // e.g. "func_static_" => ["1","3","4","5","05","10"]
     // Allows fairly quick lookup of used names and postfixes
-    typedef std::map<std::string, PostfixSet> Names;
+    typedef std::unordered_map<std::string, PostfixSet> Names;
     Names _names;
 
 public:
@@ -59,10 +59,8 @@ public:
         }
 
         // The prefix is inserted at this point, add the postfix to the set
-        auto result = found->second.insert(name.getPostfix());
-
-        // Return the boolean of the insertion result, it is true on successful insertion
-        return result.second;
+        // This returns true on successful insertion
+        return found->second.insert(name.getPostfix());
     }
 
     /**
@@ -82,8 +80,8 @@ public:
         }
 
         // The prefix has been found, remove the postfix from the set
-        // Return true if the erase method removed any elements
-        return found->second.erase(name.getPostfix()) > 0;
+        // Return true if the erase method removed the postfix
+        return found->second.erase(name.getPostfix());
     }
 
     /**
@@ -97,30 +95,43 @@ public:
      */
     std::string insertUnique(const ComplexName& name)
     {
-        // Lookup the name in the map to see if we know this prefix
-        Names::iterator found = _names.find(name.getNameWithoutPostfix());
+        // Look up the postfixes of this name "trunk", this adds an empty set if necessary
+        PostfixSet& postfixSet = _names[name.getNameWithoutPostfix()];
 
-        if (found == _names.end()) 
-		{
-            // The name is not yet in the list, we can add it with the given postfix
-            auto result = _names.insert(std::make_pair(name.getNameWithoutPostfix(), PostfixSet()));
+        // Acquire a new unique postfix (if necessary) for this name to make it
+        // unique
+        ComplexName uniqueName(name);
 
-            assert(result.second); // insert must succeed, we didn't find this just before
+        std::string postfix = uniqueName.makePostfixUnique(postfixSet);
+        postfixSet.insert(postfix);
 
-            // Overwrite the iterator
-            found = result.first;
-        }
+        return uniqueName.getFullname();
+    }
+
+    /**
+     * \brief
+     * Insert the given ComplexName into this set, changing its postfix if
+     * necessary to ensure that it is neither used in this set nor in the
+     * reserved one. The reserved set is left untouched.
+     *
+     * \return
+     * The actual unique name that was used.
+     */
+    std::string insertUnique(const ComplexName& name, const UniqueNameSet& reserved)
+    {
+        Names::const_iterator found = reserved._names.find(name.getNameWithoutPostfix());
 
-        // At this point, the "trunk" of the complex name is already in the list
-        // The found iterator points to a valid prefix => PostFixSet mapping
+        if (found == reserved._names.end())
+        {
+            // The reserved set doesn't know this prefix, no conflicts possible
+            return insertUnique(name);
+        }
 
-        // Acquire a new unique postfix (if necessary) for this name to make it
-        // unique
-        PostfixSet& postfixSet = found->second;
+        PostfixSet& postfixSet = _names[name.getNameWithoutPostfix()];
 
         ComplexName uniqueName(name);
 
-        std::string postfix = uniqueName.makePostfixUnique(postfixSet);
+        std::string postfix = uniqueName.makePostfixUnique(postfixSet, found->second);
         postfixSet.insert(postfix);
 
         return uniqueName.getFullname();
@@ -155,7 +166,7 @@ public:
             const PostfixSet& postfixSet = found->second;
 
             // If we know the number too, the full name exists
-            return postfixSet.find(name.getPostfix()) != postfixSet.end();
+            return postfixSet.contains(name.getPostfix());
         }
 
         // Prefix is not known, hence full name is not known
@@ -178,7 +189,7 @@ public:
             if (local != _names.end())
 			{
                 // Prefix exists, merge the postfixes
-                local->second.insert(i.second.begin(), i.second.end());
+                local->second.merge(i.second);
             }
             else
 			{
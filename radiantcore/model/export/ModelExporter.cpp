@@ -20,15 +20,17 @@ namespace
 {
 
 // Adapter methods to convert brush vertices to ArbitraryMeshVertex type
-ArbitraryMeshVertex convertWindingVertex(const WindingVertex& in)
+// Normal, tangent and bitangent are the same for all vertices of a face
+ArbitraryMeshVertex convertWindingVertex(const WindingVertex& in, const Vector2& texcoord,
+	const Vector3& normal, const Vector3& tangent, const Vector3& bitangent)
 {
 	ArbitraryMeshVertex out;
 
 	out.vertex = in.vertex;
-	out.normal = in.normal;
-	out.texcoord = in.texcoord;
-	out.bitangent = in.bitangent;
-	out.tangent = in.tangent;
+	out.normal = normal;
+	out.texcoord = texcoord;
+	out.bitangent = bitangent;
+	out.tangent = tangent;
 	out.colour.set(1.0, 1.0, 1.0);
 
 	return out;
@@ -250,14 +252,18 @@ void ModelExporter::processBrush(const scene::INodePtr& node)
 			continue;
 		}
 
+		const Vector3& normal = face.getPlane3().normal();
+		Vector3 tangent, bitangent;
+		face.getTextureAxes(tangent, bitangent);
+
 		// Create triangles for this winding 
 		for (std::size_t i = 1; i < winding.size() - 1; ++i)
 		{
 			model::ModelPolygon poly;
 
-			poly.a = convertWindingVertex(winding[i + 1]);
-			poly.b = convertWindingVertex(winding[i]);
-			poly.c = convertWindingVertex(winding[0]);
+			poly.a = convertWindingVertex(winding[i + 1], face.getTexcoord(i + 1), normal, tangent, bitangent);
+			poly.b = convertWindingVertex(winding[i], face.getTexcoord(i), normal, tangent, bitangent);
+			poly.c = convertWindingVertex(winding[0], face.getTexcoord(0), normal, tangent, bitangent);
 
 			polys.push_back(poly);
 		}
@@ -136,30 +136,39 @@ void MD5Model::setModelPath(const std::string& modelPath) {
 
 void MD5Model::applySkin(const ModelSkin& skin)
 {
+	bool materialsChanged = false;
+
 	// Apply the skin to each surface, then try to capture shaders
-	for (SurfaceList::iterator i = _surfaces.begin(); i != _surfaces.end(); ++i)
+	for (Surface& surface : _surfaces)
 	{
-		const std::string& defaultMaterial = i->surface->getDefaultMaterial();
-		const std::string& activeMaterial = i->surface->getActiveMaterial();
+		// The default material is known after parsing, look up its id once
+		if (surface.defaultMaterialId == ModelSkin::NO_REMAP)
+		{
+			surface.defaultMaterialId = GlobalModelSkinCache().getMaterialId(surface.surface->getDefaultMaterial());
+		}
 
-		// Look up the remap for this surface's material name. If there is a remap
-		// change the Shader* to point to the new shader.
-		std::string remap = skin.getRemap(defaultMaterial);
+		// Look up the remap for this surface's material, if there is none
+		// the surface reverts to its original unskinned material
+		std::size_t materialId = skin.getRemapId(surface.defaultMaterialId);
 
-		if (!remap.empty() && remap != activeMaterial)
+		if (materialId == ModelSkin::NO_REMAP)
 		{
-			// Save the remapped shader name
-			i->surface->setActiveMaterial(remap);
+			materialId = surface.defaultMaterialId;
 		}
-		else if (remap.empty() && activeMaterial != defaultMaterial)
+
+		if (materialId != surface.activeMaterialId)
 		{
-			// No remap, so reset our shader to the original unskinned shader
-			i->surface->setActiveMaterial(defaultMaterial);
+			surface.activeMaterialId = materialId;
+			surface.surface->setActiveMaterial(GlobalModelSkinCache().getMaterialName(materialId));
+			materialsChanged = true;
 		}
 	}
 
-	captureShaders();
-	updateMaterialList();
+	if (materialsChanged)
+	{
+		captureShaders();
+		updateMaterialList();
+	}
 }
 
 int MD5Model::getSurfaceCount() const
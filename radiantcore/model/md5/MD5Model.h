@@ -2,6 +2,7 @@
 
 #include "imodel.h"
 #include "imd5model.h"
+#include "modelskin.h"
 #include "math/AABB.h"
 #include <vector>
 #include "parser/DefTokeniser.h"
@@ -36,11 +37,20 @@ private:
 		// Mapped shader
 		ShaderPtr shader;
 
-		Surface()
+		// Skin cache ids of the default and the active material,
+		// NO_REMAP if not determined yet
+		std::size_t defaultMaterialId;
+		std::size_t activeMaterialId;
+
+		Surface() :
+			defaultMaterialId(ModelSkin::NO_REMAP),
+			activeMaterialId(ModelSkin::NO_REMAP)
 		{}
 
 		Surface(const MD5SurfacePtr& surface_) :
-			surface(surface_)
+			surface(surface_),
+			defaultMaterialId(ModelSkin::NO_REMAP),
+			activeMaterialId(ModelSkin::NO_REMAP)
 		{}
 	};
 
@@ -196,6 +196,9 @@ void MD5ModelNode::skinChanged(const std::string& newSkinName)
 
     _model->applySkin(skin);
 
+    // The map statistics are counting the skins in use
+    statisticsChanged();
+
     // Refresh the scene
     GlobalSceneGraph().sceneChanged();
 }
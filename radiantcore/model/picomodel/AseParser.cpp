@@ -0,0 +1,699 @@
+#include "AseParser.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <fmt/format.h>
+#include "itextstream.h"
+#include "parser/ParseException.h"
+#include "string/case_conv.h"
+#include "string/predicate.h"
+#include "string/replace.h"
+#include "string/string.h"
+
+namespace model
+{
+
+/**
+ * Line-aware tokeniser working on the file buffer. ASE statements are
+ * terminated by the end of the line, so the parser needs to know whether
+ * a token has been found on the current line or not.
+ */
+class AseParser::Tokeniser
+{
+private:
+	static constexpr double POWERS_OF_TEN[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	const char* _cur;
+	const char* _end;
+
+	std::size_t _length;
+
+	std::string _token;
+	std::size_t _line;
+
+public:
+	Tokeniser(const char* data, std::size_t length) :
+		_cur(data),
+		_end(data + length),
+		_length(length),
+		_line(1)
+	{}
+
+	std::size_t getLength() const
+	{
+		return _length;
+	}
+
+	const std::string& token() const
+	{
+		return _token;
+	}
+
+	std::size_t getLine() const
+	{
+		return _line;
+	}
+
+	// Reads the next token, quoted strings are returned without their quotes.
+	// Returns false at the end of the buffer, or at the end of the current
+	// line if line breaks are not allowed (the line break is not consumed).
+	bool next(bool allowLineBreaks)
+	{
+		_token.clear();
+
+		while (_cur < _end && static_cast<unsigned char>(*_cur) <= 32)
+		{
+			if (*_cur == '\n')
+			{
+				if (!allowLineBreaks) return false;
+
+				++_line;
+			}
+
+			++_cur;
+		}
+
+		if (_cur == _end) return false;
+
+		if (*_cur == '"')
+		{
+			for (++_cur; _cur < _end; ++_cur)
+			{
+				if (*_cur == '\\' && _cur + 1 < _end && _cur[1] == '"')
+				{
+					_token += *++_cur;
+					continue;
+				}
+
+				if (*_cur == '"')
+				{
+					++_cur;
+					break;
+				}
+
+				if (*_cur == '\n') ++_line;
+
+				_token += *_cur;
+			}
+
+			return true;
+		}
+
+		const char* start = _cur;
+
+		while (_cur < _end && static_cast<unsigned char>(*_cur) > 32)
+		{
+			++_cur;
+		}
+
+		_token.assign(start, _cur);
+		return true;
+	}
+
+	void skipRestOfLine()
+	{
+		while (_cur < _end && *_cur != '\n')
+		{
+			++_cur;
+		}
+	}
+
+	// The number parsers read the next token on the current line,
+	// the target value is set to 0 if there is none
+	bool nextInt(int& value)
+	{
+		value = 0;
+		if (!next(false)) return false;
+
+		value = std::atoi(_token.c_str());
+		return true;
+	}
+
+	bool nextFloat(float& value)
+	{
+		value = 0;
+		if (!next(false)) return false;
+
+		value = static_cast<float>(toDouble());
+		return true;
+	}
+
+	bool nextDouble(double& value)
+	{
+		value = 0;
+		if (!next(false)) return false;
+
+		value = toDouble();
+		return true;
+	}
+
+	// Returns the same as strtod() for the current token. The fixed-point
+	// numbers written by 3ds Max are converted without the C library: up to
+	// 15 digits and 22 decimals are exact in a double, the division is
+	// correctly rounded like strtod() is.
+	double toDouble() const
+	{
+		const char* p = _token.c_str();
+
+		bool negative = *p == '-';
+		if (negative || *p == '+') ++p;
+
+		std::uint64_t mantissa = 0;
+		int numDigits = 0;
+		int numDecimals = 0;
+
+		for (; *p >= '0' && *p <= '9'; ++p, ++numDigits)
+		{
+			mantissa = mantissa * 10 + (*p - '0');
+		}
+
+		if (*p == '.')
+		{
+			for (++p; *p >= '0' && *p <= '9'; ++p, ++numDigits, ++numDecimals)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+			}
+		}
+
+		if (*p != '\0' || numDigits == 0 || numDigits > 15 || numDecimals > 22)
+		{
+			return std::strtod(_token.c_str(), nullptr);
+		}
+
+		double value = static_cast<double>(mantissa) / POWERS_OF_TEN[numDecimals];
+		return negative ? -value : value;
+	}
+
+	// Vectors are stored in single precision by 3ds Max
+	bool nextVector(Vector3& vec)
+	{
+		float x, y, z;
+
+		if (!nextFloat(x) || !nextFloat(y) || !nextFloat(z)) return false;
+
+		vec = Vector3(x, y, z);
+		return true;
+	}
+};
+
+namespace
+{
+	// Vertex colours are stored as bytes by picomodel, do the same to get the same results
+	inline unsigned char colourToByte(float value)
+	{
+		float scaled = value * 255;
+		return scaled < 0 ? 0 : scaled > 255 ? 255 : static_cast<unsigned char>(scaled);
+	}
+}
+
+AseParser::AseParser(const char* data, std::size_t length) :
+	_tok(new Tokeniser(data, length)),
+	_nextVertexId(0)
+{}
+
+AseParser::~AseParser()
+{}
+
+std::vector<ParsedModelSurface> AseParser::parse()
+{
+	if (!_tok->next(true) || !string::iequals(_tok->token(), "*3DSMAX_ASCIIEXPORT"))
+	{
+		throw parser::ParseException("Missing *3DSMAX_ASCIIEXPORT header");
+	}
+
+	_tok->skipRestOfLine();
+
+	std::string keyword;
+
+	while (_tok->next(true))
+	{
+		const std::string& token = _tok->token();
+
+		// Only lines starting with a keyword or a brace are of interest
+		if (token[0] != '*' && token[0] != '{' && token[0] != '}')
+		{
+			_tok->skipRestOfLine();
+			continue;
+		}
+
+		keyword = token;
+		string::to_lower(keyword);
+
+		if (keyword == "*mesh")
+		{
+			submitMesh();
+		}
+		else if (keyword == "*mesh_numvertex")
+		{
+			_vertices.assign(parseCount("vertex"), Vertex());
+		}
+		else if (keyword == "*mesh_numfaces")
+		{
+			_faces.assign(parseCount("face"), Face());
+		}
+		else if (keyword == "*mesh_numtvertex")
+		{
+			_texcoords.assign(parseCount("texture vertex"), Vector2(0, 0));
+		}
+		else if (keyword == "*mesh_numcvertex")
+		{
+			_colours.assign(parseCount("colour vertex"), Vector3(1, 1, 1));
+		}
+		else if (keyword == "*mesh_vertex")
+		{
+			int index;
+			Vector3 xyz;
+
+			if (!_tok->nextInt(index) || !_tok->nextVector(xyz) || index < 0 || index >= static_cast<int>(_vertices.size()))
+			{
+				throw parser::ParseException(fmt::format("Invalid vertex on line {0}", _tok->getLine()));
+			}
+
+			_vertices[index].xyz = xyz;
+			_vertices[index].id = _nextVertexId++;
+		}
+		else if (keyword == "*mesh_vertexnormal")
+		{
+			int index;
+			Vector3 normal;
+
+			if (!_tok->nextInt(index) || !_tok->nextVector(normal) || index < 0 || index >= static_cast<int>(_vertices.size()))
+			{
+				throw parser::ParseException(fmt::format("Invalid vertex normal on line {0}", _tok->getLine()));
+			}
+
+			_vertices[index].normal = normal;
+		}
+		else if (keyword == "*mesh_face")
+		{
+			parseFace();
+		}
+		else if (keyword == "*mesh_tvert")
+		{
+			int index;
+			double s, t;
+
+			if (!_tok->nextInt(index) || !_tok->nextDouble(s) || !_tok->nextDouble(t) ||
+				index < 0 || index >= static_cast<int>(_texcoords.size()))
+			{
+				throw parser::ParseException(fmt::format("Invalid texture vertex on line {0}", _tok->getLine()));
+			}
+
+			_texcoords[index] = Vector2(s, 1.0f - t);
+		}
+		else if (keyword == "*mesh_tface")
+		{
+			parseIndexTriple(3, "texture face");
+		}
+		else if (keyword == "*mesh_vertcol")
+		{
+			int index;
+			float r, g, b;
+
+			if (!_tok->nextInt(index) || !_tok->nextFloat(r) || !_tok->nextFloat(g) || !_tok->nextFloat(b) ||
+				index < 0 || index >= static_cast<int>(_colours.size()))
+			{
+				throw parser::ParseException(fmt::format("Invalid vertex colour on line {0}", _tok->getLine()));
+			}
+
+			_colours[index] = Vector3(colourToByte(r) / 255.0f, colourToByte(g) / 255.0f, colourToByte(b) / 255.0f);
+		}
+		else if (keyword == "*mesh_cface")
+		{
+			parseIndexTriple(6, "colour face");
+		}
+		else if (keyword == "*material_ref")
+		{
+			int materialId;
+			if (!_tok->nextInt(materialId)) throw parser::ParseException(fmt::format("Missing material id on line {0}", _tok->getLine()));
+
+			for (Face& face : _faces)
+			{
+				face.materialId = materialId;
+			}
+		}
+		else if (keyword == "*material")
+		{
+			parseMaterial();
+		}
+
+		_tok->skipRestOfLine();
+	}
+
+	submitMesh();
+
+	std::vector<ParsedModelSurface> surfaces;
+	surfaces.reserve(_surfaces.size());
+
+	for (const auto& surface : _surfaces)
+	{
+		surfaces.emplace_back(surface->finish());
+	}
+
+	return surfaces;
+}
+
+std::size_t AseParser::parseCount(const char* element)
+{
+	int count;
+
+	// Each element takes more than a byte in the file, don't allocate nonsense
+	if (!_tok->nextInt(count) || count < 0 || static_cast<std::size_t>(count) > _tok->getLength())
+	{
+		throw parser::ParseException(fmt::format("Invalid {0} count on line {1}", element, _tok->getLine()));
+	}
+
+	return static_cast<std::size_t>(count);
+}
+
+void AseParser::parseMaterial()
+{
+	int materialId;
+	_tok->nextInt(materialId);
+
+	if (!_tok->next(true) || _tok->token() != "{")
+	{
+		throw parser::ParseException(fmt::format("Missing opening brace of material {0}", materialId));
+	}
+
+	const std::string& token = _tok->token();
+
+	int level = 1;
+	int subMaterialLevel = -1;
+	int subMaterialId = 0;
+	bool hasSubMaterials = false;
+
+	// Name, bitmap and texture parameters are not reset between the submaterials
+	SubMaterial properties;
+
+	while (_tok->next(true))
+	{
+		if (token[0] == '{') ++level;
+		if (token[0] == '}') --level;
+		if (level == 0) break;
+
+		// Leaving the block of the current submaterial
+		if (level == subMaterialLevel)
+		{
+			SubMaterial subMaterial = properties;
+
+			// Submaterials use the first word of their name only
+			subMaterial.name = string::replace_all_copy(
+				properties.name.substr(0, properties.name.find_first_of(" \t\r\n")), "\\", "/");
+
+			addSubMaterial(materialId, subMaterialId, std::move(subMaterial));
+
+			hasSubMaterials = true;
+			subMaterialLevel = -1;
+		}
+
+		if (string::iequals(token, "*submaterial"))
+		{
+			_tok->nextInt(subMaterialId);
+			subMaterialLevel = level;
+		}
+		else if (string::iequals(token, "*material_name"))
+		{
+			if (!_tok->next(false))
+			{
+				throw parser::ParseException(fmt::format("Missing material name on line {0}", _tok->getLine()));
+			}
+
+			properties.name = token;
+			_tok->skipRestOfLine();
+		}
+		else if (string::iequals(token, "*map_diffuse"))
+		{
+			int mapLevel = 0;
+
+			while (_tok->next(true))
+			{
+				if (token[0] == '{') ++mapLevel;
+				if (token[0] == '}') --mapLevel;
+				if (mapLevel == 0) break;
+
+				if (string::iequals(token, "*bitmap"))
+				{
+					if (!_tok->next(false))
+					{
+						throw parser::ParseException(fmt::format("Missing bitmap name on line {0}", _tok->getLine()));
+					}
+
+					properties.bitmap = token;
+					_tok->skipRestOfLine();
+					continue;
+				}
+
+				float* target = string::iequals(token, "*uvw_u_offset") ? &properties.uOffset :
+					string::iequals(token, "*uvw_v_offset") ? &properties.vOffset :
+					string::iequals(token, "*uvw_u_tiling") ? &properties.uScale :
+					string::iequals(token, "*uvw_v_tiling") ? &properties.vScale :
+					string::iequals(token, "*uvw_angle") ? &properties.uvAngle : nullptr;
+
+				if (target != nullptr)
+				{
+					if (!_tok->nextFloat(*target))
+					{
+						throw parser::ParseException(fmt::format("Missing texture parameter on line {0}", _tok->getLine()));
+					}
+
+					// The U offset is applied in the opposite direction
+					if (target == &properties.uOffset) properties.uOffset = -properties.uOffset;
+
+					_tok->skipRestOfLine();
+				}
+			}
+		}
+	}
+
+	if (hasSubMaterials) return;
+
+	// A plain material, the name is derived from the bitmap path if possible
+	SubMaterial material = properties;
+	material.name = string::replace_all_copy(properties.name, "\\", "/");
+
+	if (!properties.bitmap.empty())
+	{
+		std::string name = getNameFromBitmap(properties.bitmap);
+
+		if (!name.empty())
+		{
+			material.name = name;
+		}
+	}
+
+	addSubMaterial(materialId, 0, std::move(material));
+}
+
+void AseParser::parseFace()
+{
+	int index;
+
+	if (!_tok->nextInt(index) || index < 0 || index >= static_cast<int>(_faces.size()))
+	{
+		throw parser::ParseException(fmt::format("Invalid face on line {0}", _tok->getLine()));
+	}
+
+	Face& face = _faces[index];
+
+	// Vertex indices are preceded by their labels "A:", "B:" and "C:",
+	// the winding is reversed
+	for (int i = 2; i >= 0; --i)
+	{
+		if (!_tok->next(false) || !_tok->nextInt(face.indices[i]) ||
+			face.indices[i] < 0 || face.indices[i] >= static_cast<int>(_vertices.size()))
+		{
+			throw parser::ParseException(fmt::format("Invalid face vertex on line {0}", _tok->getLine()));
+		}
+	}
+
+	const std::string& token = _tok->token();
+
+	while (_tok->next(false))
+	{
+		// An empty smoothing group is followed by the material id, which is
+		// consumed by nextInt() and then still recognised by the second check
+		if (string::iequals(token, "*MESH_SMOOTHING"))
+		{
+			_tok->nextInt(face.smoothingGroup);
+		}
+
+		if (string::iequals(token, "*MESH_MTLID"))
+		{
+			_tok->nextInt(face.subMaterialId);
+		}
+	}
+
+	face.materialId = 0;
+}
+
+void AseParser::parseIndexTriple(int offset, const char* element)
+{
+	int index;
+	int indices[3];
+
+	if (!_tok->nextInt(index) || !_tok->nextInt(indices[0]) || !_tok->nextInt(indices[1]) || !_tok->nextInt(indices[2]) ||
+		index < 0 || index >= static_cast<int>(_faces.size()))
+	{
+		throw parser::ParseException(fmt::format("Invalid {0} on line {1}", element, _tok->getLine()));
+	}
+
+	// Reverse the winding to match the vertex indices
+	_faces[index].indices[offset] = indices[2];
+	_faces[index].indices[offset + 1] = indices[1];
+	_faces[index].indices[offset + 2] = indices[0];
+}
+
+void AseParser::submitMesh()
+{
+	for (const Face& face : _faces)
+	{
+		SubMaterial* subMaterial = findSubMaterial(face.materialId, face.subMaterialId);
+
+		if (subMaterial == nullptr)
+		{
+			// The remaining faces of this mesh are dropped, like picomodel does
+			rError() << "Could not find material/submaterial for id " <<
+				face.materialId << "/" << face.subMaterialId << std::endl;
+			break;
+		}
+
+		if (subMaterial->surface == NO_SURFACE)
+		{
+			subMaterial->surface = _surfaces.size();
+			_surfaces.emplace_back(new ModelSurfaceBuilder(subMaterial->name, subMaterial->bitmap));
+			_surfaces.back()->reserve(_vertices.size(), _faces.size() * 3);
+		}
+
+		ModelSurfaceBuilder& surface = *_surfaces[subMaterial->surface];
+
+		double sinAngle = std::sin(static_cast<double>(subMaterial->uvAngle));
+		double cosAngle = std::cos(static_cast<double>(subMaterial->uvAngle));
+
+		for (int i = 0; i < 3; ++i)
+		{
+			// Faces without a *MESH_FACE line or parsed before the vertex count
+			// changed are not validated yet
+			int vertexIndex = face.indices[i];
+
+			if (vertexIndex < 0 || vertexIndex >= static_cast<int>(_vertices.size()))
+			{
+				throw parser::ParseException(fmt::format("Vertex index {0} out of bounds", vertexIndex));
+			}
+
+			const Vertex& source = _vertices[vertexIndex];
+
+			ArbitraryMeshVertex vertex;
+			vertex.vertex = source.xyz;
+			vertex.normal = source.normal;
+			vertex.colour = Vector3(1, 1, 1);
+
+			if (!_texcoords.empty())
+			{
+				int texIndex = face.indices[i + 3];
+
+				if (texIndex < 0 || texIndex >= static_cast<int>(_texcoords.size()))
+				{
+					throw parser::ParseException(fmt::format("Texture vertex index {0} out of bounds", texIndex));
+				}
+
+				double u = _texcoords[texIndex].x() * subMaterial->uScale + subMaterial->uOffset;
+				double v = _texcoords[texIndex].y() * subMaterial->vScale + subMaterial->vOffset;
+
+				vertex.texcoord = TexCoord2f(u * cosAngle + v * sinAngle, u * -sinAngle + v * cosAngle);
+			}
+			else
+			{
+				vertex.texcoord = TexCoord2f(0, 0);
+			}
+
+			int colourIndex = face.indices[i + 6];
+
+			if (!_colours.empty() && colourIndex >= 0)
+			{
+				if (colourIndex >= static_cast<int>(_colours.size()))
+				{
+					throw parser::ParseException(fmt::format("Colour vertex index {0} out of bounds", colourIndex));
+				}
+
+				vertex.colour = _colours[colourIndex];
+			}
+
+			// Vertices are smoothed within their smoothing group only
+			std::uint64_t smoothingGroup = static_cast<std::uint64_t>(source.id) * 65536 +
+				static_cast<std::uint32_t>(face.smoothingGroup);
+
+			surface.addIndex(surface.addUniqueVertex(vertex, smoothingGroup));
+		}
+	}
+
+	_vertices.clear();
+	_texcoords.clear();
+	_colours.clear();
+	_faces.clear();
+}
+
+AseParser::SubMaterial* AseParser::findSubMaterial(int materialId, int subMaterialId)
+{
+	auto material = _materials.find(materialId);
+
+	if (material == _materials.end())
+	{
+		return nullptr;
+	}
+
+	// Fall back to the first submaterial
+	auto subMaterial = material->second.find(subMaterialId);
+
+	if (subMaterial == material->second.end())
+	{
+		subMaterial = material->second.find(0);
+	}
+
+	return subMaterial != material->second.end() ? &_subMaterials[subMaterial->second] : nullptr;
+}
+
+void AseParser::addSubMaterial(int materialId, int subMaterialId, SubMaterial&& subMaterial)
+{
+	_materials[materialId][subMaterialId] = _subMaterials.size();
+	_subMaterials.emplace_back(std::move(subMaterial));
+}
+
+std::string AseParser::getNameFromBitmap(const std::string& bitmap)
+{
+	std::string path = string::replace_all_copy(bitmap, "\\", "/");
+
+	// Strip the extension
+	std::size_t lastPeriod = path.rfind('.');
+
+	if (lastPeriod != std::string::npos)
+	{
+		path.resize(lastPeriod);
+	}
+
+	// Find the game folder
+	std::size_t pos = 0;
+
+	for (; pos < path.size(); ++pos)
+	{
+		if (string_equal_nocase_n(path.c_str() + pos, "quake", 5) ||
+			string_equal_nocase_n(path.c_str() + pos, "doom", 4))
+		{
+			break;
+		}
+	}
+
+	// The name starts below the mod folder
+	for (int i = 0; i < 2 && pos < path.size(); ++i)
+	{
+		pos = path.find('/', pos);
+		pos = pos == std::string::npos ? path.size() : pos + 1;
+	}
+
+	return pos < path.size() ? path.substr(pos) : std::string();
+}
+
+} // namespace model
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <map>
+#include <deque>
+#include <memory>
+#include "math/Vector2.h"
+#include "ModelSurfaceBuilder.h"
+
+namespace model
+{
+
+/**
+ * Parser for 3ds Max ASCII scene exports (ASE), reading the file buffer
+ * straight into the vertex and index arrays of the model surfaces.
+ *
+ * The resulting surfaces are the same as produced by picomodel's ASE module:
+ * one surface per (sub)material, vertices are welded if they share their
+ * source vertex, smoothing group, texture coordinates, normal and colour.
+ */
+class AseParser
+{
+private:
+	struct Vertex
+	{
+		Vector3 xyz;
+		Vector3 normal;
+		std::size_t id = 0;
+	};
+
+	struct Face
+	{
+		// Vertex, texture vertex and colour vertex indices
+		int indices[9] = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+		int smoothingGroup = 0;
+		int materialId = 0;
+		int subMaterialId = 0;
+	};
+
+	struct SubMaterial
+	{
+		std::string name;
+		std::string bitmap;
+
+		float uOffset = 0;
+		float vOffset = 0;
+		float uScale = 1;
+		float vScale = 1;
+		float uvAngle = 0;
+
+		// Index into _surfaces, assigned when the first triangle is using it
+		std::size_t surface = NO_SURFACE;
+	};
+
+	static const std::size_t NO_SURFACE = static_cast<std::size_t>(-1);
+
+	class Tokeniser;
+	std::unique_ptr<Tokeniser> _tok;
+
+	// Material id => submaterial id => submaterial
+	std::map<int, std::map<int, std::size_t>> _materials;
+	std::deque<SubMaterial> _subMaterials;
+
+	// The mesh being parsed
+	std::vector<Vertex> _vertices;
+	std::vector<Vector2> _texcoords;
+	std::vector<Vector3> _colours;
+	std::vector<Face> _faces;
+
+	// Running number of all vertices in the file
+	std::size_t _nextVertexId;
+
+	std::vector<std::unique_ptr<ModelSurfaceBuilder>> _surfaces;
+
+public:
+	AseParser(const char* data, std::size_t length);
+	~AseParser();
+
+	// Parses the model, throws parser::ParseException on failure
+	std::vector<ParsedModelSurface> parse();
+
+private:
+	std::size_t parseCount(const char* element);
+	void parseMaterial();
+	void parseFace();
+	// Reads the three indices of a texture or colour face into the given slot of Face::indices
+	void parseIndexTriple(int offset, const char* element);
+
+	// Adds the triangles of the current mesh to the surfaces and clears it
+	void submitMesh();
+
+	SubMaterial* findSubMaterial(int materialId, int subMaterialId);
+	void addSubMaterial(int materialId, int subMaterialId, SubMaterial&& subMaterial);
+
+	// Derives a material name from the given bitmap path, as found below a "doom" or "quake" folder
+	static std::string getNameFromBitmap(const std::string& bitmap);
+};
+
+} // namespace model
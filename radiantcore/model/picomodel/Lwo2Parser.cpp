@@ -0,0 +1,652 @@
+#include "Lwo2Parser.h"
+
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <fmt/format.h>
+#include "itextstream.h"
+#include "parser/ParseException.h"
+#include "string/replace.h"
+
+namespace model
+{
+
+namespace
+{
+	constexpr std::uint32_t makeId(char a, char b, char c, char d)
+	{
+		return static_cast<std::uint32_t>(a) << 24 | static_cast<std::uint32_t>(b) << 16 |
+			static_cast<std::uint32_t>(c) << 8 | static_cast<std::uint32_t>(d);
+	}
+
+	const std::uint32_t ID_FORM = makeId('F', 'O', 'R', 'M');
+	const std::uint32_t ID_LWO2 = makeId('L', 'W', 'O', '2');
+	const std::uint32_t ID_LAYR = makeId('L', 'A', 'Y', 'R');
+	const std::uint32_t ID_PNTS = makeId('P', 'N', 'T', 'S');
+	const std::uint32_t ID_POLS = makeId('P', 'O', 'L', 'S');
+	const std::uint32_t ID_FACE = makeId('F', 'A', 'C', 'E');
+	const std::uint32_t ID_PTAG = makeId('P', 'T', 'A', 'G');
+	const std::uint32_t ID_SURF = makeId('S', 'U', 'R', 'F');
+	const std::uint32_t ID_TAGS = makeId('T', 'A', 'G', 'S');
+	const std::uint32_t ID_VMAP = makeId('V', 'M', 'A', 'P');
+	const std::uint32_t ID_BBOX = makeId('B', 'B', 'O', 'X');
+	const std::uint32_t ID_TXUV = makeId('T', 'X', 'U', 'V');
+	const std::uint32_t ID_RGBA = makeId('R', 'G', 'B', 'A');
+	const std::uint32_t ID_COLR = makeId('C', 'O', 'L', 'R');
+	const std::uint32_t ID_DIFF = makeId('D', 'I', 'F', 'F');
+
+	// Welding tolerances, vertices are looked up in cells of the XYZ epsilon
+	const float XYZ_EPSILON = 0.01f;
+	const float ST_EPSILON = 0.0001f;
+	const float NORMAL_EPSILON = 0.02f;
+	const float CELLS_PER_UNIT = 1.f / XYZ_EPSILON;
+
+	inline unsigned char toByte(float value)
+	{
+		return value <= 0 ? 0 : value >= 255 ? 255 : static_cast<unsigned char>(value);
+	}
+
+	struct Cell
+	{
+		double x, y, z;
+
+		bool operator==(const Cell& other) const
+		{
+			return x == other.x && y == other.y && z == other.z;
+		}
+	};
+
+	struct CellHash
+	{
+		std::size_t operator()(const Cell& cell) const
+		{
+			std::hash<double> hasher;
+			std::size_t seed = hasher(cell.x);
+			seed ^= hasher(cell.y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			seed ^= hasher(cell.z) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			return seed;
+		}
+	};
+}
+
+/**
+ * Bounds-checked big-endian reader of a range in the file buffer.
+ */
+class Lwo2Parser::Reader
+{
+private:
+	const unsigned char* _cur;
+	const unsigned char* _end;
+
+public:
+	Reader(const unsigned char* data, std::size_t length) :
+		_cur(data),
+		_end(data + length)
+	{}
+
+	std::size_t getRemaining() const
+	{
+		return static_cast<std::size_t>(_end - _cur);
+	}
+
+	bool atEnd() const
+	{
+		return _cur >= _end;
+	}
+
+	void require(std::size_t numBytes) const
+	{
+		if (getRemaining() < numBytes)
+		{
+			throw parser::ParseException("Unexpected end of LWO chunk");
+		}
+	}
+
+	void skip(std::size_t numBytes)
+	{
+		require(numBytes);
+		_cur += numBytes;
+	}
+
+	std::uint16_t getU2()
+	{
+		require(2);
+		std::uint16_t value = static_cast<std::uint16_t>(_cur[0] << 8 | _cur[1]);
+		_cur += 2;
+		return value;
+	}
+
+	std::uint32_t getU4()
+	{
+		require(4);
+		std::uint32_t value = static_cast<std::uint32_t>(_cur[0]) << 24 | static_cast<std::uint32_t>(_cur[1]) << 16 |
+			static_cast<std::uint32_t>(_cur[2]) << 8 | static_cast<std::uint32_t>(_cur[3]);
+		_cur += 4;
+		return value;
+	}
+
+	float getF4()
+	{
+		std::uint32_t bits = getU4();
+
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	// Variable-length index, 2 bytes or 4 bytes if the first one is 0xFF
+	std::size_t getVX()
+	{
+		require(2);
+
+		if (_cur[0] != 0xFF)
+		{
+			return getU2();
+		}
+
+		return getU4() & 0x00FFFFFF;
+	}
+
+	// Null-terminated string, padded to an even length
+	std::string getS0()
+	{
+		const unsigned char* terminator = static_cast<const unsigned char*>(std::memchr(_cur, 0, getRemaining()));
+
+		if (terminator == nullptr)
+		{
+			throw parser::ParseException("Unterminated string in LWO chunk");
+		}
+
+		std::string value(reinterpret_cast<const char*>(_cur), terminator - _cur);
+
+		std::size_t length = value.size() + 1;
+		skip(std::min(length + (length & 1), getRemaining()));
+
+		return value;
+	}
+
+	// Returns a reader for the next chunk of the given size, skipping its pad byte
+	Reader getChunk(std::size_t size)
+	{
+		require(size);
+		Reader chunk(_cur, size);
+
+		_cur += std::min(size + (size & 1), getRemaining());
+		return chunk;
+	}
+};
+
+Lwo2Parser::Lwo2Parser(const unsigned char* data, std::size_t length) :
+	_data(data),
+	_length(length),
+	_boundingBox{ 0, 0, 0, 0, 0, 0 }
+{}
+
+bool Lwo2Parser::isLwo2(const unsigned char* data, std::size_t length)
+{
+	if (length < 12) return false;
+
+	Reader header(data, length);
+
+	if (header.getU4() != ID_FORM) return false;
+
+	header.skip(4); // FORM size
+
+	return header.getU4() == ID_LWO2;
+}
+
+std::vector<ParsedModelSurface> Lwo2Parser::parse()
+{
+	parseChunks();
+	resolveVertexMaps();
+	resolveSurfaces();
+
+	// Use the bounding box if it has been stored in the file
+	float bounds[6];
+	std::memcpy(bounds, _boundingBox, sizeof(bounds));
+
+	if (!_points.empty() && std::all_of(bounds, bounds + 6, [](float f) { return f == 0.0f; }))
+	{
+		bounds[0] = bounds[1] = bounds[2] = 1e20f;
+		bounds[3] = bounds[4] = bounds[5] = -1e20f;
+
+		for (const Point& point : _points)
+		{
+			for (int i = 0; i < 3; ++i)
+			{
+				bounds[i] = std::min(bounds[i], point.position[i]);
+				bounds[i + 3] = std::max(bounds[i + 3], point.position[i]);
+			}
+		}
+	}
+
+	// Vertices without texture coordinates are projected along the two largest
+	// extents. The axes are indexing the swizzled positions, like picomodel does.
+	std::size_t stAxis[2] = { 0, 1 };
+	double stSize[2] = { 0, 0 };
+
+	for (std::size_t i = 0; i < 3; ++i)
+	{
+		float size = bounds[i + 3] - bounds[i];
+
+		if (size > stSize[0])
+		{
+			stAxis[1] = stAxis[0];
+			stAxis[0] = i;
+			stSize[1] = stSize[0];
+			stSize[0] = size;
+		}
+		else if (size > stSize[1])
+		{
+			stAxis[1] = i;
+			stSize[1] = size;
+		}
+	}
+
+	double stScale[2] = { 4.f / stSize[0], 4.f / stSize[1] };
+
+	std::vector<ParsedModelSurface> surfaces;
+	surfaces.reserve(_surfaces.size());
+
+	for (const Surface& surface : _surfaces)
+	{
+		surfaces.emplace_back(buildSurface(surface, stAxis, stScale));
+	}
+
+	return surfaces;
+}
+
+void Lwo2Parser::parseChunks()
+{
+	Reader file(_data, _length);
+
+	if (file.getRemaining() < 12 || file.getU4() != ID_FORM)
+	{
+		throw parser::ParseException("Not an IFF file");
+	}
+
+	std::size_t formSize = file.getU4();
+
+	if (file.getU4() != ID_LWO2)
+	{
+		throw parser::ParseException("Not an LWO2 file");
+	}
+
+	// Tolerate a FORM size exceeding the file
+	Reader form = file.getChunk(std::min(formSize - 4, file.getRemaining()));
+
+	std::size_t numLayers = 0;
+	std::size_t pointOffset = 0;
+	std::size_t polygonOffset = 0;
+	std::size_t tagOffset = 0;
+
+	while (form.getRemaining() >= 8)
+	{
+		std::uint32_t id = form.getU4();
+		std::size_t size = form.getU4();
+
+		Reader chunk = form.getChunk(size);
+
+		// Surfaces and tags are shared by all layers
+		if (id == ID_TAGS)
+		{
+			tagOffset = _tags.size();
+
+			while (!chunk.atEnd())
+			{
+				_tags.emplace_back(chunk.getS0());
+			}
+			continue;
+		}
+
+		if (id == ID_SURF)
+		{
+			parseSurface(chunk);
+			continue;
+		}
+
+		if (id == ID_LAYR)
+		{
+			++numLayers;
+			continue;
+		}
+
+		// Geometry of other layers than the first one is ignored
+		if (numLayers > 1) continue;
+
+		if (id == ID_PNTS)
+		{
+			parsePoints(chunk, pointOffset);
+		}
+		else if (id == ID_POLS)
+		{
+			parsePolygons(chunk, pointOffset, polygonOffset);
+		}
+		else if (id == ID_PTAG)
+		{
+			parsePolygonTags(chunk, polygonOffset, tagOffset);
+		}
+		else if (id == ID_VMAP)
+		{
+			parseVertexMap(chunk);
+		}
+		else if (id == ID_BBOX)
+		{
+			for (float& value : _boundingBox)
+			{
+				value = chunk.getF4();
+			}
+		}
+	}
+
+	if (numLayers > 1)
+	{
+		rWarning() << "LWO loader discards any geometry data not in Layer 1 (" << numLayers << " layers found)" << std::endl;
+	}
+}
+
+void Lwo2Parser::parsePoints(Reader& chunk, std::size_t& pointOffset)
+{
+	std::size_t numPoints = chunk.getRemaining() / 12;
+
+	pointOffset = _points.size();
+	_points.resize(pointOffset + numPoints);
+
+	for (std::size_t i = pointOffset; i < _points.size(); ++i)
+	{
+		_points[i].position[0] = chunk.getF4();
+		_points[i].position[1] = chunk.getF4();
+		_points[i].position[2] = chunk.getF4();
+	}
+}
+
+void Lwo2Parser::parsePolygons(Reader& chunk, std::size_t pointOffset, std::size_t& polygonOffset)
+{
+	if (chunk.atEnd()) return;
+
+	std::uint32_t type = chunk.getU4();
+
+	polygonOffset = _polygons.size();
+
+	while (!chunk.atEnd())
+	{
+		// The upper six bits are flags
+		std::size_t numVertices = chunk.getU2() & 0x03FF;
+
+		_polygons.push_back(Polygon{ type, _polygonVertices.size(), numVertices, 0 });
+
+		for (std::size_t i = 0; i < numVertices; ++i)
+		{
+			std::size_t index = chunk.getVX() + pointOffset;
+
+			if (index >= _points.size())
+			{
+				throw parser::ParseException(fmt::format("Polygon vertex index {0} out of bounds", index));
+			}
+
+			_polygonVertices.push_back(index);
+		}
+	}
+}
+
+void Lwo2Parser::parsePolygonTags(Reader& chunk, std::size_t polygonOffset, std::size_t tagOffset)
+{
+	// Only the surface tags are of interest
+	if (chunk.getU4() != ID_SURF) return;
+
+	while (!chunk.atEnd())
+	{
+		std::size_t polygon = chunk.getVX() + polygonOffset;
+		std::size_t tag = chunk.getVX() + tagOffset;
+
+		if (polygon >= _polygons.size())
+		{
+			throw parser::ParseException(fmt::format("Polygon index {0} out of bounds", polygon));
+		}
+
+		_polygons[polygon].tag = tag;
+	}
+}
+
+void Lwo2Parser::parseVertexMap(Reader& chunk)
+{
+	std::uint32_t type = chunk.getU4();
+	std::size_t dimension = chunk.getU2();
+	chunk.getS0();
+
+	// The values of other maps and of maps with too few dimensions are never used
+	bool isUsed = (type == ID_TXUV && dimension >= 2) || (type == ID_RGBA && dimension >= 4);
+
+	if (!isUsed) return;
+
+	while (!chunk.atEnd())
+	{
+		VertexMapValue value{ type, chunk.getVX(), { 0, 0, 0, 0 } };
+
+		for (std::size_t i = 0; i < dimension; ++i)
+		{
+			float component = chunk.getF4();
+
+			if (i < 4) value.values[i] = component;
+		}
+
+		_vertexMapValues.push_back(value);
+	}
+}
+
+void Lwo2Parser::parseSurface(Reader& chunk)
+{
+	Surface surface;
+	surface.name = chunk.getS0();
+	chunk.getS0(); // source name
+
+	while (chunk.getRemaining() >= 6)
+	{
+		std::uint32_t id = chunk.getU4();
+		std::size_t size = chunk.getU2();
+
+		Reader subChunk = chunk.getChunk(size);
+
+		if (id == ID_COLR)
+		{
+			surface.colour[0] = subChunk.getF4();
+			surface.colour[1] = subChunk.getF4();
+			surface.colour[2] = subChunk.getF4();
+		}
+		else if (id == ID_DIFF)
+		{
+			surface.diffuse = subChunk.getF4();
+		}
+	}
+
+	_surfaces.emplace_back(std::move(surface));
+}
+
+void Lwo2Parser::resolveVertexMaps()
+{
+	// Later values are taking precedence
+	for (const VertexMapValue& value : _vertexMapValues)
+	{
+		if (value.point >= _points.size())
+		{
+			throw parser::ParseException(fmt::format("Vertex map point index {0} out of bounds", value.point));
+		}
+
+		Point& point = _points[value.point];
+
+		if (value.type == ID_TXUV)
+		{
+			point.texcoord = value.values;
+		}
+		else
+		{
+			point.colour = value.values;
+		}
+	}
+}
+
+void Lwo2Parser::resolveSurfaces()
+{
+	// Polygons don't have a surface if there are no tags
+	if (_tags.empty()) return;
+
+	const std::size_t NO_SURFACE = static_cast<std::size_t>(-1);
+	std::vector<std::size_t> tagSurfaces(_tags.size(), NO_SURFACE);
+
+	for (std::size_t i = 0; i < _tags.size(); ++i)
+	{
+		for (std::size_t s = 0; s < _surfaces.size(); ++s)
+		{
+			if (_surfaces[s].name == _tags[i])
+			{
+				tagSurfaces[i] = s;
+				break;
+			}
+		}
+	}
+
+	// Tags without a surface definition get a default surface
+	for (std::size_t i = 0; i < _polygons.size(); ++i)
+	{
+		std::size_t tag = _polygons[i].tag;
+
+		if (tag >= _tags.size())
+		{
+			throw parser::ParseException(fmt::format("Polygon tag {0} out of bounds", tag));
+		}
+
+		if (tagSurfaces[tag] == NO_SURFACE)
+		{
+			tagSurfaces[tag] = _surfaces.size();
+
+			_surfaces.emplace_back();
+			_surfaces.back().name = _tags[tag];
+		}
+
+		_surfaces[tagSurfaces[tag]].polygons.push_back(i);
+	}
+}
+
+ParsedModelSurface Lwo2Parser::buildSurface(const Surface& surface, const std::size_t stAxis[2], const double stScale[2])
+{
+	ModelSurfaceBuilder builder(getShaderName(surface.name));
+	builder.reserve(surface.polygons.size() * 3, surface.polygons.size() * 3);
+
+	// Alpha of the vertices, not part of ArbitraryMeshVertex but used for welding
+	std::vector<unsigned char> alphas;
+	alphas.reserve(surface.polygons.size() * 3);
+
+	// Vertex indices per cell, newer vertices are preferred
+	std::unordered_map<Cell, std::vector<unsigned int>, CellHash> cells;
+	cells.reserve(surface.polygons.size() * 3);
+
+	std::size_t numDiscarded = 0;
+
+	for (std::size_t p : surface.polygons)
+	{
+		const Polygon& polygon = _polygons[p];
+
+		// Only triangles of the FACE type are supported
+		if (polygon.type != ID_FACE || polygon.numVertices != 3)
+		{
+			++numDiscarded;
+			continue;
+		}
+
+		for (std::size_t v = 0; v < 3; ++v)
+		{
+			const Point& point = _points[_polygonVertices[polygon.firstVertex + v]];
+
+			ArbitraryMeshVertex vertex;
+			vertex.vertex = Vector3(point.position[0], point.position[2], point.position[1]);
+			vertex.normal = Vector3(0, 0, 0);
+
+			if (point.texcoord != nullptr)
+			{
+				vertex.texcoord = TexCoord2f(point.texcoord[0], 1.f - point.texcoord[1]);
+			}
+			else
+			{
+				vertex.texcoord = TexCoord2f(vertex.vertex[stAxis[0]] * stScale[0], vertex.vertex[stAxis[1]] * stScale[1]);
+			}
+
+			unsigned char rgba[4];
+
+			for (int i = 0; i < 3; ++i)
+			{
+				rgba[i] = toByte(point.colour != nullptr ?
+					point.colour[i] * surface.colour[i] * surface.diffuse * 0xFF :
+					surface.colour[i] * surface.diffuse * 0xFF);
+			}
+
+			rgba[3] = point.colour != nullptr ? toByte(point.colour[3] * 0xFF) : 0xFF;
+
+			vertex.colour = Vector3(rgba[0] / 255.0f, rgba[1] / 255.0f, rgba[2] / 255.0f);
+
+			Cell cell{
+				std::floor(vertex.vertex.x() * CELLS_PER_UNIT),
+				std::floor(vertex.vertex.y() * CELLS_PER_UNIT),
+				std::floor(vertex.vertex.z() * CELLS_PER_UNIT)
+			};
+
+			auto& candidates = cells[cell];
+			auto existing = std::find_if(candidates.rbegin(), candidates.rend(), [&](unsigned int index)
+			{
+				const ArbitraryMeshVertex& other = builder.getVertex(index);
+
+				return std::abs(vertex.vertex.x() - other.vertex.x()) <= XYZ_EPSILON &&
+					std::abs(vertex.vertex.y() - other.vertex.y()) <= XYZ_EPSILON &&
+					std::abs(vertex.vertex.z() - other.vertex.z()) <= XYZ_EPSILON &&
+					std::abs(vertex.normal.x() - other.normal.x()) <= NORMAL_EPSILON &&
+					std::abs(vertex.normal.y() - other.normal.y()) <= NORMAL_EPSILON &&
+					std::abs(vertex.normal.z() - other.normal.z()) <= NORMAL_EPSILON &&
+					std::abs(vertex.texcoord.x() - other.texcoord.x()) <= ST_EPSILON &&
+					std::abs(vertex.texcoord.y() - other.texcoord.y()) <= ST_EPSILON &&
+					vertex.colour == other.colour && alphas[index] == rgba[3];
+			});
+
+			if (existing != candidates.rend())
+			{
+				builder.addIndex(*existing);
+				continue;
+			}
+
+			unsigned int index = builder.addVertex(vertex, 0);
+			alphas.push_back(rgba[3]);
+			candidates.push_back(index);
+
+			builder.addIndex(index);
+		}
+	}
+
+	if (numDiscarded > 0)
+	{
+		rWarning() << "LWO loader discarded " << numDiscarded << " polygons of surface " <<
+			surface.name << " which are not triangles of the FACE type" << std::endl;
+	}
+
+	return builder.finish();
+}
+
+std::string Lwo2Parser::getShaderName(const std::string& surfaceName)
+{
+	// Cut off anything after the first whitespace
+	std::string name = surfaceName.substr(0, surfaceName.find_first_of(" \t\r\n\v\f"));
+
+	// Strip the extension, a period in the last character doesn't count
+	for (std::size_t i = name.size() >= 2 ? name.size() - 1 : 0; i-- > 0;)
+	{
+		if (name[i] == '/' || name[i] == '\\') break;
+
+		if (name[i] == '.')
+		{
+			name.resize(i);
+			break;
+		}
+	}
+
+	return string::replace_all_copy(name, "\\", "/");
+}
+
+} // namespace model
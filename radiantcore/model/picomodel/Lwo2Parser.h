@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include "ModelSurfaceBuilder.h"
+
+namespace model
+{
+
+/**
+ * Parser for LightWave objects in the LWO2 format, reading the file buffer
+ * straight into the vertex and index arrays of the model surfaces.
+ *
+ * Only the information used by picomodel's LWO module is evaluated: the
+ * triangles of the first layer, the TXUV and RGBA vertex maps and the colour
+ * of the surfaces. Vertices are welded within a small epsilon, like picomodel
+ * does. Older LWOB files are not supported, parse() throws on these.
+ */
+class Lwo2Parser
+{
+private:
+	class Reader;
+
+	struct Surface
+	{
+		std::string name;
+
+		float colour[3] = { 0.78431f, 0.78431f, 0.78431f };
+		float diffuse = 1.0f;
+
+		// The polygons using this surface
+		std::vector<std::size_t> polygons;
+	};
+
+	struct Polygon
+	{
+		std::uint32_t type;
+
+		// Range in _polygonVertices
+		std::size_t firstVertex;
+		std::size_t numVertices;
+
+		std::size_t tag;
+	};
+
+	struct Point
+	{
+		float position[3];
+
+		// Values of the TXUV and RGBA vertex maps, if assigned
+		const float* texcoord = nullptr;
+		const float* colour = nullptr;
+	};
+
+	const unsigned char* _data;
+	std::size_t _length;
+
+	// Geometry of the first layer
+	std::vector<Point> _points;
+	std::vector<Polygon> _polygons;
+	std::vector<std::size_t> _polygonVertices;
+	float _boundingBox[6];
+
+	std::vector<std::string> _tags;
+	std::vector<Surface> _surfaces;
+
+	// Vertex map values in the order of the file, referenced by _points
+	struct VertexMapValue
+	{
+		std::uint32_t type;
+		std::size_t point;
+		float values[4];
+	};
+	std::vector<VertexMapValue> _vertexMapValues;
+
+public:
+	Lwo2Parser(const unsigned char* data, std::size_t length);
+
+	// Parses the model, throws parser::ParseException on failure
+	std::vector<ParsedModelSurface> parse();
+
+	// Returns true if the given buffer is starting with an LWO2 header
+	static bool isLwo2(const unsigned char* data, std::size_t length);
+
+private:
+	void parseChunks();
+	void parsePoints(Reader& chunk, std::size_t& pointOffset);
+	void parsePolygons(Reader& chunk, std::size_t pointOffset, std::size_t& polygonOffset);
+	void parsePolygonTags(Reader& chunk, std::size_t polygonOffset, std::size_t tagOffset);
+	void parseVertexMap(Reader& chunk);
+	void parseSurface(Reader& chunk);
+
+	// Assigns the polygons to the surfaces, adding surfaces for tags without one
+	void resolveSurfaces();
+	void resolveVertexMaps();
+
+	ParsedModelSurface buildSurface(const Surface& surface, const std::size_t stAxis[2], const double stScale[2]);
+
+	// Returns the material name used for the given surface name
+	static std::string getShaderName(const std::string& surfaceName);
+};
+
+} // namespace model
@@ -0,0 +1,218 @@
+#include "ModelSurfaceBuilder.h"
+
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace model
+{
+
+namespace
+{
+	// Initial bucket count of the vertex lookup, it grows as needed
+	const std::size_t INITIAL_BUCKET_COUNT = 64;
+
+	// Normals deviating from unit length by more than this are replaced
+	const double NORMAL_UNIT_LENGTH_EPSILON = 0.01;
+
+	inline void combineHash(std::size_t& seed, double value)
+	{
+		// Make sure 0.0 and -0.0 end up in the same bucket
+		if (value == 0) value = 0;
+
+		std::uint64_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		seed ^= std::hash<std::uint64_t>()(bits) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+
+	// Position and smoothing group of a vertex
+	struct SmoothVertex
+	{
+		const Vector3& position;
+		std::uint64_t smoothingGroup;
+
+		bool operator==(const SmoothVertex& other) const
+		{
+			return position == other.position && smoothingGroup == other.smoothingGroup;
+		}
+	};
+
+	struct SmoothVertexHash
+	{
+		std::size_t operator()(const SmoothVertex& v) const
+		{
+			std::size_t seed = std::hash<std::uint64_t>()(v.smoothingGroup);
+
+			combineHash(seed, v.position.x());
+			combineHash(seed, v.position.y());
+			combineHash(seed, v.position.z());
+
+			return seed;
+		}
+	};
+
+	inline double normaliseVector(Vector3& vec)
+	{
+		double length = std::sqrt(vec.x() * vec.x() + vec.y() * vec.y() + vec.z() * vec.z());
+
+		if (length > 0)
+		{
+			vec /= length;
+		}
+
+		return length;
+	}
+}
+
+std::size_t ModelSurfaceBuilder::VertexHash::operator()(unsigned int index) const
+{
+	const ArbitraryMeshVertex& v = _builder._surface.vertices[index];
+	std::size_t seed = std::hash<std::uint64_t>()(_builder._smoothingGroups[index]);
+
+	combineHash(seed, v.vertex.x());
+	combineHash(seed, v.vertex.y());
+	combineHash(seed, v.vertex.z());
+	combineHash(seed, v.texcoord.x());
+	combineHash(seed, v.texcoord.y());
+
+	return seed;
+}
+
+bool ModelSurfaceBuilder::VertexEqual::operator()(unsigned int a, unsigned int b) const
+{
+	const ArbitraryMeshVertex& first = _builder._surface.vertices[a];
+	const ArbitraryMeshVertex& second = _builder._surface.vertices[b];
+
+	return _builder._smoothingGroups[a] == _builder._smoothingGroups[b] &&
+		first.vertex == second.vertex &&
+		first.normal == second.normal &&
+		first.texcoord == second.texcoord &&
+		first.colour == second.colour;
+}
+
+ModelSurfaceBuilder::ModelSurfaceBuilder(const std::string& material, const std::string& bitmap) :
+	_uniqueVertices(INITIAL_BUCKET_COUNT, VertexHash(*this), VertexEqual(*this))
+{
+	_surface.material = material;
+	_surface.bitmap = bitmap;
+}
+
+void ModelSurfaceBuilder::reserve(std::size_t numVertices, std::size_t numIndices)
+{
+	_surface.vertices.reserve(numVertices);
+	_smoothingGroups.reserve(numVertices);
+	_surface.indices.reserve(numIndices);
+}
+
+std::size_t ModelSurfaceBuilder::getNumVertices() const
+{
+	return _surface.vertices.size();
+}
+
+const ArbitraryMeshVertex& ModelSurfaceBuilder::getVertex(std::size_t index) const
+{
+	return _surface.vertices[index];
+}
+
+unsigned int ModelSurfaceBuilder::addVertex(const ArbitraryMeshVertex& vertex, std::uint64_t smoothingGroup)
+{
+	_surface.vertices.push_back(vertex);
+	_smoothingGroups.push_back(smoothingGroup);
+
+	return static_cast<unsigned int>(_surface.vertices.size() - 1);
+}
+
+unsigned int ModelSurfaceBuilder::addUniqueVertex(const ArbitraryMeshVertex& vertex, std::uint64_t smoothingGroup)
+{
+	// Add the vertex right away, the lookup is working on the vertex indices
+	unsigned int index = addVertex(vertex, smoothingGroup);
+
+	auto result = _uniqueVertices.insert(index);
+
+	if (!result.second)
+	{
+		// There's an equal vertex already, remove the new one again
+		_surface.vertices.pop_back();
+		_smoothingGroups.pop_back();
+
+		return *result.first;
+	}
+
+	return index;
+}
+
+void ModelSurfaceBuilder::addIndex(unsigned int index)
+{
+	_surface.indices.push_back(index);
+}
+
+ParsedModelSurface ModelSurfaceBuilder::finish()
+{
+	auto& vertices = _surface.vertices;
+	const auto& indices = _surface.indices;
+
+	std::vector<Vector3> normals(vertices.size(), Vector3(0, 0, 0));
+
+	// Sum up the (area-weighted) triangle normals of each vertex
+	for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		const Vector3& a = vertices[indices[i]].vertex;
+		const Vector3& b = vertices[indices[i + 1]].vertex;
+		const Vector3& c = vertices[indices[i + 2]].vertex;
+
+		Vector3 weightedNormal = (c - a).crossProduct(b - a);
+
+		normals[indices[i]] += weightedNormal;
+		normals[indices[i + 1]] += weightedNormal;
+		normals[indices[i + 2]] += weightedNormal;
+	}
+
+	// Vertices at the same position in the same smoothing group share their normal
+	std::unordered_map<SmoothVertex, std::size_t, SmoothVertexHash> sharedNormals;
+	sharedNormals.reserve(vertices.size());
+
+	std::vector<std::size_t> sharedIndices(vertices.size());
+
+	for (std::size_t i = 0; i < vertices.size(); ++i)
+	{
+		auto result = sharedNormals.emplace(SmoothVertex{ vertices[i].vertex, _smoothingGroups[i] }, i);
+
+		if (!result.second)
+		{
+			normals[result.first->second] += normals[i];
+		}
+
+		sharedIndices[i] = result.first->second;
+	}
+
+	for (std::size_t i = 0; i < vertices.size(); ++i)
+	{
+		if (sharedIndices[i] == i)
+		{
+			normaliseVector(normals[i]);
+		}
+	}
+
+	for (std::size_t i = 0; i < vertices.size(); ++i)
+	{
+		const Vector3& generated = normals[sharedIndices[i]];
+		Vector3 normal = vertices[i].normal;
+
+		if (std::abs(normaliseVector(normal) - 1.0) >= NORMAL_UNIT_LENGTH_EPSILON ||
+			vertices[i].normal.dot(generated) <= 0)
+		{
+			vertices[i].normal = generated;
+		}
+	}
+
+	// The parsers reserve for the worst case, don't keep the excess capacity
+	vertices.shrink_to_fit();
+
+	_uniqueVertices.clear();
+	_smoothingGroups.clear();
+
+	return std::move(_surface);
+}
+
+} // namespace model
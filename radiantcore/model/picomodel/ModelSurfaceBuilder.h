@@ -0,0 +1,102 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_set>
+#include "render/ArbitraryMeshVertex.h"
+
+namespace model
+{
+
+/**
+ * A static model surface as read by the native ASE and LWO parsers,
+ * ready to be turned into a RenderablePicoSurface.
+ */
+struct ParsedModelSurface
+{
+	// The material name as found in the model file
+	std::string material;
+
+	// The path of the diffuse bitmap (ASE only)
+	std::string bitmap;
+
+	std::vector<ArbitraryMeshVertex> vertices;
+	std::vector<unsigned int> indices;
+};
+
+/**
+ * Assembles a ParsedModelSurface from the triangles read by a model parser.
+ * Identical vertices can be welded through a hash lookup, and the normals
+ * are post-processed the same way as picomodel's PicoFixSurfaceNormals does.
+ *
+ * The builder refers to itself in its vertex lookup, it can't be copied.
+ */
+class ModelSurfaceBuilder
+{
+private:
+	class VertexHash
+	{
+	private:
+		const ModelSurfaceBuilder& _builder;
+
+	public:
+		VertexHash(const ModelSurfaceBuilder& builder) :
+			_builder(builder)
+		{}
+
+		std::size_t operator()(unsigned int index) const;
+	};
+
+	class VertexEqual
+	{
+	private:
+		const ModelSurfaceBuilder& _builder;
+
+	public:
+		VertexEqual(const ModelSurfaceBuilder& builder) :
+			_builder(builder)
+		{}
+
+		bool operator()(unsigned int a, unsigned int b) const;
+	};
+
+	ParsedModelSurface _surface;
+
+	// Vertices sharing position and smoothing group get the same generated normal
+	std::vector<std::uint64_t> _smoothingGroups;
+
+	// The indices of all vertices added through addUniqueVertex()
+	std::unordered_set<unsigned int, VertexHash, VertexEqual> _uniqueVertices;
+
+public:
+	ModelSurfaceBuilder(const std::string& material, const std::string& bitmap = std::string());
+
+	ModelSurfaceBuilder(const ModelSurfaceBuilder& other) = delete;
+	ModelSurfaceBuilder& operator=(const ModelSurfaceBuilder& other) = delete;
+
+	void reserve(std::size_t numVertices, std::size_t numIndices);
+
+	std::size_t getNumVertices() const;
+	const ArbitraryMeshVertex& getVertex(std::size_t index) const;
+
+	// Adds the given vertex, returns its index
+	unsigned int addVertex(const ArbitraryMeshVertex& vertex, std::uint64_t smoothingGroup);
+
+	// Returns the index of an equal vertex of the same smoothing group
+	// added by an earlier call, or adds the given vertex
+	unsigned int addUniqueVertex(const ArbitraryMeshVertex& vertex, std::uint64_t smoothingGroup);
+
+	void addIndex(unsigned int index);
+
+	/**
+	 * Generates the normals of all vertices from the area-weighted triangle
+	 * normals, summed up for each position and smoothing group. The normals
+	 * defined by the model are kept if they are of unit length and point
+	 * in the same direction as the generated ones. Returns the surface,
+	 * the builder is empty afterwards.
+	 */
+	ParsedModelSurface finish();
+};
+
+} // namespace model
@@ -12,6 +12,13 @@
 
 #include "idatastream.h"
 #include "string/case_conv.h"
+#include "stream/ScopedArchiveBuffer.h"
+#include "parser/ParseException.h"
+
+#include "AseParser.h"
+#include "Lwo2Parser.h"
+
+#include <algorithm>
 
 namespace model {
 
@@ -23,8 +30,19 @@ namespace {
 		);
 	}
 
-	size_t picoInputStreamReam(void* inputStream, unsigned char* buffer, size_t length) {
-		return reinterpret_cast<InputStream*>(inputStream)->read(buffer, length);
+	// Position in the file buffer handed to picomodel
+	struct BufferCursor
+	{
+		const unsigned char* pos;
+		const unsigned char* end;
+	};
+
+	size_t picoBufferRead(void* cursor, unsigned char* buffer, size_t length) {
+		BufferCursor* bufferCursor = reinterpret_cast<BufferCursor*>(cursor);
+		length = std::min(length, static_cast<size_t>(bufferCursor->end - bufferCursor->pos));
+		std::copy(bufferCursor->pos, bufferCursor->pos + length, buffer);
+		bufferCursor->pos += length;
+		return length;
 	}
 } // namespace
 
@@ -90,31 +108,64 @@ IModelPtr PicoModelLoader::loadModelFromPath(const std::string& name)
 	string::to_lower(fName);
 	std::string fExt = fName.substr(fName.size() - 3, 3);
 
-	picoModel_t* model = PicoModuleLoadModelStream(
-		_module,
-		&file->getInputStream(),
-		picoInputStreamReam,
-		file->size(),
-		0
-	);
+	// Read the whole file, the parsers are working on the buffer
+	archive::ScopedArchiveBuffer buffer(*file);
 
-	// greebo: Check if the model load was successful
-	if (!model || model->numSurfaces == 0)
+	RenderablePicoModelPtr modelObj;
+
+	// ASE and LWO2 files are read by the native parsers, picomodel
+	// is used for all other formats and as fallback
+	if (fExt == "ase" || (fExt == "lwo" && Lwo2Parser::isLwo2(buffer.buffer, buffer.length)))
 	{
-		// Model is either NULL or has no surfaces, this must've failed
-		return IModelPtr();
+		try
+		{
+			std::vector<ParsedModelSurface> surfaces = fExt == "ase" ?
+				AseParser(reinterpret_cast<const char*>(buffer.buffer), buffer.length).parse() :
+				Lwo2Parser(buffer.buffer, buffer.length).parse();
+
+			// A model without surfaces is treated as failure
+			if (surfaces.empty())
+			{
+				return IModelPtr();
+			}
+
+			modelObj.reset(new RenderablePicoModel(std::move(surfaces), fExt));
+		}
+		catch (const parser::ParseException& ex)
+		{
+			rWarning() << "Failed to parse model " << name << ": " << ex.what() <<
+				", trying picomodel" << std::endl;
+		}
 	}
 
-	RenderablePicoModelPtr modelObj(
-		new RenderablePicoModel(model, fExt)
-	);
+	if (!modelObj)
+	{
+		BufferCursor cursor{ buffer.buffer, buffer.buffer + buffer.length };
+
+		picoModel_t* model = PicoModuleLoadModelStream(
+			_module,
+			&cursor,
+			picoBufferRead,
+			buffer.length,
+			0
+		);
+
+		// greebo: Check if the model load was successful
+		if (!model || model->numSurfaces == 0)
+		{
+			// Model is either NULL or has no surfaces, this must've failed
+			return IModelPtr();
+		}
+
+		modelObj.reset(new RenderablePicoModel(model, fExt));
+
+		PicoFreeModel(model);
+	}
 
 	// Set the filename
 	modelObj->setFilename(os::getFilename(file->getName()));
 	modelObj->setModelPath(name);
 
-	PicoFreeModel(model);
-
 	return modelObj;
 }
 
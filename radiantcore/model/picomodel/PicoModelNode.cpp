@@ -169,6 +169,9 @@ void PicoModelNode::skinChanged(const std::string& newSkinName)
     ModelSkin& skin = GlobalModelSkinCache().capture(_skin);
     _picoModel->applySkin(skin);
 
+    // The map statistics are counting the skins in use
+    statisticsChanged();
+
     // Refresh the scene (TODO: get rid of that)
     GlobalSceneGraph().sceneChanged();
 }
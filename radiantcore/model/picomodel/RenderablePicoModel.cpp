@@ -15,6 +15,53 @@
 namespace model
 {
 
+RenderablePicoModel::Surface::Surface(const RenderablePicoSurfacePtr& surface_) :
+    surface(surface_),
+    originalSurface(surface),
+    activeMaterial(surface->getDefaultMaterial()),
+    activeMaterialId(ModelSkin::NO_REMAP)
+{}
+
+int RenderablePicoModel::Surface::getNumVertices() const
+{
+    return surface->getNumVertices();
+}
+
+int RenderablePicoModel::Surface::getNumTriangles() const
+{
+    return surface->getNumTriangles();
+}
+
+const ArbitraryMeshVertex& RenderablePicoModel::Surface::getVertex(int vertexNum) const
+{
+    return surface->getVertex(vertexNum);
+}
+
+ModelPolygon RenderablePicoModel::Surface::getPolygon(int polygonNum) const
+{
+    return surface->getPolygon(polygonNum);
+}
+
+const std::string& RenderablePicoModel::Surface::getDefaultMaterial() const
+{
+    return surface->getDefaultMaterial();
+}
+
+const std::string& RenderablePicoModel::Surface::getActiveMaterial() const
+{
+    return activeMaterial;
+}
+
+const std::vector<ArbitraryMeshVertex>& RenderablePicoModel::Surface::getVertexArray() const
+{
+    return surface->getVertexArray();
+}
+
+const std::vector<unsigned int>& RenderablePicoModel::Surface::getIndexArray() const
+{
+    return surface->getIndexArray();
+}
+
 // Constructor
 RenderablePicoModel::RenderablePicoModel(picoModel_t* mod, const std::string& fExt) :
     _scaleTransformed(1,1,1),
@@ -47,6 +94,25 @@ RenderablePicoModel::RenderablePicoModel(picoModel_t* mod, const std::string& fE
     }
 }
 
+RenderablePicoModel::RenderablePicoModel(std::vector<ParsedModelSurface>&& surfaces, const std::string& fExt) :
+    _scaleTransformed(1,1,1),
+    _scale(1,1,1),
+    _undoStateSaver(nullptr),
+    _mapFileChangeTracker(nullptr)
+{
+    _surfVec.reserve(surfaces.size());
+
+    // The normals have been fixed by the parsers already
+    for (ParsedModelSurface& surface : surfaces)
+    {
+        RenderablePicoSurfacePtr rSurf(new RenderablePicoSurface(std::move(surface), fExt));
+
+        _surfVec.push_back(Surface(rSurf));
+
+        _localAABB.includeAABB(rSurf->getAABB());
+    }
+}
+
 RenderablePicoModel::RenderablePicoModel(const RenderablePicoModel& other) :
     _surfVec(other._surfVec.size()),
     _scaleTransformed(other._scaleTransformed),
@@ -57,13 +123,18 @@ RenderablePicoModel::RenderablePicoModel(const RenderablePicoModel& other) :
     _undoStateSaver(nullptr),
     _mapFileChangeTracker(nullptr)
 {
-    // Copy the other model's surfaces, but not its shaders, revert to default
+    // Share the other model's surfaces, but not its shaders, revert to default
     for (std::size_t i = 0; i < other._surfVec.size(); ++i)
     {
-        // Copy-construct the other surface, inheriting any applied scale
-        _surfVec[i].surface = std::make_shared<RenderablePicoSurface>(*(other._surfVec[i].surface));
-        _surfVec[i].originalSurface = other._surfVec[i].originalSurface;
-        _surfVec[i].surface->setActiveMaterial(_surfVec[i].surface->getDefaultMaterial());
+        const Surface& otherSurface = other._surfVec[i];
+
+        // Unscaled geometry is shared, a scaled surface gets its own working copy
+        _surfVec[i].surface = otherSurface.surface == otherSurface.originalSurface ?
+            otherSurface.originalSurface :
+            std::make_shared<RenderablePicoSurface>(*otherSurface.surface);
+
+        _surfVec[i].originalSurface = otherSurface.originalSurface;
+        _surfVec[i].activeMaterial = otherSurface.originalSurface->getDefaultMaterial();
     }
 }
 
@@ -214,40 +285,43 @@ int RenderablePicoModel::getPolyCount() const
 const IModelSurface& RenderablePicoModel::getSurface(unsigned surfaceNum) const
 {
     assert(surfaceNum >= 0 && surfaceNum < _surfVec.size());
-    return *(_surfVec[surfaceNum].surface);
+    return _surfVec[surfaceNum];
 }
 
 // Apply the given skin to this model
 void RenderablePicoModel::applySkin(const ModelSkin& skin)
 {
+    bool materialsChanged = false;
+
     // Apply the skin to each surface, then try to capture shaders
-    for (SurfaceList::iterator i = _surfVec.begin();
-         i != _surfVec.end();
-         ++i)
+    for (Surface& surface : _surfVec)
     {
-        const std::string& defaultMaterial = i->surface->getDefaultMaterial();
-        const std::string& activeMaterial = i->surface->getActiveMaterial();
+        std::size_t defaultMaterialId = surface.surface->getDefaultMaterialId();
 
-        // Look up the remap for this surface's material name. If there is a remap
-        // change the Shader* to point to the new shader.
-        std::string remap = skin.getRemap(defaultMaterial);
+        // Look up the remap for this surface's material, if there is none
+        // the surface reverts to its original unskinned material
+        std::size_t materialId = skin.getRemapId(defaultMaterialId);
 
-        if (!remap.empty() && remap != activeMaterial)
+        if (materialId == ModelSkin::NO_REMAP)
         {
-            // Save the remapped shader name
-            i->surface->setActiveMaterial(remap);
+            materialId = defaultMaterialId;
         }
-        else if (remap.empty() && activeMaterial != defaultMaterial)
+
+        if (materialId != surface.activeMaterialId)
         {
-            // No remap, so reset our shader to the original unskinned shader
-            i->surface->setActiveMaterial(defaultMaterial);
+            surface.activeMaterialId = materialId;
+            surface.activeMaterial = GlobalModelSkinCache().getMaterialName(materialId);
+            materialsChanged = true;
         }
     }
 
-    captureShaders();
+    if (materialsChanged)
+    {
+        captureShaders();
 
-    // greebo: Update the active material list after applying this skin
-    updateMaterialList();
+        // greebo: Update the active material list after applying this skin
+        updateMaterialList();
+    }
 }
 
 void RenderablePicoModel::captureShaders()
@@ -259,7 +333,7 @@ void RenderablePicoModel::captureShaders()
     {
         if (renderSystem)
         {
-            i->shader = renderSystem->capture(i->surface->getActiveMaterial());
+            i->shader = renderSystem->capture(i->activeMaterial);
         }
         else
         {
@@ -275,7 +349,7 @@ void RenderablePicoModel::updateMaterialList() const
 
     for (const auto& s : _surfVec)
     {
-        _materialList.push_back(s.surface->getActiveMaterial());
+        _materialList.push_back(s.activeMaterial);
     }
 }
 
@@ -380,6 +454,14 @@ void RenderablePicoModel::applyScaleToSurfaces()
     // Apply the scale to each surface
     for (Surface& surf : _surfVec)
     {
+        // Unscaled models go back to sharing the original geometry
+        if (_scaleTransformed == Vector3(1, 1, 1))
+        {
+            surf.surface = surf.originalSurface;
+            _localAABB.includeAABB(surf.surface->getAABB());
+            continue;
+        }
+
         // Are we still using the original surface? If yes,
         // it's now time to create a working copy
         if (surf.surface == surf.originalSurface)
@@ -6,6 +6,8 @@
 #include "lib/picomodel.h"
 #include "math/AABB.h"
 #include "imodelsurface.h"
+#include "modelskin.h"
+#include "ModelSurfaceBuilder.h"
 
 #include <memory>
 
@@ -31,6 +33,9 @@ namespace model
  * each of which contains a number of polygons with the same texture. Rendering
  * a RenderablePicoModel involves rendering all of its surfaces, submitting 
  * their geometry via OpenGL calls.
+ *
+ * All instances of the same model file share the same surfaces (and their
+ * GL buffers), the skin and scale are applied per instance.
  */
 class RenderablePicoModel : 
 	public IModel,
@@ -38,26 +43,42 @@ class RenderablePicoModel :
 {
 private:
 	// greebo: RenderablePicoSurfaces are shared objects, the actual shaders 
-	// and the model skin handling are managed by the nodes/imodels referencing them
-	struct Surface
+	// and the model skin handling are managed by the nodes/imodels referencing them.
+	// This is the surface as seen from outside this model, i.e. with the skin applied.
+	struct Surface :
+		public IIndexedModelSurface
 	{
-		// The (shared) surface object
+		// The (shared) surface object, or a private copy if this model is scaled
 		RenderablePicoSurfacePtr surface;
 
 		// The (unmodified) surface object
 		RenderablePicoSurfacePtr originalSurface;
 
+		// The material with the skin remaps of this model applied
+		std::string activeMaterial;
+
+		// Skin cache id of the active material, NO_REMAP if not determined yet
+		std::size_t activeMaterialId;
+
 		// The shader this surface is using
 		ShaderPtr shader;
 
-		Surface()
+		Surface() :
+			activeMaterialId(ModelSkin::NO_REMAP)
 		{}
 
 		// Constructor
-		Surface(const RenderablePicoSurfacePtr& surface_) :
-			surface(surface_),
-			originalSurface(surface)
-		{}
+		Surface(const RenderablePicoSurfacePtr& surface_);
+
+		// IIndexedModelSurface implementation, delegating to the surface
+		int getNumVertices() const override;
+		int getNumTriangles() const override;
+		const ArbitraryMeshVertex& getVertex(int vertexNum) const override;
+		ModelPolygon getPolygon(int polygonNum) const override;
+		const std::string& getDefaultMaterial() const override;
+		const std::string& getActiveMaterial() const override;
+		const std::vector<ArbitraryMeshVertex>& getVertexArray() const override;
+		const std::vector<unsigned int>& getIndexArray() const override;
 	};
 
 	// List of RenderablePicoSurfaces.
@@ -115,9 +136,15 @@ public:
 	 */
 	RenderablePicoModel(picoModel_t* mod, const std::string& fExt);
 
+	/**
+	 * Constructor taking the surfaces read by the native ASE and LWO parsers.
+	 */
+	RenderablePicoModel(std::vector<ParsedModelSurface>&& surfaces, const std::string& fExt);
+
 	/**
 	 * Copy constructor: re-use the surfaces from the other model
 	 * but make it possible to assign custom skins to the surfaces.
+	 * The geometry is shared unless the other model has been scaled.
 	 */
 	RenderablePicoModel(const RenderablePicoModel& other);
 
@@ -6,6 +6,7 @@
 #include "math/Ray.h"
 #include "iselectiontest.h"
 #include "irenderable.h"
+#include "render/VBO.h"
 
 #include "string/replace.h"
 
@@ -15,41 +16,16 @@ namespace model {
 RenderablePicoSurface::RenderablePicoSurface(picoSurface_t* surf,
 											 const std::string& fExt)
 : _defaultMaterial(""),
-  _dlRegular(0),
-  _dlProgramVcol(0),
-  _dlProgramNoVCol(0)
+  _defaultMaterialId(ModelSkin::NO_REMAP),
+  _vertexBuffer(0),
+  _indexBuffer(0)
 {
-	// Get the shader from the picomodel struct. If this is a LWO model, use
-	// the material name to select the shader, while for an ASE model the
-	// bitmap path should be used.
+	// Get the shader from the picomodel struct
 	picoShader_t* shader = PicoGetSurfaceShader(surf);
-	std::string rawName = "";
 
 	if (shader != 0)
 	{
-		if (fExt == "lwo")
-		{
-			_defaultMaterial = PicoGetShaderName(shader);
-		}
-		else if (fExt == "ase")
-		{
-			rawName = PicoGetShaderName(shader);
-			std::string rawMapName = PicoGetShaderMapName(shader);
-			_defaultMaterial = cleanupShaderName(rawMapName);
-		}
-        else // if extension is not handled explicitly, use at least something
-        {
-            _defaultMaterial = PicoGetShaderName(shader);
-        }
-	}
-
-	// If shader not found, fallback to alternative if available
-	// _defaultMaterial is empty if the ase material has no BITMAP
-	// materialIsValid is false if _defaultMaterial is not an existing shader
-	if ((_defaultMaterial.empty() || !GlobalMaterialManager().materialExists(_defaultMaterial)) &&
-		!rawName.empty())
-	{
-		_defaultMaterial = cleanupShaderName(rawName);
+		determineDefaultMaterial(fExt, PicoGetShaderName(shader), PicoGetShaderMapName(shader));
 	}
 
 	// Capturing the shader happens later on when we have a RenderSystem reference
@@ -89,23 +65,36 @@ RenderablePicoSurface::RenderablePicoSurface(picoSurface_t* surf,
 
 	// Calculate the tangent and bitangent vectors
 	calculateTangents();
+}
+
+RenderablePicoSurface::RenderablePicoSurface(ParsedModelSurface&& surface, const std::string& fExt) :
+	_defaultMaterialId(ModelSkin::NO_REMAP),
+	_vertices(std::move(surface.vertices)),
+	_indices(std::move(surface.indices)),
+	_nIndices(static_cast<unsigned int>(_indices.size())),
+	_vertexBuffer(0),
+	_indexBuffer(0)
+{
+	determineDefaultMaterial(fExt, surface.material, surface.bitmap);
 
-	// Construct the DLs
-	createDisplayLists();
+	for (const ArbitraryMeshVertex& vertex : _vertices)
+	{
+		_localAABB.includePoint(vertex.vertex);
+	}
+
+	calculateTangents();
 }
 
 RenderablePicoSurface::RenderablePicoSurface(const RenderablePicoSurface& other) :
 	_defaultMaterial(other._defaultMaterial),
+	_defaultMaterialId(other._defaultMaterialId),
 	_vertices(other._vertices),
 	_indices(other._indices),
 	_nIndices(other._nIndices),
 	_localAABB(other._localAABB),
-	_dlRegular(0),
-	_dlProgramVcol(0),
-	_dlProgramNoVCol(0)
-{
-	createDisplayLists();
-}
+	_vertexBuffer(0),
+	_indexBuffer(0)
+{}
 
 std::string RenderablePicoSurface::cleanupShaderName(const std::string& inName)
 {
@@ -149,12 +138,37 @@ std::string RenderablePicoSurface::cleanupShaderName(const std::string& inName)
 	}
 }
 
-// Destructor. Release the GL display lists.
+void RenderablePicoSurface::determineDefaultMaterial(const std::string& fExt,
+	const std::string& shaderName, const std::string& mapName)
+{
+	// If this is a LWO model, use the material name to select the shader,
+	// while for an ASE model the bitmap path should be used.
+	std::string rawName = "";
+
+	if (fExt == "ase")
+	{
+		rawName = shaderName;
+		_defaultMaterial = cleanupShaderName(mapName);
+	}
+	else // LWO, or if extension is not handled explicitly, use at least something
+	{
+		_defaultMaterial = shaderName;
+	}
+
+	// If shader not found, fallback to alternative if available
+	// _defaultMaterial is empty if the ase material has no BITMAP
+	// materialIsValid is false if _defaultMaterial is not an existing shader
+	if ((_defaultMaterial.empty() || !GlobalMaterialManager().materialExists(_defaultMaterial)) &&
+		!rawName.empty())
+	{
+		_defaultMaterial = cleanupShaderName(rawName);
+	}
+}
+
+// Destructor. Release the GL buffer objects.
 RenderablePicoSurface::~RenderablePicoSurface()
 {
-	glDeleteLists(_dlRegular, 1);
-	glDeleteLists(_dlProgramNoVCol, 1);
-	glDeleteLists(_dlProgramVcol, 1);
+	releaseBuffers();
 }
 
 // Convert byte pointers to colour vector
@@ -197,92 +211,77 @@ void RenderablePicoSurface::calculateTangents() {
 // Back-end render function
 void RenderablePicoSurface::render(const RenderInfo& info) const
 {
-	// Invoke appropriate display list
-	if (info.checkFlag(RENDER_PROGRAM))
-    {
-        if (info.checkFlag(RENDER_VERTEX_COLOUR))
-        {
-            glCallList(_dlProgramVcol);
-        }
-        else
-        {
-            glCallList(_dlProgramNoVCol);
-        }
-	}
-	else
-    {
-		glCallList(_dlRegular);
+	if (_vertices.empty() || _indices.empty()) return;
+
+	if (_vertexBuffer == 0 || _indexBuffer == 0)
+	{
+		createBuffers();
 	}
-}
 
-// Construct a list for GLProgram mode, either with or without vertex colour
-GLuint RenderablePicoSurface::compileProgramList(bool includeColour)
-{
-    GLuint list = glGenLists(1);
-	assert(list != 0); // check if we run out of display lists
-    glNewList(list, GL_COMPILE);
+	typedef render::VertexTraits<ArbitraryMeshVertex> Traits;
+	const GLsizei STRIDE = sizeof(ArbitraryMeshVertex);
 
-	glBegin(GL_TRIANGLES);
-	for (Indices::const_iterator i = _indices.begin();
-		 i != _indices.end();
-		 ++i)
+	glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+
+	glVertexPointer(3, GL_DOUBLE, STRIDE, Traits::VERTEX_OFFSET());
+
+	// No colour changing, unless the vertex colours are requested below
+	glDisableClientState(GL_COLOR_ARRAY);
+
+	if (info.checkFlag(RENDER_PROGRAM))
 	{
-		// Get the vertex for this index
-		ArbitraryMeshVertex& v = _vertices[*i];
-
-		// Submit the vertex attributes and coordinate
-		if (GLEW_ARB_vertex_program)
-        {
-			glVertexAttrib2dvARB(ATTR_TEXCOORD, v.texcoord);
-			glVertexAttrib3dvARB(ATTR_TANGENT, v.tangent);
-			glVertexAttrib3dvARB(ATTR_BITANGENT, v.bitangent);
-			glVertexAttrib3dvARB(ATTR_NORMAL, v.normal);
+		// The attribute arrays are enabled by the program
+		glVertexAttribPointer(ATTR_TEXCOORD, 2, GL_DOUBLE, GL_FALSE, STRIDE, Traits::TEXCOORD_OFFSET());
+		glVertexAttribPointer(ATTR_TANGENT, 3, GL_DOUBLE, GL_FALSE, STRIDE, Traits::TANGENT_OFFSET());
+		glVertexAttribPointer(ATTR_BITANGENT, 3, GL_DOUBLE, GL_FALSE, STRIDE, Traits::BITANGENT_OFFSET());
+		glVertexAttribPointer(ATTR_NORMAL, 3, GL_DOUBLE, GL_FALSE, STRIDE, Traits::NORMAL_OFFSET());
+
+		if (info.checkFlag(RENDER_VERTEX_COLOUR))
+		{
+			glEnableClientState(GL_COLOR_ARRAY);
+			glColorPointer(3, GL_DOUBLE, STRIDE,
+				reinterpret_cast<const void*>(offsetof(ArbitraryMeshVertex, colour)));
 		}
+	}
+	else
+	{
+		// The normal array is enabled by the shader pass if lighting is active
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(2, GL_DOUBLE, STRIDE, Traits::TEXCOORD_OFFSET());
+		glNormalPointer(GL_DOUBLE, STRIDE, Traits::NORMAL_OFFSET());
+	}
 
-        // Optional vertex colour
-        if (includeColour)
-        {
-            glColor3dv(v.colour);
-        }
+	glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(_indices.size()), GL_UNSIGNED_INT, nullptr);
 
-        // Submit the vertex itself
-		glVertex3dv(v.vertex);
+	if (info.checkFlag(RENDER_PROGRAM))
+	{
+		glDisableClientState(GL_COLOR_ARRAY);
+	}
+	else
+	{
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 	}
-	glEnd();
-
-	glEndList();
 
-    return list;
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
-// Construct the two display lists
-void RenderablePicoSurface::createDisplayLists()
+void RenderablePicoSurface::createBuffers() const
 {
-	// Generate the lists for lighting mode
-    _dlProgramNoVCol = compileProgramList(false);
-    _dlProgramVcol = compileProgramList(true);
-
-	// Generate the list for flat-shaded (unlit) mode
-	_dlRegular = glGenLists(1);
-	assert(_dlRegular != 0); // check if we run out of display lists
-	glNewList(_dlRegular, GL_COMPILE);
+	releaseBuffers();
 
-	glBegin(GL_TRIANGLES);
-	for (Indices::const_iterator i = _indices.begin();
-		 i != _indices.end();
-		 ++i)
-	{
-		// Get the vertex for this index
-		ArbitraryMeshVertex& v = _vertices[*i];
+	_vertexBuffer = render::makeVBOFromArray(GL_ARRAY_BUFFER, _vertices);
+	_indexBuffer = render::makeVBOFromArray(GL_ELEMENT_ARRAY_BUFFER, _indices);
 
-		// Submit attributes
-		glNormal3dv(v.normal);
-		glTexCoord2dv(v.texcoord);
-		glVertex3dv(v.vertex);
-	}
-	glEnd();
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
 
-	glEndList();
+void RenderablePicoSurface::releaseBuffers() const
+{
+	render::deleteVBO(_vertexBuffer);
+	render::deleteVBO(_indexBuffer);
 }
 
 // Perform selection test for this surface
@@ -361,16 +360,22 @@ const std::string& RenderablePicoSurface::getDefaultMaterial() const
 void RenderablePicoSurface::setDefaultMaterial(const std::string& defaultMaterial)
 {
 	_defaultMaterial = defaultMaterial;
+	_defaultMaterialId = ModelSkin::NO_REMAP;
 }
 
-const std::string& RenderablePicoSurface::getActiveMaterial() const
+std::size_t RenderablePicoSurface::getDefaultMaterialId() const
 {
-	return _activeMaterial;
+	if (_defaultMaterialId == ModelSkin::NO_REMAP)
+	{
+		_defaultMaterialId = GlobalModelSkinCache().getMaterialId(_defaultMaterial);
+	}
+
+	return _defaultMaterialId;
 }
 
-void RenderablePicoSurface::setActiveMaterial(const std::string& activeMaterial)
+const std::string& RenderablePicoSurface::getActiveMaterial() const
 {
-	_activeMaterial = activeMaterial;
+	return _defaultMaterial;
 }
 
 bool RenderablePicoSurface::getIntersection(const Ray& ray, Vector3& intersection, const Matrix4& localToWorld)
@@ -440,11 +445,8 @@ void RenderablePicoSurface::applyScale(const Vector3& scale, const RenderablePic
 
 	calculateTangents();
 
-	glDeleteLists(_dlRegular, 1);
-	glDeleteLists(_dlProgramNoVCol, 1);
-	glDeleteLists(_dlProgramVcol, 1);
-
-	createDisplayLists();
+	// The buffers are re-created on the next render pass
+	releaseBuffers();
 }
 
 } // namespace model
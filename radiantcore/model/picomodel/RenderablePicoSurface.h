@@ -7,6 +7,7 @@
 
 #include "ishaders.h"
 #include "imodelsurface.h"
+#include "ModelSurfaceBuilder.h"
 
 /* FORWARD DECLS */
 class ModelSkin;
@@ -22,6 +23,11 @@ namespace model
 /* Renderable class containing a series of polygons textured with the same
  * material. RenderablePicoSurface objects are composited into a RenderablePicoModel
  * object to create a renderable static mesh.
+ *
+ * The surfaces loaded from a model file are shared by all the RenderablePicoModel
+ * instances of that file and are not modified after loading. Skin remaps are
+ * maintained per model instance, only scaled models use a private copy of the
+ * geometry. The geometry is uploaded to OpenGL once, on first render.
  */
 
 class RenderablePicoSurface :
@@ -31,8 +37,9 @@ class RenderablePicoSurface :
 	// Name of the material this surface is using by default (without any skins)
 	std::string _defaultMaterial;
 
-	// Name of the material with skin remaps applied
-	std::string _activeMaterial;
+	// Id of the default material as assigned by the skin cache, looked up on
+	// first use (ModelSkin::NO_REMAP until then)
+	mutable std::size_t _defaultMaterialId;
 
 	// Vector of ArbitraryMeshVertex structures, containing the coordinates,
 	// normals, tangents and texture coordinates of the component vertices
@@ -51,10 +58,10 @@ class RenderablePicoSurface :
 	// The AABB containing this surface, in local object space.
 	AABB _localAABB;
 
-	// The GL display lists for this surface's geometry
-	GLuint _dlRegular;
-	GLuint _dlProgramVcol;
-    GLuint _dlProgramNoVCol;
+	// The vertex and index buffer objects holding this surface's geometry,
+	// created on first render
+	mutable GLuint _vertexBuffer;
+	mutable GLuint _indexBuffer;
 
 private:
 
@@ -64,12 +71,15 @@ private:
 	// Calculate tangent and bitangent vectors for all vertices.
 	void calculateTangents();
 
-	// Create the display lists
-    GLuint compileProgramList(bool includeColour);
-	void createDisplayLists();
+	// Create or release the VBOs
+	void createBuffers() const;
+	void releaseBuffers() const;
 
 	std::string cleanupShaderName(const std::string& mapName);
 
+	// Picks the default material from the shader and bitmap names found in the model file
+	void determineDefaultMaterial(const std::string& fExt, const std::string& shaderName, const std::string& mapName);
+
 public:
 	/**
 	 * Constructor. Accepts a picoSurface_t struct and the file extension to determine
@@ -77,6 +87,12 @@ public:
 	 */
 	RenderablePicoSurface(picoSurface_t* surf, const std::string& fExt);
 
+	/**
+	 * Construct a surface from the output of the native model parsers, taking
+	 * over the vertex and index arrays.
+	 */
+	RenderablePicoSurface(ParsedModelSurface&& surface, const std::string& fExt);
+
 	/**
 	 * Copy-constructor.
 	 */
@@ -118,8 +134,11 @@ public:
 	const std::string& getDefaultMaterial() const override;
 	void setDefaultMaterial(const std::string& defaultMaterial);
 
+	// Returns the id of the default material, see ModelSkinCache::getMaterialId()
+	std::size_t getDefaultMaterialId() const;
+
+	// Surfaces don't know about skins, this returns the default material
 	const std::string& getActiveMaterial() const override;
-	void setActiveMaterial(const std::string& activeMaterial);
 
 	// Returns true if the given ray intersects this surface geometry and fills in
 	// the exact point in the given Vector3, returns false if no intersection was found.
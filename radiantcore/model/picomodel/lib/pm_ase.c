@@ -467,7 +467,7 @@ static void _ase_submit_triangles_unshared ( picoModel_t* model , aseMaterial_t*
 
 #endif
 
-static void _ase_submit_triangles( picoModel_t* model , aseMaterial_t* materials , aseVertex_t* vertices, aseTexCoord_t* texcoords, aseColor_t* colors, aseFace_t* faces, int numFaces )
+static void _ase_submit_triangles( picoModel_t* model , aseMaterial_t* materials , aseVertex_t* vertices, int numVertices, aseTexCoord_t* texcoords, aseColor_t* colors, aseFace_t* faces, int numFaces )
 {
 	aseFacesIter_t i = faces, end = faces + numFaces;
 	for(; i != end; ++i)
@@ -479,6 +479,17 @@ static void _ase_submit_triangles( picoModel_t* model , aseMaterial_t* materials
 			return;
 		}
 
+		/* skip faces referring to vertices outside the vertex list, faces without */
+		/* a *MESH_FACE line refer to vertex 0, which might not exist either */
+		if( vertices == NULL ||
+			(*i).indices[0] < 0 || (*i).indices[0] >= numVertices ||
+			(*i).indices[1] < 0 || (*i).indices[1] >= numVertices ||
+			(*i).indices[2] < 0 || (*i).indices[2] >= numVertices )
+		{
+			_pico_printf( PICO_WARNING, "Skipping ASE face with invalid vertex indices" );
+			continue;
+		}
+
 		{
 			picoVec3_t* xyz[3];
 			picoVec3_t* normal[3];
@@ -632,7 +643,7 @@ static picoModel_t *_ase_load( PM_PARAMS_LOAD )
 		else if (!_pico_stricmp(p->token,"*mesh"))
 		{
 			/* finish existing surface */
-			_ase_submit_triangles(model, materials, vertices, texcoords, colors, faces, numFaces);
+			_ase_submit_triangles(model, materials, vertices, numVertices, texcoords, colors, faces, numFaces);
 			_pico_free(faces);
 			_pico_free(vertices);
 			_pico_free(texcoords);
@@ -1327,7 +1338,7 @@ static picoModel_t *_ase_load( PM_PARAMS_LOAD )
 	}
 
 	/* ydnar: finish existing surface */
-	_ase_submit_triangles(model, materials, vertices, texcoords, colors, faces, numFaces);
+	_ase_submit_triangles(model, materials, vertices, numVertices, texcoords, colors, faces, numFaces);
 	_pico_free(faces);
 	_pico_free(vertices);
 	_pico_free(texcoords);
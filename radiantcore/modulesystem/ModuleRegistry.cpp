@@ -5,6 +5,11 @@
 #include "itextstream.h"
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <set>
+#include <thread>
 #include "ModuleLoader.h"
 
 #include <fmt/format.h>
@@ -91,43 +96,384 @@ void ModuleRegistry::registerModule(const RegisterableModulePtr& module)
 	rMessage() << "Module registered: " << module->getName() << std::endl;
 }
 
-// Initialise the module (including dependencies, if necessary)
-void ModuleRegistry::initialiseModuleRecursive(const std::string& name)
+namespace
 {
-	// Check if the module is already initialised
-	if (_initialisedModules.find(name) != _initialisedModules.end())
-    {
-		return;
+	// Maximum number of worker threads initialising modules
+	const unsigned int MAX_INITIALISATION_THREADS = 4;
+
+	inline long long toMilliseconds(std::chrono::steady_clock::duration duration)
+	{
+		return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+	}
+}
+
+ModuleRegistry::ModuleGraph ModuleRegistry::buildModuleGraph()
+{
+	ModuleGraph graph;
+
+	for (const ModulesMap::value_type& pair : _uninitialisedModules)
+	{
+		ModuleNode& node = graph[pair.first];
+		node.module = pair.second;
+		node.concurrent = pair.second->allowsConcurrentInitialisation();
 	}
 
-	// Check if the module exists at all
-	if (_uninitialisedModules.find(name) == _uninitialisedModules.end())
+	for (ModuleGraph::value_type& pair : graph)
 	{
-		throw std::logic_error("ModuleRegistry: Module doesn't exist: " + name);
+		const StringSet& dependencies = pair.second.module->getDependencies();
+
+		// Debug builds should ensure that the dependencies don't reference the
+		// module itself directly
+		assert(dependencies.find(pair.first) == dependencies.end());
+
+		for (const std::string& namedDependency : dependencies)
+		{
+			// Dependencies which are initialised already (like the core module) are fine
+			if (_initialisedModules.find(namedDependency) != _initialisedModules.end())
+			{
+				continue;
+			}
+
+			auto dependency = graph.find(namedDependency);
+
+			if (dependency == graph.end())
+			{
+				throw std::logic_error("ModuleRegistry: Module doesn't exist: " + namedDependency);
+			}
+
+			dependency->second.dependents.push_back(pair.first);
+			pair.second.pendingDependencies++;
+		}
 	}
 
+	return graph;
+}
+
+void ModuleRegistry::initialiseModule(ModuleNode& node, Clock::time_point phaseStart)
+{
 	// Tag this module as "ready" by moving it into the initialised list.
-	RegisterableModulePtr module = _initialisedModules.emplace(name, _uninitialisedModules[name]).first->second;
-	const StringSet& dependencies = module->getDependencies();
+	{
+		std::lock_guard<std::mutex> lock(_initialisedModulesLock);
+		_initialisedModules.emplace(node.module->getName(), node.module);
+	}
+
+	node.start = Clock::now() - phaseStart;
+
+	// Initialise the module itself, now that the dependencies are ready
+	node.module->initialiseModule(_context);
 
-    // Debug builds should ensure that the dependencies don't reference the
-    // module itself directly
-    assert(dependencies.find(module->getName()) == dependencies.end());
+	node.end = Clock::now() - phaseStart;
+}
+
+void ModuleRegistry::finishModuleInitialisation(ModuleNode& node, Clock::time_point phaseStart)
+{
+	node.module->finishModuleInitialisation(_context);
+
+	node.end = Clock::now() - phaseStart;
+}
 
-	// Initialise the dependencies first
-	for (const std::string& namedDependency : dependencies)
+void ModuleRegistry::initialiseModuleGraph(ModuleGraph& graph)
+{
+	auto phaseStart = Clock::now();
+
+	std::mutex mutex;
+	std::condition_variable stateChanged;
+
+	// Modules with all their dependencies ready, sorted by name for a stable order
+	std::set<std::string> mainThreadQueue;
+	std::deque<std::string> workerQueue;
+
+	// Modules initialised by the workers, waiting for finishModuleInitialisation()
+	std::deque<std::string> finishQueue;
+
+	std::size_t numRemaining = graph.size();
+	std::size_t numFinished = 0;
+	std::size_t numRunningConcurrently = 0;
+	std::exception_ptr workerException;
+	bool stopWorkers = false;
+
+	auto enqueue = [&](const std::string& name)
+	{
+		if (graph.at(name).concurrent)
+		{
+			workerQueue.push_back(name);
+		}
+		else
+		{
+			mainThreadQueue.insert(name);
+		}
+	};
+
+	// Called with the mutex held, makes the dependents ready for initialisation
+	auto finishModule = [&](const std::string& name)
+	{
+		for (const std::string& dependent : graph.at(name).dependents)
+		{
+			ModuleNode& node = graph.at(dependent);
+
+			// Modules forced through a circular dependency have no pending ones left
+			if (node.pendingDependencies > 0 && --node.pendingDependencies == 0)
+			{
+				enqueue(dependent);
+			}
+		}
+
+		numRemaining--;
+		numFinished++;
+		stateChanged.notify_all();
+	};
+
+	std::size_t numConcurrentModules = 0;
+
+	for (ModuleGraph::value_type& pair : graph)
 	{
-        initialiseModuleRecursive(namedDependency);
+		if (pair.second.concurrent) numConcurrentModules++;
+
+		if (pair.second.pendingDependencies == 0)
+		{
+			enqueue(pair.first);
+		}
 	}
 
-	_progress = 0.1f + (static_cast<float>(_initialisedModules.size())/_uninitialisedModules.size())*0.9f;
+	std::vector<std::thread> workers;
+	auto numWorkers = std::min({ std::max(std::thread::hardware_concurrency(), 1u),
+		MAX_INITIALISATION_THREADS, static_cast<unsigned int>(numConcurrentModules) });
 
-	_sigModuleInitialisationProgress.emit(
-		fmt::format(_("Initialising Module: {0}"), module->getName()),
-		_progress);
+	for (unsigned int i = 0; i < numWorkers; ++i)
+	{
+		workers.emplace_back([&]()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			while (true)
+			{
+				stateChanged.wait(lock, [&]() { return stopWorkers || !workerQueue.empty(); });
+
+				if (stopWorkers) return;
+
+				std::string name = workerQueue.front();
+				workerQueue.pop_front();
+				numRunningConcurrently++;
+
+				lock.unlock();
+
+				try
+				{
+					initialiseModule(graph.at(name), phaseStart);
+				}
+				catch (...)
+				{
+					lock.lock();
+					numRunningConcurrently--;
+
+					if (!workerException)
+					{
+						workerException = std::current_exception();
+					}
+
+					stateChanged.notify_all();
+					continue;
+				}
+
+				lock.lock();
+				numRunningConcurrently--;
+				finishQueue.push_back(name);
+				stateChanged.notify_all();
+			}
+		});
+	}
 
-	// Initialise the module itself, now that the dependencies are ready
-	module->initialiseModule(_context);
+	// Stops and joins the workers, also when leaving through an exception
+	auto joinWorkers = [&]()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopWorkers = true;
+			stateChanged.notify_all();
+		}
+
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+
+		workers.clear();
+	};
+
+	try
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		while (numRemaining > 0)
+		{
+			if (workerException)
+			{
+				std::rethrow_exception(workerException);
+			}
+
+			if (!finishQueue.empty())
+			{
+				std::string name = finishQueue.front();
+				finishQueue.pop_front();
+
+				lock.unlock();
+
+				finishModuleInitialisation(graph.at(name), phaseStart);
+
+				lock.lock();
+				finishModule(name);
+				continue;
+			}
+
+			if (mainThreadQueue.empty())
+			{
+				if (!workerQueue.empty() || numRunningConcurrently > 0)
+				{
+					// Wait for the workers to make some progress
+					stateChanged.wait(lock);
+					continue;
+				}
+
+				// Nothing is ready and nothing is running, the remaining modules
+				// are depending on each other. Resolve this like the recursive
+				// initialisation did: just go ahead with the first of them.
+				auto blocked = std::find_if(graph.begin(), graph.end(), [](const ModuleGraph::value_type& pair)
+				{
+					return pair.second.pendingDependencies > 0;
+				});
+				assert(blocked != graph.end());
+
+				rWarning() << "ModuleRegistry: circular dependency, initialising " << blocked->first <<
+					" before its dependencies are ready" << std::endl;
+
+				blocked->second.pendingDependencies = 0;
+				enqueue(blocked->first);
+				continue;
+			}
+
+			std::string name = *mainThreadQueue.begin();
+			mainThreadQueue.erase(mainThreadQueue.begin());
+
+			_progress = 0.1f + (static_cast<float>(numFinished) / graph.size()) * 0.9f;
+
+			lock.unlock();
+
+			_sigModuleInitialisationProgress.emit(
+				fmt::format(_("Initialising Module: {0}"), name),
+				_progress);
+
+			initialiseModule(graph.at(name), phaseStart);
+			finishModuleInitialisation(graph.at(name), phaseStart);
+
+			lock.lock();
+			finishModule(name);
+		}
+	}
+	catch (...)
+	{
+		joinWorkers();
+		throw;
+	}
+
+	joinWorkers();
+
+	writeTimingReport(graph, Clock::now() - phaseStart);
+}
+
+void ModuleRegistry::writeTimingReport(const ModuleGraph& graph, Clock::duration totalTime)
+{
+	// Longest chain of dependencies ending in each module, with its predecessor on that chain
+	std::map<std::string, std::pair<Clock::duration, std::string>> paths;
+
+	std::function<Clock::duration(const std::string&)> getPathLength = [&](const std::string& name)
+	{
+		auto existing = paths.find(name);
+
+		if (existing != paths.end())
+		{
+			return existing->second.first;
+		}
+
+		const ModuleNode& node = graph.at(name);
+
+		// Insert first to stop at circular dependencies
+		auto& path = paths[name];
+		path.first = node.end - node.start;
+
+		Clock::duration longestDependency = Clock::duration::zero();
+
+		for (const std::string& dependency : node.module->getDependencies())
+		{
+			if (graph.find(dependency) == graph.end()) continue;
+
+			auto length = getPathLength(dependency);
+
+			if (length > longestDependency || path.second.empty())
+			{
+				longestDependency = length;
+				path.second = dependency;
+			}
+		}
+
+		path.first += longestDependency;
+
+		return path.first;
+	};
+
+	std::string criticalModule;
+	Clock::duration criticalPathLength = Clock::duration::zero();
+	Clock::duration mainThreadTime = Clock::duration::zero();
+
+	std::vector<const ModuleGraph::value_type*> modules;
+
+	for (const ModuleGraph::value_type& pair : graph)
+	{
+		modules.push_back(&pair);
+
+		if (!pair.second.concurrent)
+		{
+			mainThreadTime += pair.second.end - pair.second.start;
+		}
+
+		auto length = getPathLength(pair.first);
+
+		if (length > criticalPathLength || criticalModule.empty())
+		{
+			criticalPathLength = length;
+			criticalModule = pair.first;
+		}
+	}
+
+	std::sort(modules.begin(), modules.end(), [](const ModuleGraph::value_type* a, const ModuleGraph::value_type* b)
+	{
+		return a->second.end - a->second.start > b->second.end - b->second.start;
+	});
+
+	rMessage() << fmt::format("ModuleRegistry: {0} modules initialised in {1} msec "
+		"(main thread: {2} msec, critical path: {3} msec)",
+		graph.size(), toMilliseconds(totalTime), toMilliseconds(mainThreadTime),
+		toMilliseconds(criticalPathLength)) << std::endl;
+
+	for (const ModuleGraph::value_type* pair : modules)
+	{
+		rMessage() << fmt::format("  {0:>6} msec  {1}{2}", toMilliseconds(pair->second.end - pair->second.start),
+			pair->first, pair->second.concurrent ? " (worker thread)" : "") << std::endl;
+	}
+
+	// Walk the critical path from its last module back to the start
+	std::string criticalPath;
+	std::set<std::string> visited;
+
+	// The visited check stops at circular dependencies
+	for (std::string name = criticalModule; !name.empty() && visited.insert(name).second; name = paths[name].second)
+	{
+		const ModuleNode& node = graph.at(name);
+
+		criticalPath = fmt::format("{0} ({1} msec){2}{3}", name, toMilliseconds(node.end - node.start),
+			criticalPath.empty() ? "" : " -> ", criticalPath);
+	}
+
+	rMessage() << "ModuleRegistry: critical path: " << criticalPath << std::endl;
 }
 
 void ModuleRegistry::initialiseCoreModule()
@@ -146,6 +492,7 @@ void ModuleRegistry::initialiseCoreModule()
 	assert(moduleIter->second->getDependencies().empty());
 
 	moduleIter->second->initialiseModule(_context);
+	moduleIter->second->finishModuleInitialisation(_context);
 
 	_uninitialisedModules.erase(coreModuleName);
 }
@@ -171,13 +518,8 @@ void ModuleRegistry::loadAndInitialiseModules()
 	_progress = 0.1f;
 	_sigModuleInitialisationProgress.emit(_("Initialising Modules"), _progress);
 
-	for (ModulesMap::iterator i = _uninitialisedModules.begin();
-		 i != _uninitialisedModules.end(); ++i)
-	{
-		// greebo: Dive into the recursion
-		// (this will return immediately if the module is already initialised).
-		initialiseModuleRecursive(i->first);
-	}
+	ModuleGraph graph = buildModuleGraph();
+	initialiseModuleGraph(graph);
 
 	_uninitialisedModules.clear();
 
@@ -220,6 +562,8 @@ void ModuleRegistry::shutdownModules()
 
 bool ModuleRegistry::moduleExists(const std::string& name) const
 {
+	std::lock_guard<std::mutex> lock(_initialisedModulesLock);
+
 	// Try to find the initialised module, uninitialised don't count as existing
     return _initialisedModules.find(name) != _initialisedModules.end();
 }
@@ -231,6 +575,7 @@ RegisterableModulePtr ModuleRegistry::getModule(const std::string& name) const {
 	RegisterableModulePtr returnValue;
 
 	// Try to find the module
+	std::unique_lock<std::mutex> lock(_initialisedModulesLock);
 	ModulesMap::const_iterator found = _initialisedModules.find(name);
 
 	if (found != _initialisedModules.end())
@@ -238,6 +583,8 @@ RegisterableModulePtr ModuleRegistry::getModule(const std::string& name) const {
 		returnValue = found->second;
 	}
 
+	lock.unlock();
+
 	if (!returnValue)
     {
         rConsoleError() << "ModuleRegistry: Warning! Module with name "
@@ -302,6 +649,11 @@ ModuleRegistry::InstanceId ModuleRegistry::getInstanceId() const
 	return reinterpret_cast<InstanceId>(this);
 }
 
+std::mutex& ModuleRegistry::getReferenceLock()
+{
+	return _referenceLock;
+}
+
 std::string ModuleRegistry::getModuleList(const std::string& separator)
 {
 	std::string returnValue;
@@ -2,6 +2,8 @@
 
 #include <map>
 #include <list>
+#include <mutex>
+#include <chrono>
 #include "imodule.h"
 
 namespace module 
@@ -14,7 +16,11 @@ class ModuleLoader;
  * It stores and manages the lifecycle of all modules in DarkRadiant.
  * 
  * Use the registerModule() method to add new modules, which will be initialised
- * during the startup phase, resolving the module dependencies on the go.
+ * during the startup phase. The registry builds the dependency graph of all
+ * modules and initialises each module as soon as all its dependencies are ready.
+ * Modules allowing concurrent initialisation are handed to a few worker threads,
+ * all others are initialised on the main thread. The finishing step of every
+ * module runs on the main thread, before its dependents are started.
  */
 class ModuleRegistry :
 	public IModuleRegistry
@@ -31,6 +37,12 @@ private:
 	// After initialisiation, modules get enlisted here.
 	ModulesMap _initialisedModules;
 
+	// Guards _initialisedModules during the (concurrent) initialisation phase
+	mutable std::mutex _initialisedModulesLock;
+
+	// See IModuleRegistry::getReferenceLock()
+	std::mutex _referenceLock;
+
 	// Set to TRUE as soon as initialiseModules() is finished
 	bool _modulesInitialised;
 
@@ -85,6 +97,8 @@ public:
 
 	InstanceId getInstanceId() const override;
 
+	std::mutex& getReferenceLock() override;
+
 	// Returns a list of modules
 	std::string getModuleList(const std::string& separator = "\n");
 
@@ -100,8 +114,41 @@ private:
 	// is destructed - the shared_ptrs don't work anymore and are causing double-deletes.
 	void unloadModules();
 
-	// Initialises the module (including dependencies, recursively).
-	void initialiseModuleRecursive(const std::string& name);
+	typedef std::chrono::steady_clock Clock;
+
+	// Node of the dependency graph, also holding the timing information
+	struct ModuleNode
+	{
+		RegisterableModulePtr module;
+
+		// Names of the modules depending on this one
+		std::vector<std::string> dependents;
+
+		// Number of dependencies not initialised yet
+		std::size_t pendingDependencies = 0;
+
+		// Start and end of initialiseModule(), relative to the start of the phase
+		Clock::duration start = Clock::duration::zero();
+		Clock::duration end = Clock::duration::zero();
+
+		bool concurrent = false;
+	};
+	typedef std::map<std::string, ModuleNode> ModuleGraph;
+
+	// Builds the dependency graph of the uninitialised modules, throws if a dependency is missing
+	ModuleGraph buildModuleGraph();
+
+	// Initialises all modules in dependency order, the independent ones concurrently
+	void initialiseModuleGraph(ModuleGraph& graph);
+
+	// Tags the module as ready and invokes its initialiseModule() method
+	void initialiseModule(ModuleNode& node, Clock::time_point phaseStart);
+
+	// Invokes the module's finishModuleInitialisation() method, on the main thread
+	void finishModuleInitialisation(ModuleNode& node, Clock::time_point phaseStart);
+
+	// Logs the initialisation time of each module and the critical path
+	void writeTimingReport(const ModuleGraph& graph, Clock::duration totalTime);
 
 }; // class Registry
 
@@ -234,7 +234,16 @@ void ParticlesManager::initialiseModule(const IApplicationContext& ctx)
 	// Load the .prt files in a new thread, public methods will block until
     // this has been completed
     _defLoader.start();
+}
 
+bool ParticlesManager::allowsConcurrentInitialisation() const
+{
+	// initialiseModule() is just starting the def loader
+	return true;
+}
+
+void ParticlesManager::finishModuleInitialisation(const IApplicationContext& ctx)
+{
 	// Register the "ReloadParticles" commands
 	GlobalCommandSystem().addCommand("ReloadParticles", std::bind(&ParticlesManager::reloadParticleDefs, this));
 
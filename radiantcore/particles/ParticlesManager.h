@@ -50,6 +50,8 @@ public:
 	const std::string& getName() const override;
     const StringSet& getDependencies() const override;
     void initialiseModule(const IApplicationContext& ctx) override;
+    bool allowsConcurrentInitialisation() const override;
+    void finishModuleInitialisation(const IApplicationContext& ctx) override;
 
 	static ParticlesManager& Instance()
 	{
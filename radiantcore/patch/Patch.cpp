@@ -10,6 +10,7 @@
 #include "registry/registry.h"
 #include "math/Frustum.h"
 #include "math/Ray.h"
+#include "math/BatchOps.h"
 #include "texturelib.h"
 #include "brush/TextureProjection.h"
 #include "brush/Winding.h"
@@ -277,12 +278,11 @@ void Patch::testSelect(Selector& selector, SelectionTest& test)
 // Transform this patch as defined by the transformation matrix <matrix>
 void Patch::transform(const Matrix4& matrix)
 {
-    // Cycle through all the patch control vertices and transform the points
-    for (PatchControlIter i = _ctrlTransformed.begin();
-         i != _ctrlTransformed.end();
-         ++i)
+    // Transform the points of all patch control vertices in one go
+    if (!_ctrlTransformed.empty())
     {
-        i->vertex = matrix.transformPoint(i->vertex);
+        math::transformPoints(matrix, &_ctrlTransformed.front().vertex,
+            _ctrlTransformed.size(), sizeof(PatchControl));
     }
 
     // Check the handedness of the matrix and invert it if needed
@@ -376,6 +376,7 @@ void Patch::setShader(const std::string& name)
     undoSave();
     
     _shader.setMaterialName(name);
+    _node.materialsChanged();
     
     // Check if the shader is ok
     check_shader();
@@ -455,6 +456,7 @@ void Patch::importState(const IUndoMementoPtr& state)
         _patchDef3 = other.m_patchDef3;
         _subDivisions = Subdivisions(other.m_subdivisions_x, other.m_subdivisions_y);
         _shader.setMaterialName(other._materialName);
+        _node.materialsChanged();
     }
 
     // end duplicate code
@@ -17,6 +17,16 @@ namespace render
 namespace
 {
 
+// Material images may have been evicted to meet the texture memory budget,
+// let the material manager upload them again before they are bound
+inline void ensureTextureResident(GLint texture, GLenum textureMode)
+{
+    if (texture != 0 && textureMode == GL_TEXTURE_2D)
+    {
+        GlobalMaterialManager().ensureTextureResident(static_cast<GLuint>(texture));
+    }
+}
+
 // Bind the given texture to the texture unit, if it is different from the
 // current state, then set the current state to the new texture.
 inline void setTextureState(GLint& current,
@@ -28,6 +38,7 @@ inline void setTextureState(GLint& current,
     {
         glActiveTexture(textureUnit);
         glClientActiveTexture(textureUnit);
+        ensureTextureResident(texture, textureMode);
         glBindTexture(textureMode, texture);
         debug::assertNoGlErrors();
         current = texture;
@@ -41,6 +52,7 @@ inline void setTextureState(GLint& current,
 {
     if (texture != current)
     {
+        ensureTextureResident(texture, textureMode);
         glBindTexture(textureMode, texture);
         debug::assertNoGlErrors();
         current = texture;
@@ -15,7 +15,8 @@ namespace
 	const AABB START_AABB(Vector3(0,0,0), Vector3(START_SIZE, START_SIZE, START_SIZE));
 }
 
-Octree::Octree()
+Octree::Octree() :
+	_revision(0)
 {
 	_root = OctreeNodePtr(new OctreeNode(*this, START_AABB));
 }
@@ -126,12 +127,19 @@ ISPNodePtr Octree::getRoot() const
 	return _root;
 }
 
+std::size_t Octree::getRevision() const
+{
+	return _revision;
+}
+
 void Octree::notifyLink(const scene::INodePtr& sceneNode, OctreeNode* node)
 {
 	std::pair<NodeMapping::iterator, bool> result =
 		_nodeMapping.insert(NodeMapping::value_type(sceneNode, node));
 
 	assert(result.second);
+
+	++_revision;
 }
 
 void Octree::notifyUnlink(const scene::INodePtr& sceneNode, OctreeNode* node)
@@ -142,6 +150,8 @@ void Octree::notifyUnlink(const scene::INodePtr& sceneNode, OctreeNode* node)
 	assert(found != _nodeMapping.end());
 
 	_nodeMapping.erase(found);
+
+	++_revision;
 }
 
 #ifdef _DEBUG
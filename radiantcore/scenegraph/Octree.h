@@ -49,6 +49,9 @@ private:
 	typedef std::map<INodePtr, OctreeNode*> NodeMapping;
 	NodeMapping _nodeMapping;
 
+	// Incremented on every link and unlink
+	std::size_t _revision;
+
 public:
 	Octree();
 
@@ -63,6 +66,8 @@ public:
 	// Returns the root node of this SP tree
 	ISPNodePtr getRoot() const;
 
+	std::size_t getRevision() const;
+
 	// Callback used by the OctreeNodes to let the tree update its caching structures
 	void notifyLink(const scene::INodePtr& sceneNode, OctreeNode* node);
 	void notifyUnlink(const scene::INodePtr& sceneNode, OctreeNode* node);
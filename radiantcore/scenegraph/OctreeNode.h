@@ -4,6 +4,7 @@
 #include "inode.h"
 #include "ispacepartition.h"
 #include "math/AABB.h"
+#include "math/PackedAABBs.h"
 
 #include "Octree.h"
 
@@ -51,6 +52,13 @@ protected:
 	// The scene::INodePtrs contained in this octree node
 	MemberList _members;
 
+	// The world bounds of the members at the time they were linked, in the same order.
+	// Re-linking is lazy: Node::boundsChanged() only marks the bounds as dirty, the
+	// member is re-linked when its worldAABB() (or the one of an ancestor) is evaluated
+	// next. Until then these bounds are stale. Volume traversals evaluate the root bounds
+	// before descending, only changes evaluated during a traversal are applied after it.
+	PackedAABBs _memberBounds;
+
 public:
 	// Construct a node using bounds, owning Octree and parent node
 	OctreeNode(Octree& owner, const AABB& bounds, const OctreeNodePtr& parent = OctreeNodePtr()) :
@@ -107,6 +115,11 @@ public:
 		return _children.empty();
 	}
 
+	std::size_t testMemberBounds(const Frustum& frustum, std::vector<std::uint8_t>& visibility) const
+	{
+		return _memberBounds.testFrustum(frustum, visibility);
+	}
+
 	// Subdivide this octree node (adding 8 child nodes)
 	void subdivide()
 	{
@@ -151,6 +164,7 @@ public:
 	{
 		// Copy all members from here to the target
 		target._members.insert(target._members.end(), _members.begin(), _members.end());
+		target._memberBounds.append(_memberBounds);
 
 		// Notify the Octree about the relocation
 		for (ISPNode::MemberList::iterator i = _members.begin(); i != _members.end(); ++i)
@@ -161,6 +175,7 @@ public:
 
 		// Clear our own member list
 		_members.clear();
+		_memberBounds.clear();
 	}
 
 	// This method moves all the children of this node to the "other" target node
@@ -176,12 +191,13 @@ public:
 		target.reparentChildren();
 	}
 
-	void addMember(const scene::INodePtr& sceneNode)
+	void addMember(const scene::INodePtr& sceneNode, const AABB& bounds)
 	{
 		assert(std::find(_members.begin(), _members.end(), sceneNode) == _members.end());
 
 		// Add to the internal list
 		_members.push_back(sceneNode);
+		_memberBounds.push_back(bounds);
 
 		// Notify the Octree to update lookup caches
 		_owner.notifyLink(sceneNode, this);
@@ -195,7 +211,7 @@ public:
 		// If the AABB is not valid, just link it here
 		if (!bounds.isValid())
 		{
-			addMember(sceneNode);
+			addMember(sceneNode, bounds);
 			return this;
 		}
 
@@ -212,7 +228,7 @@ public:
 		}
 
 		// Node didn't fit into any of the children, link it here
-		addMember(sceneNode);
+		addMember(sceneNode, bounds);
 
 		// If this is a leaf, check if we exceeded the subdivision threshold and are large enough
 		if (isLeaf() &&
@@ -245,6 +261,7 @@ public:
 
 			// ... so create a temporary copy on the stack
 			oldList.swap(_members);
+			_memberBounds.clear();
 
 			// Cycle through all the members and distribute them over the children
 			for (ISPNode::MemberList::iterator i = oldList.begin(); i != oldList.end(); ++i)
@@ -269,6 +286,7 @@ public:
 
 		if (found != _members.end())
 		{
+			_memberBounds.erase(std::distance(_members.begin(), found));
 			_members.erase(found);
 		}
 
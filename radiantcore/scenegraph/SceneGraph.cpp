@@ -1,6 +1,7 @@
 #include "SceneGraph.h"
 
 #include "ivolumetest.h"
+#include "irenderview.h"
 #include "itextstream.h"
 
 #include "scene/InstanceWalkers.h"
@@ -17,8 +18,8 @@ namespace scene
 
 SceneGraph::SceneGraph() :
 	_spacePartition(new Octree),
-	_visitedSPNodes(0),
-	_skippedSPNodes(0),
+	_traversalStats{ 0, 0, 0, 0 },
+	_traversalCount(0),
     _traversalOngoing(false)
 {}
 
@@ -208,7 +209,8 @@ void SceneGraph::foreachVisibleNodeInVolume(const VolumeTest& volume, const INod
 	foreachNodeInVolume(volume, functor, false); // don't visit hidden
 }
 
-void SceneGraph::foreachNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor, bool visitHidden)
+void SceneGraph::foreachNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor, bool visitHidden,
+									 const SPNodeVisitorFunc& spNodeVisitor)
 {
     // Acquire the worldAABB() of the scenegraph root - if any node got changed in the graph
     // the scenegraph's root bounds are marked as "dirty" and the bounds will be re-calculated
@@ -223,11 +225,16 @@ void SceneGraph::foreachNodeInVolume(const VolumeTest& volume, const INode::Visi
         // Descend the SpacePartition tree and call the walker for each (partially) visible member
         ISPNodePtr root = _spacePartition->getRoot();
 
-        _visitedSPNodes = _skippedSPNodes = 0;
+        _traversalStats = VolumeTraversalStatistics{ 0, 0, 0, 0 };
+        _traversalCount++;
 
-        foreachNodeInVolume_r(*root, volume, functor, visitHidden);
+        // Render views provide a frustum, which allows culling the members one by one.
+        // The result per octree node is stored in the visibility buffer.
+        auto renderView = dynamic_cast<const render::IRenderView*>(&volume);
+        std::vector<std::uint8_t> visibility;
 
-        _visitedSPNodes = _skippedSPNodes = 0;
+        foreachNodeInVolume_r(*root, volume, renderView ? &renderView->getFrustum() : nullptr,
+            visibility, functor, visitHidden, spNodeVisitor);
     }
 
     // Traversal finished, flush the action buffer
@@ -250,17 +257,45 @@ void SceneGraph::foreachVisibleNodeInVolume(const VolumeTest& volume, Walker& wa
 		false); // don't visit hidden
 }
 
-bool SceneGraph::foreachNodeInVolume_r(const ISPNode& node, const VolumeTest& volume, 
-									   const INode::VisitorFunc& functor, bool visitHidden)
+void SceneGraph::foreachVisibleNodeInVolume(const VolumeTest& volume, SpacePartitionWalker& walker)
 {
-	_visitedSPNodes++;
+	foreachNodeInVolume(volume,
+		[&] (const INodePtr& node) { return walker.visit(node); },
+		false, // don't visit hidden
+		[&] (const ISPNode& node) { walker.visitSPNode(node); });
+}
+
+bool SceneGraph::foreachNodeInVolume_r(const ISPNode& node, const VolumeTest& volume, const Frustum* frustum,
+									   std::vector<std::uint8_t>& visibility, const INode::VisitorFunc& functor, bool visitHidden,
+									   const SPNodeVisitorFunc& spNodeVisitor)
+{
+	_traversalStats.visitedSPNodes++;
+
+	if (spNodeVisitor)
+	{
+		spNodeVisitor(node);
+	}
 
 	// Visit all members
 	const ISPNode::MemberList& members = node.getMembers();
 
+	if (frustum != nullptr)
+	{
+		_traversalStats.culledNodes += node.testMemberBounds(*frustum, visibility);
+	}
+
+	std::size_t index = 0;
+
 	for (ISPNode::MemberList::const_iterator m = members.begin();
-		 m != members.end(); /* in-loop increment */)
+		 m != members.end(); ++index /* m is incremented in-loop */)
 	{
+		// Skip members outside the view
+		if (frustum != nullptr && !visibility[index])
+		{
+			++m;
+			continue;
+		}
+
 		// Skip hidden nodes, if specified
 		if (!visitHidden && !(*m)->visible())
 		{
@@ -268,6 +303,8 @@ bool SceneGraph::foreachNodeInVolume_r(const ISPNode& node, const VolumeTest& vo
 			continue;
 		}
 
+		_traversalStats.visitedNodes++;
+
 		// We're done, as soon as the walker returns FALSE
 		if (!functor(*m++))
 		{
@@ -283,12 +320,12 @@ bool SceneGraph::foreachNodeInVolume_r(const ISPNode& node, const VolumeTest& vo
 		if (volume.TestAABB((*i)->getBounds()) == VOLUME_OUTSIDE)
 		{
 			// Skip this node, not visible
-			_skippedSPNodes++;
+			_traversalStats.culledSPNodes++;
 			continue;
 		}
 
 		// Traverse all the children too, enter recursion
-		if (!foreachNodeInVolume_r(**i, volume, functor, visitHidden))
+		if (!foreachNodeInVolume_r(**i, volume, frustum, visibility, functor, visitHidden, spNodeVisitor))
 		{
 			// The walker returned false somewhere in the recursion depths, propagate this message
 			return false;
@@ -298,6 +335,16 @@ bool SceneGraph::foreachNodeInVolume_r(const ISPNode& node, const VolumeTest& vo
 	return true; // continue traversal
 }
 
+const Graph::VolumeTraversalStatistics& SceneGraph::getVolumeTraversalStatistics() const
+{
+	return _traversalStats;
+}
+
+std::size_t SceneGraph::getVolumeTraversalCount() const
+{
+	return _traversalCount;
+}
+
 ISpacePartitionSystemPtr SceneGraph::getSpacePartition()
 {
 	return _spacePartition;
@@ -2,6 +2,9 @@
 
 #include <map>
 #include <list>
+#include <vector>
+#include <cstdint>
+#include <functional>
 #include <sigc++/signal.h>
 
 #include "iscenegraph.h"
@@ -34,8 +37,8 @@ private:
 	// The space partitioning system
 	ISpacePartitionSystemPtr _spacePartition;
 
-	std::size_t _visitedSPNodes;
-	std::size_t _skippedSPNodes;
+	VolumeTraversalStatistics _traversalStats;
+	std::size_t _traversalCount;
 
     // During partition traversal all link/unlink calls are buffered and
     // performed later on.
@@ -84,6 +87,7 @@ public:
 	// Walker variants
     void foreachNodeInVolume(const VolumeTest& volume, Walker& walker) override;
     void foreachVisibleNodeInVolume(const VolumeTest& volume, Walker& walker) override;
+    void foreachVisibleNodeInVolume(const VolumeTest& volume, SpacePartitionWalker& walker) override;
 
 	// Lambda variants
     void foreachNode(const INode::VisitorFunc& functor) override;
@@ -92,12 +96,21 @@ public:
     void foreachVisibleNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor) override;
 
     ISpacePartitionSystemPtr getSpacePartition() override;
+
+    const VolumeTraversalStatistics& getVolumeTraversalStatistics() const override;
+    std::size_t getVolumeTraversalCount() const override;
 private:
-	void foreachNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor, bool visitHidden);
+	// Invoked for each traversed space partition node, before its members are visited
+	typedef std::function<void(const ISPNode&)> SPNodeVisitorFunc;
+
+	void foreachNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor, bool visitHidden,
+							 const SPNodeVisitorFunc& spNodeVisitor = SPNodeVisitorFunc());
 
 	// Recursive method used to descend the SpacePartition tree, returns FALSE if the walker signaled stop
-	bool foreachNodeInVolume_r(const ISPNode& node, const VolumeTest& volume, 
-							   const INode::VisitorFunc& functor, bool visitHidden);
+	// If a frustum is given, members are culled individually, using the visibility vector as buffer
+	bool foreachNodeInVolume_r(const ISPNode& node, const VolumeTest& volume, const Frustum* frustum,
+							   std::vector<std::uint8_t>& visibility, const INode::VisitorFunc& functor, bool visitHidden,
+							   const SPNodeVisitorFunc& spNodeVisitor);
 
     void flushActionBuffer();
 };
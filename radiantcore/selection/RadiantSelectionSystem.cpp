@@ -13,6 +13,7 @@
 #include "selection/algorithm/General.h"
 #include "selection/algorithm/Primitives.h"
 #include "selection/algorithm/Transformation.h"
+#include "selection/clipboard/Clipboard.h"
 #include "SceneWalkers.h"
 #include "SelectionTestWalkers.h"
 #include "command/ExecutionFailure.h"
@@ -777,7 +778,7 @@ void RadiantSelectionSystem::onManipulationChanged()
 
 void RadiantSelectionSystem::onManipulationEnd()
 {
-    GlobalSceneGraph().foreachNode(scene::freezeTransformableNode);
+    scene::freezeTransformableNodes();
 
     _pivot.endOperation();
 
@@ -1026,6 +1027,11 @@ void RadiantSelectionSystem::initialiseModule(const IApplicationContext& ctx)
 
 	GlobalMapModule().signal_mapEvent().connect(
 		sigc::mem_fun(*this, &RadiantSelectionSystem::onMapEvent));
+
+	// The clipboard snapshot is holding scene nodes too, release it while
+	// the map exporters are still available to render the clipboard text
+	module::GlobalModuleRegistry().signal_modulesUninitialising().connect(
+		sigc::ptr_fun(&clipboard::releaseSnapshot));
 }
 
 void RadiantSelectionSystem::shutdownModule() 
@@ -91,6 +91,29 @@ inline bool freezeTransformableNode(const scene::INodePtr& node)
 	return true;
 }
 
+// Freezes the transform of every node in the scene. The brushes changed
+// by this get their B-Rep evaluated in one parallel batch afterwards.
+inline void freezeTransformableNodes()
+{
+	std::vector<Brush*> brushes;
+
+	GlobalSceneGraph().foreachNode([&](const scene::INodePtr& node)
+	{
+		freezeTransformableNode(node);
+
+		Brush* brush = Node_getBrush(node);
+
+		if (brush != nullptr)
+		{
+			brushes.push_back(brush);
+		}
+
+		return true;
+	});
+
+	Brush::evaluateBReps(brushes);
+}
+
 } // namespace
 
 /**
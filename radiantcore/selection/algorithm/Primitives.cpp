@@ -179,8 +179,8 @@ void createCMFromSelection(const cmd::ArgumentList& args)
 
 			if (outfile.is_open())
 			{
-				// Insert the CollisionModel into the stream
-				outfile << *cm;
+				// Stream the CollisionModel into the file
+				cm->write(outfile);
 
 				// Close the file
 				outfile.close();
@@ -415,7 +415,7 @@ void makeVisportal(const cmd::ArgumentList& args)
 
 			// Calculate face area
 			float area = 0;
-			Winding& winding = face.getWinding();
+			const Winding& winding = face.getWinding();
 			const Vector3& centroid = face.centroid();
 
 			for (std::size_t i = 0; i < winding.size(); i++)
@@ -6,6 +6,8 @@
 #include "itextstream.h"
 #include "iselectiontest.h"
 #include "igroupnode.h"
+#include "imap.h"
+#include "imaterialusage.h"
 #include "selectionlib.h"
 #include "registry/registry.h"
 #include "messages/TextureChanged.h"
@@ -794,60 +796,30 @@ void normaliseTexture(const cmd::ArgumentList& args)
 	radiant::TextureChangedMessage::Send();
 }
 
-class ByShaderSelector :
-	public scene::NodeVisitor
+namespace
 {
-private:
-	std::string _shaderName;
-
-	bool _select;
-
-public:
-	ByShaderSelector(const std::string& shaderName, bool select = true) :
-		_shaderName(shaderName),
-		_select(select)
-	{}
-
-	bool pre(const scene::INodePtr& node)
+	void setSelectedByShader(const std::string& shaderName, bool select)
 	{
-		Brush* brush = Node_getBrush(node);
-
-		if (brush != NULL)
-		{
-			if (brush->hasShader(_shaderName))
-			{
-				Node_setSelected(node, _select);
-			}
+		auto root = GlobalMapModule().getRoot();
 
-			return false; // don't traverse primitives
-		}
-
-		Patch* patch = Node_getPatch(node);
+		if (!root) return;
 
-		if (patch != NULL)
+		// The material index knows about all brushes and patches using this shader
+		root->getMaterialUsageIndex().foreachNodeUsingMaterial(shaderName, [&](const scene::INodePtr& node)
 		{
-			if (patch->getShader() == _shaderName)
-			{
-				Node_setSelected(node, _select);
-			}
-
-			return false; // don't traverse primitives
-		}
-
-		return true;
+			Node_setSelected(node, select);
+		});
 	}
-};
+}
 
 void selectItemsByShader(const std::string& shaderName)
 {
-	ByShaderSelector selector(shaderName, true);
-	GlobalSceneGraph().root()->traverseChildren(selector);
+	setSelectedByShader(shaderName, true);
 }
 
 void deselectItemsByShader(const std::string& shaderName)
 {
-	ByShaderSelector selector(shaderName, false);
-	GlobalSceneGraph().root()->traverseChildren(selector);
+	setSelectedByShader(shaderName, false);
 }
 
 void selectItemsByShaderCmd(const cmd::ArgumentList& args)
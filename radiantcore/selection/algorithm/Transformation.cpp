@@ -56,7 +56,7 @@ void rotateSelected(const Quaternion& rotation)
 	// Update the views
 	SceneChangeNotify();
 
-	GlobalSceneGraph().foreachNode(scene::freezeTransformableNode);
+	scene::freezeTransformableNodes();
 }
 
 // greebo: see header for documentation
@@ -106,7 +106,7 @@ void scaleSelected(const Vector3& scaleXYZ)
 		// Update the scene views
 		SceneChangeNotify();
 
-		GlobalSceneGraph().foreachNode(scene::freezeTransformableNode);
+		scene::freezeTransformableNodes();
 	}
 	else 
 	{
@@ -370,7 +370,7 @@ void translateSelected(const Vector3& translation)
 	// Update the scene so that the changes are made visible
 	SceneChangeNotify();
 
-	GlobalSceneGraph().foreachNode(scene::freezeTransformableNode);
+	scene::freezeTransformableNodes();
 }
 
 // Specialised overload, called by the general nudgeSelected() routine
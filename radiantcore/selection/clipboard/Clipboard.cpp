@@ -1,4 +1,5 @@
 #include "Clipboard.h"
+#include "ClipboardSnapshot.h"
 
 #include "i18n.h"
 #include "iselection.h"
@@ -20,6 +21,27 @@ namespace selection
 namespace clipboard
 {
 
+namespace
+{
+	// The objects copied last, kept for pasting them into this instance
+	std::shared_ptr<ClipboardSnapshot> _snapshot;
+
+	// Identifies the system clipboard content belonging to the snapshot
+	std::size_t _snapshotToken = 0;
+
+	std::string getSnapshotText(ClipboardSnapshot& snapshot)
+	{
+		// When exporting to the system clipboard, use the portable format
+		auto format = GlobalMapFormatManager().getMapFormatByName(map::PORTABLE_MAP_FORMAT_NAME);
+
+		// Stream the copied objects into a stringstream
+		std::stringstream out;
+		snapshot.exportToStream(out, format);
+
+		return out.str();
+	}
+}
+
 void pasteToMap()
 {
 	if (!module::GlobalModuleRegistry().moduleExists(MODULE_CLIPBOARD))
@@ -27,6 +49,13 @@ void pasteToMap()
 		throw cmd::ExecutionNotPossible(_("No clipboard module attached, cannot perform this action."));
 	}
 
+	// Skip the map parsers if the clipboard still holds our own copy
+	if (_snapshot && GlobalClipboard().containsContent(_snapshotToken))
+	{
+		_snapshot->pasteToMap();
+		return;
+	}
+
     std::stringstream stream(GlobalClipboard().getString());
 	map::algorithm::importFromStream(stream);
 }
@@ -40,15 +69,18 @@ void copy(const cmd::ArgumentList& args)
 			throw cmd::ExecutionNotPossible(_("No clipboard module attached, cannot perform this action."));
 		}
 
-		// When exporting to the system clipboard, use the portable format
-		auto format = GlobalMapFormatManager().getMapFormatByName(map::PORTABLE_MAP_FORMAT_NAME);
+		_snapshot = std::make_shared<ClipboardSnapshot>();
 
-        // Stream selected objects into a stringstream
-        std::stringstream out;
-        GlobalMap().exportSelected(out, format);
+		// The map text is generated once the clipboard is read, the snapshot
+		// might have been released or replaced at that point
+		std::weak_ptr<ClipboardSnapshot> weakSnapshot(_snapshot);
 
-        // Copy the resulting string to the clipboard
-		GlobalClipboard().setString(out.str());
+		_snapshotToken = GlobalClipboard().setDeferredString([weakSnapshot]()
+		{
+			auto snapshot = weakSnapshot.lock();
+
+			return snapshot ? getSnapshotText(*snapshot) : std::string();
+		});
 	}
 	else
 	{
@@ -91,6 +123,21 @@ void pasteToCamera(const cmd::ArgumentList& args)
 	}
 }
 
+void releaseSnapshot()
+{
+	if (!_snapshot) return;
+
+	// The deferred text cannot be generated anymore once the snapshot is gone,
+	// if the clipboard is still holding it, replace it with the actual map text
+	if (module::GlobalModuleRegistry().moduleExists(MODULE_CLIPBOARD) &&
+		GlobalClipboard().containsContent(_snapshotToken))
+	{
+		GlobalClipboard().setString(getSnapshotText(*_snapshot));
+	}
+
+	_snapshot.reset();
+}
+
 } // namespace
 
 } // namespace
@@ -32,6 +32,14 @@ void paste(const cmd::ArgumentList& args);
  */
 void pasteToCamera(const cmd::ArgumentList& args);
 
+/**
+ * Frees the objects kept for pasting them into this instance. If the system
+ * clipboard is still referring to them, their map text is placed on the
+ * clipboard first, such that it can still be pasted after DarkRadiant exits.
+ * Needs the map format modules, call this before the modules are shut down.
+ */
+void releaseSnapshot();
+
 } // namespace
 
 } // namespace
@@ -0,0 +1,159 @@
+#include "ClipboardSnapshot.h"
+
+#include <stack>
+#include "iselection.h"
+#include "iselectiongroup.h"
+#include "ibrush.h"
+#include "iscenegraph.h"
+
+#include "scene/BasicRootNode.h"
+#include "scene/Clone.h"
+#include "scene/Traverse.h"
+#include "map/Map.h"
+#include "map/algorithm/Import.h"
+#include "map/algorithm/MapExporter.h"
+
+namespace selection
+{
+
+namespace clipboard
+{
+
+namespace
+{
+
+// Clones the visited nodes into the given root node, reproducing the
+// entity/primitive hierarchy and the selection group assignments
+class SubgraphCloner :
+	public scene::NodeVisitor
+{
+private:
+	scene::IMapRootNodePtr _targetRoot;
+
+	// The cloned parents, an empty node marks a subtree which is skipped
+	std::stack<scene::INodePtr> _path;
+
+public:
+	SubgraphCloner(const scene::IMapRootNodePtr& targetRoot) :
+		_targetRoot(targetRoot)
+	{
+		_path.push(_targetRoot);
+	}
+
+	bool pre(const scene::INodePtr& node) override
+	{
+		scene::INodePtr clone;
+
+		// Brushes without faces are not written by the map exporter either
+		auto* brush = Node_getIBrush(node);
+
+		if (_path.top() && (brush == nullptr || brush->hasContributingFaces()))
+		{
+			clone = scene::cloneSingleNode(node);
+		}
+
+		if (clone)
+		{
+			_path.top()->addChildNode(clone);
+			copyGroupAssignments(node, clone);
+		}
+
+		_path.push(clone);
+
+		return clone != nullptr;
+	}
+
+	void post(const scene::INodePtr& node) override
+	{
+		_path.pop();
+	}
+
+private:
+	void copyGroupAssignments(const scene::INodePtr& source, const scene::INodePtr& clone)
+	{
+		auto groupSelectable = std::dynamic_pointer_cast<IGroupSelectable>(source);
+		auto sourceRoot = source->getRootNode();
+
+		if (!groupSelectable || !sourceRoot) return;
+
+		auto& sourceGroups = sourceRoot->getSelectionGroupManager();
+		auto& targetGroups = _targetRoot->getSelectionGroupManager();
+
+		// The order of the IDs is kept, the most recent group is at the back
+		for (auto id : groupSelectable->getGroupIds())
+		{
+			auto group = targetGroups.getSelectionGroup(id);
+
+			if (!group)
+			{
+				group = targetGroups.createSelectionGroup(id);
+
+				auto sourceGroup = sourceGroups.getSelectionGroup(id);
+
+				if (sourceGroup)
+				{
+					group->setName(sourceGroup->getName());
+				}
+			}
+
+			group->addNode(clone);
+		}
+	}
+};
+
+// Clones the part of the source root visited by the given traversal function
+std::shared_ptr<scene::BasicRootNode> cloneSubgraph(const scene::IMapRootNodePtr& sourceRoot,
+	const GraphTraversalFunc& traverse)
+{
+	auto root = std::make_shared<scene::BasicRootNode>();
+
+	// Take over the layer definitions and the map properties
+	sourceRoot->getLayerManager().foreachLayer([&](int layerId, const std::string& layerName)
+	{
+		root->getLayerManager().createLayer(layerName, layerId);
+	});
+
+	sourceRoot->foreachProperty([&](const std::string& key, const std::string& value)
+	{
+		root->setProperty(key, value);
+	});
+
+	SubgraphCloner cloner(root);
+	traverse(sourceRoot, cloner);
+
+	return root;
+}
+
+}
+
+ClipboardSnapshot::ClipboardSnapshot() :
+	_root(cloneSubgraph(GlobalSceneGraph().root(), scene::traverseSelected))
+{}
+
+ClipboardSnapshot::~ClipboardSnapshot()
+{}
+
+void ClipboardSnapshot::exportToStream(std::ostream& stream, const map::MapFormatPtr& format)
+{
+	assert(format);
+
+	map::MapExporter exporter(*format->getMapWriter(), _root, stream);
+	exporter.exportMap(_root, scene::traverse);
+}
+
+void ClipboardSnapshot::pasteToMap()
+{
+	GlobalSelectionSystem().setSelectedAll(false);
+
+	// Work on a copy, the snapshot can be pasted more than once
+	auto root = cloneSubgraph(_root, scene::traverse);
+
+	// The cloned primitives are already positioned in world space, no need
+	// to add the origin of their parent entities like after parsing a map.
+	map::algorithm::prepareNamesForImport(GlobalMap().getRoot(), root);
+	map::algorithm::mergeMap(root);
+}
+
+} // namespace
+
+} // namespace
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <ostream>
+#include <memory>
+#include "imapformat.h"
+
+namespace scene
+{
+class BasicRootNode;
+}
+
+namespace selection
+{
+
+namespace clipboard
+{
+
+/**
+ * A detached copy of the map objects that have been copied to the clipboard.
+ * Pasting into the same DarkRadiant instance clones the snapshot nodes instead
+ * of going through the map parsers, the map text is only generated when the
+ * system clipboard is actually read.
+ */
+class ClipboardSnapshot
+{
+private:
+	// Holds the cloned entities and primitives, structured like a parsed map
+	std::shared_ptr<scene::BasicRootNode> _root;
+
+public:
+	// Captures the current map selection (entities including their children,
+	// selected primitives along with their parent entity)
+	ClipboardSnapshot();
+
+	~ClipboardSnapshot();
+
+	// Writes the snapshot contents to the given stream, using the given map format
+	void exportToStream(std::ostream& stream, const map::MapFormatPtr& format);
+
+	// De-selects the current selection and inserts a copy of the snapshot
+	// into the active map, the inserted objects are selected afterwards.
+	void pasteToMap();
+};
+
+} // namespace
+
+} // namespace
@@ -54,11 +54,32 @@ TexturePtr CShader::getEditorImage()
         _editorTexture = GetTextureManager().getBinding(
             _template->getEditorTexture()
         );
+
+        // The thumbnail is not needed anymore
+        _editorThumbnail.reset();
     }
 
     return _editorTexture;
 }
 
+TexturePtr CShader::getEditorImageThumbnail()
+{
+    // No need for a thumbnail if the full image is realised already
+    if (_editorTexture)
+    {
+        return _editorTexture;
+    }
+
+    if (!_editorThumbnail)
+    {
+        _editorThumbnail = GetShaderSystem()->getThumbnailCache().getThumbnail(
+            _name, _template->getEditorTexture()
+        );
+    }
+
+    return _editorThumbnail;
+}
+
 bool CShader::isEditorImageNoTex()
 {
 	return (getEditorImage() == GetTextureManager().getShaderNotFound());
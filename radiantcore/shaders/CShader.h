@@ -24,6 +24,9 @@ private:
 	// The 2D editor texture
 	TexturePtr _editorTexture;
 
+	// The downscaled editor image shown in the texture browsers
+	TexturePtr _editorThumbnail;
+
 	TexturePtr _texLightFalloff;
 
 	bool m_bInUse;
@@ -48,6 +51,7 @@ public:
     int getSortRequest() const;
     float getPolygonOffset() const;
 	TexturePtr getEditorImage();
+	TexturePtr getEditorImageThumbnail();
 	bool isEditorImageNoTex();
 
 	// Return the light falloff texture (Z dimension).
@@ -62,6 +62,7 @@ void Doom3ShaderSystem::construct()
 {
     _library = std::make_shared<ShaderLibrary>();
     _textureManager = std::make_shared<GLTextureManager>();
+    _thumbnailCache.reset(new ThumbnailCache);
 
     // Register this class as VFS observer
     GlobalFileSystem().addObserver(*this);
@@ -162,6 +163,10 @@ void Doom3ShaderSystem::freeShaders() {
     _library->clear();
     _defLoader.reset();
     _textureManager->checkBindings();
+
+    // Stop generating thumbnails and keep what we have so far
+    _thumbnailCache->save();
+
     activeShadersChangedNotify();
 }
 
@@ -244,6 +249,11 @@ GLTextureManager& Doom3ShaderSystem::getTextureManager()
     return *_textureManager;
 }
 
+ThumbnailCache& Doom3ShaderSystem::getThumbnailCache()
+{
+    return *_thumbnailCache;
+}
+
 // Get default textures
 TexturePtr Doom3ShaderSystem::getDefaultInteractionTexture(ShaderLayer::Type type)
 {
@@ -296,6 +306,16 @@ TexturePtr Doom3ShaderSystem::loadTextureFromFile(const std::string& filename)
     return _textureManager->getBinding(filename);
 }
 
+void Doom3ShaderSystem::ensureTextureResident(GLuint textureNumber)
+{
+    _textureManager->ensureResident(textureNumber);
+}
+
+TextureMemoryUsage Doom3ShaderSystem::getTextureMemoryUsage()
+{
+    return _textureManager->getMemoryUsage();
+}
+
 IShaderExpressionPtr Doom3ShaderSystem::createShaderExpressionFromString(const std::string& exprStr)
 {
     return ShaderExpression::createFromString(exprStr);
@@ -323,6 +343,8 @@ const StringSet& Doom3ShaderSystem::getDependencies() const
         _dependencies.insert(MODULE_VIRTUALFILESYSTEM);
         _dependencies.insert(MODULE_XMLREGISTRY);
         _dependencies.insert(MODULE_GAMEMANAGER);
+        _dependencies.insert(MODULE_IMAGELOADER);
+        _dependencies.insert(MODULE_PREFERENCESYSTEM);
     }
 
     return _dependencies;
@@ -11,6 +11,7 @@
 #include "ShaderLibrary.h"
 #include "TableDefinition.h"
 #include "textures/GLTextureManager.h"
+#include "textures/ThumbnailCache.h"
 #include "ThreadedDefLoader.h"
 
 namespace shaders 
@@ -34,6 +35,9 @@ class Doom3ShaderSystem :
 	// The manager that handles the texture caching.
 	GLTextureManagerPtr _textureManager;
 
+	// Persistent editor image thumbnails for the texture browsers
+	std::unique_ptr<ThumbnailCache> _thumbnailCache;
+
 	// Active shaders list changed signal
     sigc::signal<void> _signalActiveShadersChanged;
 
@@ -101,8 +105,13 @@ public:
 	 */
     TexturePtr loadTextureFromFile(const std::string& filename) override;
 
+    void ensureTextureResident(GLuint textureNumber) override;
+    TextureMemoryUsage getTextureMemoryUsage() override;
+
 	GLTextureManager& getTextureManager();
 
+	ThumbnailCache& getThumbnailCache();
+
     // Get default textures for D,B,S layers
     TexturePtr getDefaultInteractionTexture(ShaderLayer::Type t) override;
 
@@ -5,17 +5,58 @@
 #include "itextstream.h"
 #include "texturelib.h"
 #include "igl.h"
+#include "ipreferencesystem.h"
+#include "registry/registry.h"
 #include "../MapExpression.h"
 #include "TextureManipulator.h"
 #include "parser/DefTokeniser.h"
 
+#include <cstring>
+#include <algorithm>
+
 namespace
 {
     const std::string SHADER_NOT_FOUND = "notex.bmp";
+
+    const std::string RKEY_TEXTURES_COMPRESSION = "user/ui/textures/compressOnUpload";
+    const std::string RKEY_TEXTURES_MEMORY_BUDGET = "user/ui/textures/memoryBudget";
+
+    // Textures used this recently are likely on screen, evicting them
+    // would only cause them to be uploaded again in the next frame
+    const std::chrono::seconds EVICTION_DELAY(2);
 }
 
 namespace shaders {
 
+GLTextureManager::GLTextureManager() :
+    _residentBytes(0),
+    _compressionEnabled(registry::getValue<bool>(RKEY_TEXTURES_COMPRESSION)),
+    _memoryBudget(0),
+    _maxTextureSize(0)
+{
+    keyChanged();
+
+    GlobalRegistry().signalForKey(RKEY_TEXTURES_COMPRESSION).connect(
+        sigc::mem_fun(this, &GLTextureManager::keyChanged)
+    );
+    GlobalRegistry().signalForKey(RKEY_TEXTURES_MEMORY_BUDGET).connect(
+        sigc::mem_fun(this, &GLTextureManager::keyChanged)
+    );
+
+    constructPreferences();
+}
+
+GLTextureManager::~GLTextureManager()
+{
+    _compressor.stopWorkers();
+
+    // Textures still referenced elsewhere must not call back into this instance
+    for (const auto& pair : _managedTextures)
+    {
+        pair.second->detach();
+    }
+}
+
 void GLTextureManager::checkBindings()
 {
     // Check the TextureMap for unique pointers and release them
@@ -57,8 +98,14 @@ TexturePtr GLTextureManager::getBinding(NamedBindablePtr bindable)
     }
     else
     {
+        // Images are uploaded by this manager, other bindables (like
+        // cube maps) bind themselves
+        auto mapExpression = std::dynamic_pointer_cast<MapExpression>(bindable);
+
         // Create and insert texture object, if it is valid
-        TexturePtr texture = bindable->bindTexture(identifier);
+        TexturePtr texture = mapExpression ?
+            createTexture(identifier, [mapExpression]() { return mapExpression->getImage(); }) :
+            bindable->bindTexture(identifier);
         if (texture)
         {
             _textures.insert(TextureMap::value_type(identifier, texture));
@@ -80,13 +127,14 @@ TexturePtr GLTextureManager::getBinding(const std::string& fullPath)
 
     if (i == _textures.end())
     {
-        ImagePtr img = GlobalImageLoader().imageFromFile(fullPath);
+        TexturePtr texture = createTexture(fullPath, [fullPath]()
+        {
+            return GlobalImageLoader().imageFromFile(fullPath);
+        });
 
-        // see if the MapExpression returned a valid image
-        if (img != NULL)
+        // see if the loader returned a valid image
+        if (texture)
         {
-            // Constructor returned a valid image, now create the texture object
-            TexturePtr texture = img->bindTexture(fullPath);
             _textures[fullPath] = texture;
         }
         else
@@ -134,4 +182,261 @@ TexturePtr GLTextureManager::loadStandardTexture(const std::string& filename)
     return TexturePtr();
 }
 
+TexturePtr GLTextureManager::createTexture(const std::string& name, const ManagedTexture::ImageLoader& loader)
+{
+    ImagePtr image = loader();
+
+    if (!image || image->getWidth() == 0 || image->getHeight() == 0)
+    {
+        return TexturePtr();
+    }
+
+    // Precompressed images come with their own mipmaps
+    if (image->isPrecompressed())
+    {
+        return image->bindTexture(name);
+    }
+
+    auto texture = std::make_shared<ManagedTexture>(*this, name, image->getWidth(), image->getHeight(), loader);
+    _managedTextures[texture->getTextureNumber()] = texture.get();
+
+    uploadTexture(*texture, image);
+
+    return texture;
+}
+
+void GLTextureManager::uploadTexture(ManagedTexture& texture, const ImagePtr& image)
+{
+    if (_maxTextureSize == 0)
+    {
+        GLint maxTextureSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+
+        _maxTextureSize = maxTextureSize > 0 ? static_cast<std::size_t>(maxTextureSize) : 1024;
+    }
+
+    bool compress = isCompressionEnabled();
+    ImagePtr source = image;
+
+    if (compress && texture._cacheKey == 0)
+    {
+        if (!source) source = texture.loadImage();
+        if (source) texture._cacheKey = render::getImageHash(*source);
+    }
+
+    bool wasResident = texture.isResident();
+    std::size_t previousSize = texture.getMemorySize();
+    render::MipMapChain chain;
+
+    if (compress && texture._cacheKey != 0 &&
+        _compressor.loadFromCache(texture._cacheKey, texture.getWidth(), texture.getHeight(), chain))
+    {
+        texture.upload(chain, _maxTextureSize);
+    }
+    else
+    {
+        if (!source) source = texture.loadImage();
+
+        if (source && !source->isPrecompressed() && source->getWidth() > 0 && source->getHeight() > 0)
+        {
+            chain = render::MipMapChain::CreateFromImage(*source);
+        }
+
+        if (chain.empty())
+        {
+            rError() << "[shaders] Unable to load texture: " << texture.getName() << std::endl;
+
+            // Keep the single pixel, don't retry on every use
+            chain.levels.push_back(render::MipMapChain::Level{ 1, 1, 0, 4 });
+            chain.data.resize(4);
+            std::memcpy(chain.data.data(), &texture._averageColour, 4);
+            chain.averageColour = texture._averageColour;
+
+            texture.upload(chain, _maxTextureSize);
+        }
+        else
+        {
+            // Use the plain chain until the compressed one is ready
+            texture.upload(chain, _maxTextureSize);
+
+            if (compress && texture._cacheKey != 0 && !texture._compressionPending)
+            {
+                texture._compressionPending = true;
+
+                // Textures sharing the same image share the job
+                auto& pending = _pendingCompressions[texture._cacheKey];
+                pending.push_back(&texture);
+
+                if (pending.size() == 1)
+                {
+                    _compressor.addJob(texture._cacheKey, std::move(chain));
+                }
+            }
+        }
+    }
+
+    _residentBytes = _residentBytes - previousSize + texture.getMemorySize();
+
+    if (!wasResident)
+    {
+        texture._lruPosition = _residentTextures.insert(_residentTextures.begin(), &texture);
+    }
+
+    markAsUsed(texture);
+    evictUnusedTextures();
+}
+
+void GLTextureManager::ensureResident(GLuint textureNum)
+{
+    auto found = _managedTextures.find(textureNum);
+
+    if (found != _managedTextures.end())
+    {
+        ensureResident(*found->second);
+    }
+}
+
+void GLTextureManager::ensureResident(ManagedTexture& texture)
+{
+    if (_compressor.hasResults())
+    {
+        processCompressedTextures();
+    }
+
+    if (texture.isResident())
+    {
+        markAsUsed(texture);
+    }
+    else
+    {
+        uploadTexture(texture, ImagePtr());
+    }
+}
+
+void GLTextureManager::onTextureDestroyed(ManagedTexture& texture)
+{
+    if (texture.isResident())
+    {
+        _residentBytes -= texture.getMemorySize();
+        _residentTextures.erase(texture._lruPosition);
+    }
+
+    if (texture._compressionPending)
+    {
+        auto found = _pendingCompressions.find(texture._cacheKey);
+
+        if (found != _pendingCompressions.end())
+        {
+            auto& pending = found->second;
+            pending.erase(std::remove(pending.begin(), pending.end(), &texture), pending.end());
+        }
+    }
+
+    _managedTextures.erase(texture.getTextureNumber());
+}
+
+TextureMemoryUsage GLTextureManager::getMemoryUsage() const
+{
+    TextureMemoryUsage usage;
+
+    usage.residentBytes = _residentBytes;
+    usage.budgetBytes = _memoryBudget;
+    usage.numResident = _residentTextures.size();
+    usage.numEvicted = _managedTextures.size() - _residentTextures.size();
+
+    for (const ManagedTexture* texture : _residentTextures)
+    {
+        if (texture->isCompressed())
+        {
+            ++usage.numCompressed;
+        }
+    }
+
+    return usage;
+}
+
+void GLTextureManager::markAsUsed(ManagedTexture& texture)
+{
+    texture._lastUsed = std::chrono::steady_clock::now();
+
+    // Move it to the front of the list
+    _residentTextures.splice(_residentTextures.begin(), _residentTextures, texture._lruPosition);
+}
+
+void GLTextureManager::evictUnusedTextures()
+{
+    if (_memoryBudget == 0) return;
+
+    auto now = std::chrono::steady_clock::now();
+
+    while (_residentBytes > _memoryBudget && !_residentTextures.empty())
+    {
+        ManagedTexture& oldest = *_residentTextures.back();
+
+        // The remaining textures have all been used even more recently
+        if (now - oldest._lastUsed < EVICTION_DELAY)
+        {
+            break;
+        }
+
+        evictTexture(oldest);
+    }
+}
+
+void GLTextureManager::evictTexture(ManagedTexture& texture)
+{
+    _residentBytes -= texture.getMemorySize();
+    _residentTextures.erase(texture._lruPosition);
+
+    texture.evict();
+}
+
+void GLTextureManager::processCompressedTextures()
+{
+    for (auto& result : _compressor.collectResults())
+    {
+        auto found = _pendingCompressions.find(result.key);
+
+        if (found == _pendingCompressions.end()) continue;
+
+        std::vector<ManagedTexture*> textures = std::move(found->second);
+        _pendingCompressions.erase(found);
+
+        for (ManagedTexture* pendingTexture : textures)
+        {
+            ManagedTexture& texture = *pendingTexture;
+
+            texture._compressionPending = false;
+
+            // Evicted textures will read the compressed chain from the cache
+            if (!texture.isResident()) continue;
+
+            _residentBytes -= texture.getMemorySize();
+            texture.upload(result.chain, _maxTextureSize);
+            _residentBytes += texture.getMemorySize();
+        }
+    }
+}
+
+bool GLTextureManager::isCompressionEnabled() const
+{
+    return _compressionEnabled && GLEW_EXT_texture_compression_s3tc;
+}
+
+void GLTextureManager::keyChanged()
+{
+    _compressionEnabled = registry::getValue<bool>(RKEY_TEXTURES_COMPRESSION);
+
+    int budget = registry::getValue<int>(RKEY_TEXTURES_MEMORY_BUDGET);
+    _memoryBudget = budget > 0 ? static_cast<std::size_t>(budget) * 1024 * 1024 : 0;
+}
+
+void GLTextureManager::constructPreferences()
+{
+    IPreferencePage& page = GlobalPreferenceSystem().getPage("Settings/Textures");
+
+    page.appendCheckBox("Compress textures on upload (S3TC)", RKEY_TEXTURES_COMPRESSION);
+    page.appendSpinner("Texture memory budget in MB (0 = unlimited)", RKEY_TEXTURES_MEMORY_BUDGET, 0, 65536, 1);
+}
+
 } // namespace shaders
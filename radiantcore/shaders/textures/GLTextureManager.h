@@ -3,13 +3,19 @@
 
 #include "ishaders.h"
 #include <map>
+#include <list>
+#include <unordered_map>
+#include <sigc++/trackable.h>
 #include "../MapExpression.h"
 #include "texturelib.h"
+#include "ManagedTexture.h"
+#include "TextureCompressor.h"
 
 namespace shaders
 {
 
-class GLTextureManager
+class GLTextureManager :
+	public sigc::trackable
 {
 	// The mapping between texturekeys and Texture instances
 	typedef std::map<std::string, TexturePtr> TextureMap;
@@ -18,12 +24,35 @@ class GLTextureManager
 	// The fallback textures in case a texture is empty or broken
 	TexturePtr _shaderNotFound;
 
+	// All textures uploaded from plain images, by texture number
+	std::unordered_map<GLuint, ManagedTexture*> _managedTextures;
+
+	// The resident managed textures, most recently used first
+	std::list<ManagedTexture*> _residentTextures;
+	std::size_t _residentBytes;
+
+	// Compresses the uploaded images in the background
+	TextureCompressor _compressor;
+
+	// The textures waiting for their compressed version, by cache key
+	std::unordered_map<std::uint64_t, std::vector<ManagedTexture*>> _pendingCompressions;
+
+	bool _compressionEnabled;
+
+	// Texture memory budget in bytes, 0 if unlimited
+	std::size_t _memoryBudget;
+
+	// Gets filled in by an OpenGL query
+	std::size_t _maxTextureSize;
+
 private:
 
 	// Constructs the fallback textures like "Shader Image Missing"
 	TexturePtr loadStandardTexture(const std::string& filename);
 
 public:
+	GLTextureManager();
+	~GLTextureManager();
 
     /**
      * \brief
@@ -51,6 +80,36 @@ public:
 	 */
 	void checkBindings();
 
+	// Uploads the given texture again if it has been evicted, and marks it
+	// as recently used. Unknown texture numbers are ignored.
+	void ensureResident(GLuint textureNum);
+	void ensureResident(ManagedTexture& texture);
+
+	// Called by managed textures going out of scope
+	void onTextureDestroyed(ManagedTexture& texture);
+
+	TextureMemoryUsage getMemoryUsage() const;
+
+private:
+	// Loads the image and uploads it, precompressed images are bound as they are
+	TexturePtr createTexture(const std::string& name, const ManagedTexture::ImageLoader& loader);
+
+	// Uploads the texture from the cache, the given image or its loader (if image is empty)
+	void uploadTexture(ManagedTexture& texture, const ImagePtr& image);
+
+	// Evicts the least recently used textures until the budget is met
+	void evictUnusedTextures();
+	void evictTexture(ManagedTexture& texture);
+
+	// Uploads the compressed versions finished by the workers
+	void processCompressedTextures();
+
+	void markAsUsed(ManagedTexture& texture);
+
+	bool isCompressionEnabled() const;
+
+	void keyChanged();
+	void constructPreferences();
 };
 
 typedef std::shared_ptr<GLTextureManager> GLTextureManagerPtr;
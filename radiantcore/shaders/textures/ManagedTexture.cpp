@@ -0,0 +1,161 @@
+#include "ManagedTexture.h"
+
+#include "GLTextureManager.h"
+#include "TextureCompressor.h"
+#include "debugging/gl.h"
+
+namespace shaders
+{
+
+namespace
+{
+	// Binds the given texture to the active unit, restoring the previous
+	// binding when going out of scope. The render system tracks the bound
+	// textures, uploads in between must not disturb them.
+	class ScopedTextureBinding
+	{
+	private:
+		GLint _previous;
+
+	public:
+		ScopedTextureBinding(GLuint textureNum)
+		{
+			glGetIntegerv(GL_TEXTURE_BINDING_2D, &_previous);
+			glBindTexture(GL_TEXTURE_2D, textureNum);
+		}
+
+		~ScopedTextureBinding()
+		{
+			glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(_previous));
+		}
+	};
+}
+
+ManagedTexture::ManagedTexture(GLTextureManager& manager, const std::string& name,
+		std::size_t width, std::size_t height, const ImageLoader& loader) :
+	_manager(&manager),
+	_name(name),
+	_textureNum(0),
+	_width(width),
+	_height(height),
+	_loader(loader),
+	_cacheKey(0),
+	_resident(false),
+	_compressed(false),
+	_compressionPending(false),
+	_memorySize(0),
+	_averageColour({ 0, 0, 0, 255 })
+{
+	glGenTextures(1, &_textureNum);
+}
+
+ManagedTexture::~ManagedTexture()
+{
+	if (_manager != nullptr)
+	{
+		_manager->onTextureDestroyed(*this);
+	}
+
+	glDeleteTextures(1, &_textureNum);
+}
+
+std::string ManagedTexture::getName() const
+{
+	return _name;
+}
+
+GLuint ManagedTexture::getGLTexNum() const
+{
+	if (_manager != nullptr)
+	{
+		_manager->ensureResident(const_cast<ManagedTexture&>(*this));
+	}
+
+	return _textureNum;
+}
+
+std::size_t ManagedTexture::getWidth() const
+{
+	return _width;
+}
+
+std::size_t ManagedTexture::getHeight() const
+{
+	return _height;
+}
+
+void ManagedTexture::upload(const render::MipMapChain& chain, std::size_t maxSize)
+{
+	debug::assertNoGlErrors();
+
+	ScopedTextureBinding binding(_textureNum);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE);
+
+	// Skip the levels exceeding the maximum texture size
+	std::size_t first = 0;
+
+	while (first + 1 < chain.levels.size() &&
+		(chain.levels[first].width > maxSize || chain.levels[first].height > maxSize))
+	{
+		++first;
+	}
+
+	_memorySize = 0;
+
+	for (std::size_t i = first; i < chain.levels.size(); ++i)
+	{
+		const render::MipMapChain::Level& level = chain.levels[i];
+		GLint glLevel = static_cast<GLint>(i - first);
+
+		if (chain.compressed)
+		{
+			glCompressedTexImage2D(GL_TEXTURE_2D, glLevel, chain.format,
+				static_cast<GLsizei>(level.width), static_cast<GLsizei>(level.height),
+				0, static_cast<GLsizei>(level.size), chain.getLevelData(i));
+		}
+		else
+		{
+			glTexImage2D(GL_TEXTURE_2D, glLevel, GL_RGBA,
+				static_cast<GLsizei>(level.width), static_cast<GLsizei>(level.height),
+				0, GL_RGBA, GL_UNSIGNED_BYTE, chain.getLevelData(i));
+		}
+
+		_memorySize += level.size;
+	}
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(chain.levels.size() - first - 1));
+
+	_resident = true;
+	_compressed = chain.compressed;
+	_averageColour = chain.averageColour;
+
+	debug::assertNoGlErrors();
+}
+
+void ManagedTexture::evict()
+{
+	ScopedTextureBinding binding(_textureNum);
+
+	// Zero-sized levels release their storage
+	GLint maxLevel = 0;
+	glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &maxLevel);
+
+	for (GLint level = 1; level <= maxLevel; ++level)
+	{
+		glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	}
+
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &_averageColour);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+	_resident = false;
+	_compressed = false;
+	_memorySize = 0;
+
+	debug::assertNoGlErrors();
+}
+
+} // namespace shaders
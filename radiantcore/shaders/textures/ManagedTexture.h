@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Texture.h"
+#include "iimage.h"
+#include "RGBAImage.h"
+
+#include <list>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+
+namespace render { struct MipMapChain; }
+
+namespace shaders
+{
+
+class GLTextureManager;
+
+/**
+ * A 2D texture uploaded by the GLTextureManager. Its storage can be released
+ * to keep the texture memory within the configured budget, it is uploaded
+ * again the next time it is used.
+ *
+ * The GL texture number is assigned once and never changes, since the render
+ * system keeps the numbers of the textures it is using.
+ */
+class ManagedTexture :
+	public Texture
+{
+public:
+	// Loads the source image when the texture needs to be uploaded again
+	typedef std::function<ImagePtr()> ImageLoader;
+
+private:
+	friend class GLTextureManager;
+
+	// The manager keeping track of this texture, null after it has been destroyed
+	GLTextureManager* _manager;
+
+	std::string _name;
+	GLuint _textureNum;
+
+	// Dimensions of the source image
+	std::size_t _width;
+	std::size_t _height;
+
+	ImageLoader _loader;
+
+	// Hash of the source pixels, used as key into the compressed texture cache
+	std::uint64_t _cacheKey;
+
+	bool _resident;
+	bool _compressed;
+	bool _compressionPending;
+
+	// Bytes used by the currently uploaded mipmap chain
+	std::size_t _memorySize;
+
+	// Colour of the single pixel left behind while evicted
+	RGBAPixel _averageColour;
+
+	// Maintained by the manager for its least-recently-used list
+	std::list<ManagedTexture*>::iterator _lruPosition;
+	std::chrono::steady_clock::time_point _lastUsed;
+
+public:
+	ManagedTexture(GLTextureManager& manager, const std::string& name,
+		std::size_t width, std::size_t height, const ImageLoader& loader);
+
+	~ManagedTexture();
+
+	/* Texture implementation */
+	std::string getName() const override;
+	GLuint getGLTexNum() const override; // uploads the texture if evicted
+	std::size_t getWidth() const override;
+	std::size_t getHeight() const override;
+
+	// The texture number, without checking whether the texture is resident
+	GLuint getTextureNumber() const
+	{
+		return _textureNum;
+	}
+
+	bool isResident() const
+	{
+		return _resident;
+	}
+
+	bool isCompressed() const
+	{
+		return _compressed;
+	}
+
+	std::size_t getMemorySize() const
+	{
+		return _memorySize;
+	}
+
+	ImagePtr loadImage() const
+	{
+		return _loader ? _loader() : ImagePtr();
+	}
+
+	// Replaces the texture storage with the given mipmap chain, levels
+	// larger than maxSize are left out
+	void upload(const render::MipMapChain& chain, std::size_t maxSize);
+
+	// Releases the texture storage, leaving a single pixel of the average colour
+	void evict();
+
+	// Called by the manager when it is destroyed before this texture
+	void detach()
+	{
+		_manager = nullptr;
+	}
+};
+
+} // namespace shaders
@@ -0,0 +1,251 @@
+#include "TextureCompressor.h"
+
+#include "imodule.h"
+#include "itextstream.h"
+#include "os/fs.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <algorithm>
+#include <random>
+
+namespace shaders
+{
+
+namespace
+{
+	const char* const CACHE_FOLDER = "texturecache/";
+	const char* const CACHE_EXTENSION = ".dxt";
+
+	const char CACHE_MAGIC[4] = { 'D', 'R', 'T', 'C' };
+	const std::uint32_t CACHE_VERSION = 2;
+
+	// Version, format, level count and average colour
+	struct CacheHeader
+	{
+		std::uint32_t version;
+		std::uint32_t format;
+		std::uint32_t numLevels;
+		RGBAPixel averageColour;
+	};
+
+	struct CacheLevel
+	{
+		std::uint32_t width;
+		std::uint32_t height;
+		std::uint32_t size;
+	};
+
+	inline std::size_t getBlockSize(std::uint32_t format)
+	{
+		return format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ? 8 : 16;
+	}
+}
+
+TextureCompressor::TextureCompressor() :
+	_stopWorkers(false),
+	_nextTempFileId(std::random_device()()),
+	_hasResults(false)
+{
+	_cachePath = module::GlobalModuleRegistry().getApplicationContext().getSettingsPath() + CACHE_FOLDER;
+}
+
+TextureCompressor::~TextureCompressor()
+{
+	stopWorkers();
+}
+
+std::string TextureCompressor::getCacheFilename(std::uint64_t key) const
+{
+	std::ostringstream filename;
+	filename << _cachePath << std::hex << std::setw(16) << std::setfill('0') << key << CACHE_EXTENSION;
+
+	return filename.str();
+}
+
+bool TextureCompressor::loadFromCache(std::uint64_t key, std::size_t width, std::size_t height,
+	render::MipMapChain& chain) const
+{
+	std::ifstream stream(getCacheFilename(key), std::ios::binary);
+
+	if (!stream) return false;
+
+	char magic[4];
+	CacheHeader header;
+
+	if (!stream.read(magic, sizeof(magic)) || std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0 ||
+		!stream.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+		header.version != CACHE_VERSION || header.numLevels == 0 || header.numLevels > 32 ||
+		(header.format != GL_COMPRESSED_RGB_S3TC_DXT1_EXT && header.format != GL_COMPRESSED_RGBA_S3TC_DXT5_EXT))
+	{
+		return false;
+	}
+
+	render::MipMapChain result;
+	result.compressed = true;
+	result.format = header.format;
+	result.averageColour = header.averageColour;
+
+	std::size_t offset = 0;
+
+	for (std::uint32_t i = 0; i < header.numLevels; ++i)
+	{
+		CacheLevel level;
+
+		if (!stream.read(reinterpret_cast<char*>(&level), sizeof(level))) return false;
+
+		// Each level needs to be half the size of the previous one, starting with the image size
+		if (level.width != width || level.height != height ||
+			level.size != ((width + 3) / 4) * ((height + 3) / 4) * getBlockSize(header.format))
+		{
+			return false;
+		}
+
+		width = std::max<std::size_t>(1, width / 2);
+		height = std::max<std::size_t>(1, height / 2);
+
+		result.levels.push_back(render::MipMapChain::Level{ level.width, level.height, offset, level.size });
+		offset += level.size;
+	}
+
+	result.data.resize(offset);
+
+	if (!stream.read(reinterpret_cast<char*>(result.data.data()), offset)) return false;
+
+	chain = std::move(result);
+	return true;
+}
+
+void TextureCompressor::saveToCache(std::uint64_t key, const render::MipMapChain& chain) const
+{
+	std::string filename = getCacheFilename(key);
+
+	// Another instance might be writing the same file
+	std::string tempFilename = filename + "." + std::to_string(_nextTempFileId++) + ".tmp";
+
+	try
+	{
+		fs::create_directories(_cachePath);
+
+		{
+			std::ofstream stream(tempFilename, std::ios::binary);
+
+			CacheHeader header{ CACHE_VERSION, static_cast<std::uint32_t>(chain.format),
+				static_cast<std::uint32_t>(chain.levels.size()), chain.averageColour };
+
+			stream.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+			for (const auto& level : chain.levels)
+			{
+				CacheLevel cacheLevel{ static_cast<std::uint32_t>(level.width),
+					static_cast<std::uint32_t>(level.height), static_cast<std::uint32_t>(level.size) };
+
+				stream.write(reinterpret_cast<const char*>(&cacheLevel), sizeof(cacheLevel));
+			}
+
+			stream.write(reinterpret_cast<const char*>(chain.data.data()), chain.data.size());
+
+			if (!stream)
+			{
+				throw std::runtime_error("write failed");
+			}
+		}
+
+		// Readers never see a partially written file
+		fs::rename(tempFilename, filename);
+	}
+	catch (std::exception& ex)
+	{
+		rWarning() << "[shaders] Unable to write texture cache file " << filename
+			<< ": " << ex.what() << std::endl;
+	}
+}
+
+void TextureCompressor::addJob(std::uint64_t key, render::MipMapChain&& chain)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+
+	// The pending job will report the result for this key as well
+	if (!_pendingKeys.insert(key).second) return;
+
+	_jobs.emplace_back(Job{ key, std::move(chain) });
+
+	// Start the workers on demand, leave some cores to the UI
+	if (_workers.empty())
+	{
+		std::size_t numWorkers = std::max(1u, std::thread::hardware_concurrency() / 2);
+
+		for (std::size_t i = 0; i < numWorkers; ++i)
+		{
+			_workers.emplace_back(&TextureCompressor::processJobs, this);
+		}
+	}
+
+	_jobAdded.notify_one();
+}
+
+std::vector<TextureCompressor::Result> TextureCompressor::collectResults()
+{
+	std::vector<Result> results;
+
+	std::lock_guard<std::mutex> lock(_lock);
+
+	results.swap(_results);
+	_hasResults = false;
+
+	return results;
+}
+
+void TextureCompressor::stopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+
+		_stopWorkers = true;
+		_jobs.clear();
+	}
+
+	_jobAdded.notify_all();
+
+	for (auto& worker : _workers)
+	{
+		worker.join();
+	}
+
+	_workers.clear();
+	_pendingKeys.clear();
+	_stopWorkers = false;
+}
+
+void TextureCompressor::processJobs()
+{
+	while (true)
+	{
+		Job job;
+
+		{
+			std::unique_lock<std::mutex> lock(_lock);
+
+			_jobAdded.wait(lock, [this]() { return _stopWorkers || !_jobs.empty(); });
+
+			if (_stopWorkers) return;
+
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+		}
+
+		render::MipMapChain compressed = render::MipMapChain::Compress(job.chain);
+
+		saveToCache(job.key, compressed);
+
+		std::lock_guard<std::mutex> lock(_lock);
+		_pendingKeys.erase(job.key);
+		_results.emplace_back(Result{ job.key, std::move(compressed) });
+		_hasResults = true;
+	}
+}
+
+} // namespace shaders
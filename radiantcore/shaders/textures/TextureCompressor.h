@@ -0,0 +1,93 @@
+#pragma once
+
+#include "iimage.h"
+#include "render/MipMapChain.h"
+
+#include <deque>
+#include <set>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <cstdint>
+
+namespace shaders
+{
+
+/**
+ * Compresses textures in the background and keeps the compressed mipmap
+ * chains in a cache folder below the settings path.
+ *
+ * Cache files are named after the render::getImageHash() of the source
+ * pixels, so modified images and changed map expressions produce a new cache
+ * entry, and images shared by several materials are compressed only once:
+ * jobs for a key which is already being compressed are dropped, the result
+ * is reported once for all of them.
+ */
+class TextureCompressor
+{
+public:
+	struct Result
+	{
+		std::uint64_t key;
+		render::MipMapChain chain;
+	};
+
+private:
+	struct Job
+	{
+		std::uint64_t key;
+		render::MipMapChain chain;
+	};
+
+	std::string _cachePath;
+
+	// Worker threads and their queues, guarded by _lock
+	std::mutex _lock;
+	std::condition_variable _jobAdded;
+	std::deque<Job> _jobs;
+	std::vector<Result> _results;
+	std::vector<std::thread> _workers;
+	bool _stopWorkers;
+
+	// Keys of the queued jobs and the ones being compressed
+	std::set<std::uint64_t> _pendingKeys;
+
+	// Makes the names of the temporary cache files unique
+	mutable std::atomic<std::uint64_t> _nextTempFileId;
+
+	// Set by the workers, to let the main thread check for results without locking
+	std::atomic<bool> _hasResults;
+
+public:
+	TextureCompressor();
+	~TextureCompressor();
+
+	// Reads the compressed chain with the given key from the cache folder,
+	// returns false if it is not cached yet or doesn't match the given size
+	bool loadFromCache(std::uint64_t key, std::size_t width, std::size_t height, render::MipMapChain& chain) const;
+
+	// Queues the given RGBA chain for compression, unless the key is pending already
+	void addJob(std::uint64_t key, render::MipMapChain&& chain);
+
+	bool hasResults() const
+	{
+		return _hasResults;
+	}
+
+	// Returns the chains compressed since the last call
+	std::vector<Result> collectResults();
+
+	// Discards the pending jobs and stops the worker threads
+	void stopWorkers();
+
+private:
+	std::string getCacheFilename(std::uint64_t key) const;
+	void saveToCache(std::uint64_t key, const render::MipMapChain& chain) const;
+
+	void processJobs();
+};
+
+} // namespace shaders
@@ -0,0 +1,650 @@
+#include "ThumbnailCache.h"
+
+#include "imodule.h"
+#include "ifilesystem.h"
+#include "itextstream.h"
+#include "igl.h"
+#include "BasicTexture2D.h"
+#include "debugging/gl.h"
+#include "string/case_conv.h"
+#include "string/predicate.h"
+
+#include "../MapExpression.h"
+#include "../Doom3ShaderSystem.h"
+
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace shaders
+{
+
+namespace
+{
+	const char* const ATLAS_FILENAME = "thumbnails.atlas";
+	const char* const INDEX_FILENAME = "thumbnails.index";
+
+	const char ATLAS_MAGIC[4] = { 'D', 'R', 'T', 'H' };
+	const std::uint32_t ATLAS_VERSION = 1;
+
+	// Magic, version, tile size and a reserved field
+	const std::size_t HEADER_SIZE = 16;
+
+	// Tile info followed by the RGBA pixels of the largest possible thumbnail
+	const std::size_t SLOT_SIZE = 16 + ThumbnailCache::TILE_SIZE * ThumbnailCache::TILE_SIZE * 4;
+
+	// Generated tiles are written to the atlas in batches of this size (4 MB)
+	const std::size_t MAX_UNSAVED_TILES = 64;
+}
+
+/**
+ * Read-only view of a file mapped into memory. Falls back to reading the
+ * file contents into a buffer if the file can't be mapped.
+ */
+class ThumbnailCache::MappedFile
+{
+private:
+	const std::uint8_t* _data;
+	std::size_t _size;
+
+#ifdef WIN32
+	HANDLE _file;
+	HANDLE _mapping;
+#endif
+
+	std::vector<std::uint8_t> _buffer;
+
+public:
+	MappedFile(const std::string& path) :
+		_data(nullptr),
+		_size(0)
+	{
+#ifdef WIN32
+		_mapping = NULL;
+		_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+		if (_file == INVALID_HANDLE_VALUE) return;
+
+		LARGE_INTEGER size;
+
+		if (GetFileSizeEx(_file, &size) && size.QuadPart > 0)
+		{
+			_mapping = CreateFileMappingA(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+			if (_mapping != NULL)
+			{
+				_data = static_cast<const std::uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+				_size = _data != nullptr ? static_cast<std::size_t>(size.QuadPart) : 0;
+			}
+		}
+#else
+		int fd = open(path.c_str(), O_RDONLY);
+
+		if (fd == -1) return;
+
+		struct stat info;
+
+		if (fstat(fd, &info) == 0 && info.st_size > 0)
+		{
+			void* data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+			if (data != MAP_FAILED)
+			{
+				_data = static_cast<const std::uint8_t*>(data);
+				_size = static_cast<std::size_t>(info.st_size);
+			}
+		}
+
+		close(fd);
+#endif
+
+		if (_data == nullptr)
+		{
+			readIntoBuffer(path);
+		}
+	}
+
+	~MappedFile()
+	{
+		if (!_buffer.empty()) return;
+
+#ifdef WIN32
+		if (_data != nullptr) UnmapViewOfFile(_data);
+		if (_mapping != NULL) CloseHandle(_mapping);
+		if (_file != INVALID_HANDLE_VALUE) CloseHandle(_file);
+#else
+		if (_data != nullptr) munmap(const_cast<std::uint8_t*>(_data), _size);
+#endif
+	}
+
+	const std::uint8_t* data() const
+	{
+		return _data;
+	}
+
+	std::size_t size() const
+	{
+		return _size;
+	}
+
+private:
+	void readIntoBuffer(const std::string& path)
+	{
+		std::ifstream stream(path, std::ios::binary);
+
+		if (!stream) return;
+
+		_buffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+
+		_data = _buffer.empty() ? nullptr : _buffer.data();
+		_size = _buffer.size();
+	}
+};
+
+ThumbnailCache::ThumbnailCache() :
+	_loaded(false),
+	_numSlots(0),
+	_writeFailed(false),
+	_stopWorkers(false)
+{
+	std::string settingsPath = module::GlobalModuleRegistry().getApplicationContext().getSettingsPath();
+
+	_atlasPath = settingsPath + ATLAS_FILENAME;
+	_indexPath = settingsPath + INDEX_FILENAME;
+}
+
+ThumbnailCache::~ThumbnailCache()
+{
+	stopWorkers();
+}
+
+TexturePtr ThumbnailCache::getThumbnail(const std::string& materialName, const NamedBindablePtr& editorImage)
+{
+	auto imageExpression = std::dynamic_pointer_cast<ImageExpression>(editorImage);
+
+	// Map expressions and the built-in images like "_white" are bound as they are
+	if (!imageExpression || string::starts_with(imageExpression->getIdentifier(), "_"))
+	{
+		return GetTextureManager().getBinding(editorImage);
+	}
+
+	// Collect first, writing the new tiles to the atlas unloads it
+	collectResults();
+	ensureLoaded();
+
+	std::string key = string::to_lower_copy(materialName);
+	Entry& entry = _entries[key];
+
+	TexturePtr texture = entry.texture.lock();
+
+	if (texture || entry.pending)
+	{
+		return texture;
+	}
+
+	// Check the source image the first time this material is looked up
+	if (entry.filename.empty())
+	{
+		entry.filename = GlobalImageLoader().findImageFile(imageExpression->getIdentifier());
+
+		if (entry.filename.empty())
+		{
+			// The full editor image would not load either
+			return GetTextureManager().getShaderNotFound();
+		}
+
+		entry.stamp = GlobalFileSystem().getFileModificationTime(entry.filename);
+	}
+
+	auto generated = _newThumbnails.find(key);
+	auto indexed = _index.find(key);
+
+	if (generated != _newThumbnails.end() &&
+		generated->second.stamp == entry.stamp && generated->second.filename == entry.filename)
+	{
+		Thumbnail& thumbnail = generated->second;
+
+		if (thumbnail.image)
+		{
+			texture = thumbnail.image->bindTexture(entry.filename);
+
+			// Precompressed images are not kept in memory
+			_newThumbnails.erase(generated);
+		}
+		else if (!thumbnail.pixels.empty())
+		{
+			texture = uploadTile(entry.filename, thumbnail.info, thumbnail.pixels.data());
+		}
+		else
+		{
+			texture = GetTextureManager().getShaderNotFound();
+		}
+	}
+	else if (indexed != _index.end() &&
+		indexed->second.stamp == entry.stamp && indexed->second.filename == entry.filename)
+	{
+		const std::uint8_t* slot = _atlas->data() + HEADER_SIZE + indexed->second.slot * SLOT_SIZE;
+
+		TileInfo info;
+		std::memcpy(&info, slot, sizeof(TileInfo));
+
+		texture = uploadTile(entry.filename, info, slot + sizeof(TileInfo));
+	}
+
+	if (texture)
+	{
+		entry.texture = texture;
+		return texture;
+	}
+
+	// Missing or outdated, let the workers generate it
+	entry.pending = true;
+	addJob(Job{ key, imageExpression->getIdentifier(), entry.filename, entry.stamp });
+
+	return texture;
+}
+
+void ThumbnailCache::clear()
+{
+	collectResults();
+
+	_entries.clear();
+}
+
+void ThumbnailCache::save()
+{
+	stopWorkers();
+	collectResults();
+
+	_entries.clear();
+
+	writeNewTiles();
+
+	// Whatever could not be written is generated again next time
+	_newThumbnails.clear();
+	_writeFailed = false;
+}
+
+void ThumbnailCache::writeNewTiles()
+{
+	bool hasNewTiles = std::any_of(_newThumbnails.begin(), _newThumbnails.end(),
+		[](const std::pair<const std::string, Thumbnail>& pair) { return !pair.second.pixels.empty(); });
+
+	if (!hasNewTiles) return;
+
+	// The index tells which slots are taken
+	ensureLoaded();
+
+	// Without a valid atlas on disk the index is meaningless, start over
+	bool createAtlas = !_atlas;
+
+	// Release the mapping, the file is written to in place. It is
+	// mapped again on the next request.
+	_atlas.reset();
+	_loaded = false;
+
+	std::fstream atlas;
+
+	if (!createAtlas)
+	{
+		atlas.open(_atlasPath, std::ios::in | std::ios::out | std::ios::binary);
+		createAtlas = !atlas;
+	}
+
+	if (createAtlas)
+	{
+		_index.clear();
+		_numSlots = 0;
+
+		atlas.open(_atlasPath, std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+
+		std::uint32_t header[3] = { ATLAS_VERSION, static_cast<std::uint32_t>(TILE_SIZE), 0 };
+
+		atlas.write(ATLAS_MAGIC, sizeof(ATLAS_MAGIC));
+		atlas.write(reinterpret_cast<const char*>(header), sizeof(header));
+	}
+
+	if (!atlas)
+	{
+		rError() << "[shaders] Failed to write thumbnail atlas " << _atlasPath << std::endl;
+
+		// Keep the tiles in memory for this session, don't try again before saving
+		_writeFailed = true;
+		return;
+	}
+
+	std::vector<char> slotData(SLOT_SIZE);
+
+	for (auto pair = _newThumbnails.begin(); pair != _newThumbnails.end();)
+	{
+		const Thumbnail& thumbnail = pair->second;
+
+		// Precompressed images and failed loads are not stored in the atlas
+		if (thumbnail.pixels.empty())
+		{
+			++pair;
+			continue;
+		}
+
+		// Outdated thumbnails are overwritten in their slot
+		auto indexed = _index.find(pair->first);
+		std::size_t slot = indexed != _index.end() ? indexed->second.slot : _numSlots++;
+
+		std::fill(slotData.begin(), slotData.end(), 0);
+		std::memcpy(slotData.data(), &thumbnail.info, sizeof(TileInfo));
+		std::memcpy(slotData.data() + sizeof(TileInfo), thumbnail.pixels.data(), thumbnail.pixels.size());
+
+		atlas.seekp(HEADER_SIZE + slot * SLOT_SIZE);
+		atlas.write(slotData.data(), slotData.size());
+
+		_index[pair->first] = IndexEntry{ slot, thumbnail.stamp, thumbnail.filename };
+
+		// The tile is read from the atlas from now on
+		pair = _newThumbnails.erase(pair);
+	}
+
+	atlas.close();
+
+	std::ofstream index(_indexPath);
+
+	for (const auto& pair : _index)
+	{
+		index << pair.second.slot << '\t' << pair.second.stamp << '\t'
+			<< pair.second.filename << '\t' << pair.first << '\n';
+	}
+}
+
+void ThumbnailCache::ensureLoaded()
+{
+	if (_loaded) return;
+
+	_loaded = true;
+	_numSlots = 0;
+	_index.clear();
+
+	_atlas.reset(new MappedFile(_atlasPath));
+
+	const std::uint8_t* data = _atlas->data();
+	std::uint32_t header[3] = { 0, 0, 0 };
+
+	if (_atlas->size() >= HEADER_SIZE)
+	{
+		std::memcpy(header, data + sizeof(ATLAS_MAGIC), sizeof(header));
+	}
+
+	if (_atlas->size() < HEADER_SIZE || std::memcmp(data, ATLAS_MAGIC, sizeof(ATLAS_MAGIC)) != 0 ||
+		header[0] != ATLAS_VERSION || header[1] != TILE_SIZE)
+	{
+		// Missing or incompatible, a new atlas is written on save
+		_atlas.reset();
+		return;
+	}
+
+	_numSlots = (_atlas->size() - HEADER_SIZE) / SLOT_SIZE;
+
+	loadIndex();
+}
+
+void ThumbnailCache::loadIndex()
+{
+	std::ifstream stream(_indexPath);
+	std::string line;
+
+	while (std::getline(stream, line))
+	{
+		std::istringstream fields(line);
+		std::string slot, stamp, filename, key;
+
+		if (!std::getline(fields, slot, '\t') || !std::getline(fields, stamp, '\t') ||
+			!std::getline(fields, filename, '\t') || !std::getline(fields, key))
+		{
+			continue;
+		}
+
+		try
+		{
+			IndexEntry entry{ std::stoul(slot), std::stoll(stamp), filename };
+
+			if (entry.slot >= _numSlots) continue;
+
+			// Reject slots with broken tile info
+			TileInfo info;
+			std::memcpy(&info, _atlas->data() + HEADER_SIZE + entry.slot * SLOT_SIZE, sizeof(TileInfo));
+
+			if (info.width == 0 || info.height == 0 || info.width > TILE_SIZE || info.height > TILE_SIZE)
+			{
+				continue;
+			}
+
+			_index[key] = entry;
+		}
+		catch (std::logic_error&)
+		{
+			continue; // std::invalid_argument or std::out_of_range
+		}
+	}
+}
+
+void ThumbnailCache::collectResults()
+{
+	std::vector<std::pair<std::string, Thumbnail>> results;
+
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		results.swap(_results);
+	}
+
+	for (auto& result : results)
+	{
+		auto entry = _entries.find(result.first);
+
+		if (entry != _entries.end())
+		{
+			entry->second.pending = false;
+		}
+
+		_newThumbnails[result.first] = std::move(result.second);
+	}
+
+	if (results.empty() || _writeFailed) return;
+
+	// Don't keep more than a few new tiles in memory
+	auto numNewTiles = std::count_if(_newThumbnails.begin(), _newThumbnails.end(),
+		[](const std::pair<const std::string, Thumbnail>& pair) { return !pair.second.pixels.empty(); });
+
+	if (static_cast<std::size_t>(numNewTiles) >= MAX_UNSAVED_TILES)
+	{
+		writeNewTiles();
+	}
+}
+
+void ThumbnailCache::addJob(Job&& job)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+
+	_jobs.emplace_back(std::move(job));
+
+	// Start the workers on demand, leave some cores to the UI
+	if (_workers.empty())
+	{
+		std::size_t numWorkers = std::max(1u, std::thread::hardware_concurrency() / 2);
+
+		for (std::size_t i = 0; i < numWorkers; ++i)
+		{
+			_workers.emplace_back(&ThumbnailCache::processJobs, this);
+		}
+	}
+
+	_jobAdded.notify_one();
+}
+
+void ThumbnailCache::stopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+
+		_stopWorkers = true;
+		_jobs.clear();
+	}
+
+	_jobAdded.notify_all();
+
+	for (auto& worker : _workers)
+	{
+		worker.join();
+	}
+
+	_workers.clear();
+	_stopWorkers = false;
+
+	// Jobs which have been dropped will be re-queued on the next request
+	for (auto& pair : _entries)
+	{
+		pair.second.pending = false;
+	}
+}
+
+void ThumbnailCache::processJobs()
+{
+	while (true)
+	{
+		Job job;
+
+		{
+			std::unique_lock<std::mutex> lock(_lock);
+
+			_jobAdded.wait(lock, [this]() { return _stopWorkers || !_jobs.empty(); });
+
+			if (_stopWorkers) return;
+
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+		}
+
+		Thumbnail thumbnail = createThumbnail(job);
+
+		std::lock_guard<std::mutex> lock(_lock);
+		_results.emplace_back(job.key, std::move(thumbnail));
+	}
+}
+
+ThumbnailCache::Thumbnail ThumbnailCache::createThumbnail(const Job& job)
+{
+	Thumbnail thumbnail;
+
+	thumbnail.stamp = job.stamp;
+	thumbnail.filename = job.filename;
+	thumbnail.info = TileInfo{ 0, 0, 0, 0 };
+
+	ImagePtr image = GlobalImageLoader().imageFromVFS(job.imageName);
+
+	if (!image || image->getWidth() == 0 || image->getHeight() == 0)
+	{
+		rWarning() << "[shaders] Unable to load image for thumbnail: " << job.filename << std::endl;
+		return thumbnail;
+	}
+
+	if (image->isPrecompressed())
+	{
+		thumbnail.image = image;
+		return thumbnail;
+	}
+
+	std::size_t width = image->getWidth();
+	std::size_t height = image->getHeight();
+	std::size_t largest = std::max(width, height);
+
+	// Shrink the image to fit the tile, preserving the aspect ratio
+	std::size_t tileWidth = largest > TILE_SIZE ? std::max<std::size_t>(1, width * TILE_SIZE / largest) : width;
+	std::size_t tileHeight = largest > TILE_SIZE ? std::max<std::size_t>(1, height * TILE_SIZE / largest) : height;
+
+	thumbnail.info = TileInfo
+	{
+		static_cast<std::uint32_t>(tileWidth), static_cast<std::uint32_t>(tileHeight),
+		static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height)
+	};
+
+	thumbnail.pixels.resize(tileWidth * tileHeight * 4);
+
+	const std::uint8_t* source = image->getPixels();
+	std::uint8_t* target = thumbnail.pixels.data();
+
+	// Box filter, each tile pixel averages the source pixels it covers
+	for (std::size_t y = 0; y < tileHeight; ++y)
+	{
+		std::size_t y0 = y * height / tileHeight;
+		std::size_t y1 = std::max(y0 + 1, (y + 1) * height / tileHeight);
+
+		for (std::size_t x = 0; x < tileWidth; ++x)
+		{
+			std::size_t x0 = x * width / tileWidth;
+			std::size_t x1 = std::max(x0 + 1, (x + 1) * width / tileWidth);
+
+			std::size_t sum[4] = { 0, 0, 0, 0 };
+
+			for (std::size_t sy = y0; sy < y1; ++sy)
+			{
+				const std::uint8_t* pixel = source + (sy * width + x0) * 4;
+
+				for (std::size_t sx = x0; sx < x1; ++sx, pixel += 4)
+				{
+					sum[0] += pixel[0];
+					sum[1] += pixel[1];
+					sum[2] += pixel[2];
+					sum[3] += pixel[3];
+				}
+			}
+
+			std::size_t count = (y1 - y0) * (x1 - x0);
+
+			for (std::size_t c = 0; c < 4; ++c)
+			{
+				*target++ = static_cast<std::uint8_t>(sum[c] / count);
+			}
+		}
+	}
+
+	return thumbnail;
+}
+
+TexturePtr ThumbnailCache::uploadTile(const std::string& name, const TileInfo& info, const std::uint8_t* pixels)
+{
+	GLuint textureNum;
+
+	debug::assertNoGlErrors();
+
+	glGenTextures(1, &textureNum);
+	glBindTexture(GL_TEXTURE_2D, textureNum);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
+
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
+		static_cast<GLsizei>(info.width), static_cast<GLsizei>(info.height),
+		0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// The browsers lay out their tiles using the dimensions of the full image
+	BasicTexture2DPtr texture(new BasicTexture2D(textureNum, name));
+	texture->setWidth(info.imageWidth);
+	texture->setHeight(info.imageHeight);
+
+	debug::assertNoGlErrors();
+
+	return texture;
+}
+
+} // namespace shaders
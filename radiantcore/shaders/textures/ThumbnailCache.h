@@ -0,0 +1,160 @@
+#pragma once
+
+#include "ishaders.h"
+#include "iimage.h"
+#include "../NamedBindable.h"
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <cstdint>
+
+namespace shaders
+{
+
+/**
+ * Persistent cache of downscaled editor images, as displayed by the
+ * texture and media browsers.
+ *
+ * Thumbnails are stored in a memory-mapped atlas file of fixed-size tile
+ * slots in the settings folder, along with an index mapping each material
+ * name to its slot and the modification time of the source image. Missing
+ * or outdated thumbnails are generated by background workers, so the
+ * browsers only ever upload small tiles to OpenGL. New thumbnails are
+ * written to the atlas in batches while they come in, the rest of them
+ * when the cache is saved.
+ *
+ * Editor images which are not plain images (map expressions) and
+ * precompressed (DDS) images are not thumbnailed, for these the full
+ * image is bound instead (DDS images are still loaded by the workers).
+ */
+class ThumbnailCache
+{
+public:
+	// Edge length of the square tile slots in the atlas
+	static const std::size_t TILE_SIZE = 128;
+
+private:
+	// Stored in front of the pixels of each atlas slot
+	struct TileInfo
+	{
+		// Dimensions of the thumbnail
+		std::uint32_t width;
+		std::uint32_t height;
+
+		// Dimensions of the source image
+		std::uint32_t imageWidth;
+		std::uint32_t imageHeight;
+	};
+
+	struct IndexEntry
+	{
+		std::size_t slot;
+		std::int64_t stamp;
+		std::string filename;
+	};
+
+	// A thumbnail generated in this session
+	struct Thumbnail
+	{
+		std::int64_t stamp = 0;
+		std::string filename;
+
+		TileInfo info;
+		std::vector<std::uint8_t> pixels;
+
+		// Images which can't be thumbnailed are passed on as they are
+		ImagePtr image;
+	};
+
+	struct Job
+	{
+		std::string key;
+		std::string imageName;
+		std::string filename;
+		std::int64_t stamp;
+	};
+
+	// The state of each material looked up in this session
+	struct Entry
+	{
+		std::string filename;
+		std::int64_t stamp = 0;
+		bool pending = false;
+
+		std::weak_ptr<Texture> texture;
+	};
+
+	class MappedFile;
+
+	std::string _atlasPath;
+	std::string _indexPath;
+
+	bool _loaded;
+
+	// The atlas as found on disk, mapped into memory
+	std::unique_ptr<MappedFile> _atlas;
+	std::size_t _numSlots;
+
+	// Persistent index, material name (lowercase) => atlas slot
+	std::map<std::string, IndexEntry> _index;
+
+	// Material name (lowercase) => session state
+	std::map<std::string, Entry> _entries;
+
+	// Generated thumbnails which are not written to the atlas yet
+	std::map<std::string, Thumbnail> _newThumbnails;
+
+	// Set if the atlas could not be written, new tiles are kept in memory then
+	bool _writeFailed;
+
+	// Worker threads and their queues, guarded by _lock
+	std::mutex _lock;
+	std::condition_variable _jobAdded;
+	std::deque<Job> _jobs;
+	std::vector<std::pair<std::string, Thumbnail>> _results;
+	std::vector<std::thread> _workers;
+	bool _stopWorkers;
+
+public:
+	ThumbnailCache();
+	~ThumbnailCache();
+
+	/**
+	 * Returns the thumbnail of the given material's editor image. The texture
+	 * reports the dimensions of the full editor image. Returns an empty pointer
+	 * if the thumbnail is being generated, check back later.
+	 */
+	TexturePtr getThumbnail(const std::string& materialName, const NamedBindablePtr& editorImage);
+
+	// Forget about the looked up materials, the source images are checked again
+	void clear();
+
+	// Stops the workers and writes the new thumbnails to the atlas
+	void save();
+
+private:
+	void ensureLoaded();
+	void loadIndex();
+
+	// Moves the results of the workers into _newThumbnails,
+	// writes them to the atlas once enough of them have been collected
+	void collectResults();
+
+	// Writes the tiles in _newThumbnails to the atlas and the index file
+	void writeNewTiles();
+
+	void addJob(Job&& job);
+	void stopWorkers();
+	void processJobs();
+
+	static Thumbnail createThumbnail(const Job& job);
+	static TexturePtr uploadTile(const std::string& name, const TileInfo& info, const std::uint8_t* pixels);
+};
+
+} // namespace shaders
@@ -0,0 +1,64 @@
+#include "Doom3ModelSkin.h"
+
+#include "itextstream.h"
+#include "parser/DefTokeniser.h"
+
+namespace skins
+{
+
+void Doom3ModelSkin::parseDefinition()
+{
+	_parsed = true;
+
+	// ( "model" <modelname> | <sourceTex> <destTex> )*
+	parser::BasicDefTokeniser<std::string> tok(_blockContents);
+
+	try
+	{
+		while (tok.hasMoreTokens())
+		{
+			std::string key = tok.nextToken();
+			std::string value = tok.nextToken();
+
+			// If this is a model key, add to the list of models, otherwise
+			// assume this is a remap declaration
+			if (key == "model")
+			{
+				_models.push_back(value);
+			}
+			else
+			{
+				// The first remap of a material wins
+				_remaps.emplace(key, value);
+			}
+		}
+	}
+	catch (parser::ParseException& e)
+	{
+		rWarning() << "[skins] in " << _skinFileName << ": skin " << _name << ": "
+			<< e.what() << std::endl;
+	}
+
+	// The declaration is not needed anymore
+	_blockContents.clear();
+	_blockContents.shrink_to_fit();
+}
+
+void Doom3ModelSkin::compileRemapTable()
+{
+	_compiled = true;
+
+	for (const auto& remap : _remaps)
+	{
+		auto srcId = _materialIndex.getId(remap.first);
+
+		if (srcId >= _remapTable.size())
+		{
+			_remapTable.resize(srcId + 1, NO_REMAP);
+		}
+
+		_remapTable[srcId] = _materialIndex.getId(remap.second);
+	}
+}
+
+}
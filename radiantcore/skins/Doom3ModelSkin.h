@@ -1,10 +1,12 @@
 #pragma once
 
 #include "modelskin.h"
+#include "MaterialNameIndex.h"
 
 #include <string>
 #include <map>
 #include <memory>
+#include <vector>
 
 namespace skins
 {
@@ -13,6 +15,10 @@ namespace skins
  * A single instance of a Doom 3 model skin. This structure stores a set of
  * maps between an existing texture and a new texture, and possibly the name of
  * the model that this skin is associated with.
+ *
+ * The skin is constructed with its raw declaration, which is parsed on first
+ * use only. The remaps are compiled into a table indexed by material id when
+ * the skin is captured for the first time.
  */
 class Doom3ModelSkin
 : public ModelSkin
@@ -21,42 +27,89 @@ class Doom3ModelSkin
 	typedef std::map<std::string, std::string> StringMap;
 	StringMap _remaps;
 
+	// Target material id by source material id, NO_REMAP for unmapped materials
+	std::vector<std::size_t> _remapTable;
+
+	// The models this skin is associated with
+	StringList _models;
+
 	std::string _name;
 	std::string _skinFileName;
 
+	// Raw skin declaration (excluding braces)
+	std::string _blockContents;
+
+	// Whether the block has been parsed and the remap table been built
+	bool _parsed;
+	bool _compiled;
+
+	MaterialNameIndex& _materialIndex;
+
 public:
-	Doom3ModelSkin(const std::string& name) :
-		_name(name)
+	Doom3ModelSkin(const std::string& name, MaterialNameIndex& materialIndex,
+		const std::string& blockContents = std::string()) :
+		_name(name),
+		_blockContents(blockContents),
+		_parsed(false),
+		_compiled(false),
+		_materialIndex(materialIndex)
 	{}
 
-	std::string getName() const {
+	std::string getName() const override
+	{
 		return _name;
 	}
 
-	void setSkinFileName(const std::string& fileName) {
+	void setSkinFileName(const std::string& fileName)
+	{
 		_skinFileName = fileName;
 	}
 
-	std::string getSkinFileName() const {
+	std::string getSkinFileName() const
+	{
 		return _skinFileName;
 	}
 
 	// Get this skin's remap for the provided material name (if any).
-	std::string getRemap(const std::string& name) const {
-		StringMap::const_iterator i = _remaps.find(name);
-		if(i != _remaps.end()) {
-			return i->second;
-		}
-		else { // none found
-			return "";
+	std::string getRemap(const std::string& name) const override
+	{
+		auto i = _remaps.find(name);
+		return i != _remaps.end() ? i->second : std::string();
+	}
+
+	std::size_t getRemapId(std::size_t materialId) const override
+	{
+		return materialId < _remapTable.size() ? _remapTable[materialId] : NO_REMAP;
+	}
+
+	// Returns the models named in the "model" keys of this skin
+	const StringList& getModels() const
+	{
+		return _models;
+	}
+
+	// Parses the declaration if this hasn't happened yet
+	void ensureParsed()
+	{
+		if (!_parsed)
+		{
+			parseDefinition();
 		}
 	}
 
-	// Add a remap pair to this skin
-	void addRemap(const std::string& src, const std::string& dst) {
-		_remaps.insert(StringMap::value_type(src, dst));
+	// Parses the declaration and builds the remap table, if not done yet
+	void ensureCompiled()
+	{
+		if (!_compiled)
+		{
+			ensureParsed();
+			compileRemapTable();
+		}
 	}
 
+private:
+	void parseDefinition();
+	void compileRemapTable();
 };
 typedef std::shared_ptr<Doom3ModelSkin> Doom3ModelSkinPtr;
 
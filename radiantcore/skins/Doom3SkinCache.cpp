@@ -4,6 +4,7 @@
 #include "ifilesystem.h"
 #include "iarchive.h"
 #include "module/StaticModule.h"
+#include "string/predicate.h"
 
 #include <iostream>
 
@@ -17,8 +18,9 @@ namespace
 }
 
 Doom3SkinCache::Doom3SkinCache() :
+    _modelSkinsBuilt(false),
     _defLoader(std::bind(&Doom3SkinCache::loadSkinFiles, this)),
-    _nullSkin("")
+    _nullSkin("", _materialIndex)
 {}
 
 ModelSkin& Doom3SkinCache::capture(const std::string& name)
@@ -27,21 +29,61 @@ ModelSkin& Doom3SkinCache::capture(const std::string& name)
 
     auto i = _namedSkins.find(name);
 
-	return i != _namedSkins.end() ? *(i->second) : _nullSkin;
+    if (i == _namedSkins.end())
+    {
+        return _nullSkin;
+    }
+
+    i->second->ensureCompiled();
+
+    return *(i->second);
 }
 
 const StringList& Doom3SkinCache::getSkinsForModel(const std::string& model) 
 {
     ensureDefsLoaded();
+
+    if (!_modelSkinsBuilt)
+    {
+        buildModelSkinMap();
+    }
+
     return _modelSkins[model];
 }
 
+void Doom3SkinCache::buildModelSkinMap()
+{
+    _modelSkinsBuilt = true;
+
+    // Go through the skins in declaration order, to keep the skin lists sorted that way
+    for (const auto& skinName : _allSkins)
+    {
+        auto& skin = _namedSkins[skinName];
+        skin->ensureParsed();
+
+        for (const auto& model : skin->getModels())
+        {
+            _modelSkins[model].push_back(skinName);
+        }
+    }
+}
+
 const StringList& Doom3SkinCache::getAllSkins()
 {
     ensureDefsLoaded();
     return _allSkins;
 }
 
+std::size_t Doom3SkinCache::getMaterialId(const std::string& materialName)
+{
+    return _materialIndex.getId(materialName);
+}
+
+const std::string& Doom3SkinCache::getMaterialName(std::size_t materialId)
+{
+    return _materialIndex.getName(materialId);
+}
+
 sigc::signal<void> Doom3SkinCache::signal_skinsReloaded()
 {
 	return _sigSkinsReloaded;
@@ -96,99 +138,50 @@ void Doom3SkinCache::loadSkinFiles()
 	_sigSkinsReloaded.emit();
 }
 
-// Parse the contents of a .skin file
+// Index the declarations in a .skin file
 void Doom3SkinCache::parseFile(std::istream& contents, const std::string& filename)
 {
-    // Construct a DefTokeniser to parse the file
-	parser::BasicDefTokeniser<std::istream> tok(contents);
+    // [ "skin" ] <name> "{" ... "}"
+    // The block contents are parsed by the skin itself
+	parser::BasicDefBlockTokeniser<std::istream> tok(contents);
 
-	// Call the parseSkin() function for each skin decl
-	while (tok.hasMoreTokens())
+	while (tok.hasMoreBlocks())
     {
-		try
-        {
-			// Try to parse the skin
-			Doom3ModelSkinPtr modelSkin = parseSkin(tok);
-			std::string skinName = modelSkin->getName();
+        auto block = tok.nextBlock();
 
-			modelSkin->setSkinFileName(filename);
+        // The block name is the skin name, optionally preceded by "skin"
+        std::string skinName = block.name;
 
-			auto found = _namedSkins.find(skinName);
-
-			// Is this already defined?
-			if (found != _namedSkins.end()) 
-            {
-                rWarning() << "[skins] in " << filename << ": skin " + skinName +
-						     " previously defined in " +
-							 found->second->getSkinFileName() + "!" << std::endl;
-				// Don't insert the skin into the list
-			}
-			else
-            {
-				// Add the populated Doom3ModelSkin to the hashtable and the name to the
-				// list of all skins
-				_namedSkins.emplace(skinName, modelSkin);
-				_allSkins.emplace_back(skinName);
-			}
-		}
-		catch (parser::ParseException& e)
+        if (string::starts_with(skinName, "skin "))
         {
-            rWarning() << "[skins]: in " << filename << ": " << e.what() << std::endl;
-		}
-	}
-}
-
-// Parse an individual skin declaration
-Doom3ModelSkinPtr Doom3SkinCache::parseSkin(parser::DefTokeniser& tok) 
-{
-	// [ "skin" ] <name> "{"
-	//			[ "model" <modelname> ]
-	//			( <sourceTex> <destTex> )*
-	// "}"
-
-	// Parse the skin name, this is either the first token or the second token
-	// (preceded by "skin")
-	std::string skinName = tok.nextToken();
-
-    if (skinName == "skin")
-    {
-        skinName = tok.nextToken();
-    }
+            skinName = skinName.substr(5);
+        }
 
-	tok.assertNextToken("{");
-
-	// Create the skin object
-	auto skin = std::make_shared<Doom3ModelSkin>(skinName);
-
-	// Read key/value pairs until end of decl
-	std::string key = tok.nextToken();
-	while (key != "}")
-    {
-		// Read the value
-		std::string value = tok.nextToken();
-
-		if (value == "}")
+        if (skinName.length() >= 2 && skinName.front() == '"' && skinName.back() == '"')
         {
-            rWarning() << "[skins] Warning: '}' found where shader name expected in skin: "
-					  << skinName << std::endl;
-		}
+            skinName = skinName.substr(1, skinName.length() - 2);
+        }
 
-		// If this is a model key, add to the model->skin map, otherwise assume
-		// this is a remap declaration
-		if (key == "model")
-        {
-			_modelSkins[value].push_back(skinName);
-		}
-		else
-        {
-			skin->addRemap(key, value);
-		}
+        auto found = _namedSkins.find(skinName);
 
-		// Get next key
-		key = tok.nextToken();
+        // Is this already defined?
+        if (found != _namedSkins.end()) 
+        {
+            rWarning() << "[skins] in " << filename << ": skin " + skinName +
+                " previously defined in " +
+                found->second->getSkinFileName() + "!" << std::endl;
+            // Don't insert the skin into the list
+            continue;
+        }
+
+        auto modelSkin = std::make_shared<Doom3ModelSkin>(skinName, _materialIndex, block.contents);
+        modelSkin->setSkinFileName(filename);
+
+        // Add the Doom3ModelSkin to the hashtable and the name to the
+        // list of all skins
+        _namedSkins.emplace(skinName, modelSkin);
+        _allSkins.emplace_back(skinName);
 	}
-
-	return skin;
 }
 
 const std::string& Doom3SkinCache::getName() const
@@ -212,6 +205,7 @@ const StringSet& Doom3SkinCache::getDependencies() const
 void Doom3SkinCache::refresh()
 {
 	_modelSkins.clear();
+	_modelSkinsBuilt = false;
 	_namedSkins.clear();
 	_allSkins.clear();
 
@@ -228,6 +222,12 @@ void Doom3SkinCache::initialiseModule(const IApplicationContext& ctx)
     refresh();
 }
 
+bool Doom3SkinCache::allowsConcurrentInitialisation() const
+{
+    // The skins are loaded in their own thread anyway
+    return true;
+}
+
 // Module instance
 module::StaticModule<Doom3SkinCache> skinCacheModule;
 
@@ -5,6 +5,7 @@
 #include "imodule.h"
 #include "modelskin.h"
 #include "parser/DefTokeniser.h"
+#include "parser/DefBlockTokeniser.h"
 
 #include <map>
 #include <string>
@@ -28,9 +29,14 @@ class Doom3SkinCache :
 	StringList _allSkins;
 
 	// Map between model paths and a vector of names of the associated skins,
-	// which are contained in the main NamedSkinMap.
+	// which are contained in the main NamedSkinMap. This requires all skins
+	// to be parsed, so it is built on first request.
 	typedef std::map<std::string, std::vector<std::string> > ModelSkinMap;
 	ModelSkinMap _modelSkins;
+	bool _modelSkinsBuilt;
+
+	// Material ids used by the skin remap tables, kept across refreshes
+	MaterialNameIndex _materialIndex;
 
     // Helper which will invoke loadSkinFiles() in a separate thread
     util::ThreadedDefLoader<void> _defLoader;
@@ -58,6 +64,9 @@ public:
 	 */
     const StringList& getAllSkins() override;
 
+    std::size_t getMaterialId(const std::string& materialName) override;
+    const std::string& getMaterialName(std::size_t materialId) override;
+
 	/**
 	 * greebo: Clears and reloads all skins.
 	 */
@@ -70,6 +79,7 @@ public:
 	const std::string& getName() const override;
     const StringSet& getDependencies() const override;
     void initialiseModule(const IApplicationContext& ctx) override;
+    bool allowsConcurrentInitialisation() const override;
 
 private:
     // Load and parse the skin files, populating internal data structures.
@@ -80,11 +90,12 @@ private:
     // Iterates over each skin file in the VFS skins/ folder
     void loadSkinFiles();
 
-    // Parse an individual skin declaration and add return the skin object
-    Doom3ModelSkinPtr parseSkin(parser::DefTokeniser& tokeniser);
+    // Associate the models of all skins with their skin names
+    void buildModelSkinMap();
 
-    /* Parse the provided istream as a .skin file, and add all skins found within
-    * to the internal data structures.
+    /* Index the skin declarations in the provided istream, adding all skins
+    * found within to the internal data structures. The skins themselves are
+    * parsed when they are used for the first time.
     *
     * @filename: This is for informational purposes only (error message display).
     */
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace skins
+{
+
+/**
+ * Assigns a running number to each material name it is asked for, such that
+ * skin remaps can be stored and applied as plain id tables. Ids are never
+ * released, the names are kept for the lifetime of this object.
+ */
+class MaterialNameIndex
+{
+private:
+	std::unordered_map<std::string, std::size_t> _ids;
+
+	// Names by id, a deque keeps the references stable when growing
+	std::deque<std::string> _names;
+
+	std::mutex _lock;
+
+public:
+	std::size_t getId(const std::string& name)
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+
+		auto result = _ids.emplace(name, _names.size());
+
+		if (result.second)
+		{
+			_names.push_back(name);
+		}
+
+		return result.first->second;
+	}
+
+	const std::string& getName(std::size_t id)
+	{
+		static const std::string _emptyName;
+
+		std::lock_guard<std::mutex> lock(_lock);
+
+		return id < _names.size() ? _names[id] : _emptyName;
+	}
+};
+
+}
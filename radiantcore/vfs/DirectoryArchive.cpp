@@ -5,16 +5,32 @@
 #include "os/file.h"
 #include "os/dir.h"
 #include "os/fs.h"
+#include "os/path.h"
 #include "string/encoding.h"
 #include <vector>
 
 #include "DirectoryArchiveFile.h"
 #include "DirectoryArchiveTextFile.h"
 
+namespace
+{
+	// The index is case-insensitive, this checks whether the OS agrees
+	inline bool pathsAreEqual(const std::string& path, const std::string& other)
+	{
+		return path.length() == other.length() && path_equal_n(path.c_str(), other.c_str(), path.length());
+	}
+}
+
 DirectoryArchive::DirectoryArchive(const std::string& root) :
-	_root(root)
+	_root(root),
+	_indexed(false)
 {}
 
+const std::string& DirectoryArchive::getRoot() const
+{
+	return _root;
+}
+
 ArchiveFilePtr DirectoryArchive::openFile(const std::string& name) 
 {
 	UnixPath path(_root);
@@ -48,12 +64,143 @@ ArchiveTextFilePtr DirectoryArchive::openTextFile(const std::string& name)
 
 bool DirectoryArchive::containsFile(const std::string& name)
 {
+    std::lock_guard<std::recursive_mutex> lock(_indexLock);
+
+    if (_indexed)
+    {
+        auto i = _index.find(name);
+
+        return i != _index.end() && !i->second.isDirectory() && pathsAreEqual(i->first.string(), name);
+    }
+
     UnixPath path(_root);
     std::string filePath = std::string(path) + name;
     return os::fileIsReadable(filePath);
 }
 
 void DirectoryArchive::traverse(Visitor& visitor, const std::string& root)
+{
+	std::lock_guard<std::recursive_mutex> lock(_indexLock);
+
+	if (!_indexed)
+	{
+		traverseDisk(visitor, root);
+		return;
+	}
+
+	if (!root.empty())
+	{
+		auto i = _index.find(root);
+
+		if (i == _index.end() || !pathsAreEqual(i->first.string(), root))
+		{
+			return;
+		}
+	}
+
+	_index.traverse(visitor, root);
+}
+
+void DirectoryArchive::buildIndex(const std::function<void(const std::string&)>& functor)
+{
+	std::lock_guard<std::recursive_mutex> lock(_indexLock);
+
+	_index.clear();
+	_indexed = true;
+
+	fs::path start(_root);
+
+	if (!fs::exists(start))
+	{
+		return;
+	}
+
+	std::size_t rootLen = _root.length();
+
+	for (fs::recursive_directory_iterator it(start); it != fs::recursive_directory_iterator(); ++it)
+	{
+		const fs::path& candidate = *it;
+
+		try
+		{
+			auto name = candidate.generic_string().substr(rootLen);
+
+			if (fs::is_directory(candidate))
+			{
+				name += "/";
+				_index[name];
+			}
+			else
+			{
+				_index[name] = std::make_shared<IndexRecord>();
+			}
+
+			functor(name);
+		}
+		catch (const std::system_error& ex)
+		{
+			rWarning() << "[vfs] Skipping file " << string::unicode_to_utf8(candidate.filename().wstring()) <<
+				" - possibly unsupported characters in filename? " <<
+				"(Exception: " << ex.what() << ")" << std::endl;
+		}
+	}
+}
+
+void DirectoryArchive::addToIndex(const std::string& name)
+{
+	std::lock_guard<std::recursive_mutex> lock(_indexLock);
+
+	if (string::ends_with(name, "/"))
+	{
+		_index[name];
+	}
+	else
+	{
+		_index[name] = std::make_shared<IndexRecord>();
+	}
+}
+
+void DirectoryArchive::removeFromIndex(const std::string& name)
+{
+	std::lock_guard<std::recursive_mutex> lock(_indexLock);
+
+	if (name.empty())
+	{
+		_index.clear();
+		return;
+	}
+
+	_index.erase(name);
+}
+
+bool DirectoryArchive::probeFile(const std::string& name)
+{
+	if (name.empty() || os::isDirectory(name))
+	{
+		return false;
+	}
+
+	UnixPath path(_root);
+	path.push_filename(name);
+
+	try
+	{
+		if (!fs::is_regular_file(std::string(path)))
+		{
+			return false;
+		}
+	}
+	catch (fs::filesystem_error&)
+	{
+		return false;
+	}
+
+	addToIndex(name);
+
+	return true;
+}
+
+void DirectoryArchive::traverseDisk(Visitor& visitor, const std::string& root)
 {
 	// Initialise the search's starting point
 	fs::path start(_root + root);
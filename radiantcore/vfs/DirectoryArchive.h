@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Archive.h"
+#include "GenericFileSystem.h"
+#include <mutex>
+#include <functional>
 
 /**
  * greebo: This wraps around a certain path in the "real"
@@ -8,6 +11,11 @@
  *
  * A real folder is treated like any other "archive" and gets
  * added to the list of PK4 archives, using this class.
+ *
+ * After buildIndex() has been called, the archive answers containsFile()
+ * and traverse() from an in-memory copy of the directory tree instead of
+ * querying the disk. The owner is responsible for keeping this index up
+ * to date by calling addToIndex() and removeFromIndex() on changes.
  */
 class DirectoryArchive :
 	public Archive
@@ -19,10 +27,20 @@ class DirectoryArchive :
 	// of the VFS anyway.
 	mutable std::string _modName;
 
+	// Files carry no extra information in the index
+	struct IndexRecord
+	{};
+
+	bool _indexed;
+	archive::GenericFileSystem<IndexRecord> _index;
+	std::recursive_mutex _indexLock;
+
 public:
 	// Pass the root path to the constructor
 	DirectoryArchive(const std::string& root);
 
+	const std::string& getRoot() const;
+
 	virtual ArchiveFilePtr openFile(const std::string& name) override;
 
 	virtual ArchiveTextFilePtr openTextFile(const std::string& name) override;
@@ -30,5 +48,24 @@ public:
 	virtual bool containsFile(const std::string& name) override;
 
 	virtual void traverse(Visitor& visitor, const std::string& root) override;
+
+	// Walks the directory tree on disk and keeps the file list in memory.
+	// Invokes the given functor for each file and directory that has been
+	// found (relative to the root, directories with a trailing slash).
+	void buildIndex(const std::function<void(const std::string&)>& functor);
+
+	// Adds the given file or directory (with trailing slash) to the index
+	void addToIndex(const std::string& name);
+
+	// Removes the given file or directory (with trailing slash) from the index,
+	// for directories all the contained items are removed as well
+	void removeFromIndex(const std::string& name);
+
+	// Checks the disk for the given file, which is added to the index if it exists.
+	// Used for files that have been written before the owner got notified.
+	bool probeFile(const std::string& name);
+
+private:
+	void traverseDisk(Visitor& visitor, const std::string& root);
 };
 typedef std::shared_ptr<DirectoryArchive> DirectoryArchivePtr;
@@ -0,0 +1,574 @@
+#include "DirectoryWatcher.h"
+
+#include "itextstream.h"
+#include "string/predicate.h"
+#include <algorithm>
+#include <chrono>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace vfs
+{
+
+namespace
+{
+	// Time between two checks of the polled directories
+	const std::size_t POLL_INTERVAL_MSEC = 2000;
+
+	// Lists the files and subdirectories directly inside the given directory
+	void listDirectory(const fs::path& directory, std::set<std::string>& files, std::set<std::string>& directories)
+	{
+		for (fs::directory_iterator it(directory); it != fs::directory_iterator(); ++it)
+		{
+			try
+			{
+				if (fs::is_directory(*it))
+				{
+					directories.insert(it->path().filename().generic_string());
+				}
+				else
+				{
+					files.insert(it->path().filename().generic_string());
+				}
+			}
+			catch (const std::system_error& ex)
+			{
+				rWarning() << "[vfs] Cannot watch " << it->path().generic_string() <<
+					" (Exception: " << ex.what() << ")" << std::endl;
+			}
+		}
+	}
+}
+
+DirectoryWatcher::DirectoryWatcher(const Callback& callback) :
+	_callback(callback),
+	_stopRequested(false),
+	_watching(false)
+#if defined(__linux__)
+	, _inotifyFd(-1),
+	_watchLimitReported(false)
+#endif
+{}
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+	stop();
+}
+
+std::size_t DirectoryWatcher::addRoot(const std::string& root)
+{
+	_roots.push_back(root);
+	_polledDirectories.emplace_back();
+	_rootIsPolled.push_back(false);
+
+	return _roots.size() - 1;
+}
+
+void DirectoryWatcher::watch()
+{
+	if (_watching) return;
+
+	_watching = true;
+
+#if defined(__linux__)
+	if (initialiseInotify())
+	{
+		return;
+	}
+
+	rWarning() << "[vfs] Cannot use inotify to watch the mod directories, falling back to polling" << std::endl;
+#endif
+
+	for (std::size_t rootIndex = 0; rootIndex < _roots.size(); ++rootIndex)
+	{
+		_rootIsPolled[rootIndex] = true;
+		addPolledDirectory(rootIndex, "", false);
+	}
+}
+
+void DirectoryWatcher::start()
+{
+	if (_thread.joinable() || _roots.empty()) return;
+
+	watch();
+
+	_stopRequested = false;
+	_thread = std::thread(&DirectoryWatcher::run, this);
+}
+
+void DirectoryWatcher::stop()
+{
+	if (_thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(_lock);
+			_stopRequested = true;
+		}
+
+		_stopCondition.notify_all();
+		_thread.join();
+	}
+
+	_watching = false;
+
+#if defined(__linux__)
+	if (_inotifyFd != -1)
+	{
+		close(_inotifyFd);
+		_inotifyFd = -1;
+	}
+
+	_watches.clear();
+#endif
+
+	for (auto& directories : _polledDirectories)
+	{
+		directories.clear();
+	}
+
+	_rootIsPolled.assign(_roots.size(), false);
+}
+
+bool DirectoryWatcher::waitFor(std::size_t milliseconds)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+
+	_stopCondition.wait_for(lock, std::chrono::milliseconds(milliseconds), [this] { return _stopRequested; });
+
+	return !_stopRequested;
+}
+
+void DirectoryWatcher::run()
+{
+#if defined(__linux__)
+	if (_inotifyFd != -1)
+	{
+		runInotify();
+		return;
+	}
+#endif
+
+	runPolling();
+}
+
+void DirectoryWatcher::runPolling()
+{
+	while (waitFor(POLL_INTERVAL_MSEC))
+	{
+		pollRoots();
+	}
+}
+
+void DirectoryWatcher::pollRoots()
+{
+	for (std::size_t rootIndex = 0; rootIndex < _roots.size(); ++rootIndex)
+	{
+		if (!_rootIsPolled[rootIndex]) continue;
+
+		// Take a copy, polling might add or remove directories
+		std::vector<std::string> paths;
+
+		for (const auto& pair : _polledDirectories[rootIndex])
+		{
+			paths.push_back(pair.first);
+		}
+
+		for (const auto& path : paths)
+		{
+			pollDirectory(rootIndex, path);
+		}
+	}
+}
+
+void DirectoryWatcher::pollDirectory(std::size_t rootIndex, const std::string& path)
+{
+	auto& polledDirectories = _polledDirectories[rootIndex];
+	auto existing = polledDirectories.find(path);
+
+	// Might have been removed while polling its parent
+	if (existing == polledDirectories.end()) return;
+
+	fs::path fullPath(_roots[rootIndex] + path);
+	PolledDirectory current;
+
+	try
+	{
+		if (!fs::is_directory(fullPath))
+		{
+			// Removed subdirectories are reported by their parent,
+			// a missing root is treated like an empty one
+			if (!path.empty()) return;
+
+			current.modificationTime = FileTime();
+		}
+		else
+		{
+			current.modificationTime = fs::last_write_time(fullPath);
+
+			// Adding or removing items changes the modification time of the directory,
+			// which might have a resolution of a second only
+			if (current.modificationTime == existing->second.modificationTime && !existing->second.changed) return;
+
+			current.changed = current.modificationTime != existing->second.modificationTime;
+
+			listDirectory(fullPath, current.files, current.directories);
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		rWarning() << "[vfs] Failed to poll " << fullPath.generic_string() << ": " << ex.what() << std::endl;
+		return;
+	}
+
+	PolledDirectory previous = std::move(existing->second);
+	existing->second = std::move(current);
+
+	const auto& newState = polledDirectories[path];
+
+	for (const auto& file : newState.files)
+	{
+		if (previous.files.count(file) == 0)
+		{
+			_callback(rootIndex, path + file, Change::Added);
+		}
+	}
+
+	for (const auto& file : previous.files)
+	{
+		if (newState.files.count(file) == 0)
+		{
+			_callback(rootIndex, path + file, Change::Removed);
+		}
+	}
+
+	for (const auto& directory : previous.directories)
+	{
+		if (newState.directories.count(directory) == 0)
+		{
+			_callback(rootIndex, path + directory + "/", Change::Removed);
+			removePolledDirectory(rootIndex, path + directory + "/");
+		}
+	}
+
+	for (const auto& directory : newState.directories)
+	{
+		if (previous.directories.count(directory) == 0)
+		{
+			_callback(rootIndex, path + directory + "/", Change::Added);
+			addPolledDirectory(rootIndex, path + directory + "/", true);
+		}
+	}
+}
+
+void DirectoryWatcher::addPolledDirectory(std::size_t rootIndex, const std::string& path, bool reportContents)
+{
+	fs::path fullPath(_roots[rootIndex] + path);
+	PolledDirectory state;
+
+	try
+	{
+		if (fs::is_directory(fullPath))
+		{
+			state.modificationTime = fs::last_write_time(fullPath);
+			listDirectory(fullPath, state.files, state.directories);
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		rWarning() << "[vfs] Failed to poll " << fullPath.generic_string() << ": " << ex.what() << std::endl;
+	}
+
+	if (reportContents)
+	{
+		for (const auto& file : state.files)
+		{
+			_callback(rootIndex, path + file, Change::Added);
+		}
+	}
+
+	std::set<std::string> directories = state.directories;
+	_polledDirectories[rootIndex][path] = std::move(state);
+
+	for (const auto& directory : directories)
+	{
+		if (reportContents)
+		{
+			_callback(rootIndex, path + directory + "/", Change::Added);
+		}
+
+		addPolledDirectory(rootIndex, path + directory + "/", reportContents);
+	}
+}
+
+void DirectoryWatcher::removePolledDirectory(std::size_t rootIndex, const std::string& path)
+{
+	auto& polledDirectories = _polledDirectories[rootIndex];
+
+	// Subdirectories follow their parent in the sorted map
+	auto first = polledDirectories.find(path);
+	auto last = first;
+
+	while (last != polledDirectories.end() && string::starts_with(last->first, path))
+	{
+		++last;
+	}
+
+	polledDirectories.erase(first, last);
+}
+
+#if defined(__linux__)
+
+bool DirectoryWatcher::initialiseInotify()
+{
+	_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (_inotifyFd == -1)
+	{
+		return false;
+	}
+
+	for (std::size_t rootIndex = 0; rootIndex < _roots.size(); ++rootIndex)
+	{
+		// This fails if the system limit of watches is exceeded
+		if (!addWatchedDirectory(rootIndex, "", false))
+		{
+			fallBackToPolling(rootIndex, false);
+		}
+	}
+
+	return true;
+}
+
+void DirectoryWatcher::fallBackToPolling(std::size_t rootIndex, bool reportContents)
+{
+	if (!_watchLimitReported)
+	{
+		rWarning() << "[vfs] The inotify watch limit has been reached, directories exceeding it " <<
+			"are polled instead. Consider raising fs.inotify.max_user_watches." << std::endl;
+		_watchLimitReported = true;
+	}
+
+	rMessage() << "[vfs] Polling " << _roots[rootIndex] << std::endl;
+
+	// Release the watches which are no longer used by any root
+	removeWatchedDirectory(rootIndex, "");
+
+	for (auto i = _watches.begin(); i != _watches.end();)
+	{
+		if (i->second.empty())
+		{
+			inotify_rm_watch(_inotifyFd, i->first);
+			i = _watches.erase(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	_rootIsPolled[rootIndex] = true;
+
+	if (reportContents)
+	{
+		// Some of the contents might not have been reported before running
+		// out of watches, start over with this root
+		_callback(rootIndex, "", Change::Removed);
+	}
+
+	addPolledDirectory(rootIndex, "", reportContents);
+}
+
+void DirectoryWatcher::runInotify()
+{
+	alignas(inotify_event) char buffer[16384];
+
+	auto nextPoll = std::chrono::steady_clock::now() + std::chrono::milliseconds(POLL_INTERVAL_MSEC);
+
+	while (true)
+	{
+		pollfd descriptor{ _inotifyFd, POLLIN, 0 };
+
+		// Wake up regularly to check whether we should stop
+		int result = ::poll(&descriptor, 1, 250);
+
+		{
+			std::lock_guard<std::mutex> lock(_lock);
+
+			if (_stopRequested) break;
+		}
+
+		if (std::chrono::steady_clock::now() >= nextPoll)
+		{
+			// Check the roots which couldn't be watched
+			pollRoots();
+			nextPoll = std::chrono::steady_clock::now() + std::chrono::milliseconds(POLL_INTERVAL_MSEC);
+		}
+
+		if (result <= 0) continue;
+
+		ssize_t length = read(_inotifyFd, buffer, sizeof(buffer));
+
+		for (ssize_t offset = 0; offset < length;)
+		{
+			const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+			offset += sizeof(inotify_event) + event->len;
+
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				// Events got lost, report everything again
+				for (std::size_t rootIndex = 0; rootIndex < _roots.size(); ++rootIndex)
+				{
+					// Polled roots catch up by themselves
+					if (_rootIsPolled[rootIndex]) continue;
+
+					_callback(rootIndex, "", Change::Removed);
+
+					if (!addWatchedDirectory(rootIndex, "", true))
+					{
+						fallBackToPolling(rootIndex, true);
+					}
+				}
+
+				continue;
+			}
+
+			auto found = _watches.find(event->wd);
+
+			if (found == _watches.end()) continue;
+
+			if (event->mask & IN_IGNORED)
+			{
+				// The watched directory is gone
+				_watches.erase(found);
+				continue;
+			}
+
+			if (event->len == 0) continue;
+
+			bool isDirectory = (event->mask & IN_ISDIR) != 0;
+			std::string name = std::string(event->name) + (isDirectory ? "/" : "");
+
+			// Take a copy, adding or removing directories changes the watches
+			auto watchedDirectories = found->second;
+
+			for (const auto& watched : watchedDirectories)
+			{
+				// The root might have run out of watches while handling this event
+				if (_rootIsPolled[watched.rootIndex]) continue;
+
+				std::string path = watched.path + name;
+
+				if (event->mask & (IN_CREATE | IN_MOVED_TO))
+				{
+					_callback(watched.rootIndex, path, Change::Added);
+
+					if (isDirectory)
+					{
+						// Files might have been created before the watch is in place
+						if (!addWatchedDirectory(watched.rootIndex, path, true))
+						{
+							fallBackToPolling(watched.rootIndex, true);
+						}
+					}
+				}
+				else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+				{
+					_callback(watched.rootIndex, path, Change::Removed);
+
+					if (isDirectory)
+					{
+						removeWatchedDirectory(watched.rootIndex, path);
+					}
+				}
+			}
+		}
+	}
+}
+
+bool DirectoryWatcher::addWatchedDirectory(std::size_t rootIndex, const std::string& path, bool reportContents)
+{
+	fs::path fullPath(_roots[rootIndex] + path);
+
+	int wd = inotify_add_watch(_inotifyFd, fullPath.generic_string().c_str(),
+		IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+
+	if (wd == -1)
+	{
+		// Missing directories are fine, running out of watches is not
+		return errno != ENOSPC;
+	}
+
+	auto& watchedDirectories = _watches[wd];
+	bool alreadyWatched = false;
+
+	for (const auto& watched : watchedDirectories)
+	{
+		alreadyWatched |= watched.rootIndex == rootIndex && watched.path == path;
+	}
+
+	if (!alreadyWatched)
+	{
+		watchedDirectories.push_back(WatchedDirectory{ rootIndex, path });
+	}
+
+	std::set<std::string> files;
+	std::set<std::string> directories;
+
+	try
+	{
+		listDirectory(fullPath, files, directories);
+	}
+	catch (const std::exception& ex)
+	{
+		rWarning() << "[vfs] Cannot watch " << fullPath.generic_string() << ": " << ex.what() << std::endl;
+		return true;
+	}
+
+	if (reportContents)
+	{
+		for (const auto& file : files)
+		{
+			_callback(rootIndex, path + file, Change::Added);
+		}
+	}
+
+	for (const auto& directory : directories)
+	{
+		if (reportContents)
+		{
+			_callback(rootIndex, path + directory + "/", Change::Added);
+		}
+
+		if (!addWatchedDirectory(rootIndex, path + directory + "/", reportContents))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void DirectoryWatcher::removeWatchedDirectory(std::size_t rootIndex, const std::string& path)
+{
+	// A moved directory keeps its watch descriptor, so the mapping needs to be
+	// removed here. If it's moved back into the tree, it's added again.
+	for (auto& pair : _watches)
+	{
+		auto& watchedDirectories = pair.second;
+
+		watchedDirectories.erase(std::remove_if(watchedDirectories.begin(), watchedDirectories.end(),
+			[&](const WatchedDirectory& watched)
+			{
+				return watched.rootIndex == rootIndex && string::starts_with(watched.path, path);
+			}), watchedDirectories.end());
+	}
+}
+
+#endif
+
+}
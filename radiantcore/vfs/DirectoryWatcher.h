@@ -0,0 +1,136 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "os/fs.h"
+
+namespace vfs
+{
+
+/**
+ * Watches a set of directory trees on disk and reports files and directories
+ * being added or removed. On Linux this is using inotify, on other platforms
+ * (or if inotify is not available) the directories are polled periodically,
+ * comparing their modification times. Roots exceeding the inotify watch limit
+ * are polled as well.
+ *
+ * The callback is invoked on the watcher thread.
+ */
+class DirectoryWatcher
+{
+public:
+	enum class Change
+	{
+		Added,
+		Removed,
+	};
+
+	// Receives the index of the root, the path relative to that root (directories
+	// end with a slash, an empty path refers to the root itself) and the change.
+	typedef std::function<void(std::size_t, const std::string&, Change)> Callback;
+
+private:
+	Callback _callback;
+
+	// The watched roots, with trailing slash
+	std::vector<std::string> _roots;
+
+	std::thread _thread;
+	std::mutex _lock;
+	std::condition_variable _stopCondition;
+	bool _stopRequested;
+
+	// True once the watches have been installed
+	bool _watching;
+
+	// Roots which are polled, by root index. With inotify, this is
+	// only the case for roots exceeding the watch limit.
+	std::vector<bool> _rootIsPolled;
+
+	typedef decltype(fs::last_write_time(std::declval<fs::path>())) FileTime;
+
+	// State of a directory when polling
+	struct PolledDirectory
+	{
+		FileTime modificationTime;
+
+		// Set if the directory has been listed because of a change (or for the
+		// first time). It's listed once more on the next poll, since changes made
+		// right after listing it don't necessarily alter its modification time.
+		bool changed = true;
+
+		std::set<std::string> files;
+		std::set<std::string> directories;
+	};
+
+	// Polled directories by root index and relative path
+	std::vector<std::map<std::string, PolledDirectory>> _polledDirectories;
+
+#if defined(__linux__)
+	int _inotifyFd;
+
+	struct WatchedDirectory
+	{
+		std::size_t rootIndex;
+		std::string path;
+	};
+
+	// Inotify watch descriptors mapped to the directories they refer to. The same
+	// directory can be part of more than one root (e.g. a pk4dir in a mod folder)
+	std::map<int, std::vector<WatchedDirectory>> _watches;
+
+	// The watch limit warning is emitted only once
+	bool _watchLimitReported;
+#endif
+
+public:
+	DirectoryWatcher(const Callback& callback);
+	~DirectoryWatcher();
+
+	// Adds a root directory (with trailing slash) to watch, returns its index.
+	// Roots have to be added before the watcher is started.
+	std::size_t addRoot(const std::string& root);
+
+	// Installs the watches (or reads the initial state of the polled roots).
+	// Changes made after this call are reported once the watcher has been
+	// started, this allows to scan the directories in between without
+	// missing any changes.
+	void watch();
+
+	// Starts the watcher thread, installing the watches if not done yet
+	void start();
+
+	// Stops the watcher thread, blocks until it's done
+	void stop();
+
+private:
+	void run();
+
+	// Waits for the given time, returns false if the watcher should stop
+	bool waitFor(std::size_t milliseconds);
+
+	// Polling implementation
+	void runPolling();
+	void pollRoots();
+	void pollDirectory(std::size_t rootIndex, const std::string& path);
+	void addPolledDirectory(std::size_t rootIndex, const std::string& path, bool reportContents);
+	void removePolledDirectory(std::size_t rootIndex, const std::string& path);
+
+#if defined(__linux__)
+	bool initialiseInotify();
+	void runInotify();
+
+	// Removes the watches of the given root and polls it instead
+	void fallBackToPolling(std::size_t rootIndex, bool reportContents);
+	bool addWatchedDirectory(std::size_t rootIndex, const std::string& path, bool reportContents);
+	void removeWatchedDirectory(std::size_t rootIndex, const std::string& path);
+#endif
+};
+
+}
@@ -39,6 +39,7 @@
 #include "DirectoryArchiveTextFile.h"
 #include "SortedFilenames.h"
 #include "ZipArchive.h"
+#include "ParallelForEach.h"
 #include "module/StaticModule.h"
 
 namespace vfs
@@ -235,6 +236,37 @@ public:
     }
 };
 
+// Collects the names of all files in an archive
+class FileCollector :
+    public Archive::Visitor
+{
+    std::vector<std::string>& _files;
+
+public:
+    FileCollector(std::vector<std::string>& files) :
+        _files(files)
+    {}
+
+    void visitFile(const std::string& name) override
+    {
+        _files.push_back(name);
+    }
+
+    bool visitDirectory(const std::string& name, std::size_t depth) override
+    {
+        return false;
+    }
+};
+
+// The file index is case-insensitive, this checks whether the name
+// matches according to the rules of the archive
+inline bool fileNameMatches(const std::string& indexedName, const std::string& name, bool isPakFile)
+{
+    // PK4 lookups are always case-insensitive, directories depend on the OS
+    return isPakFile ||
+        (indexedName.length() == name.length() && path_equal_n(indexedName.c_str(), name.c_str(), name.length()));
+}
+
 }
 
 void Doom3FileSystem::initDirectory(const std::string& inputPath)
@@ -330,6 +362,12 @@ void Doom3FileSystem::initialise(const SearchPaths& vfsSearchPaths, const Extens
         initDirectory(path);
     }
 
+    // Watch the directories before scanning them, changes made
+    // in the meantime are reported once the watcher is started
+    createDirectoryWatcher();
+    buildFileIndex();
+    _directoryWatcher->start();
+
     for (Observer* observer : _observers)
     {
         observer->onFileSystemInitialise();
@@ -343,6 +381,15 @@ void Doom3FileSystem::shutdown()
         observer->onFileSystemShutdown();
     }
 
+    // Stop watching before the archives are gone
+    _directoryWatcher.reset();
+    _watchedArchives.clear();
+
+    {
+        std::unique_lock<std::shared_mutex> lock(_indexLock);
+        _fileIndex.clear();
+    }
+
     _archives.clear();
     _directories.clear();
     _vfsSearchPaths.clear();
@@ -362,20 +409,161 @@ void Doom3FileSystem::removeObserver(Observer& observer)
     _observers.erase(&observer);
 }
 
-int Doom3FileSystem::getFileCount(const std::string& filename)
+void Doom3FileSystem::buildFileIndex()
 {
-    int count = 0;
-    std::string fixedFilename(os::standardPath(filename));
+    ScopedDebugTimer timer("[vfs] File index built");
 
-    for (const ArchiveDescriptor& descriptor : _archives)
+    std::vector<std::vector<std::string>> files(_archives.size());
+
+    // Reading the PK4 directories and walking the folders is independent of each other
+    util::parallelForEach(_archives.size(), [&](std::size_t i)
     {
-        if (descriptor.archive->containsFile(fixedFilename))
+        ArchiveDescriptor& descriptor = _archives[i];
+
+        if (descriptor.is_pakfile)
+        {
+            descriptor.archive = std::make_shared<archive::ZipArchive>(descriptor.name);
+
+            FileCollector collector(files[i]);
+            descriptor.archive->traverse(collector, "");
+        }
+        else
         {
-            ++count;
+            auto directory = std::static_pointer_cast<DirectoryArchive>(descriptor.archive);
+
+            directory->buildIndex([&](const std::string& name)
+            {
+                if (!string::ends_with(name, "/"))
+                {
+                    files[i].push_back(name);
+                }
+            });
         }
+    });
+
+    std::unique_lock<std::shared_mutex> lock(_indexLock);
+
+    for (std::size_t i = 0; i < files.size(); ++i)
+    {
+        for (const std::string& name : files[i])
+        {
+            _fileIndex.insert(i, name);
+        }
+    }
+
+    rMessage() << "[vfs] Indexed " << _fileIndex.size() << " files in " << _archives.size() << " archives" << std::endl;
+}
+
+void Doom3FileSystem::createDirectoryWatcher()
+{
+    _directoryWatcher.reset(new DirectoryWatcher(
+        std::bind(&Doom3FileSystem::onDirectoryChanged, this,
+            std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)));
+
+    for (std::size_t i = 0; i < _archives.size(); ++i)
+    {
+        if (!_archives[i].is_pakfile)
+        {
+            _directoryWatcher->addRoot(_archives[i].name);
+            _watchedArchives.push_back(i);
+        }
+    }
+
+    _directoryWatcher->watch();
+}
+
+void Doom3FileSystem::onDirectoryChanged(std::size_t rootIndex, const std::string& path, DirectoryWatcher::Change change)
+{
+    std::size_t archiveIndex = _watchedArchives[rootIndex];
+    auto directory = std::static_pointer_cast<DirectoryArchive>(_archives[archiveIndex].archive);
+
+    bool isDirectory = path.empty() || string::ends_with(path, "/");
+
+    // Update the archive first, without holding the index lock. The archive
+    // keeps its own lock while traversing, and visitors might look up files.
+    if (change == DirectoryWatcher::Change::Added)
+    {
+        directory->addToIndex(path);
+    }
+    else
+    {
+        directory->removeFromIndex(path);
     }
 
-    return count;
+    std::unique_lock<std::shared_mutex> lock(_indexLock);
+
+    if (change == DirectoryWatcher::Change::Added)
+    {
+        if (!isDirectory)
+        {
+            _fileIndex.insert(archiveIndex, path);
+        }
+    }
+    else if (isDirectory)
+    {
+        _fileIndex.eraseDirectory(archiveIndex, path);
+    }
+    else
+    {
+        _fileIndex.erase(archiveIndex, path);
+    }
+}
+
+std::vector<std::pair<ArchivePtr, std::string>> Doom3FileSystem::findArchivesContaining(const std::string& filename)
+{
+    std::vector<std::pair<ArchivePtr, std::string>> result;
+
+    {
+        std::shared_lock<std::shared_mutex> lock(_indexLock);
+
+        auto entries = _fileIndex.find(filename);
+
+        if (entries != nullptr)
+        {
+            for (const auto& entry : *entries)
+            {
+                const ArchiveDescriptor& descriptor = _archives[entry.archiveIndex];
+
+                if (fileNameMatches(entry.name, filename, descriptor.is_pakfile))
+                {
+                    result.emplace_back(descriptor.archive, entry.name);
+                }
+            }
+        }
+    }
+
+    return result.empty() ? findUnindexedFile(filename) : result;
+}
+
+std::vector<std::pair<ArchivePtr, std::string>> Doom3FileSystem::findUnindexedFile(const std::string& filename)
+{
+    std::vector<std::pair<ArchivePtr, std::string>> result;
+
+    for (std::size_t i = 0; i < _archives.size(); ++i)
+    {
+        if (_archives[i].is_pakfile) continue;
+
+        auto directory = std::static_pointer_cast<DirectoryArchive>(_archives[i].archive);
+
+        if (directory->probeFile(filename))
+        {
+            {
+                std::unique_lock<std::shared_mutex> lock(_indexLock);
+                _fileIndex.insert(i, filename);
+            }
+
+            result.emplace_back(directory, filename);
+        }
+    }
+
+    return result;
+}
+
+int Doom3FileSystem::getFileCount(const std::string& filename)
+{
+    std::string fixedFilename(os::standardPath(filename));
+
+    return static_cast<int>(findArchivesContaining(fixedFilename).size());
 }
 
 ArchiveFilePtr Doom3FileSystem::openFile(const std::string& filename)
@@ -386,9 +574,9 @@ ArchiveFilePtr Doom3FileSystem::openFile(const std::string& filename)
         return ArchiveFilePtr();
     }
 
-    for (const ArchiveDescriptor& descriptor : _archives)
+    for (const auto& pair : findArchivesContaining(filename))
     {
-        ArchiveFilePtr file = descriptor.archive->openFile(filename);
+        ArchiveFilePtr file = pair.first->openFile(pair.second);
 
         if (file)
         {
@@ -415,9 +603,9 @@ ArchiveFilePtr Doom3FileSystem::openFileInAbsolutePath(const std::string& filena
 
 ArchiveTextFilePtr Doom3FileSystem::openTextFile(const std::string& filename)
 {
-    for (const ArchiveDescriptor& descriptor : _archives)
+    for (const auto& pair : findArchivesContaining(filename))
     {
-        ArchiveTextFilePtr file = descriptor.archive->openTextFile(filename);
+        ArchiveTextFilePtr file = pair.first->openTextFile(pair.second);
 
         if (file)
         {
@@ -481,15 +669,78 @@ void Doom3FileSystem::forEachFileInAbsolutePath(const std::string& path,
 
 std::string Doom3FileSystem::findFile(const std::string& name)
 {
-    for (const ArchiveDescriptor& descriptor : _archives)
     {
-        if (!descriptor.is_pakfile && descriptor.archive->containsFile(name))
+        std::shared_lock<std::shared_mutex> lock(_indexLock);
+
+        auto entries = _fileIndex.find(name);
+
+        if (entries != nullptr)
         {
-            return descriptor.name;
+            for (const auto& entry : *entries)
+            {
+                const ArchiveDescriptor& descriptor = _archives[entry.archiveIndex];
+
+                if (!descriptor.is_pakfile && fileNameMatches(entry.name, name, false))
+                {
+                    return descriptor.name;
+                }
+            }
+
+            return std::string(); // only found in PK4s
         }
     }
 
-    return std::string();
+    auto unindexed = findUnindexedFile(name);
+
+    return unindexed.empty() ? std::string() :
+        std::static_pointer_cast<DirectoryArchive>(unindexed.front().first)->getRoot();
+}
+
+std::int64_t Doom3FileSystem::getFileModificationTime(const std::string& filename)
+{
+    std::string path;
+
+    {
+        std::shared_lock<std::shared_mutex> lock(_indexLock);
+
+        auto entries = _fileIndex.find(filename);
+
+        if (entries != nullptr)
+        {
+            for (const auto& entry : *entries)
+            {
+                const ArchiveDescriptor& descriptor = _archives[entry.archiveIndex];
+
+                if (fileNameMatches(entry.name, filename, descriptor.is_pakfile))
+                {
+                    // Files in PK4s inherit the modification time of the archive
+                    path = descriptor.is_pakfile ? descriptor.name : descriptor.name + entry.name;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (path.empty())
+    {
+        auto unindexed = findUnindexedFile(filename);
+
+        if (unindexed.empty())
+        {
+            return 0;
+        }
+
+        path = std::static_pointer_cast<DirectoryArchive>(unindexed.front().first)->getRoot() + filename;
+    }
+
+    try
+    {
+        return os::getLastWriteTime(path);
+    }
+    catch (fs::filesystem_error&)
+    {
+        return 0;
+    }
 }
 
 std::string Doom3FileSystem::findRoot(const std::string& name)
@@ -512,10 +763,10 @@ void Doom3FileSystem::initPakFile(const std::string& filename)
     if (_allowedExtensions.find(fileExt) != _allowedExtensions.end())
     {
         // Matched extension for archive (e.g. "pk3", "pk4")
+        // The archive itself is loaded when building the file index
         ArchiveDescriptor entry;
 
         entry.name = filename;
-        entry.archive = std::make_shared<archive::ZipArchive>(filename);
         entry.is_pakfile = true;
         _archives.push_back(entry);
 
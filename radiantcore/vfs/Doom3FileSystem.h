@@ -2,6 +2,10 @@
 
 #include "Archive.h"
 #include "ifilesystem.h"
+#include "FileIndex.h"
+#include "DirectoryWatcher.h"
+#include <memory>
+#include <shared_mutex>
 
 namespace vfs
 {
@@ -24,9 +28,19 @@ private:
 		bool is_pakfile;
 	};
 
-	typedef std::list<ArchiveDescriptor> ArchiveList;
+	typedef std::vector<ArchiveDescriptor> ArchiveList;
 	ArchiveList _archives;
 
+	// All files of all archives, guarded by the index lock since the
+	// directory watcher is updating it from its own thread
+	FileIndex _fileIndex;
+	std::shared_mutex _indexLock;
+
+	// Keeps the directory archives up to date, the watched
+	// roots refer to the archive indices stored in _watchedArchives
+	std::unique_ptr<DirectoryWatcher> _directoryWatcher;
+	std::vector<std::size_t> _watchedArchives;
+
 	typedef std::set<Observer*> ObserverList;
 	ObserverList _observers;
 
@@ -52,6 +66,7 @@ public:
 		std::size_t depth = 1) override;
 
 	std::string findFile(const std::string& name) override;
+	std::int64_t getFileModificationTime(const std::string& filename) override;
 	std::string findRoot(const std::string& name) override;
 
 	void addObserver(Observer& observer) override;
@@ -68,6 +83,19 @@ public:
 private:
 	void initDirectory(const std::string& path);
 	void initPakFile(const std::string& filename);
+
+	// Loads all archives in parallel and fills the file index
+	void buildFileIndex();
+	void createDirectoryWatcher();
+	void onDirectoryChanged(std::size_t rootIndex, const std::string& path, DirectoryWatcher::Change change);
+
+	// Returns the archives containing the given file, in search order
+	std::vector<std::pair<ArchivePtr, std::string>> findArchivesContaining(const std::string& filename);
+
+	// Looks for a file in the directory archives that is not indexed yet, because the
+	// directory watcher hasn't reported it so far. This is the case for files written
+	// by DarkRadiant itself and loaded right away. Found files are added to the index.
+	std::vector<std::pair<ArchivePtr, std::string>> findUnindexedFile(const std::string& filename);
 };
 
 }
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include "string/case_conv.h"
+#include "string/predicate.h"
+
+namespace vfs
+{
+
+/**
+ * Maps the virtual path of every file to the archives containing it, such
+ * that the filesystem doesn't need to query each archive in turn.
+ *
+ * Paths are hashed case-insensitively. Each entry remembers the name in its
+ * original case, it's up to the caller to decide whether that's a match.
+ */
+class FileIndex
+{
+public:
+	struct Entry
+	{
+		// Position of the archive in the search order, lower values take precedence
+		std::size_t archiveIndex;
+
+		// The file name as stored in the archive
+		std::string name;
+	};
+
+	typedef std::vector<Entry> Entries;
+
+private:
+	std::unordered_map<std::string, Entries> _files;
+
+public:
+	void insert(std::size_t archiveIndex, const std::string& name)
+	{
+		auto& entries = _files[string::to_lower_copy(name)];
+
+		// Keep the entries sorted by archive index
+		auto i = entries.begin();
+
+		for (; i != entries.end() && i->archiveIndex <= archiveIndex; ++i)
+		{
+			if (i->archiveIndex == archiveIndex && i->name == name)
+			{
+				return; // already indexed
+			}
+		}
+
+		entries.insert(i, Entry{ archiveIndex, name });
+	}
+
+	void erase(std::size_t archiveIndex, const std::string& name)
+	{
+		auto found = _files.find(string::to_lower_copy(name));
+
+		if (found == _files.end()) return;
+
+		auto& entries = found->second;
+
+		entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const Entry& entry)
+		{
+			return entry.archiveIndex == archiveIndex && entry.name == name;
+		}), entries.end());
+
+		if (entries.empty())
+		{
+			_files.erase(found);
+		}
+	}
+
+	// Removes all files of the given archive below the given directory
+	// (with trailing slash), an empty directory removes all of them.
+	// This needs to check every file in the index.
+	void eraseDirectory(std::size_t archiveIndex, const std::string& directory)
+	{
+		for (auto i = _files.begin(); i != _files.end();)
+		{
+			auto& entries = i->second;
+
+			entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const Entry& entry)
+			{
+				return entry.archiveIndex == archiveIndex && string::starts_with(entry.name, directory);
+			}), entries.end());
+
+			if (entries.empty())
+			{
+				i = _files.erase(i);
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+
+	// Returns the entries for the given path (sorted by archive index), or nullptr if not found
+	const Entries* find(const std::string& name) const
+	{
+		auto found = _files.find(string::to_lower_copy(name));
+
+		return found != _files.end() ? &found->second : nullptr;
+	}
+
+	void clear()
+	{
+		_files.clear();
+	}
+
+	std::size_t size() const
+	{
+		return _files.size();
+	}
+};
+
+}
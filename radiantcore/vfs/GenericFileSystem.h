@@ -160,6 +160,33 @@ public:
 		return _entries.find(path);
 	}
 
+	/// \brief Removes the file or directory at \p path.
+	/// If \p path is a directory (ending with a slash), everything below it is removed too.
+	void erase(const std::string& path)
+	{
+		iterator i = _entries.find(path);
+
+		if (i == _entries.end())
+		{
+			return;
+		}
+
+		if (!i->second.isDirectory())
+		{
+			_entries.erase(i);
+			return;
+		}
+
+		// Entries below the directory follow it in the sorted map
+		iterator last = i;
+
+		for (++last; last != _entries.end() &&
+			string_equal_nocase_n(last->first.c_str(), path.c_str(), path.length()); ++last)
+		{}
+
+		_entries.erase(i, last);
+	}
+
 	/// \brief Performs a depth-first traversal of the file-system subtree rooted at \p root.
 	/// Traverses the entire tree if \p root is "".
 	/// Calls \p visitor.file() with the path to each file relative to the filesystem root.
@@ -0,0 +1,178 @@
+#include "RadiantTest.h"
+
+#include <sstream>
+#include "iaasfile.h"
+#include "stream/BufferInputStream.h"
+#include "stream/ProgressTrackingInputStream.h"
+
+namespace test
+{
+
+using AasFileTest = RadiantTest;
+
+namespace
+{
+
+// Area 0 is the empty default area, area 1 is a 64x64x32 box with a floor face
+const std::string TEST_AAS_FILE = R"(DewmAAS 1.07
+
+1234567890
+
+planes 2 {
+	0 ( 0 0 1 0 )
+	1 ( 0 0 -1 -32 )
+}
+vertices 8 {
+	0 ( 0 0 0 )
+	1 ( 64 0 0 )
+	2 ( 64 64 0 )
+	3 ( 0 64 0 )
+	4 ( 0 0 32 )
+	5 ( 64 0 32 )
+	6 ( 64 64 32 )
+	7 ( 0 64 32 )
+}
+edges 9 {
+	0 ( 0 0 )
+	1 ( 0 1 )
+	2 ( 1 2 )
+	3 ( 2 3 )
+	4 ( 3 0 )
+	5 ( 4 5 )
+	6 ( 5 6 )
+	7 ( 6 7 )
+	8 ( 7 4 )
+}
+edgeIndex 8 {
+	0 ( 1 )
+	1 ( 2 )
+	2 ( 3 )
+	3 ( 4 )
+	4 ( 5 )
+	5 ( 6 )
+	6 ( 7 )
+	7 ( 8 )
+}
+faces 3 {
+	0 ( 0 0 0 0 0 0 )
+	1 ( 0 4 1 0 0 4 )
+	2 ( 1 1 1 0 4 4 )
+}
+faceIndex 2 {
+	0 ( 1 )
+	1 ( 2 )
+}
+areas 2 {
+	0 ( 0 0 0 0 0 0 ) 0 {
+	}
+	1 ( 65 0 0 2 1 1 ) 0 {
+	}
+}
+)";
+
+// Hands out the data of another stream in small portions,
+// to have the tokens cross the boundaries of the read buffer
+class ChunkedInputStream :
+    public TextInputStream
+{
+private:
+    TextInputStream& _source;
+    std::size_t _chunkSize;
+
+public:
+    ChunkedInputStream(TextInputStream& source, std::size_t chunkSize) :
+        _source(source),
+        _chunkSize(chunkSize)
+    {}
+
+    std::size_t read(char* buffer, std::size_t length) override
+    {
+        return _source.read(buffer, std::min(length, _chunkSize));
+    }
+};
+
+map::IAasFileLoaderPtr getLoader(const std::string& content)
+{
+    std::istringstream stream(content);
+    return GlobalAasFileManager().getLoaderForStream(stream);
+}
+
+map::IAasFilePtr loadThroughProgressStream(TextInputStream& source, std::atomic<std::size_t>& bytesRead)
+{
+    auto loader = getLoader(TEST_AAS_FILE);
+    EXPECT_TRUE(loader) << "No loader for the test file";
+
+    if (!loader) return map::IAasFilePtr();
+
+    stream::ProgressTrackingInputStream progressStream(source, bytesRead);
+    std::istream stream(&progressStream);
+
+    return loader->loadFromStream(stream);
+}
+
+void expectTestAreas(const map::IAasFilePtr& aasFile)
+{
+    ASSERT_TRUE(aasFile);
+
+    EXPECT_EQ(aasFile->getNumPlanes(), 2);
+    EXPECT_EQ(aasFile->getNumVertices(), 8);
+    EXPECT_EQ(aasFile->getNumFaces(), 3);
+    ASSERT_EQ(aasFile->getNumAreas(), 2);
+
+    const auto& area = aasFile->getArea(1);
+
+    EXPECT_EQ(area.numFaces, 2);
+    EXPECT_TRUE(area.bounds.getOrigin().isEqual(Vector3(32, 32, 16), 0.01));
+    EXPECT_TRUE(area.bounds.getExtents().isEqual(Vector3(32, 32, 16), 0.01));
+
+    // The area is reachable by walking, its center is the one of the floor face
+    EXPECT_TRUE(area.center.isEqual(Vector3(32, 32, 0), 0.01));
+}
+
+}
+
+TEST_F(AasFileTest, LoadThroughProgressTrackingStream)
+{
+    stream::BufferInputStream buffer(TEST_AAS_FILE.data(), TEST_AAS_FILE.size());
+    std::atomic<std::size_t> bytesRead(0);
+
+    auto aasFile = loadThroughProgressStream(buffer, bytesRead);
+
+    expectTestAreas(aasFile);
+
+    // The whole file has been consumed and counted
+    EXPECT_EQ(bytesRead, TEST_AAS_FILE.size());
+}
+
+TEST_F(AasFileTest, LoadInSmallChunks)
+{
+    for (std::size_t chunkSize : { 1, 3, 7, 64 })
+    {
+        stream::BufferInputStream buffer(TEST_AAS_FILE.data(), TEST_AAS_FILE.size());
+        ChunkedInputStream chunks(buffer, chunkSize);
+        std::atomic<std::size_t> bytesRead(0);
+
+        auto aasFile = loadThroughProgressStream(chunks, bytesRead);
+
+        expectTestAreas(aasFile);
+        EXPECT_EQ(bytesRead, TEST_AAS_FILE.size()) << "Chunk size " << chunkSize;
+    }
+}
+
+TEST_F(AasFileTest, TruncatedFileFailsToLoad)
+{
+    // Cut the file in the middle of the area list
+    std::string truncated = TEST_AAS_FILE.substr(0, TEST_AAS_FILE.find("1 ( 65"));
+
+    stream::BufferInputStream buffer(truncated.data(), truncated.size());
+    std::atomic<std::size_t> bytesRead(0);
+
+    map::IAasFilePtr aasFile;
+    EXPECT_NO_THROW(aasFile = loadThroughProgressStream(buffer, bytesRead));
+
+    // The parse error is reported by an empty result
+    EXPECT_FALSE(aasFile);
+    EXPECT_EQ(bytesRead, truncated.size());
+}
+
+}
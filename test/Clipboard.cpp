@@ -0,0 +1,201 @@
+#include "RadiantTest.h"
+
+#include "iclipboard.h"
+#include "icommandsystem.h"
+#include "imap.h"
+#include "imapstatistics.h"
+#include "iselection.h"
+#include "ientity.h"
+#include "scenelib.h"
+#include "algorithm/Scene.h"
+
+namespace test
+{
+
+namespace
+{
+
+// Clipboard module standing in for the system clipboard, which is not
+// available in the test environment. Deferred text is generated on the
+// first read, like the wxWidgets-based implementation does.
+class TestClipboard :
+    public radiant::IClipboard
+{
+private:
+    std::string _text;
+    StringProducer _producer;
+
+    std::size_t _token = 0;
+    std::size_t _nextToken = 1;
+
+public:
+    std::string getString() override
+    {
+        if (_producer)
+        {
+            _text = _producer();
+            _producer = nullptr;
+        }
+
+        return _text;
+    }
+
+    void setString(const std::string& str) override
+    {
+        _text = str;
+        _producer = nullptr;
+        _token = 0;
+    }
+
+    std::size_t setDeferredString(const StringProducer& producer) override
+    {
+        _text.clear();
+        _producer = producer;
+        _token = _nextToken++;
+
+        return _token;
+    }
+
+    bool containsContent(std::size_t token) override
+    {
+        return token != 0 && token == _token;
+    }
+
+    // Returns true if the deferred text has not been requested yet
+    bool isDeferred() const
+    {
+        return static_cast<bool>(_producer);
+    }
+
+    const std::string& getName() const override
+    {
+        static std::string _name(MODULE_CLIPBOARD);
+        return _name;
+    }
+
+    const StringSet& getDependencies() const override
+    {
+        static StringSet _dependencies;
+        return _dependencies;
+    }
+
+    void initialiseModule(const IApplicationContext& ctx) override
+    {}
+};
+
+}
+
+class ClipboardSnapshotTest :
+    public RadiantTest
+{
+protected:
+    std::shared_ptr<TestClipboard> _clipboard;
+
+    // Text expected on the clipboard after all modules have been shut down
+    std::string _expectedTextAfterShutdown;
+
+    void SetUp() override
+    {
+        // The clipboard module needs to be present before the modules are initialised
+        _clipboard = std::make_shared<TestClipboard>();
+        _coreModule->get()->getModuleRegistry().registerModule(_clipboard);
+
+        RadiantTest::SetUp();
+    }
+
+    void TearDown() override
+    {
+        RadiantTest::TearDown();
+
+        if (!_expectedTextAfterShutdown.empty())
+        {
+            EXPECT_NE(_clipboard->getString().find(_expectedTextAfterShutdown), std::string::npos)
+                << "Clipboard text has not been kept after shutdown";
+        }
+    }
+
+    // Selects func_static_1, light_1 and the first worldspawn brush and copies them
+    void copyTestSelection()
+    {
+        loadMap("select_items_by_model.map");
+
+        auto root = GlobalMapModule().getRoot();
+        auto funcStatic = algorithm::getEntityByName(root, "func_static_1");
+        auto light = algorithm::getEntityByName(root, "light_1");
+        auto brush = algorithm::getNthChild(GlobalMapModule().getWorldspawn(), 0);
+
+        ASSERT_TRUE(funcStatic);
+        ASSERT_TRUE(light);
+        ASSERT_TRUE(brush);
+
+        Node_setSelected(funcStatic, true);
+        Node_setSelected(light, true);
+        Node_setSelected(brush, true);
+
+        GlobalCommandSystem().executeCommand("Copy");
+    }
+};
+
+TEST_F(ClipboardSnapshotTest, PasteSnapshotTwice)
+{
+    copyTestSelection();
+
+    auto& statistics = GlobalMapModule().getRoot()->getStatistics();
+
+    EXPECT_EQ(statistics.getEntityCount(), 7);
+    EXPECT_EQ(statistics.getPrimitiveCount(), 6);
+
+    GlobalCommandSystem().executeCommand("Paste");
+
+    // Two entities and one brush have been added, the brush went into the existing worldspawn
+    EXPECT_EQ(statistics.getEntityCount(), 9);
+    EXPECT_EQ(statistics.getPrimitiveCount(), 7);
+    EXPECT_EQ(GlobalSelectionSystem().countSelected(), 3);
+
+    GlobalCommandSystem().executeCommand("Paste");
+
+    EXPECT_EQ(statistics.getEntityCount(), 11);
+    EXPECT_EQ(statistics.getPrimitiveCount(), 8);
+    EXPECT_EQ(GlobalSelectionSystem().countSelected(), 3);
+
+    // Pasting the snapshot didn't need the clipboard text
+    EXPECT_TRUE(_clipboard->isDeferred());
+
+    auto root = GlobalMapModule().getRoot();
+
+    // The originals are untouched, every paste got a new set of names
+    for (const auto& name : { "func_static_1", "func_static_2", "func_static_3", "func_static_4",
+        "light_1", "light_2", "light_3" })
+    {
+        EXPECT_TRUE(algorithm::getEntityByName(root, name)) << "Entity " << name << " not found";
+    }
+
+    // The pasted entities got their children cloned too
+    EXPECT_TRUE(algorithm::findChildModel(algorithm::getEntityByName(root, "func_static_3")));
+    EXPECT_TRUE(algorithm::findChildModel(algorithm::getEntityByName(root, "func_static_4")));
+}
+
+TEST_F(ClipboardSnapshotTest, ClipboardTextIsGeneratedOnDemand)
+{
+    copyTestSelection();
+
+    EXPECT_TRUE(_clipboard->isDeferred());
+
+    auto text = _clipboard->getString();
+
+    EXPECT_NE(text.find("\"name\" \"func_static_1\""), std::string::npos);
+    EXPECT_NE(text.find("\"name\" \"light_1\""), std::string::npos);
+    EXPECT_EQ(text.find("\"name\" \"func_static_2\""), std::string::npos);
+}
+
+TEST_F(ClipboardSnapshotTest, ClipboardTextSurvivesShutdown)
+{
+    copyTestSelection();
+
+    EXPECT_TRUE(_clipboard->isDeferred());
+
+    // Checked in TearDown, after the snapshot has been released
+    _expectedTextAfterShutdown = "\"name\" \"func_static_1\"";
+}
+
+}
@@ -0,0 +1,128 @@
+#include "RadiantTest.h"
+
+#include "imap.h"
+#include "igame.h"
+#include "icommandsystem.h"
+#include "iselection.h"
+#include "scenelib.h"
+#include "os/fs.h"
+#include "algorithm/Scene.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace test
+{
+
+using CollisionModelTest = RadiantTest;
+
+namespace
+{
+
+// Returns the number following the given "/* label = */" comment in the file contents
+std::size_t getCount(const std::string& contents, const std::string& label)
+{
+    std::string comment = "/* " + label + " = */ ";
+    auto pos = contents.find(comment);
+
+    return pos != std::string::npos ? std::stoul(contents.substr(pos + comment.length())) : 0;
+}
+
+std::size_t getNumPolygons(const std::string& contents)
+{
+    std::size_t count = 0;
+
+    for (auto pos = contents.find("\"textures/common/collision\""); pos != std::string::npos;
+         pos = contents.find("\"textures/common/collision\"", pos + 1))
+    {
+        ++count;
+    }
+
+    return count;
+}
+
+std::string readFile(const fs::path& path)
+{
+    std::stringstream contents;
+    contents << std::ifstream(path.string()).rdbuf();
+
+    return contents.str();
+}
+
+// Exports the brushes of the collision_hull entity as models/cm_export_test.cm
+// and returns the contents of the written file
+std::string exportCollisionHull()
+{
+    auto entity = algorithm::getEntityByName(GlobalMapModule().getRoot(), "collision_hull");
+    EXPECT_TRUE(entity);
+
+    if (!entity) return std::string();
+
+    GlobalSelectionSystem().setSelectedAll(false);
+    Node_setSelected(entity, true);
+
+    GlobalCommandSystem().executeCommand("ExportSelectedAsCollisionModel", std::string("models/cm_export_test.lwo"));
+
+    fs::path cmPath = GlobalGameManager().getModPath() + "models/cm_export_test.cm";
+    EXPECT_TRUE(fs::exists(cmPath));
+
+    std::string contents = readFile(cmPath);
+    fs::remove(cmPath);
+
+    return contents;
+}
+
+}
+
+TEST_F(CollisionModelTest, TouchingBrushesShareVerticesAndEdges)
+{
+    loadMap("collision_model_export.map");
+
+    std::string cm = exportCollisionHull();
+
+    EXPECT_EQ(cm.find("CM \"1.00\"\n\n0\n\ncollisionModel \"models/cm_export_test.lwo\" {\n"), 0);
+
+    // The four corners of the touching faces are welded
+    EXPECT_EQ(getCount(cm, "numVertices"), 12);
+
+    // 12 edges per box, minus the 4 shared ones, plus the NULL edge
+    EXPECT_EQ(getCount(cm, "numEdges"), 21);
+
+    // The two touching faces cancel each other out
+    EXPECT_EQ(getNumPolygons(cm), 10);
+
+    // Two brushes with 6 faces each
+    EXPECT_EQ(getCount(cm, "brushMemory"), 2 * 6 * 16 + 2 * 44);
+}
+
+TEST_F(CollisionModelTest, ExportMatchesReferenceFile)
+{
+    loadMap("collision_model_export.map");
+
+    std::string cm = exportCollisionHull();
+
+    // Vertex and edge numbering, polygon order and number formatting
+    // have to match the reference byte for byte
+    EXPECT_EQ(cm, readFile(_context.getTestResourcePath() + "maps/collision_model_export.cm"));
+}
+
+TEST_F(CollisionModelTest, VerticesWithinToleranceAreWelded)
+{
+    // The touching faces are at x = 64.00004 and x = 64.00006, which
+    // are snapped to different positions but are within the tolerance
+    loadMap("collision_model_weld.map");
+
+    std::string cm = exportCollisionHull();
+
+    EXPECT_EQ(getCount(cm, "numVertices"), 12);
+    EXPECT_EQ(getCount(cm, "numEdges"), 21);
+    EXPECT_EQ(getNumPolygons(cm), 10);
+
+    // The welded vertices keep the position of the first brush
+    std::string vertices = cm.substr(0, cm.find("edges {"));
+
+    EXPECT_NE(vertices.find("/* 0 */ ( 64 64 64 )"), std::string::npos);
+    EXPECT_EQ(vertices.find("64.0001"), std::string::npos);
+}
+
+}
@@ -0,0 +1,95 @@
+#include "RadiantTest.h"
+
+#include "ieclass.h"
+#include "os/fs.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace test
+{
+
+using EntityClassTest = RadiantTest;
+
+namespace
+{
+
+// Replaces the contents of a file, the original contents are restored on destruction
+class ModifiedFile
+{
+private:
+    fs::path _path;
+    std::string _originalContents;
+
+public:
+    ModifiedFile(const fs::path& path, const std::string& newContents) :
+        _path(path)
+    {
+        std::stringstream contents;
+        contents << std::ifstream(_path.string()).rdbuf();
+        _originalContents = contents.str();
+
+        std::ofstream(_path.string()) << newContents;
+    }
+
+    ~ModifiedFile()
+    {
+        std::ofstream(_path.string()) << _originalContents;
+    }
+};
+
+}
+
+TEST_F(EntityClassTest, ModelDefIsAppliedToEntityClass)
+{
+    auto eclass = GlobalEntityClassManager().findClass("dr:entity_using_modeldef");
+
+    ASSERT_TRUE(eclass);
+    EXPECT_EQ(eclass->getModelPath(), "just_an_md5.md5mesh");
+}
+
+TEST_F(EntityClassTest, ReloadKeepsUnchangedClassesIntact)
+{
+    auto eclass = GlobalEntityClassManager().findClass("dr:entity_using_modeldef");
+    auto model = GlobalEntityClassManager().findModel("just_a_model");
+
+    GlobalEntityClassManager().reloadDefs();
+
+    // The same objects are still in place, with their resolved contents
+    EXPECT_EQ(GlobalEntityClassManager().findClass("dr:entity_using_modeldef"), eclass);
+    EXPECT_EQ(GlobalEntityClassManager().findModel("just_a_model"), model);
+    EXPECT_EQ(eclass->getModelPath(), "just_an_md5.md5mesh");
+    EXPECT_EQ(eclass->getAttribute("random").getValue(), "1");
+}
+
+TEST_F(EntityClassTest, ReloadOnlyParsesModifiedFiles)
+{
+    auto changedClass = GlobalEntityClassManager().findClass("dr:reload_test");
+    auto unchangedClass = GlobalEntityClassManager().findClass("dr:entity_using_modeldef");
+
+    ASSERT_TRUE(changedClass);
+    ASSERT_TRUE(unchangedClass);
+    EXPECT_EQ(changedClass->getAttribute("reload_value").getValue(), "original");
+
+    // Classes taking over freshly parsed contents emit their changed signal
+    std::size_t changedClassParsed = 0;
+    std::size_t unchangedClassParsed = 0;
+
+    changedClass->changedSignal().connect([&]() { ++changedClassParsed; });
+    unchangedClass->changedSignal().connect([&]() { ++unchangedClassParsed; });
+
+    ModifiedFile modifiedDef(_context.getTestResourcePath() + "def/reload_test.def",
+        "entityDef dr:reload_test\n{\n\t\"reload_value\"\t\"modified\"\n}\n");
+
+    GlobalEntityClassManager().reloadDefs();
+
+    // The modified file has been parsed again, the other one has been skipped
+    EXPECT_EQ(changedClassParsed, 1);
+    EXPECT_EQ(unchangedClassParsed, 0);
+
+    EXPECT_EQ(GlobalEntityClassManager().findClass("dr:reload_test"), changedClass);
+    EXPECT_EQ(changedClass->getAttribute("reload_value").getValue(), "modified");
+    EXPECT_EQ(unchangedClass->getModelPath(), "just_an_md5.md5mesh");
+}
+
+}
@@ -107,4 +107,41 @@ TEST_F(FacePlaneTest, FacePlaneTranslate)
     });
 }
 
+TEST_F(FacePlaneTest, TextureCoordinatesFollowTexdefChanges)
+{
+    performTest([this](const IBrushNodePtr& brush)
+    {
+        auto& face = brush->getIBrush().getFace(0);
+
+        std::vector<Vector2> texcoords;
+
+        for (std::size_t i = 0; i < face.getWinding().size(); ++i)
+        {
+            texcoords.push_back(face.getTexcoord(i));
+        }
+
+        EXPECT_EQ(texcoords.size(), 4);
+
+        // The texture coordinates are evaluated again after shifting
+        face.shiftTexdef(0.5f, 0.25f);
+
+        for (std::size_t i = 0; i < face.getWinding().size(); ++i)
+        {
+            EXPECT_NEAR(face.getTexcoord(i).x(), texcoords[i].x() - 0.5, 0.001);
+            EXPECT_NEAR(face.getTexcoord(i).y(), texcoords[i].y() + 0.25, 0.001);
+        }
+
+        // Texture axes are perpendicular to the face normal
+        Vector3 tangent, bitangent;
+        face.getTextureAxes(tangent, bitangent);
+
+        EXPECT_NEAR(tangent.getLength(), 1, 0.001);
+        EXPECT_NEAR(bitangent.getLength(), 1, 0.001);
+        EXPECT_NEAR(tangent.dot(face.getPlane3().normal()), 0, 0.001);
+        EXPECT_NEAR(bitangent.dot(face.getPlane3().normal()), 0, 0.001);
+
+        return true;
+    });
+}
+
 }
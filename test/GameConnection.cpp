@@ -0,0 +1,230 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gameconn/AutomationEngine.h"
+#include "gameconn/MessageTcp.h"
+#include "gameconn/clsocket/ActiveSocket.h"
+#include "gameconn/clsocket/PassiveSocket.h"
+
+namespace test
+{
+
+namespace
+{
+
+const char* const LOOPBACK_HOST = "127.0.0.1";
+
+// Upper limit for waiting on the loopback game, to fail instead of hanging
+const std::chrono::seconds RESPONSE_TIMEOUT(10);
+
+/**
+ * Local stand-in for the game side of the automation protocol.
+ * Accepts one connection and answers every request with its own content,
+ * optionally holding back responses until released.
+ * It listens on a free port assigned by the system.
+ */
+class LoopbackGame
+{
+private:
+    CPassiveSocket _listener;
+    int _port;
+    std::thread _thread;
+    std::atomic<bool> _stop;
+    std::atomic<bool> _holdResponses;
+    std::atomic<int> _numRequests;
+
+public:
+    LoopbackGame() :
+        _port(0),
+        _stop(false),
+        _holdResponses(false),
+        _numRequests(0)
+    {
+        _listener.Initialize();
+
+        if (_listener.Listen(LOOPBACK_HOST, 0))
+        {
+            sockaddr_in address;
+            socklen_t length = sizeof(address);
+
+            if (getsockname(_listener.GetSocketDescriptor(), reinterpret_cast<sockaddr*>(&address), &length) == 0)
+            {
+                _port = ntohs(address.sin_port);
+            }
+        }
+
+        _thread = std::thread([this]() { run(); });
+    }
+
+    ~LoopbackGame()
+    {
+        _stop = true;
+        _thread.join();
+    }
+
+    int getPort() const
+    {
+        return _port;
+    }
+
+    void setHoldResponses(bool hold)
+    {
+        _holdResponses = hold;
+    }
+
+    int getNumRequests() const
+    {
+        return _numRequests;
+    }
+
+private:
+    void run()
+    {
+        if (_port == 0) return;
+
+        std::unique_ptr<CActiveSocket> socket(_listener.Accept());
+        if (!socket) return;
+        socket->SetNonblocking();
+
+        gameconn::MessageTcp connection;
+        connection.init(std::move(socket));
+
+        std::vector<char> message;
+        std::vector<std::string> heldResponses;
+
+        while (!_stop && connection.isAlive())
+        {
+            while (connection.readMessage(message))
+            {
+                ++_numRequests;
+
+                int seqno = 0, lineLen = 0;
+                sscanf(message.data(), "seqno %d\n%n", &seqno, &lineLen);
+
+                heldResponses.push_back("response " + std::to_string(seqno) + "\n" +
+                    std::string(message.begin() + lineLen, message.end()));
+            }
+
+            if (!_holdResponses)
+            {
+                for (const auto& response : heldResponses)
+                {
+                    connection.writeMessage(response.data(), static_cast<int>(response.size()));
+                }
+                heldResponses.clear();
+            }
+
+            connection.think();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+};
+
+std::unique_ptr<gameconn::MessageTcp> connectToLoopback(const LoopbackGame& game)
+{
+    std::unique_ptr<CActiveSocket> socket(new CActiveSocket());
+
+    if (game.getPort() == 0 || !socket->Initialize() ||
+        !socket->Open(LOOPBACK_HOST, static_cast<uint16>(game.getPort())) || !socket->SetNonblocking())
+    {
+        return std::unique_ptr<gameconn::MessageTcp>();
+    }
+
+    std::unique_ptr<gameconn::MessageTcp> connection(new gameconn::MessageTcp());
+    connection->init(std::move(socket));
+    return connection;
+}
+
+// Lets the engine think until the given condition is met, returns false on timeout
+template<typename Condition>
+bool thinkUntil(gameconn::AutomationEngine& engine, const Condition& condition)
+{
+    auto deadline = std::chrono::steady_clock::now() + RESPONSE_TIMEOUT;
+
+    while (!condition())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+
+        engine.think();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return true;
+}
+
+}
+
+TEST(GameConnection, BlockingRequestReturnsResponse)
+{
+    LoopbackGame game;
+
+    gameconn::AutomationEngine engine;
+    engine.attach(connectToLoopback(game));
+    ASSERT_TRUE(engine.isAlive());
+
+    EXPECT_EQ(engine.executeRequest(0, "getviewpos\n"), "getviewpos\n");
+    EXPECT_EQ(engine.getNumRequestsInProgress(), 0);
+}
+
+TEST(GameConnection, PipelinedRequestsMatchedBySeqno)
+{
+    LoopbackGame game;
+    game.setHoldResponses(true);
+
+    gameconn::AutomationEngine engine;
+    engine.attach(connectToLoopback(game));
+    ASSERT_TRUE(engine.isAlive());
+
+    std::vector<std::string> responses;
+
+    auto first = engine.sendRequest(1, "first", [&](const std::string& r) { responses.push_back(r); });
+    auto second = engine.sendRequest(2, "second", [&](const std::string& r) { responses.push_back(r); });
+
+    // Both requests are in flight at the same time, nothing is blocking
+    EXPECT_NE(first, second);
+    EXPECT_EQ(engine.getNumRequestsInProgress(), 2);
+    EXPECT_TRUE(engine.isTagInProgress(1));
+    EXPECT_TRUE(engine.isTagInProgress(2));
+
+    ASSERT_TRUE(thinkUntil(engine, [&]() { return game.getNumRequests() >= 2; }));
+
+    EXPECT_EQ(engine.getNumRequestsInProgress(), 2);
+
+    game.setHoldResponses(false);
+    ASSERT_TRUE(thinkUntil(engine, [&]() { return engine.getNumRequestsInProgress() == 0; }));
+
+    EXPECT_TRUE(engine.isRequestFinished(first));
+    EXPECT_TRUE(engine.isRequestFinished(second));
+    EXPECT_FALSE(engine.isTagInProgress(1));
+    ASSERT_EQ(responses.size(), 2);
+    EXPECT_EQ(responses[0], "first");
+    EXPECT_EQ(responses[1], "second");
+}
+
+TEST(GameConnection, DetachDropsRequestsInProgress)
+{
+    LoopbackGame game;
+    game.setHoldResponses(true);
+
+    gameconn::AutomationEngine engine;
+    engine.attach(connectToLoopback(game));
+
+    bool called = false;
+    auto seqno = engine.sendRequest(0, "never answered", [&](const std::string&) { called = true; });
+    EXPECT_FALSE(engine.isRequestFinished(seqno));
+
+    engine.detach();
+
+    EXPECT_FALSE(engine.isAlive());
+    EXPECT_TRUE(engine.isRequestFinished(seqno));
+    EXPECT_EQ(engine.sendRequest(0, "dropped"), 0);
+    EXPECT_FALSE(called);
+}
+
+}
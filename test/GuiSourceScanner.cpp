@@ -0,0 +1,110 @@
+#include "gtest/gtest.h"
+
+#include "parser/GuiSourceScanner.h"
+
+namespace test
+{
+
+namespace
+{
+
+const std::vector<std::string> READABLE_WINDOWDEFS = { "body", "leftBody" };
+
+std::vector<std::string> getTokens(const std::string& text)
+{
+    std::vector<std::string> tokens;
+
+    parser::GuiSourceScanner scanner(text);
+    std::string token;
+
+    while (scanner.nextToken(token))
+    {
+        tokens.push_back(token);
+    }
+
+    return tokens;
+}
+
+}
+
+TEST(GuiSourceScanner, Tokenise)
+{
+    // Same delimiters as the CodeTokeniser, quotes are stripped
+    EXPECT_EQ(getTokens("windowDef Desktop{rect 0,0,640,480;text \"a {quoted} text\"}"),
+        std::vector<std::string>({ "windowDef", "Desktop", "{", "rect", "0", ",", "0", ",", "640", ",", "480", ";",
+            "text", "a {quoted} text", "}" }));
+
+    // An unterminated quote ends at the end of the text
+    EXPECT_EQ(getTokens("text \"unterminated"), std::vector<std::string>({ "text", "unterminated" }));
+}
+
+TEST(GuiSourceScanner, CommentsAreSkipped)
+{
+    EXPECT_EQ(getTokens("// line comment\nfirst/* block\ncomment */second// trailing"),
+        std::vector<std::string>({ "first", "second" }));
+
+    // Comment markers within quotes are part of the token
+    EXPECT_EQ(getTokens("\"//not a comment\" \"/*\""), std::vector<std::string>({ "//not a comment", "/*" }));
+
+    // An unterminated block comment is running to the end of the text
+    EXPECT_EQ(getTokens("token /* windowDef body {"), std::vector<std::string>({ "token" }));
+}
+
+TEST(GuiSourceScanner, FindWindowDefs)
+{
+    auto statements = parser::GuiSourceScanner::findStatements(R"(
+windowDef Desktop
+{
+    // windowDef body { }
+    /* windowDef leftBody { } */
+    windowDef Body { }
+    text "windowDef body"
+    WINDOWDEF leftBody
+    {
+        indowDef body { }
+    }
+})", READABLE_WINDOWDEFS);
+
+    // Names are case-sensitive, the keyword is not. The "indowDef" typo is accepted.
+    ASSERT_EQ(statements.size(), 2);
+
+    EXPECT_FALSE(statements[0].isInclude);
+    EXPECT_EQ(statements[0].name, "leftBody");
+    EXPECT_EQ(statements[0].depth, 1);
+
+    EXPECT_FALSE(statements[1].isInclude);
+    EXPECT_EQ(statements[1].name, "body");
+    EXPECT_EQ(statements[1].depth, 2);
+}
+
+TEST(GuiSourceScanner, FindIncludes)
+{
+    auto statements = parser::GuiSourceScanner::findStatements(R"(
+#include "guis/readables/common.guicode"
+windowDef Desktop
+{
+    #include "guis/readables/body.guicode"
+    windowDef body { }
+}
+}
+#include "guis/readables/trailing.guicode")", READABLE_WINDOWDEFS);
+
+    ASSERT_EQ(statements.size(), 4);
+
+    EXPECT_TRUE(statements[0].isInclude);
+    EXPECT_EQ(statements[0].name, "guis/readables/common.guicode");
+    EXPECT_EQ(statements[0].depth, 0);
+
+    EXPECT_TRUE(statements[1].isInclude);
+    EXPECT_EQ(statements[1].name, "guis/readables/body.guicode");
+    EXPECT_EQ(statements[1].depth, 1);
+
+    EXPECT_FALSE(statements[2].isInclude);
+    EXPECT_EQ(statements[2].depth, 1);
+
+    // Excess closing braces don't make the depth negative
+    EXPECT_TRUE(statements[3].isInclude);
+    EXPECT_EQ(statements[3].depth, 0);
+}
+
+}
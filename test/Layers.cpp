@@ -0,0 +1,133 @@
+#include "RadiantTest.h"
+
+#include "imap.h"
+#include "ilayer.h"
+#include "ibrush.h"
+#include "entitylib.h"
+#include "scenelib.h"
+#include "algorithm/Scene.h"
+
+namespace test
+{
+
+using LayerTest = RadiantTest;
+
+TEST(LayerList, InsertAndErase)
+{
+    scene::LayerList layers;
+    EXPECT_TRUE(layers.empty());
+
+    EXPECT_TRUE(layers.insert(3));
+    EXPECT_FALSE(layers.insert(3));
+    EXPECT_TRUE(layers.insert(0));
+    EXPECT_TRUE(layers.insert(200)); // beyond the inline word
+
+    EXPECT_EQ(layers.size(), 3);
+    EXPECT_TRUE(layers.contains(200));
+    EXPECT_FALSE(layers.contains(64));
+    EXPECT_TRUE(layers.find(1) == layers.end());
+
+    EXPECT_EQ(layers.erase(3), 1);
+    EXPECT_EQ(layers.erase(3), 0);
+    EXPECT_EQ(layers.size(), 2);
+}
+
+TEST(LayerList, IteratesInAscendingOrder)
+{
+    scene::LayerList layers{ 130, 5, 63, 64, 0 };
+
+    std::vector<int> ids(layers.begin(), layers.end());
+
+    EXPECT_EQ(ids, std::vector<int>({ 0, 5, 63, 64, 130 }));
+}
+
+TEST(LayerList, IntersectionAndEquality)
+{
+    scene::LayerList a{ 1, 100 };
+    scene::LayerList b{ 2, 100 };
+    scene::LayerList c{ 2 };
+
+    EXPECT_TRUE(a.intersects(b));
+    EXPECT_FALSE(a.intersects(c));
+
+    // Trailing empty words don't matter for equality
+    c.insert(300);
+    c.erase(300);
+    EXPECT_TRUE(c == scene::LayerList{ 2 });
+    EXPECT_TRUE(a != b);
+}
+
+TEST_F(LayerTest, MemberCountFollowsMembership)
+{
+    loadMap("csg_merge.map");
+
+    auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
+    auto worldspawn = GlobalMapModule().getWorldspawn();
+
+    std::size_t numPrimitivesAndEntities = 0;
+    GlobalSceneGraph().root()->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (Node_isPrimitive(node) || Node_isEntity(node)) ++numPrimitivesAndEntities;
+        return true;
+    });
+
+    EXPECT_EQ(layerManager.getLayerMemberCount(0), numPrimitivesAndEntities);
+
+    int layerId = layerManager.createLayer("Test");
+    auto brush = algorithm::findFirstBrushWithMaterial(worldspawn, "1");
+
+    GlobalSelectionSystem().setSelectedAll(false);
+    Node_setSelected(brush, true);
+    layerManager.moveSelectionToLayer(layerId);
+
+    EXPECT_EQ(layerManager.getLayerMemberCount(layerId), 1);
+    EXPECT_EQ(layerManager.getLayerMemberCount(0), numPrimitivesAndEntities - 1);
+
+    // Removed nodes are no longer counted
+    scene::removeNodeFromParent(brush);
+    EXPECT_EQ(layerManager.getLayerMemberCount(layerId), 0);
+}
+
+TEST_F(LayerTest, HidingLayerUpdatesMembersAndParents)
+{
+    loadMap("csg_merge.map");
+
+    auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
+    auto worldspawn = GlobalMapModule().getWorldspawn();
+
+    int layerId = layerManager.createLayer("Test");
+
+    // Move everything to the new layer, including worldspawn
+    GlobalSelectionSystem().setSelectedAll(false);
+    GlobalSceneGraph().root()->foreachNode([&](const scene::INodePtr& node)
+    {
+        node->moveToLayer(layerId);
+        return true;
+    });
+
+    // Put one brush back into the default layer
+    auto brush = algorithm::findFirstBrushWithMaterial(worldspawn, "1");
+    auto otherBrush = algorithm::findFirstBrushWithMaterial(worldspawn, "2");
+    brush->moveToLayer(0);
+
+    Node_setSelected(otherBrush, true);
+    layerManager.setLayerVisibility(layerId, false);
+
+    EXPECT_FALSE(otherBrush->visible());
+    EXPECT_FALSE(Node_isSelected(otherBrush));
+    EXPECT_TRUE(brush->visible());
+
+    // Worldspawn stays visible, since one of its children is
+    EXPECT_TRUE(worldspawn->visible());
+
+    layerManager.setLayerVisibility(0, false);
+    EXPECT_FALSE(brush->visible());
+    EXPECT_FALSE(worldspawn->visible());
+
+    layerManager.setLayerVisibility(layerId, true);
+    EXPECT_TRUE(otherBrush->visible());
+    EXPECT_TRUE(worldspawn->visible());
+    EXPECT_FALSE(brush->visible());
+}
+
+}
@@ -0,0 +1,129 @@
+#include "RadiantTest.h"
+
+#include "imap.h"
+#include "imapstatistics.h"
+#include "ientity.h"
+#include "ieclass.h"
+#include "scenelib.h"
+#include "scene/EntityBreakdown.h"
+#include "scene/ModelBreakdown.h"
+#include "algorithm/Scene.h"
+
+namespace test
+{
+
+using MapStatisticsTest = RadiantTest;
+
+namespace
+{
+    const char* const STATIC_MESH_PATH = "models/just_a_static_mesh.ase";
+
+    std::size_t getEntityClassCount(const std::string& eclass)
+    {
+        const auto& counts = GlobalMapModule().getRoot()->getStatistics().getEntityClassCounts();
+        auto found = counts.find(eclass);
+
+        return found != counts.end() ? found->second : 0;
+    }
+
+    std::size_t getSkinCount(const std::string& model, const std::string& skin)
+    {
+        const auto& counts = GlobalMapModule().getRoot()->getStatistics().getModelCounts();
+        auto found = counts.find(model);
+
+        if (found == counts.end()) return 0;
+
+        auto foundSkin = found->second.skinCount.find(skin);
+
+        return foundSkin != found->second.skinCount.end() ? foundSkin->second : 0;
+    }
+}
+
+TEST_F(MapStatisticsTest, CountsAfterLoading)
+{
+    loadMap("select_items_by_model.map");
+
+    auto& statistics = GlobalMapModule().getRoot()->getStatistics();
+
+    EXPECT_EQ(statistics.getEntityCount(), 7);
+    EXPECT_EQ(statistics.getPrimitiveCount(), 6);
+
+    EXPECT_EQ(getEntityClassCount("worldspawn"), 1);
+    EXPECT_EQ(getEntityClassCount("dr:entity_using_modeldef"), 3);
+    EXPECT_EQ(getEntityClassCount("light"), 1);
+    EXPECT_EQ(getEntityClassCount("func_static"), 2);
+
+    const auto& models = statistics.getModelCounts();
+    auto staticMesh = models.find(STATIC_MESH_PATH);
+
+    ASSERT_NE(staticMesh, models.end());
+    EXPECT_EQ(staticMesh->second.count, 2);
+    EXPECT_GT(staticMesh->second.polyCount, 0);
+    EXPECT_EQ(getSkinCount(STATIC_MESH_PATH, ""), 2);
+}
+
+TEST_F(MapStatisticsTest, BreakdownsMatchStatistics)
+{
+    loadMap("select_items_by_model.map");
+
+    auto& statistics = GlobalMapModule().getRoot()->getStatistics();
+
+    scene::EntityBreakdown entityBreakdown;
+    EXPECT_EQ(entityBreakdown.getMap(), statistics.getEntityClassCounts());
+
+    scene::ModelBreakdown modelBreakdown;
+    EXPECT_EQ(modelBreakdown.getMap().size(), statistics.getModelCounts().size());
+    EXPECT_EQ(modelBreakdown.getNumSkins(), 0);
+}
+
+TEST_F(MapStatisticsTest, SkinChangesAreCounted)
+{
+    loadMap("select_items_by_model.map");
+
+    auto funcStatic = algorithm::getEntityByName(GlobalMapModule().getRoot(), "func_static_1");
+    ASSERT_TRUE(funcStatic);
+
+    Node_getEntity(funcStatic)->setKeyValue("skin", "tile_boards");
+
+    EXPECT_EQ(getSkinCount(STATIC_MESH_PATH, ""), 1);
+    EXPECT_EQ(getSkinCount(STATIC_MESH_PATH, "tile_boards"), 1);
+
+    scene::ModelBreakdown modelBreakdown;
+    EXPECT_EQ(modelBreakdown.getNumSkins(), 1);
+
+    Node_getEntity(funcStatic)->setKeyValue("skin", "");
+
+    EXPECT_EQ(getSkinCount(STATIC_MESH_PATH, ""), 2);
+    EXPECT_EQ(getSkinCount(STATIC_MESH_PATH, "tile_boards"), 0);
+}
+
+TEST_F(MapStatisticsTest, InsertedAndRemovedNodesAreCounted)
+{
+    loadMap("select_items_by_model.map");
+
+    auto& statistics = GlobalMapModule().getRoot()->getStatistics();
+
+    auto eclass = GlobalEntityClassManager().findOrInsert("func_static", true);
+    auto newEntity = GlobalEntityModule().createEntity(eclass);
+    scene::addNodeToContainer(newEntity, GlobalMapModule().getRoot());
+
+    EXPECT_EQ(statistics.getEntityCount(), 8);
+    EXPECT_EQ(getEntityClassCount("func_static"), 3);
+
+    // Removing an entity removes its child model too
+    auto funcStatic = algorithm::getEntityByName(GlobalMapModule().getRoot(), "func_static_1");
+    scene::removeNodeFromParent(funcStatic);
+
+    EXPECT_EQ(statistics.getEntityCount(), 7);
+    EXPECT_EQ(getEntityClassCount("func_static"), 2);
+    EXPECT_EQ(statistics.getModelCounts().find(STATIC_MESH_PATH)->second.count, 1);
+
+    // Removing the worldspawn removes its brushes
+    scene::removeNodeFromParent(GlobalMapModule().getWorldspawn());
+
+    EXPECT_EQ(statistics.getPrimitiveCount(), 0);
+    EXPECT_EQ(getEntityClassCount("worldspawn"), 0);
+    EXPECT_EQ(statistics.getEntityClassCounts().count("worldspawn"), 0);
+}
+
+}
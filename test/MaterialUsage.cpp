@@ -0,0 +1,94 @@
+#include "RadiantTest.h"
+
+#include "imap.h"
+#include "imaterialusage.h"
+#include "ibrush.h"
+#include "iundo.h"
+#include "icommandsystem.h"
+#include "selectionlib.h"
+#include "scenelib.h"
+#include "shaderlib.h"
+#include "algorithm/Scene.h"
+
+namespace test
+{
+
+using MaterialUsageTest = RadiantTest;
+
+namespace
+{
+    // Returns the number of faces using the given material according to the map's index
+    std::size_t getFaceCount(const std::string& material)
+    {
+        std::size_t result = 0;
+
+        GlobalMapModule().getRoot()->getMaterialUsageIndex().foreachMaterial(
+            [&](const std::string& name, std::size_t faceCount, std::size_t patchCount)
+        {
+            if (name == material) result = faceCount;
+        });
+
+        return result;
+    }
+}
+
+TEST_F(MaterialUsageTest, IndexFollowsShaderChanges)
+{
+    loadMap("csg_merge.map");
+
+    auto& index = GlobalMapModule().getRoot()->getMaterialUsageIndex();
+
+    EXPECT_EQ(getFaceCount("1"), 10);
+    EXPECT_EQ(getFaceCount("3"), 5);
+    EXPECT_FALSE(index.isMaterialInUse("textures/common/caulk"));
+
+    auto brush = algorithm::findFirstBrushWithMaterial(GlobalMapModule().getWorldspawn(), "3");
+
+    {
+        UndoableCommand command("setShader");
+        Node_getIBrush(brush)->getFace(0).setShader("textures/common/caulk");
+    }
+
+    EXPECT_EQ(getFaceCount("3"), 4);
+    EXPECT_EQ(getFaceCount("textures/common/caulk"), 1);
+
+    GlobalUndoSystem().undo();
+
+    EXPECT_EQ(getFaceCount("3"), 5);
+    EXPECT_FALSE(index.isMaterialInUse("textures/common/caulk"));
+
+    // Removed brushes are no longer counted
+    scene::removeNodeFromParent(brush);
+    EXPECT_FALSE(index.isMaterialInUse("3"));
+}
+
+TEST_F(MaterialUsageTest, SelectItemsByShader)
+{
+    loadMap("csg_merge.map");
+
+    GlobalSelectionSystem().setSelectedAll(false);
+
+    // Material "1" is used by a worldspawn brush and a func_static brush
+    auto material = "1";
+
+    GlobalCommandSystem().executeCommand("SelectItemsByShader", { material });
+    EXPECT_EQ(GlobalSelectionSystem().getSelectionInfo().brushCount, 2);
+
+    GlobalCommandSystem().executeCommand("DeselectItemsByShader", { material });
+    EXPECT_EQ(GlobalSelectionSystem().getSelectionInfo().totalCount, 0);
+}
+
+TEST_F(MaterialUsageTest, FindAndReplaceShader)
+{
+    loadMap("csg_merge.map");
+
+    EXPECT_EQ(scene::findAndReplaceShader("2", "4", false), 10);
+
+    EXPECT_FALSE(GlobalMapModule().getRoot()->getMaterialUsageIndex().isMaterialInUse("2"));
+    EXPECT_EQ(getFaceCount("4"), 15);
+
+    // Nothing left to replace
+    EXPECT_EQ(scene::findAndReplaceShader("2", "4", false), 0);
+}
+
+}
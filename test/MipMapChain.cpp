@@ -0,0 +1,267 @@
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include "RGBAImage.h"
+#include "render/MipMapChain.h"
+
+namespace test
+{
+
+using render::MipMapChain;
+
+namespace
+{
+
+std::shared_ptr<RGBAImage> createImage(std::size_t width, std::size_t height, bool translucent)
+{
+    auto image = std::make_shared<RGBAImage>(width, height);
+
+    for (std::size_t y = 0; y < height; ++y)
+    {
+        for (std::size_t x = 0; x < width; ++x)
+        {
+            RGBAPixel& pixel = image->pixels[y * width + x];
+
+            // A diagonal gradient with some blocky detail. The colours lie on
+            // a line through the colour space, green running against red and blue.
+            std::size_t t = (x + y) * 191 / (width + height - 2) + ((x / 8 + y / 8) % 2) * 64;
+
+            pixel.red = static_cast<uint8_t>(t);
+            pixel.green = static_cast<uint8_t>(255 - t);
+            pixel.blue = static_cast<uint8_t>(t / 2 + 64);
+            pixel.alpha = translucent ? static_cast<uint8_t>(x * 255 / (width - 1)) : 255;
+        }
+    }
+
+    return image;
+}
+
+void decodeColours(const uint8_t* block, bool dxt1, int palette[4][3])
+{
+    uint16_t colours[2] = {
+        static_cast<uint16_t>(block[0] | (block[1] << 8)),
+        static_cast<uint16_t>(block[2] | (block[3] << 8))
+    };
+
+    for (int i = 0; i < 2; ++i)
+    {
+        int r = (colours[i] >> 11) & 31;
+        int g = (colours[i] >> 5) & 63;
+        int b = colours[i] & 31;
+
+        palette[i][0] = (r << 3) | (r >> 2);
+        palette[i][1] = (g << 2) | (g >> 4);
+        palette[i][2] = (b << 3) | (b >> 2);
+    }
+
+    for (int c = 0; c < 3; ++c)
+    {
+        if (colours[0] > colours[1] || !dxt1)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        else
+        {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+}
+
+// Decodes a DXT1 or DXT5 level into RGBA pixels
+std::vector<uint8_t> decodeLevel(const MipMapChain& chain, std::size_t levelIndex)
+{
+    const MipMapChain::Level& level = chain.levels[levelIndex];
+    bool dxt1 = chain.format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+
+    std::vector<uint8_t> pixels(level.width * level.height * 4);
+    const uint8_t* block = chain.getLevelData(levelIndex);
+
+    for (std::size_t by = 0; by < level.height; by += 4)
+    {
+        for (std::size_t bx = 0; bx < level.width; bx += 4)
+        {
+            int alpha[16];
+            std::fill(alpha, alpha + 16, 255);
+
+            if (!dxt1)
+            {
+                int alphaPalette[8] = { block[0], block[1] };
+
+                for (int p = 1; p < 7; ++p)
+                {
+                    alphaPalette[p + 1] = block[0] > block[1] ?
+                        ((7 - p) * block[0] + p * block[1]) / 7 :
+                        p < 5 ? ((5 - p) * block[0] + p * block[1]) / 5 : (p == 5 ? 0 : 255);
+                }
+
+                uint64_t indices = 0;
+
+                for (int b = 0; b < 6; ++b)
+                {
+                    indices |= static_cast<uint64_t>(block[2 + b]) << (b * 8);
+                }
+
+                for (int i = 0; i < 16; ++i)
+                {
+                    alpha[i] = alphaPalette[(indices >> (i * 3)) & 7];
+                }
+
+                block += 8;
+            }
+
+            int palette[4][3];
+            decodeColours(block, dxt1, palette);
+
+            uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24);
+
+            for (std::size_t i = 0; i < 16; ++i)
+            {
+                std::size_t x = bx + i % 4;
+                std::size_t y = by + i / 4;
+
+                if (x >= level.width || y >= level.height) continue;
+
+                uint8_t* pixel = pixels.data() + (y * level.width + x) * 4;
+                const int* colour = palette[(indices >> (i * 2)) & 3];
+
+                pixel[0] = static_cast<uint8_t>(colour[0]);
+                pixel[1] = static_cast<uint8_t>(colour[1]);
+                pixel[2] = static_cast<uint8_t>(colour[2]);
+                pixel[3] = static_cast<uint8_t>(alpha[i]);
+            }
+
+            block += 8;
+        }
+    }
+
+    return pixels;
+}
+
+// Compares the decoded levels of the compressed chain to the RGBA chain
+void expectRoundTrip(const MipMapChain& rgba, const MipMapChain& compressed, bool compareAlpha)
+{
+    ASSERT_EQ(compressed.levels.size(), rgba.levels.size());
+
+    for (std::size_t i = 0; i < rgba.levels.size(); ++i)
+    {
+        EXPECT_EQ(compressed.levels[i].width, rgba.levels[i].width);
+        EXPECT_EQ(compressed.levels[i].height, rgba.levels[i].height);
+
+        auto decoded = decodeLevel(compressed, i);
+        const uint8_t* original = rgba.getLevelData(i);
+
+        int maxError = 0;
+        long totalError = 0;
+
+        for (std::size_t p = 0; p < decoded.size(); ++p)
+        {
+            if (p % 4 == 3 && !compareAlpha) continue;
+
+            int error = std::abs(decoded[p] - original[p]);
+            maxError = std::max(maxError, error);
+            totalError += error;
+        }
+
+        // DXT is lossy, every pixel is snapped to one of four colours spanning
+        // the block, the error must stay within a fraction of that step size
+        EXPECT_LE(maxError, 32) << "Level " << i;
+        EXPECT_LE(static_cast<double>(totalError) / decoded.size(), 16.0) << "Level " << i;
+    }
+}
+
+}
+
+TEST(MipMapChain, Levels)
+{
+    auto image = createImage(16, 4, false);
+    auto chain = MipMapChain::CreateFromImage(*image);
+
+    ASSERT_EQ(chain.levels.size(), 5);
+    EXPECT_FALSE(chain.compressed);
+
+    std::size_t expected[5][2] = { { 16, 4 }, { 8, 2 }, { 4, 1 }, { 2, 1 }, { 1, 1 } };
+
+    for (std::size_t i = 0; i < chain.levels.size(); ++i)
+    {
+        EXPECT_EQ(chain.levels[i].width, expected[i][0]);
+        EXPECT_EQ(chain.levels[i].height, expected[i][1]);
+        EXPECT_EQ(chain.levels[i].size, expected[i][0] * expected[i][1] * 4);
+    }
+
+    // The first level is the image itself
+    EXPECT_EQ(std::memcmp(chain.getLevelData(0), image->getPixels(), 16 * 4 * 4), 0);
+
+    // The second level averages 2x2 pixels
+    const uint8_t* source = image->getPixels();
+    const uint8_t* pixel = chain.getLevelData(1);
+
+    for (std::size_t c = 0; c < 4; ++c)
+    {
+        int sum = source[c] + source[4 + c] + source[16 * 4 + c] + source[16 * 4 + 4 + c];
+        EXPECT_EQ(pixel[c], (sum + 2) / 4);
+    }
+
+    // The average colour is the last level
+    EXPECT_EQ(std::memcmp(&chain.averageColour, chain.getLevelData(4), 4), 0);
+}
+
+TEST(MipMapChain, CompressOpaqueImageAsDXT1)
+{
+    auto image = createImage(64, 32, false);
+    auto rgba = MipMapChain::CreateFromImage(*image);
+    auto compressed = MipMapChain::Compress(rgba);
+
+    EXPECT_TRUE(compressed.compressed);
+    EXPECT_EQ(compressed.format, GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+
+    // 8 bytes per 4x4 block, small levels still use a whole block
+    EXPECT_EQ(compressed.levels[0].size, 16 * 8 * 8);
+    EXPECT_EQ(compressed.levels.back().size, 8);
+
+    expectRoundTrip(rgba, compressed, false);
+}
+
+TEST(MipMapChain, CompressTranslucentImageAsDXT5)
+{
+    auto image = createImage(32, 32, true);
+    auto rgba = MipMapChain::CreateFromImage(*image);
+    auto compressed = MipMapChain::Compress(rgba);
+
+    EXPECT_TRUE(compressed.compressed);
+    EXPECT_EQ(compressed.format, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+    EXPECT_EQ(compressed.levels[0].size, 8 * 8 * 16);
+
+    expectRoundTrip(rgba, compressed, true);
+}
+
+TEST(MipMapChain, ImageHashDependsOnPixelsAndSize)
+{
+    auto image = createImage(16, 8, false);
+    auto sameImage = createImage(16, 8, false);
+
+    auto key = render::getImageHash(*image);
+
+    EXPECT_NE(key, 0);
+    EXPECT_EQ(key, render::getImageHash(*sameImage));
+
+    // Changing a single byte in any position changes the key
+    for (std::size_t offset : { std::size_t(0), std::size_t(3), std::size_t(16 * 8 * 4 - 1) })
+    {
+        auto modified = createImage(16, 8, false);
+        modified->getPixels()[offset] ^= 1;
+
+        EXPECT_NE(render::getImageHash(*modified), key) << "Offset " << offset;
+    }
+
+    // Same pixel data with different dimensions
+    auto transposed = std::make_shared<RGBAImage>(8, 16);
+    std::memcpy(transposed->getPixels(), image->getPixels(), 16 * 8 * 4);
+
+    EXPECT_NE(render::getImageHash(*transposed), key);
+}
+
+}
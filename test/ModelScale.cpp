@@ -3,6 +3,7 @@
 #include "algorithm/Scene.h"
 #include "iscenegraph.h"
 #include "imodel.h"
+#include "imodelsurface.h"
 #include "itransformable.h"
 #include "icommandsystem.h"
 #include "iselectable.h"
@@ -13,17 +14,18 @@
 namespace test
 {
 
-// #5263: "Model Scaler" doesn't handle model duplication correctly
-TEST_F(RadiantTest, DuplicateScaledModel)
+namespace
 {
-    loadMap("duplicate_scaled_model.map");
 
-    const std::string funcStaticName("moss01");
-    const Vector3 scale(3, 4, 2);
-    auto func_static = algorithm::getEntityByName(GlobalSceneGraph().root(), funcStaticName);
+inline const std::vector<ArbitraryMeshVertex>& getFirstSurfaceVertices(const model::ModelNodePtr& model)
+{
+    const auto& surface = dynamic_cast<const model::IIndexedModelSurface&>(model->getIModel().getSurface(0));
+    return surface.getVertexArray();
+}
 
-    // Apply the scale to the model beneath the entity
-    func_static->foreachNode([&](const scene::INodePtr& node)
+inline void applyScale(const scene::INodePtr& entity, const Vector3& scale)
+{
+    entity->foreachNode([&](const scene::INodePtr& node)
     {
         ITransformablePtr transformable = Node_getTransformable(node);
 
@@ -36,6 +38,21 @@ TEST_F(RadiantTest, DuplicateScaledModel)
 
         return true;
     });
+}
+
+}
+
+// #5263: "Model Scaler" doesn't handle model duplication correctly
+TEST_F(RadiantTest, DuplicateScaledModel)
+{
+    loadMap("duplicate_scaled_model.map");
+
+    const std::string funcStaticName("moss01");
+    const Vector3 scale(3, 4, 2);
+    auto func_static = algorithm::getEntityByName(GlobalSceneGraph().root(), funcStaticName);
+
+    // Apply the scale to the model beneath the entity
+    applyScale(func_static, scale);
 
     auto model = algorithm::findChildModel(func_static);
 
@@ -60,4 +77,35 @@ TEST_F(RadiantTest, DuplicateScaledModel)
     ASSERT_TRUE(duplicatedModel->getModelScale() == scale);
 }
 
+// Instances of the same model share their surface geometry until they are scaled
+TEST_F(RadiantTest, ModelInstancesShareSurfaces)
+{
+    loadMap("duplicate_scaled_model.map");
+
+    auto func_static = algorithm::getEntityByName(GlobalSceneGraph().root(), "moss01");
+
+    GlobalSelectionSystem().setSelectedAll(false);
+    Node_setSelected(func_static, true);
+
+    // Clone in place, the previous setting is restored at the end of the test
+    registry::ScopedKeyChanger<std::string> offsetChanger("user/ui/offsetClonedObjects", "0");
+    GlobalCommandSystem().executeCommand("CloneSelection");
+
+    auto duplicate = GlobalSelectionSystem().ultimateSelected();
+
+    auto model = algorithm::findChildModel(func_static);
+    auto duplicatedModel = algorithm::findChildModel(duplicate);
+
+    ASSERT_NE(model, duplicatedModel);
+    EXPECT_EQ(&getFirstSurfaceVertices(model), &getFirstSurfaceVertices(duplicatedModel));
+
+    // Scaling the duplicate must not affect the original model
+    auto originalVertex = getFirstSurfaceVertices(model).front().vertex;
+    applyScale(duplicate, Vector3(2, 2, 2));
+
+    EXPECT_NE(&getFirstSurfaceVertices(model), &getFirstSurfaceVertices(duplicatedModel));
+    EXPECT_EQ(getFirstSurfaceVertices(model).front().vertex, originalVertex);
+    EXPECT_TRUE(getFirstSurfaceVertices(duplicatedModel).front().vertex.isEqual(originalVertex * 2, 0.01));
+}
+
 }
@@ -0,0 +1,86 @@
+#include "RadiantTest.h"
+
+#include <algorithm>
+#include "imodel.h"
+#include "imodelcache.h"
+#include "imodelsurface.h"
+#include "modelskin.h"
+
+namespace test
+{
+
+inline bool containsSkin(const StringList& skins, const std::string& name)
+{
+    return std::find(skins.begin(), skins.end(), name) != skins.end();
+}
+
+TEST_F(RadiantTest, FindSkinsForModel)
+{
+    const auto& allSkins = GlobalModelSkinCache().getAllSkins();
+
+    EXPECT_TRUE(containsSkin(allSkins, "tile_boards"));
+    EXPECT_TRUE(containsSkin(allSkins, "swap_boards_and_unused"));
+
+    // Skins are listed in declaration order
+    const auto& lwoSkins = GlobalModelSkinCache().getSkinsForModel("models/grid_surfaces.lwo");
+
+    ASSERT_EQ(lwoSkins.size(), 2);
+    EXPECT_EQ(lwoSkins[0], "tile_boards");
+    EXPECT_EQ(lwoSkins[1], "swap_boards_and_unused");
+
+    const auto& aseSkins = GlobalModelSkinCache().getSkinsForModel("models/moss_patch.ase");
+
+    ASSERT_EQ(aseSkins.size(), 1);
+    EXPECT_EQ(aseSkins[0], "swap_boards_and_unused");
+
+    EXPECT_TRUE(GlobalModelSkinCache().getSkinsForModel("models/nonexisting.lwo").empty());
+}
+
+TEST_F(RadiantTest, CaptureSkin)
+{
+    auto& skin = GlobalModelSkinCache().capture("tile_boards");
+
+    EXPECT_EQ(skin.getName(), "tile_boards");
+    EXPECT_EQ(skin.getRemap("textures/darkmod/wood/boards"), "textures/numbers/1");
+    EXPECT_EQ(skin.getRemap("unused_surface"), "");
+
+    // The remap table is working on the material ids of the skin cache
+    auto boardsId = GlobalModelSkinCache().getMaterialId("textures/darkmod/wood/boards");
+    auto remapId = skin.getRemapId(boardsId);
+
+    ASSERT_NE(remapId, ModelSkin::NO_REMAP);
+    EXPECT_EQ(GlobalModelSkinCache().getMaterialName(remapId), "textures/numbers/1");
+    EXPECT_EQ(GlobalModelSkinCache().getMaterialId("textures/numbers/1"), remapId);
+    EXPECT_EQ(skin.getRemapId(GlobalModelSkinCache().getMaterialId("unused_surface")), ModelSkin::NO_REMAP);
+
+    // Unknown skins don't remap anything
+    auto& nullSkin = GlobalModelSkinCache().capture("nonexisting_skin");
+
+    EXPECT_EQ(nullSkin.getName(), "");
+    EXPECT_EQ(nullSkin.getRemapId(boardsId), ModelSkin::NO_REMAP);
+}
+
+TEST_F(RadiantTest, ApplySkinToModel)
+{
+    auto model = GlobalModelCache().getModel("models/grid_surfaces.lwo");
+    ASSERT_TRUE(model);
+
+    model->applySkin(GlobalModelSkinCache().capture("swap_boards_and_unused"));
+
+    EXPECT_EQ(model->getSurface(0).getActiveMaterial(), "textures/numbers/2");
+    EXPECT_EQ(model->getSurface(1).getActiveMaterial(), "textures/numbers/3");
+    EXPECT_EQ(model->getActiveMaterials().front(), "textures/numbers/2");
+
+    model->applySkin(GlobalModelSkinCache().capture("tile_boards"));
+
+    EXPECT_EQ(model->getSurface(0).getActiveMaterial(), "textures/numbers/1");
+    EXPECT_EQ(model->getSurface(1).getActiveMaterial(), "unused_surface");
+
+    // An empty skin reverts the model to its default materials
+    model->applySkin(GlobalModelSkinCache().capture(""));
+
+    EXPECT_EQ(model->getSurface(0).getActiveMaterial(), "textures/darkmod/wood/boards");
+    EXPECT_EQ(model->getSurface(1).getActiveMaterial(), "unused_surface");
+}
+
+}
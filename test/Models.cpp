@@ -0,0 +1,120 @@
+#include "RadiantTest.h"
+
+#include "imodel.h"
+#include "imodelcache.h"
+#include "imodelsurface.h"
+
+namespace test
+{
+
+namespace
+{
+
+inline void expectValidIndices(const model::IModel& model)
+{
+    for (int i = 0; i < model.getSurfaceCount(); ++i)
+    {
+        const auto& surface = dynamic_cast<const model::IIndexedModelSurface&>(model.getSurface(i));
+
+        EXPECT_EQ(surface.getIndexArray().size() % 3, 0);
+
+        for (auto index : surface.getIndexArray())
+        {
+            EXPECT_LT(index, surface.getVertexArray().size());
+        }
+    }
+}
+
+}
+
+TEST_F(RadiantTest, LoadAseModel)
+{
+    auto model = GlobalModelCache().getModel("models/moss_patch.ase");
+
+    ASSERT_TRUE(model);
+    EXPECT_EQ(model->getSurfaceCount(), 1);
+    EXPECT_EQ(model->getVertexCount(), 9);
+    EXPECT_EQ(model->getPolyCount(), 6);
+
+    // Every vertex normal must be normalised
+    const auto& surface = model->getSurface(0);
+
+    for (int i = 0; i < surface.getNumVertices(); ++i)
+    {
+        EXPECT_NEAR(surface.getVertex(i).normal.getLength(), 1.0, 0.01);
+    }
+
+    expectValidIndices(*model);
+}
+
+TEST_F(RadiantTest, AseModelMatchesPicomodel)
+{
+    auto model = GlobalModelCache().getModel("models/moss_patch.ase");
+    ASSERT_TRUE(model);
+    ASSERT_EQ(model->getSurfaceCount(), 1);
+
+    // Output of picomodel's ASE loader for this model: position, normal, texcoord
+    const double picoVertices[][8] =
+    {
+        { -0, 0, 2.12520003, -0, -0, 1, 0.5, 0.5 },
+        { -17.8586998, -17.8586998, 0.0434000008, -0.704699993, -0.704699993, -0.0819000006, 0, 1 },
+        { -17.8586998, 17.8586998, 0.0434000008, -0.115800001, 0.115800001, 0.986500025, 0, 0 },
+        { 17.8586998, 17.8586998, 0.0434000008, 0.704699993, 0.704699993, -0.0819000006, 1, 0 },
+        { 17.8586998, -17.8586998, 0.0434000008, 0.115800001, -0.115800001, 0.986500025, 1, 1 },
+        { -17.8586998, -17.8586998, 0.0434000008, -0.704699993, -0.704699993, -0.0819000006, 0, 0 },
+        { 17.8586998, -17.8586998, 0.0434000008, 0.115800001, -0.115800001, 0.986500025, 1, 0 },
+        { 17.8586998, 17.8586998, 0.0434000008, 0.704699993, 0.704699993, -0.0819000006, 1, 1 },
+        { -17.8586998, 17.8586998, 0.0434000008, -0.115800001, 0.115800001, 0.986500025, 0, 1 },
+    };
+    const std::vector<unsigned int> picoIndices = { 0, 1, 2, 0, 2, 3, 4, 1, 0, 4, 0, 3, 5, 6, 7, 7, 8, 5 };
+
+    const auto& surface = dynamic_cast<const model::IIndexedModelSurface&>(model->getSurface(0));
+
+    // The material is not defined, the material name is used instead of the bitmap
+    EXPECT_EQ(surface.getDefaultMaterial(), "moss_d");
+    EXPECT_EQ(surface.getIndexArray(), picoIndices);
+    ASSERT_EQ(surface.getVertexArray().size(), 9);
+
+    for (std::size_t i = 0; i < surface.getVertexArray().size(); ++i)
+    {
+        const auto& vertex = surface.getVertexArray()[i];
+        const auto& expected = picoVertices[i];
+
+        EXPECT_TRUE(vertex.vertex.isEqual(Vector3(expected[0], expected[1], expected[2]), 1e-6)) << "Vertex " << i;
+        EXPECT_TRUE(vertex.normal.isEqual(Vector3(expected[3], expected[4], expected[5]), 1e-6)) << "Normal " << i;
+        EXPECT_NEAR(vertex.texcoord.x(), expected[6], 1e-6) << "Texcoord " << i;
+        EXPECT_NEAR(vertex.texcoord.y(), expected[7], 1e-6) << "Texcoord " << i;
+    }
+}
+
+TEST_F(RadiantTest, AseModelWithInvalidFaceIndices)
+{
+    // The native parser rejects the file, picomodel loads it skipping the invalid faces
+    auto model = GlobalModelCache().getModel("models/invalid_face_indices.ase");
+
+    ASSERT_TRUE(model);
+    EXPECT_EQ(model->getSurfaceCount(), 1);
+    EXPECT_EQ(model->getVertexCount(), 3);
+    EXPECT_EQ(model->getPolyCount(), 1);
+
+    expectValidIndices(*model);
+}
+
+TEST_F(RadiantTest, LoadLwoModel)
+{
+    auto model = GlobalModelCache().getModel("models/grid_surfaces.lwo");
+
+    // The quad is discarded, surfaces without polygons are kept like picomodel does
+    ASSERT_TRUE(model);
+    EXPECT_EQ(model->getSurfaceCount(), 2);
+    EXPECT_EQ(model->getVertexCount(), 64);
+    EXPECT_EQ(model->getPolyCount(), 98);
+
+    EXPECT_EQ(model->getSurface(0).getDefaultMaterial(), "textures/darkmod/wood/boards");
+    EXPECT_EQ(model->getSurface(1).getDefaultMaterial(), "unused_surface");
+    EXPECT_EQ(model->getSurface(1).getNumTriangles(), 0);
+
+    expectValidIndices(*model);
+}
+
+}
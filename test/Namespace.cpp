@@ -0,0 +1,50 @@
+#include "RadiantTest.h"
+
+#include "inamespace.h"
+
+namespace test
+{
+
+TEST_F(RadiantTest, NamespaceAddUniqueName)
+{
+    auto nspace = GlobalNamespaceFactory().createNamespace();
+
+    EXPECT_TRUE(nspace->insert("func_static_1"));
+    EXPECT_FALSE(nspace->insert("func_static_1"));
+    EXPECT_TRUE(nspace->insert("func_static_2"));
+    EXPECT_TRUE(nspace->insert("func_static_04"));
+
+    // Postfixes with leading zeros don't block the plain number
+    EXPECT_EQ(nspace->addUniqueName("func_static_1"), "func_static_3");
+    EXPECT_EQ(nspace->addUniqueName("func_static_4"), "func_static_4");
+    EXPECT_EQ(nspace->addUniqueName("func_static_04"), "func_static_5");
+
+    // Freed numbers are handed out again
+    EXPECT_TRUE(nspace->erase("func_static_2"));
+    EXPECT_FALSE(nspace->nameExists("func_static_2"));
+    EXPECT_EQ(nspace->addUniqueName("func_static_3"), "func_static_2");
+    EXPECT_EQ(nspace->addUniqueName("func_static_3"), "func_static_6");
+
+    // Names without postfix get a number if they're taken
+    EXPECT_EQ(nspace->addUniqueName("light"), "light");
+    EXPECT_EQ(nspace->addUniqueName("light"), "light1");
+    EXPECT_TRUE(nspace->nameExists("light1"));
+    EXPECT_FALSE(nspace->nameExists("light2"));
+}
+
+TEST_F(RadiantTest, NamespaceAddManyUniqueNames)
+{
+    auto nspace = GlobalNamespaceFactory().createNamespace();
+
+    for (int i = 1; i <= 2000; ++i)
+    {
+        EXPECT_EQ(nspace->addUniqueName("func_static_1"), "func_static_" + std::to_string(i));
+    }
+
+    // Punch a hole into the used range
+    EXPECT_TRUE(nspace->erase("func_static_1000"));
+    EXPECT_EQ(nspace->addUniqueName("func_static_1"), "func_static_1000");
+    EXPECT_EQ(nspace->addUniqueName("func_static_1"), "func_static_2001");
+}
+
+}
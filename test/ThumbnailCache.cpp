@@ -0,0 +1,137 @@
+#include "RadiantTest.h"
+
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include "ishaders.h"
+#include "os/fs.h"
+
+namespace test
+{
+
+using ThumbnailCacheTest = RadiantTest;
+
+namespace
+{
+
+// A 256x128 editor image, its thumbnail is downscaled to 128x64
+const char* const STRIPES_MATERIAL = "textures/thumbnails/stripes";
+const char* const STRIPES_IMAGE = "textures/thumbnails/stripes.tga";
+
+// Header and a single tile slot of 128x128 RGBA pixels
+const std::size_t ATLAS_SIZE_WITH_ONE_SLOT = 16 + 16 + 128 * 128 * 4;
+
+// Thumbnails are generated in the background, give the workers some time
+TexturePtr waitForThumbnail(const std::string& materialName)
+{
+    for (int i = 0; i < 100; ++i)
+    {
+        auto texture = GlobalMaterialManager().getMaterialForName(materialName)->getEditorImageThumbnail();
+
+        if (texture) return texture;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    return TexturePtr();
+}
+
+// Returns the line of the given material in the index file, or an empty string
+std::string getIndexLine(const fs::path& indexPath, const std::string& materialName)
+{
+    std::ifstream stream(indexPath.string());
+    std::string line;
+
+    while (std::getline(stream, line))
+    {
+        if (line.size() > materialName.size() &&
+            line.compare(line.size() - materialName.size() - 1, std::string::npos, "\t" + materialName) == 0)
+        {
+            return line;
+        }
+    }
+
+    return std::string();
+}
+
+// Moves the modification time of the given file by the given number of hours
+void touchFile(const fs::path& path, int hours)
+{
+#ifdef DR_USE_STD_FILESYSTEM
+    fs::last_write_time(path, fs::last_write_time(path) + std::chrono::hours(hours));
+#else
+    fs::last_write_time(path, fs::last_write_time(path) + hours * 3600);
+#endif
+}
+
+}
+
+TEST_F(ThumbnailCacheTest, GenerateSaveAndReload)
+{
+    fs::path atlasPath = _context.getSettingsPath() + "thumbnails.atlas";
+    fs::path indexPath = _context.getSettingsPath() + "thumbnails.index";
+
+    // Nothing cached yet, the first request starts generating the thumbnail
+    EXPECT_FALSE(GlobalMaterialManager().getMaterialForName(STRIPES_MATERIAL)->getEditorImageThumbnail());
+
+    auto thumbnail = waitForThumbnail(STRIPES_MATERIAL);
+    ASSERT_TRUE(thumbnail);
+
+    // The thumbnail reports the dimensions of the full image
+    EXPECT_EQ(thumbnail->getWidth(), 256);
+    EXPECT_EQ(thumbnail->getHeight(), 128);
+
+    // A single tile is kept in memory until the cache is saved
+    EXPECT_FALSE(fs::exists(atlasPath));
+
+    // Reloading the materials saves the cache
+    thumbnail.reset();
+    GlobalMaterialManager().refresh();
+
+    ASSERT_TRUE(fs::exists(atlasPath));
+    EXPECT_EQ(fs::file_size(atlasPath), ATLAS_SIZE_WITH_ONE_SLOT);
+    EXPECT_FALSE(getIndexLine(indexPath, STRIPES_MATERIAL).empty());
+
+    // The thumbnail is read from the atlas right away
+    thumbnail = GlobalMaterialManager().getMaterialForName(STRIPES_MATERIAL)->getEditorImageThumbnail();
+
+    ASSERT_TRUE(thumbnail);
+    EXPECT_EQ(thumbnail->getWidth(), 256);
+    EXPECT_EQ(thumbnail->getHeight(), 128);
+}
+
+TEST_F(ThumbnailCacheTest, ModifiedImageIsRegenerated)
+{
+    fs::path atlasPath = _context.getSettingsPath() + "thumbnails.atlas";
+    fs::path indexPath = _context.getSettingsPath() + "thumbnails.index";
+    fs::path imagePath = _context.getTestResourcePath() + STRIPES_IMAGE;
+
+    ASSERT_TRUE(waitForThumbnail(STRIPES_MATERIAL));
+    GlobalMaterialManager().refresh();
+
+    auto indexLine = getIndexLine(indexPath, STRIPES_MATERIAL);
+    EXPECT_NE(indexLine.find("\t" + std::to_string(os::getLastWriteTime(imagePath)) + "\t"), std::string::npos);
+
+    touchFile(imagePath, 1);
+    auto newStamp = os::getLastWriteTime(imagePath);
+
+    // The image is newer than the cached thumbnail, it is generated again
+    GlobalMaterialManager().refresh();
+    EXPECT_FALSE(GlobalMaterialManager().getMaterialForName(STRIPES_MATERIAL)->getEditorImageThumbnail());
+    EXPECT_TRUE(waitForThumbnail(STRIPES_MATERIAL));
+
+    GlobalMaterialManager().refresh();
+
+    // The outdated tile has been overwritten in its slot
+    EXPECT_EQ(fs::file_size(atlasPath), ATLAS_SIZE_WITH_ONE_SLOT);
+
+    indexLine = getIndexLine(indexPath, STRIPES_MATERIAL);
+    EXPECT_NE(indexLine.find("\t" + std::to_string(newStamp) + "\t"), std::string::npos);
+
+    // Up to date again, no need to generate anything
+    EXPECT_TRUE(GlobalMaterialManager().getMaterialForName(STRIPES_MATERIAL)->getEditorImageThumbnail());
+
+    touchFile(imagePath, -1);
+}
+
+}
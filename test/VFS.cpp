@@ -1,6 +1,10 @@
 #include "RadiantTest.h"
 
 #include "ifilesystem.h"
+#include "os/fs.h"
+#include <fstream>
+#include <thread>
+#include <chrono>
 
 namespace test
 {
@@ -120,4 +124,60 @@ TEST_F(VfsTest, assetsLstFileHandling)
     EXPECT_EQ(fileVis.count("assets.lst"), 0);
 }
 
+TEST_F(VfsTest, FilesystemChangesAreNoticed)
+{
+    // The mod folder is watched in the background, give it some time to notice
+    auto waitForFileCount = [](const std::string& filename, int expectedCount)
+    {
+        for (int i = 0; i < 100 && GlobalFileSystem().getFileCount(filename) != expectedCount; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+
+        return GlobalFileSystem().getFileCount(filename);
+    };
+
+    fs::path materialFile = _context.getTestResourcePath() + "materials/vfs_watcher_test.mtr";
+
+    EXPECT_EQ(GlobalFileSystem().getFileCount("materials/vfs_watcher_test.mtr"), 0);
+
+    std::ofstream(materialFile.string()) << "textures/vfs_watcher_test {}" << std::endl;
+    EXPECT_EQ(waitForFileCount("materials/vfs_watcher_test.mtr", 1), 1);
+    EXPECT_TRUE(GlobalFileSystem().openTextFile("materials/vfs_watcher_test.mtr"));
+
+    fs::remove(materialFile);
+    EXPECT_EQ(waitForFileCount("materials/vfs_watcher_test.mtr", 0), 0);
+    EXPECT_FALSE(GlobalFileSystem().openTextFile("materials/vfs_watcher_test.mtr"));
+}
+
+TEST_F(VfsTest, WrittenFilesAreFoundRightAway)
+{
+    fs::path modelFile = _context.getTestResourcePath() + "models/vfs_written_model_test.ase";
+
+    // Without waiting for the directory watcher, like an exporter loading its output
+    std::ofstream(modelFile.string()) << "*3DSMAX_ASCIIEXPORT 200" << std::endl;
+
+    EXPECT_EQ(GlobalFileSystem().getFileCount("models/vfs_written_model_test.ase"), 1);
+    EXPECT_TRUE(GlobalFileSystem().openFile("models/vfs_written_model_test.ase"));
+    EXPECT_FALSE(GlobalFileSystem().findFile("models/vfs_written_model_test.ase").empty());
+    EXPECT_NE(GlobalFileSystem().getFileModificationTime("models/vfs_written_model_test.ase"), 0);
+
+    fs::remove(modelFile);
+    EXPECT_FALSE(GlobalFileSystem().openFile("models/vfs_written_model_test.ase"));
+}
+
+TEST_F(VfsTest, FileModificationTime)
+{
+    fs::path resourcePath = _context.getTestResourcePath();
+
+    EXPECT_EQ(GlobalFileSystem().getFileModificationTime("nothere"), 0);
+
+    EXPECT_EQ(GlobalFileSystem().getFileModificationTime("materials/example.mtr"),
+        os::getLastWriteTime(resourcePath / "materials/example.mtr"));
+
+    // Files in PK4s report the modification time of the archive
+    EXPECT_EQ(GlobalFileSystem().getFileModificationTime("materials/tdm_bloom_afx.mtr"),
+        os::getLastWriteTime(resourcePath / "tdm_example_mtrs.pk4"));
+}
+
 }
@@ -0,0 +1,376 @@
+#include "gtest/gtest.h"
+
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <functional>
+
+#include "math/BatchOps.h"
+#include "math/Matrix4.h"
+#include "math/Plane3.h"
+#include "math/AABB.h"
+
+namespace test
+{
+
+namespace
+{
+
+const double EPSILON = 0.0000001;
+
+const math::InstructionSet ALL_INSTRUCTION_SETS[] =
+{
+    math::InstructionSet::Scalar,
+    math::InstructionSet::SSE2,
+    math::InstructionSet::AVX,
+};
+
+const char* getInstructionSetName(math::InstructionSet set)
+{
+    switch (set)
+    {
+    case math::InstructionSet::SSE2: return "SSE2";
+    case math::InstructionSet::AVX: return "AVX";
+    default: return "Scalar";
+    }
+}
+
+// Restores the instruction set picked by the library when going out of scope
+class InstructionSetGuard
+{
+private:
+    math::InstructionSet _previous;
+
+public:
+    InstructionSetGuard() :
+        _previous(math::getInstructionSet())
+    {}
+
+    ~InstructionSetGuard()
+    {
+        math::setInstructionSet(_previous);
+    }
+};
+
+Matrix4 createTestTransform()
+{
+    Matrix4 transform = Matrix4::getTranslation(Vector3(128, -56, 1024));
+    transform.multiplyBy(Matrix4::getRotationForEulerXYZDegrees(Vector3(30, -45, 10)));
+    transform.multiplyBy(Matrix4::getScale(Vector3(2, 0.5, -1.5)));
+
+    return transform;
+}
+
+std::vector<Vector3> createRandomPoints(std::size_t count)
+{
+    std::minstd_rand rand(17);
+    std::uniform_real_distribution<double> coord(-8192, 8192);
+
+    std::vector<Vector3> points;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        points.emplace_back(coord(rand), coord(rand), coord(rand));
+    }
+
+    return points;
+}
+
+std::vector<Plane3> createRandomPlanes(std::size_t count)
+{
+    std::minstd_rand rand(23);
+    std::uniform_real_distribution<double> normal(-1, 1);
+    std::uniform_real_distribution<double> dist(-4096, 4096);
+
+    std::vector<Plane3> planes;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        planes.emplace_back(Vector3(normal(rand), normal(rand), normal(rand)).getNormalised(), dist(rand));
+    }
+
+    return planes;
+}
+
+std::vector<AABB> createRandomBoxes(std::size_t count)
+{
+    std::minstd_rand rand(31);
+    std::uniform_real_distribution<double> origin(-8192, 8192);
+    std::uniform_real_distribution<double> extents(0, 512);
+
+    std::vector<AABB> boxes;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        boxes.emplace_back(Vector3(origin(rand), origin(rand), origin(rand)),
+            Vector3(extents(rand), extents(rand), extents(rand)));
+    }
+
+    return boxes;
+}
+
+void expectNear(const Vector3& a, const Vector3& b)
+{
+    EXPECT_NEAR(a.x(), b.x(), EPSILON);
+    EXPECT_NEAR(a.y(), b.y(), EPSILON);
+    EXPECT_NEAR(a.z(), b.z(), EPSILON);
+}
+
+// Returns the average time of the given operation in microseconds
+double measure(const std::function<void()>& operation)
+{
+    const int REPETITIONS = 20;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < REPETITIONS; ++i)
+    {
+        operation();
+    }
+
+    auto duration = std::chrono::steady_clock::now() - start;
+
+    return std::chrono::duration<double, std::micro>(duration).count() / REPETITIONS;
+}
+
+// Prints the time taken by the operation using each supported instruction set
+void runBenchmark(const std::string& name, const std::function<void()>& operation)
+{
+    InstructionSetGuard guard;
+
+    for (auto set : ALL_INSTRUCTION_SETS)
+    {
+        if (!math::isInstructionSetSupported(set)) continue;
+
+        math::setInstructionSet(set);
+        operation(); // warm-up
+
+        std::cout << name << " [" << getInstructionSetName(set) << "]: "
+            << measure(operation) << " us" << std::endl;
+    }
+}
+
+}
+
+TEST(BatchOps, ScalarIsAlwaysSupported)
+{
+    InstructionSetGuard guard;
+
+    EXPECT_TRUE(math::isInstructionSetSupported(math::InstructionSet::Scalar));
+
+    math::setInstructionSet(math::InstructionSet::Scalar);
+    EXPECT_EQ(math::getInstructionSet(), math::InstructionSet::Scalar);
+}
+
+TEST(BatchOps, UnsupportedInstructionSetFallsBack)
+{
+    InstructionSetGuard guard;
+
+    math::setInstructionSet(math::InstructionSet::AVX);
+    EXPECT_TRUE(math::isInstructionSetSupported(math::getInstructionSet()));
+}
+
+TEST(BatchOps, TransformPoints)
+{
+    InstructionSetGuard guard;
+
+    auto transform = createTestTransform();
+    auto original = createRandomPoints(103); // not a multiple of four
+
+    for (auto set : ALL_INSTRUCTION_SETS)
+    {
+        math::setInstructionSet(set);
+
+        auto points = original;
+        math::transformPoints(transform, points.data(), points.size());
+
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            expectNear(points[i], transform.transformPoint(original[i]));
+        }
+    }
+}
+
+TEST(BatchOps, TransformStridedPoints)
+{
+    InstructionSetGuard guard;
+
+    struct Vertex
+    {
+        Vector3 vertex;
+        double texcoord[2];
+    };
+
+    auto transform = createTestTransform();
+    auto points = createRandomPoints(37);
+
+    for (auto set : ALL_INSTRUCTION_SETS)
+    {
+        math::setInstructionSet(set);
+
+        std::vector<Vertex> vertices;
+
+        for (const auto& point : points)
+        {
+            vertices.push_back(Vertex{ point, { 0.25, 0.75 } });
+        }
+
+        math::transformPoints(transform, &vertices.front().vertex, vertices.size(), sizeof(Vertex));
+
+        for (std::size_t i = 0; i < vertices.size(); ++i)
+        {
+            expectNear(vertices[i].vertex, transform.transformPoint(points[i]));
+
+            // The remaining members are not touched
+            EXPECT_EQ(vertices[i].texcoord[0], 0.25);
+            EXPECT_EQ(vertices[i].texcoord[1], 0.75);
+        }
+    }
+}
+
+TEST(BatchOps, TransformPlanes)
+{
+    InstructionSetGuard guard;
+
+    auto transform = createTestTransform();
+    auto original = createRandomPlanes(103);
+
+    for (auto set : ALL_INSTRUCTION_SETS)
+    {
+        math::setInstructionSet(set);
+
+        auto planes = original;
+        math::transformPlanes(transform, planes.data(), planes.size());
+
+        for (std::size_t i = 0; i < planes.size(); ++i)
+        {
+            Plane3 expected = original[i].transformed(transform);
+
+            expectNear(planes[i].normal(), expected.normal());
+            EXPECT_NEAR(planes[i].dist(), expected.dist(), EPSILON);
+        }
+    }
+}
+
+TEST(BatchOps, TransformAABBs)
+{
+    InstructionSetGuard guard;
+
+    auto transform = createTestTransform();
+    auto original = createRandomBoxes(103);
+
+    // Invalid boxes are left untouched
+    original[5] = AABB();
+    original[6] = AABB(Vector3(0, 0, 0), Vector3(1, -1, 1));
+    original[100] = AABB(Vector3(0, 1e40, 0), Vector3(1, 1, 1));
+
+    for (auto set : ALL_INSTRUCTION_SETS)
+    {
+        math::setInstructionSet(set);
+
+        auto boxes = original;
+        math::transformAABBs(transform, boxes.data(), boxes.size());
+
+        for (std::size_t i = 0; i < boxes.size(); ++i)
+        {
+            AABB expected = AABB::createFromOrientedAABBSafe(original[i], transform);
+
+            expectNear(boxes[i].origin, expected.origin);
+            expectNear(boxes[i].extents, expected.extents);
+        }
+
+        EXPECT_EQ(boxes[5], original[5]);
+        EXPECT_EQ(boxes[6], original[6]);
+        EXPECT_EQ(boxes[100], original[100]);
+    }
+}
+
+TEST(BatchOps, GetPlaneDistances)
+{
+    InstructionSetGuard guard;
+
+    Plane3 plane(Vector3(0.3, -0.5, 0.8).getNormalised(), 256);
+    auto points = createRandomPoints(103);
+
+    for (auto set : ALL_INSTRUCTION_SETS)
+    {
+        math::setInstructionSet(set);
+
+        std::vector<double> distances(points.size());
+        math::getPlaneDistances(plane, points.data(), points.size(), distances.data());
+
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            EXPECT_NEAR(distances[i], plane.distanceToPoint(points[i]), EPSILON);
+        }
+    }
+}
+
+TEST(BatchOps, EmptyBatchesAreIgnored)
+{
+    InstructionSetGuard guard;
+
+    auto transform = createTestTransform();
+
+    for (auto set : ALL_INSTRUCTION_SETS)
+    {
+        math::setInstructionSet(set);
+
+        math::transformPoints(transform, nullptr, 0);
+        math::transformPlanes(transform, nullptr, 0);
+        math::transformAABBs(transform, nullptr, 0);
+        math::getPlaneDistances(Plane3(0, 0, 1, 0), nullptr, 0, nullptr);
+    }
+}
+
+// The benchmarks print the timings of each instruction set, they don't fail
+// on slow machines
+
+TEST(BatchOpsBenchmark, TransformPoints)
+{
+    auto transform = createTestTransform();
+    auto points = createRandomPoints(100000);
+
+    runBenchmark("Transform 100000 points", [&]()
+    {
+        math::transformPoints(transform, points.data(), points.size());
+    });
+}
+
+TEST(BatchOpsBenchmark, TransformPlanes)
+{
+    auto transform = createTestTransform();
+    auto planes = createRandomPlanes(100000);
+
+    runBenchmark("Transform 100000 planes", [&]()
+    {
+        math::transformPlanes(transform, planes.data(), planes.size());
+    });
+}
+
+TEST(BatchOpsBenchmark, TransformAABBs)
+{
+    auto transform = createTestTransform();
+    auto boxes = createRandomBoxes(100000);
+
+    runBenchmark("Transform 100000 AABBs", [&]()
+    {
+        // Start from the same boxes each time, the extents would grow otherwise
+        auto transformed = boxes;
+        math::transformAABBs(transform, transformed.data(), transformed.size());
+    });
+}
+
+TEST(BatchOpsBenchmark, GetPlaneDistances)
+{
+    Plane3 plane(Vector3(0.3, -0.5, 0.8).getNormalised(), 256);
+    auto points = createRandomPoints(100000);
+    std::vector<double> distances(points.size());
+
+    runBenchmark("Plane distances of 100000 points", [&]()
+    {
+        math::getPlaneDistances(plane, points.data(), points.size(), distances.data());
+    });
+}
+
+}
@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+
+#include <random>
+#include "math/PackedAABBs.h"
+
+namespace test
+{
+
+namespace
+{
+
+// A slightly skewed box-shaped frustum around the origin, the normals point inwards
+Frustum createTestFrustum()
+{
+    return Frustum(
+        Plane3(Vector3(-1, 0.2, 0).getNormalised(), -500),
+        Plane3(Vector3(1, 0.1, 0).getNormalised(), -400),
+        Plane3(Vector3(0, 1, -0.3).getNormalised(), -300),
+        Plane3(Vector3(0, -1, 0).getNormalised(), -600),
+        Plane3(Vector3(0.1, 0, 1).getNormalised(), -1000),
+        Plane3(Vector3(0, 0, -1).getNormalised(), -200)
+    );
+}
+
+std::vector<AABB> createRandomBoxes(std::size_t count)
+{
+    std::minstd_rand rand(17);
+    std::uniform_real_distribution<double> origin(-3000, 3000);
+    std::uniform_real_distribution<double> extents(0.5, 400);
+
+    std::vector<AABB> boxes;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        boxes.emplace_back(Vector3(origin(rand), origin(rand), origin(rand)),
+            Vector3(extents(rand), extents(rand), extents(rand)));
+    }
+
+    return boxes;
+}
+
+}
+
+TEST(PackedAABBs, FrustumTestAgreesWithFrustum)
+{
+    auto frustum = createTestFrustum();
+    auto boxes = createRandomBoxes(1003); // not a multiple of four
+
+    PackedAABBs packed;
+
+    for (const auto& box : boxes)
+    {
+        packed.push_back(box);
+    }
+
+    EXPECT_EQ(packed.size(), boxes.size());
+
+    std::vector<std::uint8_t> visibility;
+    auto numOutside = packed.testFrustum(frustum, visibility);
+
+    ASSERT_EQ(visibility.size(), boxes.size());
+
+    std::size_t numCulled = 0;
+
+    for (std::size_t i = 0; i < boxes.size(); ++i)
+    {
+        // Boxes (partially) inside must never be culled
+        if (frustum.testIntersection(boxes[i]) != VOLUME_OUTSIDE)
+        {
+            EXPECT_EQ(visibility[i], 1) << "Box " << i << " has been culled";
+        }
+
+        // Boxes outside by more than the tolerance must always be culled
+        AABB expanded(boxes[i].origin, boxes[i].extents + Vector3(2, 2, 2));
+
+        if (frustum.testIntersection(expanded) == VOLUME_OUTSIDE)
+        {
+            EXPECT_EQ(visibility[i], 0) << "Box " << i << " has not been culled";
+        }
+
+        numCulled += visibility[i] == 0 ? 1 : 0;
+    }
+
+    EXPECT_EQ(numOutside, numCulled);
+
+    // The test set should contain both visible and culled boxes
+    EXPECT_GT(numCulled, 0);
+    EXPECT_LT(numCulled, boxes.size());
+}
+
+TEST(PackedAABBs, InvalidBoxesAreNeverCulled)
+{
+    PackedAABBs packed;
+
+    for (std::size_t i = 0; i < 5; ++i)
+    {
+        packed.push_back(AABB());
+    }
+
+    std::vector<std::uint8_t> visibility;
+    EXPECT_EQ(packed.testFrustum(createTestFrustum(), visibility), 0);
+    EXPECT_EQ(visibility, std::vector<std::uint8_t>(5, 1));
+}
+
+TEST(PackedAABBs, EraseAndAppendKeepOrder)
+{
+    auto frustum = createTestFrustum();
+
+    AABB inside(Vector3(0, 0, 0), Vector3(10, 10, 10));
+    AABB outside(Vector3(5000, 0, 0), Vector3(10, 10, 10));
+
+    PackedAABBs packed;
+    packed.push_back(inside);
+    packed.push_back(outside);
+    packed.push_back(inside);
+
+    PackedAABBs other;
+    other.push_back(outside);
+    other.push_back(inside);
+
+    packed.append(other);
+    packed.erase(0);
+
+    std::vector<std::uint8_t> visibility;
+    EXPECT_EQ(packed.testFrustum(frustum, visibility), 2);
+    EXPECT_EQ(visibility, std::vector<std::uint8_t>({ 0, 1, 0, 1 }));
+
+    packed.clear();
+    EXPECT_TRUE(packed.empty());
+}
+
+}